@@ -0,0 +1,285 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "AudioProcessor.h"
+#include "Benchmark.h"
+#include "BenchUtil.h"
+#include "Mp3AudioFileReader.h"
+#include "ParallelWaveformGenerator.h"
+#include "SndFileAudioFileReader.h"
+#include "WaveformBuffer.h"
+#include "WaveformGenerator.h"
+
+#include <sndfile.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// Counts the decoded frames, so that only the time spent reading the audio is
+// measured.
+
+class NullAudioProcessor : public AudioProcessor
+{
+    public:
+        NullAudioProcessor() : frame_count_(0)
+        {
+        }
+
+        virtual bool init(int, int, long, int)
+        {
+            frame_count_ = 0;
+            return true;
+        }
+
+        virtual bool shouldContinue() const
+        {
+            return true;
+        }
+
+        virtual bool process(const short*, int input_frame_count)
+        {
+            frame_count_ += input_frame_count;
+            return true;
+        }
+
+        virtual bool supportsFloat() const
+        {
+            return true;
+        }
+
+        virtual bool processFloat(const float*, int input_frame_count)
+        {
+            frame_count_ += input_frame_count;
+            return true;
+        }
+
+        virtual void done()
+        {
+        }
+
+        long long getFrameCount() const { return frame_count_; }
+
+    private:
+        long long frame_count_;
+};
+
+//------------------------------------------------------------------------------
+
+// One minute of audio
+static const int FRAMES = BenchUtil::SAMPLE_RATE * 60;
+
+//------------------------------------------------------------------------------
+
+static void readSndFile(
+    BenchmarkState& state,
+    const char* extension,
+    const int channels,
+    const int format)
+{
+    TempFile file(extension);
+
+    const long long size = BenchUtil::writeAudioFile(
+        file.c_str(),
+        BenchUtil::createAudio(FRAMES, channels),
+        channels,
+        format
+    );
+
+    while (state.keepRunning()) {
+        SndFileAudioFileReader reader;
+
+        if (!reader.open(file.c_str(), false)) {
+            throw std::runtime_error("Failed to open audio file");
+        }
+
+        NullAudioProcessor processor;
+
+        if (!reader.run(processor) || processor.getFrameCount() != FRAMES) {
+            throw std::runtime_error("Failed to read audio file");
+        }
+    }
+
+    state.setItemsPerIteration(FRAMES);
+    state.setBytesPerIteration(size);
+}
+
+//------------------------------------------------------------------------------
+
+static void SndFileAudioFileReader_wav_16bit_mono(BenchmarkState& state)
+{
+    readSndFile(state, ".wav", 1, SF_FORMAT_WAV | SF_FORMAT_PCM_16);
+}
+
+BENCHMARK(SndFileAudioFileReader_wav_16bit_mono);
+
+//------------------------------------------------------------------------------
+
+static void SndFileAudioFileReader_wav_16bit_stereo(BenchmarkState& state)
+{
+    readSndFile(state, ".wav", 2, SF_FORMAT_WAV | SF_FORMAT_PCM_16);
+}
+
+BENCHMARK(SndFileAudioFileReader_wav_16bit_stereo);
+
+//------------------------------------------------------------------------------
+
+static void SndFileAudioFileReader_wav_24bit_stereo(BenchmarkState& state)
+{
+    readSndFile(state, ".wav", 2, SF_FORMAT_WAV | SF_FORMAT_PCM_24);
+}
+
+BENCHMARK(SndFileAudioFileReader_wav_24bit_stereo);
+
+//------------------------------------------------------------------------------
+
+static void SndFileAudioFileReader_wav_float_stereo(BenchmarkState& state)
+{
+    readSndFile(state, ".wav", 2, SF_FORMAT_WAV | SF_FORMAT_FLOAT);
+}
+
+BENCHMARK(SndFileAudioFileReader_wav_float_stereo);
+
+//------------------------------------------------------------------------------
+
+static void SndFileAudioFileReader_flac_stereo(BenchmarkState& state)
+{
+    readSndFile(state, ".flac", 2, SF_FORMAT_FLAC | SF_FORMAT_PCM_16);
+}
+
+BENCHMARK(SndFileAudioFileReader_flac_stereo);
+
+//------------------------------------------------------------------------------
+
+// libsndfile can't write MP3 files in all versions, so this uses the MP3
+// file from the tests. Like the tests, run this from the build directory.
+
+static void Mp3AudioFileReader_stereo(BenchmarkState& state)
+{
+    const char* filename = "../test/data/test_file_stereo.mp3";
+
+    long long frame_count = 0;
+
+    while (state.keepRunning()) {
+        Mp3AudioFileReader reader;
+
+        if (!reader.open(filename, false)) {
+            throw std::runtime_error(std::string("Failed to open ") + filename);
+        }
+
+        NullAudioProcessor processor;
+
+        if (!reader.run(processor)) {
+            throw std::runtime_error(std::string("Failed to read ") + filename);
+        }
+
+        frame_count = processor.getFrameCount();
+    }
+
+    state.setItemsPerIteration(frame_count);
+    state.setBytesPerIteration(BenchUtil::getFileSize(filename));
+}
+
+BENCHMARK(Mp3AudioFileReader_stereo);
+
+//------------------------------------------------------------------------------
+
+// Decodes a FLAC file and generates waveform data at 256 samples per pixel,
+// using one thread or several, as with the --threads option.
+
+static void generateFromFlac(BenchmarkState& state, const int threads)
+{
+    const int channels = 2;
+
+    TempFile file(".flac");
+
+    const long long size = BenchUtil::writeAudioFile(
+        file.c_str(),
+        BenchUtil::createAudio(FRAMES, channels),
+        channels,
+        SF_FORMAT_FLAC | SF_FORMAT_PCM_16
+    );
+
+    const SamplesPerPixelScaleFactor scale_factor(256);
+
+    while (state.keepRunning()) {
+        WaveformBuffer buffer;
+
+        bool success = false;
+
+        if (threads > 1) {
+            ParallelWaveformGenerator processor(threads, false);
+            processor.addLevel(buffer, scale_factor);
+
+            success = processor.run(
+                [&](long long start_frame, long long end_frame) -> std::unique_ptr<AudioFileReader> {
+                    std::unique_ptr<SndFileAudioFileReader> reader(new SndFileAudioFileReader);
+
+                    if (!reader->open(file.c_str(), false) ||
+                        !reader->setFrameRange(start_frame, end_frame)) {
+                        return nullptr;
+                    }
+
+                    return std::unique_ptr<AudioFileReader>(reader.release());
+                },
+                BenchUtil::SAMPLE_RATE,
+                FRAMES
+            );
+        }
+        else {
+            SndFileAudioFileReader reader;
+
+            WaveformGenerator processor(buffer, false, scale_factor);
+
+            success = reader.open(file.c_str(), false) && reader.run(processor);
+        }
+
+        if (!success || buffer.getSize() == 0) {
+            throw std::runtime_error("Failed to generate waveform data");
+        }
+    }
+
+    state.setItemsPerIteration(FRAMES);
+    state.setBytesPerIteration(size);
+}
+
+//------------------------------------------------------------------------------
+
+static void WaveformGenerator_flac_threads_1(BenchmarkState& state)
+{
+    generateFromFlac(state, 1);
+}
+
+BENCHMARK(WaveformGenerator_flac_threads_1);
+
+//------------------------------------------------------------------------------
+
+static void WaveformGenerator_flac_threads_4(BenchmarkState& state)
+{
+    generateFromFlac(state, 4);
+}
+
+BENCHMARK(WaveformGenerator_flac_threads_4);
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,190 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "BenchUtil.h"
+#include "WaveformBuffer.h"
+
+#include <sndfile.h>
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+TempFile::TempFile(const char* extension) :
+    filename_(
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("audiowaveform_bench_%%%%-%%%%")
+    )
+{
+    filename_ += extension;
+}
+
+//------------------------------------------------------------------------------
+
+TempFile::~TempFile()
+{
+    boost::system::error_code error_code;
+    boost::filesystem::remove(filename_, error_code);
+}
+
+//------------------------------------------------------------------------------
+
+namespace BenchUtil {
+
+//------------------------------------------------------------------------------
+
+std::vector<short> createAudio(const int frames, const int channels)
+{
+    std::vector<short> samples(static_cast<size_t>(frames) * static_cast<size_t>(channels));
+
+    const double pi = 3.14159265358979323846;
+
+    uint32_t seed = 1;
+
+    size_t index = 0;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int channel = 0; channel < channels; ++channel) {
+            seed = seed * 1664525U + 1013904223U;
+
+            const double frequency = 220.0 * (channel + 1);
+
+            const double tone = 20000.0 * std::sin(
+                2.0 * pi * frequency * frame / SAMPLE_RATE
+            );
+
+            const int noise = static_cast<int>(seed >> 20) - 2048;
+
+            samples[index++] = static_cast<short>(static_cast<int>(tone) + noise);
+        }
+    }
+
+    return samples;
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<float> toFloat(const std::vector<short>& samples)
+{
+    std::vector<float> float_samples(samples.size());
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        float_samples[i] = static_cast<float>(samples[i]) / 32768.0f;
+    }
+
+    return float_samples;
+}
+
+//------------------------------------------------------------------------------
+
+void createWaveformData(
+    WaveformBuffer& buffer,
+    const int points,
+    const int channels,
+    const int samples_per_pixel)
+{
+    buffer.setSampleRate(SAMPLE_RATE);
+    buffer.setSamplesPerPixel(samples_per_pixel);
+    buffer.setChannels(channels);
+    buffer.setSize(points);
+
+    const double pi = 3.14159265358979323846;
+
+    uint32_t seed = 1;
+
+    for (int i = 0; i < points; ++i) {
+        for (int channel = 0; channel < channels; ++channel) {
+            seed = seed * 1664525U + 1013904223U;
+
+            // A slowly varying envelope, so that the waveform data doesn't
+            // compress unrealistically well
+            const double envelope = 0.5 + 0.5 * std::sin(
+                2.0 * pi * i / (1000.0 + 100.0 * channel)
+            );
+
+            const int noise = static_cast<int>(seed >> 22);
+
+            const int max = static_cast<int>(envelope * 30000.0) + noise;
+            const int min = -max + noise;
+
+            buffer.setSamples(
+                channel,
+                i,
+                static_cast<short>(min),
+                static_cast<short>(max)
+            );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+long long writeAudioFile(
+    const char* filename,
+    const std::vector<short>& samples,
+    const int channels,
+    const int format)
+{
+    SF_INFO info;
+
+    info.frames     = 0;
+    info.samplerate = SAMPLE_RATE;
+    info.channels   = channels;
+    info.format     = format;
+    info.sections   = 0;
+    info.seekable   = 0;
+
+    SNDFILE* file = sf_open(filename, SFM_WRITE, &info);
+
+    if (file == nullptr) {
+        throw std::runtime_error(
+            std::string("Failed to create audio file: ") + sf_strerror(nullptr)
+        );
+    }
+
+    const sf_count_t frames = static_cast<sf_count_t>(samples.size() / channels);
+
+    const sf_count_t written = sf_writef_short(file, samples.data(), frames);
+
+    sf_close(file);
+
+    if (written != frames) {
+        throw std::runtime_error("Failed to write audio file");
+    }
+
+    return getFileSize(filename);
+}
+
+//------------------------------------------------------------------------------
+
+long long getFileSize(const char* filename)
+{
+    return static_cast<long long>(boost::filesystem::file_size(filename));
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace BenchUtil
+
+//------------------------------------------------------------------------------
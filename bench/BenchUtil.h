@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_BENCH_UTIL_H)
+#define INC_BENCH_UTIL_H
+
+//------------------------------------------------------------------------------
+
+#include <boost/filesystem.hpp>
+
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+class WaveformBuffer;
+
+//------------------------------------------------------------------------------
+
+// Creates a temporary file, which is deleted when this object is destroyed.
+
+class TempFile
+{
+    public:
+        explicit TempFile(const char* extension);
+        ~TempFile();
+
+        TempFile(const TempFile&) = delete;
+        TempFile& operator=(const TempFile&) = delete;
+
+        const char* c_str() const { return filename_.c_str(); }
+
+    private:
+        boost::filesystem::path filename_;
+};
+
+//------------------------------------------------------------------------------
+
+// Synthetic inputs for the benchmarks. These use a fixed pseudo-random
+// sequence, so are the same in every run, and results can be compared between
+// releases.
+
+namespace BenchUtil {
+
+const int SAMPLE_RATE = 44100;
+
+// Returns interleaved 16-bit audio: a sine wave at a different frequency in
+// each channel, with added noise.
+std::vector<short> createAudio(int frames, int channels);
+
+// Converts 16-bit samples to floating point, in the range -1.0 to 1.0.
+std::vector<float> toFloat(const std::vector<short>& samples);
+
+// Fills the buffer with waveform data, as generated from createAudio().
+void createWaveformData(
+    WaveformBuffer& buffer,
+    int points,
+    int channels,
+    int samples_per_pixel
+);
+
+// Writes the audio using libsndfile, where format is a combination of
+// SF_FORMAT_* values. Returns the file size.
+long long writeAudioFile(
+    const char* filename,
+    const std::vector<short>& samples,
+    int channels,
+    int format
+);
+
+long long getFileSize(const char* filename);
+
+} // namespace BenchUtil
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_BENCH_UTIL_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,275 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "Config.h"
+#include "MinMaxKernels.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+BenchmarkState::BenchmarkState(const long long iterations) :
+    iterations_(iterations),
+    count_(0),
+    items_(0),
+    bytes_(0),
+    output_bytes_(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+double BenchmarkState::getElapsedSeconds() const
+{
+    return std::chrono::duration<double>(end_ - start_).count();
+}
+
+//------------------------------------------------------------------------------
+
+namespace Benchmark {
+
+//------------------------------------------------------------------------------
+
+typedef std::pair<std::string, Function> Registration;
+
+static std::vector<Registration>& getBenchmarks()
+{
+    static std::vector<Registration> benchmarks;
+    return benchmarks;
+}
+
+//------------------------------------------------------------------------------
+
+bool add(const std::string& name, Function function)
+{
+    getBenchmarks().push_back(Registration(name, function));
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+struct Result
+{
+    std::string name;
+    long long iterations;
+    double seconds_per_iteration;
+    double items_per_second;
+    double bytes_per_second;
+    long long output_bytes;
+};
+
+//------------------------------------------------------------------------------
+
+// Runs the benchmark with an increasing number of iterations, until it takes
+// at least min_time seconds.
+
+static Result runBenchmark(
+    const Registration& benchmark,
+    const double min_time)
+{
+    long long iterations = 1;
+
+    for (;;) {
+        BenchmarkState state(iterations);
+        benchmark.second(state);
+
+        const double elapsed = state.getElapsedSeconds();
+
+        if (elapsed >= min_time || iterations >= 1000000000LL) {
+            Result result;
+
+            result.name                  = benchmark.first;
+            result.iterations            = iterations;
+            result.seconds_per_iteration = elapsed / static_cast<double>(iterations);
+
+            const double iterations_per_second = elapsed > 0.0 ?
+                static_cast<double>(iterations) / elapsed : 0.0;
+
+            result.items_per_second =
+                static_cast<double>(state.getItemsPerIteration()) * iterations_per_second;
+
+            result.bytes_per_second =
+                static_cast<double>(state.getBytesPerIteration()) * iterations_per_second;
+
+            result.output_bytes = state.getOutputBytes();
+
+            return result;
+        }
+
+        // Aim for 1.5 times the minimum, but no more than 10 times as many
+        // iterations as the last run
+        double multiplier = elapsed > 0.0 ? min_time * 1.5 / elapsed : 10.0;
+
+        if (multiplier > 10.0) {
+            multiplier = 10.0;
+        }
+        else if (multiplier < 2.0) {
+            multiplier = 2.0;
+        }
+
+        iterations = static_cast<long long>(static_cast<double>(iterations) * multiplier);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static void writeText(std::ostream& stream, const std::vector<Result>& results)
+{
+    stream << std::left << std::setw(64) << "Benchmark"
+           << std::right << std::setw(12) << "Iterations"
+           << std::setw(16) << "Time (ns)"
+           << std::setw(16) << "Items/s"
+           << std::setw(16) << "MB/s"
+           << std::setw(16) << "Output bytes" << '\n';
+
+    for (const Result& result : results) {
+        stream << std::left << std::setw(64) << result.name
+               << std::right << std::setw(12) << result.iterations
+               << std::fixed << std::setprecision(0)
+               << std::setw(16) << result.seconds_per_iteration * 1e9
+               << std::setw(16) << result.items_per_second
+               << std::setprecision(1)
+               << std::setw(16) << result.bytes_per_second / 1e6;
+
+        if (result.output_bytes > 0) {
+            stream << std::setw(16) << result.output_bytes;
+        }
+
+        stream << '\n';
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Benchmark names only contain letters, digits, and '_', '/', ':' characters,
+// so don't need escaping. The context identifies the build and the CPU
+// features used, so that results from different releases can be compared.
+
+static void writeJson(
+    std::ostream& stream,
+    const std::vector<Result>& results,
+    const double min_time)
+{
+    stream << "{\"context\":{\"version\":\""
+           << VERSION_MAJOR << '.' << VERSION_MINOR << '.' << VERSION_PATCH << '"'
+           << ",\"min_max_kernels\":\"" << MinMaxKernels::getKernelSet().name << '"'
+           << ",\"min_time\":" << min_time << "},\n\"benchmarks\":[";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+
+        if (i > 0) {
+            stream << ',';
+        }
+
+        stream << "\n{\"name\":\"" << result.name << '"'
+               << ",\"iterations\":" << result.iterations
+               << std::fixed << std::setprecision(1)
+               << ",\"time_ns\":" << result.seconds_per_iteration * 1e9
+               << ",\"items_per_second\":" << result.items_per_second
+               << ",\"bytes_per_second\":" << result.bytes_per_second;
+
+        if (result.output_bytes > 0) {
+            stream << ",\"output_bytes\":" << result.output_bytes;
+        }
+
+        stream << '}';
+    }
+
+    stream << "\n]}\n";
+}
+
+//------------------------------------------------------------------------------
+
+static bool startsWith(const char* arg, const char* prefix)
+{
+    return strncmp(arg, prefix, strlen(prefix)) == 0;
+}
+
+//------------------------------------------------------------------------------
+
+int run(const int argc, const char* const* argv)
+{
+    std::string filter;
+    double min_time = 0.5;
+    bool json = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+
+        if (startsWith(arg, "--filter=")) {
+            filter = arg + strlen("--filter=");
+        }
+        else if (startsWith(arg, "--min-time=")) {
+            min_time = atof(arg + strlen("--min-time="));
+        }
+        else if (strcmp(arg, "--format=json") == 0) {
+            json = true;
+        }
+        else if (strcmp(arg, "--format=text") == 0) {
+            json = false;
+        }
+        else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter=<substring>] [--min-time=<seconds>]"
+                      << " [--format=text|json]\n";
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+
+    for (const Registration& benchmark : getBenchmarks()) {
+        if (!filter.empty() && benchmark.first.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        try {
+            results.push_back(runBenchmark(benchmark, min_time));
+        }
+        catch (const std::exception& e) {
+            std::cerr << benchmark.first << ": " << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    if (json) {
+        writeJson(std::cout, results, min_time);
+    }
+    else {
+        writeText(std::cout, results);
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace Benchmark
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_BENCHMARK_H)
+#define INC_BENCHMARK_H
+
+//------------------------------------------------------------------------------
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+// Passed to each benchmark function, which should run the code being measured
+// in a loop while keepRunning() returns true. Only the time spent in the loop
+// is measured, so any setup should be done before the loop.
+
+class BenchmarkState
+{
+    public:
+        explicit BenchmarkState(long long iterations);
+
+    public:
+        bool keepRunning()
+        {
+            if (count_ == 0) {
+                start_ = std::chrono::steady_clock::now();
+            }
+
+            if (count_ == iterations_) {
+                end_ = std::chrono::steady_clock::now();
+                return false;
+            }
+
+            ++count_;
+            return true;
+        }
+
+        // The number of items, e.g., audio frames or waveform points, or
+        // bytes processed in each iteration, to report throughput
+        void setItemsPerIteration(long long items) { items_ = items; }
+        void setBytesPerIteration(long long bytes) { bytes_ = bytes; }
+
+        // The size of the output of each iteration, e.g., an encoded image,
+        // to compare the output of different encoder options
+        void setOutputBytes(long long bytes) { output_bytes_ = bytes; }
+
+        long long getIterations() const { return iterations_; }
+        long long getItemsPerIteration() const { return items_; }
+        long long getBytesPerIteration() const { return bytes_; }
+        long long getOutputBytes() const { return output_bytes_; }
+
+        double getElapsedSeconds() const;
+
+    private:
+        long long iterations_;
+        long long count_;
+        long long items_;
+        long long bytes_;
+        long long output_bytes_;
+
+        std::chrono::steady_clock::time_point start_;
+        std::chrono::steady_clock::time_point end_;
+};
+
+//------------------------------------------------------------------------------
+
+namespace Benchmark {
+
+typedef std::function<void(BenchmarkState&)> Function;
+
+// Registers a benchmark. Returns true, so this can be used to initialize
+// a static variable, see BENCHMARK().
+bool add(const std::string& name, Function function);
+
+// Runs the registered benchmarks, and writes the results to standard output.
+// Returns the process exit code.
+int run(int argc, const char* const* argv);
+
+} // namespace Benchmark
+
+//------------------------------------------------------------------------------
+
+#define BENCHMARK(function) \
+    static const bool function##_registered = Benchmark::add(#function, function)
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_BENCHMARK_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "BenchUtil.h"
+#include "GdImageRenderer.h"
+#include "WaveformBuffer.h"
+#include "WaveformColors.h"
+
+#include <stdexcept>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+enum class Style {
+    Normal,
+    Bars,
+    RoundedBars
+};
+
+static const char* toString(const Style style)
+{
+    return style == Style::Normal ? "normal" :
+           style == Style::Bars   ? "bars" : "rounded";
+}
+
+//------------------------------------------------------------------------------
+
+static void configure(GdImageRenderer& renderer, const Style style)
+{
+    if (style != Style::Normal) {
+        renderer.setBarStyle(8, 4, style == Style::RoundedBars);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Draws one image from waveform data with one point per pixel.
+
+static void create(
+    BenchmarkState& state,
+    const int channels,
+    const int image_width,
+    const int image_height,
+    const Style style)
+{
+    WaveformBuffer buffer;
+    BenchUtil::createWaveformData(buffer, image_width, channels, 256);
+
+    while (state.keepRunning()) {
+        GdImageRenderer renderer;
+        configure(renderer, style);
+
+        if (!renderer.create(buffer, image_width, image_height, audacity_waveform_colors)) {
+            throw std::runtime_error("Failed to create image");
+        }
+    }
+
+    state.setItemsPerIteration(static_cast<long long>(image_width) * image_height);
+}
+
+//------------------------------------------------------------------------------
+
+static const char* toString(const PngFilter filter)
+{
+    switch (filter) {
+        case PngFilter::None:    return "none";
+        case PngFilter::Sub:     return "sub";
+        case PngFilter::Up:      return "up";
+        case PngFilter::Average: return "average";
+        case PngFilter::Paeth:   return "paeth";
+        case PngFilter::All:     return "all";
+        default:                 return "default";
+    }
+}
+
+static const char* toString(const PngStrategy strategy)
+{
+    switch (strategy) {
+        case PngStrategy::Filtered:    return "filtered";
+        case PngStrategy::HuffmanOnly: return "huffman";
+        case PngStrategy::Rle:         return "rle";
+        case PngStrategy::Fixed:       return "fixed";
+        default:                       return "default";
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Encodes one image, and reports the file size, to compare indexed color and
+// truecolor images, and the PNG encoding options.
+
+static void saveAsPng(
+    BenchmarkState& state,
+    const int image_width,
+    const int image_height,
+    const PngOptions& options)
+{
+    WaveformBuffer buffer;
+    BenchUtil::createWaveformData(buffer, image_width, 2, 256);
+
+    GdImageRenderer renderer;
+
+    if (!renderer.create(buffer, image_width, image_height, audacity_waveform_colors)) {
+        throw std::runtime_error("Failed to create image");
+    }
+
+    TempFile file(".png");
+
+    while (state.keepRunning()) {
+        if (!renderer.saveAsPng(file.c_str(), options)) {
+            throw std::runtime_error("Failed to save image");
+        }
+    }
+
+    state.setItemsPerIteration(static_cast<long long>(image_width) * image_height);
+    state.setBytesPerIteration(BenchUtil::getFileSize(file.c_str()));
+    state.setOutputBytes(BenchUtil::getFileSize(file.c_str()));
+}
+
+//------------------------------------------------------------------------------
+
+static bool registerBenchmarks()
+{
+    struct Size {
+        int width;
+        int height;
+    };
+
+    const Size sizes[] = { { 1000, 200 }, { 4000, 400 }, { 16000, 256 } };
+
+    for (const Size& size : sizes) {
+        const std::string size_name =
+            std::to_string(size.width) + "x" + std::to_string(size.height);
+
+        for (const int channels : { 1, 2 }) {
+            for (const Style style : { Style::Normal, Style::Bars, Style::RoundedBars }) {
+                const std::string name =
+                    "GdImageRenderer_create/" + size_name +
+                    "/channels:" + std::to_string(channels) +
+                    "/" + toString(style);
+
+                Benchmark::add(name, [=](BenchmarkState& state) {
+                    create(state, channels, size.width, size.height, style);
+                });
+            }
+        }
+
+        for (const bool palette : { true, false }) {
+            const std::string png_name =
+                "GdImageRenderer_saveAsPng/" + size_name +
+                (palette ? "/palette" : "/truecolor");
+
+            PngOptions options;
+            options.palette = palette;
+
+            // The default compression level, and the fastest
+            for (const int compression_level : { -1, 1 }) {
+                const std::string name =
+                    png_name + "/compression:" + std::to_string(compression_level);
+
+                options.compression_level = compression_level;
+
+                Benchmark::add(name, [=](BenchmarkState& state) {
+                    saveAsPng(state, size.width, size.height, options);
+                });
+            }
+
+            options.compression_level = -1;
+
+            for (const PngFilter filter : { PngFilter::None, PngFilter::Up, PngFilter::All }) {
+                const std::string name =
+                    png_name + "/filter:" + toString(filter);
+
+                options.filter = filter;
+
+                Benchmark::add(name, [=](BenchmarkState& state) {
+                    saveAsPng(state, size.width, size.height, options);
+                });
+            }
+
+            options.filter = PngFilter::Default;
+
+            for (const PngStrategy strategy : { PngStrategy::HuffmanOnly, PngStrategy::Rle }) {
+                const std::string name =
+                    png_name + "/strategy:" + toString(strategy);
+
+                options.strategy = strategy;
+
+                Benchmark::add(name, [=](BenchmarkState& state) {
+                    saveAsPng(state, size.width, size.height, options);
+                });
+            }
+        }
+    }
+
+    return true;
+}
+
+static const bool registered = registerBenchmarks();
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include <ostream>
+
+//------------------------------------------------------------------------------
+
+// Benchmarks check for errors themselves, so discard any log messages.
+
+static std::ostream null_stream(nullptr);
+
+std::ostream& output_stream = null_stream;
+std::ostream& error_stream  = null_stream;
+
+//------------------------------------------------------------------------------
+
+int main(int argc, const char* const* argv)
+{
+    return Benchmark::run(argc, argv);
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "BenchUtil.h"
+#include "MinMaxKernels.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// Runs the kernel over 10 seconds of audio, in runs of samples_per_pixel
+// frames, as WaveformGenerator does.
+
+static void runKernel(
+    BenchmarkState& state,
+    const MinMaxKernels::KernelSet& kernel_set,
+    const int channels,
+    const bool split_channels,
+    const int samples_per_pixel)
+{
+    const int frames = BenchUtil::SAMPLE_RATE * 10;
+
+    const std::vector<short> samples = BenchUtil::createAudio(frames, channels);
+
+    const MinMaxKernels::Kernel kernel = MinMaxKernels::selectKernel(
+        kernel_set,
+        channels,
+        split_channels
+    );
+
+    const int output_channels = split_channels ? channels : 1;
+
+    std::vector<int> min(static_cast<size_t>(output_channels));
+    std::vector<int> max(static_cast<size_t>(output_channels));
+
+    long long total = 0;
+
+    while (state.keepRunning()) {
+        for (int frame = 0; frame < frames; frame += samples_per_pixel) {
+            for (int channel = 0; channel < output_channels; ++channel) {
+                min[static_cast<size_t>(channel)] = std::numeric_limits<int>::max();
+                max[static_cast<size_t>(channel)] = std::numeric_limits<int>::min();
+            }
+
+            const int run_frames = frames - frame < samples_per_pixel ?
+                frames - frame : samples_per_pixel;
+
+            kernel(
+                &samples[static_cast<size_t>(frame) * static_cast<size_t>(channels)],
+                run_frames,
+                channels,
+                min.data(),
+                max.data()
+            );
+
+            total += max[0] - min[0];
+        }
+    }
+
+    // Stop the compiler removing the loop
+    if (total < 0) {
+        throw std::runtime_error("Invalid minimum and maximum values");
+    }
+
+    state.setItemsPerIteration(frames);
+    state.setBytesPerIteration(static_cast<long long>(samples.size() * sizeof(short)));
+}
+
+//------------------------------------------------------------------------------
+
+// Registers each supported kernel set, for mono, stereo, and 5.1 audio.
+
+static bool registerBenchmarks()
+{
+    const std::vector<const MinMaxKernels::KernelSet*> kernel_sets =
+        MinMaxKernels::getSupportedKernelSets();
+
+    for (const MinMaxKernels::KernelSet* kernel_set : kernel_sets) {
+        for (const int channels : { 1, 2, 6 }) {
+            for (const bool split_channels : { false, true }) {
+                if (channels == 1 && split_channels) {
+                    continue;
+                }
+
+                const std::string name =
+                    std::string("MinMaxKernels_minMax/") + kernel_set->name +
+                    "/channels:" + std::to_string(channels) +
+                    (split_channels ? "/split" : "/mix");
+
+                Benchmark::add(
+                    name,
+                    [=](BenchmarkState& state) {
+                        runKernel(state, *kernel_set, channels, split_channels, 256);
+                    }
+                );
+            }
+        }
+    }
+
+    return true;
+}
+
+static const bool registered = registerBenchmarks();
+
+//------------------------------------------------------------------------------
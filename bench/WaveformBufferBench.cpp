@@ -0,0 +1,290 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "BenchUtil.h"
+#include "WaveformBuffer.h"
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+// Writes a JSON waveform data file with pseudo-random values, which are the
+// same in every run. If generic is true, the first value is written as 0.0,
+// so that the data array is read by pdjson instead of WaveformBuffer's own
+// integer parser. Returns the file size.
+
+static long long writeJsonFile(
+    const char* filename,
+    const int points,
+    const int channels,
+    const int bits,
+    const bool generic)
+{
+    std::ofstream stream(filename, std::ios::out | std::ios::binary);
+
+    stream << "{\"version\":2,\"channels\":" << channels
+           << ",\"sample_rate\":44100,\"samples_per_pixel\":256"
+           << ",\"bits\":" << bits
+           << ",\"length\":" << points
+           << ",\"data\":[";
+
+    const int range = bits == 8 ? 128 : 32768;
+
+    uint32_t seed = 1;
+
+    const long long values = static_cast<long long>(points) * channels * 2;
+
+    for (long long i = 0; i < values; ++i) {
+        seed = seed * 1664525U + 1013904223U;
+
+        const int value = static_cast<int>(seed >> 16) % range;
+
+        if (i > 0) {
+            stream << ',';
+        }
+
+        if (i == 0 && generic) {
+            stream << "0.0";
+        }
+        else {
+            stream << (i % 2 == 0 ? -value : value);
+        }
+    }
+
+    stream << "]}";
+
+    return static_cast<long long>(stream.tellp());
+}
+
+//------------------------------------------------------------------------------
+
+static void loadJson(BenchmarkState& state, const int bits, const bool generic)
+{
+    const int points   = 500000;
+    const int channels = 2;
+
+    TempFile file(".json");
+
+    const long long size = writeJsonFile(file.c_str(), points, channels, bits, generic);
+
+    while (state.keepRunning()) {
+        WaveformBuffer buffer;
+
+        if (!buffer.loadJson(file.c_str()) || buffer.getSize() != points) {
+            throw std::runtime_error("Failed to load JSON file");
+        }
+    }
+
+    state.setItemsPerIteration(points);
+    state.setBytesPerIteration(size);
+}
+
+//------------------------------------------------------------------------------
+
+static void WaveformBuffer_loadJson_8bit(BenchmarkState& state)
+{
+    loadJson(state, 8, false);
+}
+
+BENCHMARK(WaveformBuffer_loadJson_8bit);
+
+//------------------------------------------------------------------------------
+
+static void WaveformBuffer_loadJson_16bit(BenchmarkState& state)
+{
+    loadJson(state, 16, false);
+}
+
+BENCHMARK(WaveformBuffer_loadJson_16bit);
+
+//------------------------------------------------------------------------------
+
+// As above, but the data array is read by pdjson, for comparison.
+
+static void WaveformBuffer_loadJson_8bit_generic(BenchmarkState& state)
+{
+    loadJson(state, 8, true);
+}
+
+BENCHMARK(WaveformBuffer_loadJson_8bit_generic);
+
+//------------------------------------------------------------------------------
+
+static void WaveformBuffer_loadJson_16bit_generic(BenchmarkState& state)
+{
+    loadJson(state, 16, true);
+}
+
+BENCHMARK(WaveformBuffer_loadJson_16bit_generic);
+
+//------------------------------------------------------------------------------
+
+// One hour of stereo audio at 256 samples per pixel
+static const int POINTS = BenchUtil::SAMPLE_RATE * 3600 / 256;
+
+static const int CHANNELS = 2;
+
+//------------------------------------------------------------------------------
+
+enum class Format {
+    Dat,
+    Json,
+    Text
+};
+
+static const char* getExtension(const Format format)
+{
+    return format == Format::Dat  ? ".dat" :
+           format == Format::Json ? ".json" : ".txt";
+}
+
+//------------------------------------------------------------------------------
+
+static bool save(
+    const WaveformBuffer& buffer,
+    const char* filename,
+    const Format format,
+    const int bits,
+    const int version,
+    const int block_size)
+{
+    return format == Format::Dat  ? buffer.save(filename, bits, version, block_size) :
+           format == Format::Json ? buffer.saveAsJson(filename, bits) :
+                                    buffer.saveAsText(filename, bits);
+}
+
+//------------------------------------------------------------------------------
+
+static void saveFile(
+    BenchmarkState& state,
+    const Format format,
+    const int bits,
+    const int version,
+    const int block_size)
+{
+    WaveformBuffer buffer;
+    BenchUtil::createWaveformData(buffer, POINTS, CHANNELS, 256);
+
+    TempFile file(getExtension(format));
+
+    while (state.keepRunning()) {
+        if (!save(buffer, file.c_str(), format, bits, version, block_size)) {
+            throw std::runtime_error("Failed to save waveform data");
+        }
+    }
+
+    state.setItemsPerIteration(POINTS);
+    state.setBytesPerIteration(BenchUtil::getFileSize(file.c_str()));
+}
+
+//------------------------------------------------------------------------------
+
+// Loads all the points, or only the first 2000 if partial is true, as when
+// rendering an image of part of the audio.
+
+static void loadDatFile(
+    BenchmarkState& state,
+    const int bits,
+    const int version,
+    const int block_size,
+    const bool partial)
+{
+    TempFile file(".dat");
+
+    {
+        WaveformBuffer buffer;
+        BenchUtil::createWaveformData(buffer, POINTS, CHANNELS, 256);
+
+        if (!buffer.save(file.c_str(), bits, version, block_size)) {
+            throw std::runtime_error("Failed to save waveform data");
+        }
+    }
+
+    const int start_index = partial ? POINTS / 2 : 0;
+    const int end_index   = partial ? start_index + 2000 : POINTS;
+
+    while (state.keepRunning()) {
+        WaveformBuffer buffer;
+
+        if (!buffer.load(file.c_str(), start_index, end_index) ||
+            buffer.getSize() != end_index - start_index) {
+            throw std::runtime_error("Failed to load waveform data");
+        }
+    }
+
+    state.setItemsPerIteration(end_index - start_index);
+    state.setBytesPerIteration(BenchUtil::getFileSize(file.c_str()));
+}
+
+//------------------------------------------------------------------------------
+
+static bool registerBenchmarks()
+{
+    for (const int bits : { 8, 16 }) {
+        const std::string bits_name = "/bits:" + std::to_string(bits);
+
+        Benchmark::add("WaveformBuffer_save/v2" + bits_name, [=](BenchmarkState& state) {
+            saveFile(state, Format::Dat, bits, 2, 0);
+        });
+
+        Benchmark::add("WaveformBuffer_save/v3" + bits_name, [=](BenchmarkState& state) {
+            saveFile(state, Format::Dat, bits, 3, 0);
+        });
+
+        Benchmark::add("WaveformBuffer_save/v2/indexed" + bits_name, [=](BenchmarkState& state) {
+            saveFile(state, Format::Dat, bits, 2, 4096);
+        });
+
+        Benchmark::add("WaveformBuffer_saveAsJson" + bits_name, [=](BenchmarkState& state) {
+            saveFile(state, Format::Json, bits, 0, 0);
+        });
+
+        Benchmark::add("WaveformBuffer_saveAsText" + bits_name, [=](BenchmarkState& state) {
+            saveFile(state, Format::Text, bits, 0, 0);
+        });
+
+        Benchmark::add("WaveformBuffer_load/v2" + bits_name, [=](BenchmarkState& state) {
+            loadDatFile(state, bits, 2, 0, false);
+        });
+
+        Benchmark::add("WaveformBuffer_load/v3" + bits_name, [=](BenchmarkState& state) {
+            loadDatFile(state, bits, 3, 0, false);
+        });
+
+        Benchmark::add("WaveformBuffer_load/v2/partial" + bits_name, [=](BenchmarkState& state) {
+            loadDatFile(state, bits, 2, 0, true);
+        });
+
+        Benchmark::add("WaveformBuffer_load/v2/indexed/partial" + bits_name, [=](BenchmarkState& state) {
+            loadDatFile(state, bits, 2, 4096, true);
+        });
+    }
+
+    return true;
+}
+
+static const bool registered = registerBenchmarks();
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,185 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "BenchUtil.h"
+#include "MultiLevelWaveformGenerator.h"
+#include "WaveformBuffer.h"
+#include "WaveformGenerator.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// The number of samples passed to each call to process(), as by the audio
+// file readers.
+
+static const int BUFFER_SIZE = 16384;
+
+// One minute of audio
+static const int FRAMES = BenchUtil::SAMPLE_RATE * 60;
+
+//------------------------------------------------------------------------------
+
+// Passes the audio to the processor, as floating point samples if
+// float_samples is not null.
+
+static void runProcessor(
+    AudioProcessor& processor,
+    const std::vector<short>& samples,
+    const std::vector<float>* float_samples,
+    const int channels)
+{
+    if (!processor.init(BenchUtil::SAMPLE_RATE, channels, FRAMES, BUFFER_SIZE)) {
+        throw std::runtime_error("Failed to initialize processor");
+    }
+
+    const int max_frames = BUFFER_SIZE / channels;
+
+    for (int frame = 0; frame < FRAMES; frame += max_frames) {
+        const int frames = FRAMES - frame < max_frames ? FRAMES - frame : max_frames;
+
+        const size_t offset = static_cast<size_t>(frame) * static_cast<size_t>(channels);
+
+        const bool success = float_samples != nullptr ?
+            processor.processFloat(&(*float_samples)[offset], frames) :
+            processor.process(&samples[offset], frames);
+
+        if (!success) {
+            throw std::runtime_error("Failed to process audio");
+        }
+    }
+
+    processor.done();
+}
+
+//------------------------------------------------------------------------------
+
+static void generate(
+    BenchmarkState& state,
+    const int channels,
+    const int samples_per_pixel,
+    const bool split_channels,
+    const bool use_float)
+{
+    const std::vector<short> samples = BenchUtil::createAudio(FRAMES, channels);
+
+    const std::vector<float> float_samples = use_float ?
+        BenchUtil::toFloat(samples) :
+        std::vector<float>();
+
+    const SamplesPerPixelScaleFactor scale_factor(samples_per_pixel);
+
+    while (state.keepRunning()) {
+        WaveformBuffer buffer;
+        WaveformGenerator processor(buffer, split_channels, scale_factor);
+
+        runProcessor(processor, samples, use_float ? &float_samples : nullptr, channels);
+
+        if (buffer.getSize() == 0) {
+            throw std::runtime_error("No waveform data generated");
+        }
+    }
+
+    state.setItemsPerIteration(FRAMES);
+    state.setBytesPerIteration(
+        static_cast<long long>(samples.size()) *
+        static_cast<long long>(use_float ? sizeof(float) : sizeof(short))
+    );
+}
+
+//------------------------------------------------------------------------------
+
+// Generates the zoom levels 64, 128, ... 4096 from a single pass over the
+// audio, as with '-z 64,128,256,512,1024,2048,4096'.
+
+static void WaveformGenerator_multiLevel(BenchmarkState& state)
+{
+    const int channels = 2;
+
+    const std::vector<short> samples = BenchUtil::createAudio(FRAMES, channels);
+
+    std::vector<std::unique_ptr<SamplesPerPixelScaleFactor>> scale_factors;
+
+    for (int samples_per_pixel = 64; samples_per_pixel <= 4096; samples_per_pixel *= 2) {
+        scale_factors.emplace_back(new SamplesPerPixelScaleFactor(samples_per_pixel));
+    }
+
+    while (state.keepRunning()) {
+        std::vector<std::unique_ptr<WaveformBuffer>> buffers;
+
+        MultiLevelWaveformGenerator processor(false);
+
+        for (const auto& scale_factor : scale_factors) {
+            buffers.emplace_back(new WaveformBuffer);
+            processor.addLevel(*buffers.back(), *scale_factor);
+        }
+
+        runProcessor(processor, samples, nullptr, channels);
+    }
+
+    state.setItemsPerIteration(FRAMES);
+    state.setBytesPerIteration(static_cast<long long>(samples.size() * sizeof(short)));
+}
+
+BENCHMARK(WaveformGenerator_multiLevel);
+
+//------------------------------------------------------------------------------
+
+static bool registerBenchmarks()
+{
+    for (const int channels : { 1, 2, 6 }) {
+        for (const int samples_per_pixel : { 64, 256, 4096 }) {
+            const std::string name =
+                "WaveformGenerator_process/channels:" + std::to_string(channels) +
+                "/zoom:" + std::to_string(samples_per_pixel);
+
+            Benchmark::add(name, [=](BenchmarkState& state) {
+                generate(state, channels, samples_per_pixel, false, false);
+            });
+        }
+
+        if (channels > 1) {
+            Benchmark::add(
+                "WaveformGenerator_process/channels:" + std::to_string(channels) + "/zoom:256/split",
+                [=](BenchmarkState& state) {
+                    generate(state, channels, 256, true, false);
+                }
+            );
+        }
+
+        Benchmark::add(
+            "WaveformGenerator_process/channels:" + std::to_string(channels) + "/zoom:256/float",
+            [=](BenchmarkState& state) {
+                generate(state, channels, 256, false, true);
+            }
+        );
+    }
+
+    return true;
+}
+
+static const bool registered = registerBenchmarks();
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "BenchUtil.h"
+#include "WaveformBuffer.h"
+#include "WaveformRescaler.h"
+
+#include <stdexcept>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+// Rescales one hour of waveform data at 256 samples per pixel.
+
+static void rescale(
+    BenchmarkState& state,
+    const int channels,
+    const int samples_per_pixel,
+    const int threads)
+{
+    const int input_samples_per_pixel = 256;
+
+    const int points = BenchUtil::SAMPLE_RATE * 3600 / input_samples_per_pixel;
+
+    WaveformBuffer input_buffer;
+
+    BenchUtil::createWaveformData(
+        input_buffer,
+        points,
+        channels,
+        input_samples_per_pixel
+    );
+
+    WaveformRescaler rescaler(threads);
+
+    while (state.keepRunning()) {
+        WaveformBuffer output_buffer;
+
+        rescaler.rescale(input_buffer, output_buffer, samples_per_pixel);
+
+        if (output_buffer.getSize() == 0) {
+            throw std::runtime_error("No waveform data generated");
+        }
+    }
+
+    state.setItemsPerIteration(points);
+    state.setBytesPerIteration(
+        static_cast<long long>(points) * channels * 2 * static_cast<long long>(sizeof(short))
+    );
+}
+
+//------------------------------------------------------------------------------
+
+static bool registerBenchmarks()
+{
+    for (const int channels : { 1, 2 }) {
+        // 300 isn't a multiple of 256, so output points don't start on input
+        // point boundaries
+        for (const int samples_per_pixel : { 300, 512, 4096, 65536 }) {
+            for (const int threads : { 1, 4 }) {
+                const std::string name =
+                    "WaveformRescaler_rescale/channels:" + std::to_string(channels) +
+                    "/zoom:" + std::to_string(samples_per_pixel) +
+                    "/threads:" + std::to_string(threads);
+
+                Benchmark::add(name, [=](BenchmarkState& state) {
+                    rescale(state, channels, samples_per_pixel, threads);
+                });
+            }
+        }
+    }
+
+    return true;
+}
+
+static const bool registered = registerBenchmarks();
+
+//------------------------------------------------------------------------------
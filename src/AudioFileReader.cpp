@@ -22,6 +22,9 @@
 //------------------------------------------------------------------------------
 
 #include "AudioFileReader.h"
+#include "Log.h"
+
+#include <ostream>
 
 //------------------------------------------------------------------------------
 
@@ -36,3 +39,20 @@ AudioFileReader::~AudioFileReader()
 }
 
 //------------------------------------------------------------------------------
+
+int AudioFileReader::getSampleRate() const
+{
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+bool AudioFileReader::setFrameRange(
+    long long /* start_frame */,
+    long long /* end_frame */)
+{
+    log(Error) << "Reading part of the input is not supported\n";
+    return false;
+}
+
+//------------------------------------------------------------------------------
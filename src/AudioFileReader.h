@@ -40,6 +40,15 @@ class AudioFileReader
         virtual bool open(const char* input_filename, bool show_info = true) = 0;
 
         virtual bool run(AudioProcessor& processor) = 0;
+
+        // Returns the sample rate of the open input, or 0 if this isn't known
+        // until run() is called.
+        virtual int getSampleRate() const;
+
+        // Restricts run() to frames from start_frame up to, but not
+        // including, end_frame, or to the end of the input if end_frame is
+        // negative. Returns false if the reader doesn't support this.
+        virtual bool setFrameRange(long long start_frame, long long end_frame);
 };
 
 //------------------------------------------------------------------------------
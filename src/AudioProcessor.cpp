@@ -30,3 +30,19 @@ AudioProcessor::~AudioProcessor()
 }
 
 //------------------------------------------------------------------------------
+
+bool AudioProcessor::supportsFloat() const
+{
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+bool AudioProcessor::processFloat(
+    const float* /* input_buffer */,
+    int /* input_frame_count */)
+{
+    return false;
+}
+
+//------------------------------------------------------------------------------
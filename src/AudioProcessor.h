@@ -45,6 +45,17 @@ class AudioProcessor
             int input_frame_count
         ) = 0;
 
+        // Processors that can use floating point samples directly override
+        // these. Otherwise, readers of floating point audio convert the
+        // samples to 16-bit and call process().
+        virtual bool supportsFloat() const;
+
+        // Samples are in the range -1.0 to 1.0.
+        virtual bool processFloat(
+            const float* input_buffer,
+            int input_frame_count
+        );
+
         virtual void done() = 0;
 };
 
@@ -28,7 +28,8 @@
 
 //------------------------------------------------------------------------------
 
-BStdFile::BStdFile(FILE* file)
+BStdFile::BStdFile(FILE* file) :
+    fp_(file)
 {
     file_ = NewBstdFile(file);
 
@@ -62,3 +63,23 @@ size_t BStdFile::read(void* buffer, size_t size, size_t count) const
 }
 
 //------------------------------------------------------------------------------
+
+bool BStdFile::seek(long offset)
+{
+    if (fseek(fp_, offset, SEEK_SET) != 0) {
+        return false;
+    }
+
+    bstdfile_t* file = NewBstdFile(fp_);
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    BstdFileDestroy(file_);
+    file_ = file;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
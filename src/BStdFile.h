@@ -49,7 +49,11 @@ class BStdFile
 
         size_t read(void* buffer, size_t size, size_t count) const;
 
+        // Discards any buffered input, and moves to the given file position.
+        bool seek(long offset);
+
     private:
+        FILE* fp_;
         bstdfile_t* file_;
 };
 
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "BatchRunner.h"
+#include "JobUtil.h"
+
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+BatchRunner::BatchRunner(const int jobs, JobHandler handler) :
+    jobs_(jobs < 1 ? 1 : jobs),
+    handler_(std::move(handler)),
+    manifest_(nullptr),
+    output_(nullptr),
+    line_number_(0),
+    job_count_(0),
+    failed_count_(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+bool BatchRunner::run(std::istream& manifest, std::ostream& output)
+{
+    manifest_ = &manifest;
+    output_   = &output;
+
+    line_number_  = 0;
+    job_count_    = 0;
+    failed_count_ = 0;
+
+    if (jobs_ == 1) {
+        runJobs();
+    }
+    else {
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < jobs_; ++i) {
+            threads.emplace_back(&BatchRunner::runJobs, this);
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    output.flush();
+
+    return failed_count_ == 0;
+}
+
+//------------------------------------------------------------------------------
+
+void BatchRunner::runJobs()
+{
+    std::string line;
+    int line_number;
+
+    while (readJob(line, line_number)) {
+        runJob(line, line_number);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Reads the next job from the manifest, skipping blank lines and comments.
+// Returns false at the end of the manifest.
+
+bool BatchRunner::readJob(std::string& line, int& line_number)
+{
+    std::lock_guard<std::mutex> lock(input_mutex_);
+
+    while (std::getline(*manifest_, line)) {
+        line_number = ++line_number_;
+
+        const size_t pos = line.find_first_not_of(" \t\r");
+
+        if (pos != std::string::npos && line[pos] != '#') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+bool BatchRunner::runJob(const std::string& line, const int line_number)
+{
+    const JobUtil::Result result = JobUtil::runJob(line, handler_);
+
+    std::ostringstream status;
+
+    status << "{\"line\":" << line_number << ',';
+    JobUtil::writeResult(status, result);
+    status << "}\n";
+
+    std::lock_guard<std::mutex> lock(output_mutex_);
+
+    *output_ << status.str();
+    output_->flush();
+
+    ++job_count_;
+
+    if (!result.success) {
+        ++failed_count_;
+    }
+
+    return result.success;
+}
+
+//------------------------------------------------------------------------------
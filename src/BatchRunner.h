@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_BATCH_RUNNER_H)
+#define INC_BATCH_RUNNER_H
+
+//------------------------------------------------------------------------------
+
+#include "JobUtil.h"
+
+#include <iosfwd>
+#include <mutex>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+// Runs the jobs listed in a manifest, one per line, on a pool of threads.
+//
+// Each line contains the command line options for one job, e.g.,
+// "-i input.mp3 -o output.dat -b 8". Filenames containing spaces can be
+// quoted. Blank lines and lines starting with '#' are ignored.
+//
+// The result of each job is written to the output stream as a line of JSON,
+// in the order the jobs finish. A failing job doesn't stop the other jobs.
+
+class BatchRunner
+{
+    public:
+        typedef JobUtil::Handler JobHandler;
+
+    public:
+        BatchRunner(int jobs, JobHandler handler);
+
+        BatchRunner(const BatchRunner&) = delete;
+        BatchRunner& operator=(const BatchRunner&) = delete;
+
+    public:
+        // Returns true if all jobs succeeded.
+        bool run(std::istream& manifest, std::ostream& output);
+
+        int getJobCount() const { return job_count_; }
+        int getFailedCount() const { return failed_count_; }
+
+    private:
+        void runJobs();
+        bool readJob(std::string& line, int& line_number);
+        bool runJob(const std::string& line, int line_number);
+
+    private:
+        int jobs_;
+        JobHandler handler_;
+
+        std::istream* manifest_;
+        std::ostream* output_;
+
+        int line_number_;
+        int job_count_;
+        int failed_count_;
+
+        std::mutex input_mutex_;
+        std::mutex output_mutex_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_BATCH_RUNNER_H)
+
+//------------------------------------------------------------------------------
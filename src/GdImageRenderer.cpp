@@ -25,15 +25,18 @@
 #include "Array.h"
 #include "Error.h"
 #include "FileUtil.h"
+#include "JobStats.h"
 #include "Log.h"
 #include "MathUtil.h"
 #include "TimeUtil.h"
+#include "Trace.h"
 #include "WaveformBuffer.h"
 #include "WaveformColors.h"
 #include "WaveformUtil.h"
 
 #include <gdfonts.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
@@ -44,14 +47,23 @@
 
 //------------------------------------------------------------------------------
 
+// The maximum number of pixels in each strip drawn by renderAsPng(), unless
+// set with setStripHeight(): 16 MB.
+
+const int MAX_STRIP_PIXELS = 4 * 1024 * 1024;
+
+//------------------------------------------------------------------------------
+
 GdImageRenderer::GdImageRenderer() :
     image_(nullptr),
     image_width_(0),
     image_height_(0),
     start_time_(0.0),
+    start_point_index_(-1),
     sample_rate_(0),
     samples_per_pixel_(0),
     start_index_(0),
+    buffer_start_index_(0),
     border_color_(0),
     background_color_(0),
     axis_label_color_(0),
@@ -60,8 +72,11 @@ GdImageRenderer::GdImageRenderer() :
     bar_gap_(4),
     bar_style_rounded_(false),
     render_axis_labels_(true),
+    save_alpha_(false),
     auto_amplitude_scale_(false),
-    amplitude_scale_(1.0)
+    amplitude_scale_(1.0),
+    waveform_amplitude_scale_(1.0),
+    strip_height_(0)
 {
 }
 
@@ -91,6 +106,20 @@ bool GdImageRenderer::setStartTime(double start_time)
 
 //------------------------------------------------------------------------------
 
+void GdImageRenderer::setStartIndex(int start_index)
+{
+    start_point_index_ = start_index;
+}
+
+//------------------------------------------------------------------------------
+
+void GdImageRenderer::setBufferStartIndex(int buffer_start_index)
+{
+    buffer_start_index_ = buffer_start_index;
+}
+
+//------------------------------------------------------------------------------
+
 bool GdImageRenderer::setBarStyle(
     int bar_width,
     int bar_gap,
@@ -139,6 +168,36 @@ bool GdImageRenderer::create(
     const int image_width,
     const int image_height,
     const WaveformColors& colors)
+{
+    StageTimer timer(JobStats::Render);
+    TRACE_SCOPE("render", "GdImageRenderer::create");
+
+    if (!init(buffer, image_width, image_height, colors)) {
+        return false;
+    }
+
+    image_ = gdImageCreateTrueColor(image_width, image_height);
+
+    if (image_ == nullptr) {
+        log(Error) << "Failed to create image\n";
+        return false;
+    }
+
+    // Draw directly into the image's pixels, which saveAsPng() then encodes
+    image_buffer_.attach(image_->tpixels, image_width, image_height);
+
+    draw(buffer);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool GdImageRenderer::init(
+    const WaveformBuffer& buffer,
+    const int image_width,
+    const int image_height,
+    const WaveformColors& colors)
 {
     if (image_width < 1) {
         log(Error) << "Invalid image width: minimum 1\n";
@@ -157,7 +216,10 @@ bool GdImageRenderer::create(
         return false;
     }
 
-    if (buffer.getSize() < 1) {
+    // A buffer that starts part way through the audio is empty if the start
+    // time is after the end of the audio, which gives a blank image
+
+    if (buffer.getSize() < 1 && buffer_start_index_ == 0) {
         log(Error) << "Empty waveform buffer\n";
         return false;
     }
@@ -169,13 +231,6 @@ bool GdImageRenderer::create(
         return false;
     }
 
-    image_ = gdImageCreateTrueColor(image_width, image_height);
-
-    if (image_ == nullptr) {
-        log(Error) << "Failed to create image\n";
-        return false;
-    }
-
     assert(sample_rate != 0);
     assert(samples_per_pixel != 0);
 
@@ -183,7 +238,14 @@ bool GdImageRenderer::create(
     image_height_      = image_height;
     sample_rate_       = buffer.getSampleRate();
     samples_per_pixel_ = samples_per_pixel;
-    start_index_       = secondsToPixels(start_time_);
+
+    if (start_point_index_ >= 0) {
+        start_time_  = static_cast<double>(start_point_index_) * samples_per_pixel_ / sample_rate_;
+        start_index_ = start_point_index_ - buffer_start_index_;
+    }
+    else {
+        start_index_ = secondsToPixels(start_time_) - buffer_start_index_;
+    }
 
     log(Info) << "Image dimensions: " << image_width_ << "x" << image_height_ << " pixels"
               << "\nChannels: " << buffer.getChannels()
@@ -203,13 +265,36 @@ bool GdImageRenderer::create(
                   << '\n';
     }
 
-    if (colors.hasAlpha()) {
-        gdImageSaveAlpha(image_, 1);
-        gdImageAlphaBlending(image_, 0);
+    if (auto_amplitude_scale_) {
+        int end_index = start_index_ + image_width_;
+
+        if (end_index > buffer.getSize()) {
+            end_index = buffer.getSize();
+        }
+
+        waveform_amplitude_scale_ = WaveformUtil::getAmplitudeScale(buffer, start_index_, end_index);
+    }
+    else {
+        waveform_amplitude_scale_ = amplitude_scale_;
+    }
+
+    log(Info) << "Amplitude scale: " << waveform_amplitude_scale_ << '\n';
+
+    save_alpha_ = colors.hasAlpha();
+
+    if (save_alpha_) {
+        image_buffer_.setAlphaBlending(false);
     }
 
     initColors(colors);
 
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void GdImageRenderer::draw(const WaveformBuffer& buffer)
+{
     drawBackground();
 
     if (waveform_style_bars_) {
@@ -223,8 +308,6 @@ bool GdImageRenderer::create(
         drawBorder();
         drawTimeAxisLabels();
     }
-
-    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -243,14 +326,14 @@ void GdImageRenderer::initColors(const WaveformColors& colors)
 
 //------------------------------------------------------------------------------
 
+// Same as gdImageColorAllocateAlpha() for a truecolor image, so that colors
+// can be created before the image.
+
 int GdImageRenderer::createColor(const RGBA& color) const
 {
-    if (color.hasAlpha()) {
-        return gdImageColorAllocateAlpha(image_, color.red, color.green, color.blue, 127 - (color.alpha / 2));
-    }
-    else {
-        return gdImageColorAllocate(image_, color.red, color.green, color.blue);
-    }
+    const int alpha = color.hasAlpha() ? 127 - (color.alpha / 2) : 0;
+
+    return (alpha << 24) + (color.red << 16) + (color.green << 8) + color.blue;
 }
 
 //------------------------------------------------------------------------------
@@ -264,44 +347,35 @@ int GdImageRenderer::getWaveformColor(int channel) const
 
 //------------------------------------------------------------------------------
 
-void GdImageRenderer::drawBackground() const
+void GdImageRenderer::drawBackground()
 {
-    gdImageFilledRectangle(image_, 0, 0, image_width_ - 1, image_height_ - 1, background_color_);
+    TRACE_SCOPE("render", "GdImageRenderer::drawBackground");
+
+    image_buffer_.fillRectangle(0, 0, image_width_ - 1, image_height_ - 1, background_color_);
 }
 
 //------------------------------------------------------------------------------
 
-void GdImageRenderer::drawBorder() const
+void GdImageRenderer::drawBorder()
 {
-    gdImageRectangle(image_, 0, 0, image_width_ - 1, image_height_ - 1, border_color_);
+    TRACE_SCOPE("render", "GdImageRenderer::drawBorder");
+
+    image_buffer_.drawRectangle(0, 0, image_width_ - 1, image_height_ - 1, border_color_);
 }
 
 //------------------------------------------------------------------------------
 
-void GdImageRenderer::drawWaveform(const WaveformBuffer& buffer) const
+void GdImageRenderer::drawWaveform(const WaveformBuffer& buffer)
 {
+    TRACE_SCOPE("render", "GdImageRenderer::drawWaveform");
+
     // Avoid drawing over the top and bottom borders
     const int top_y   = render_axis_labels_ ? 1 : 0;
     const int bottom_y = render_axis_labels_ ? image_height_ - 2 : image_height_ - 1;
 
     const int buffer_size = buffer.getSize();
 
-    double amplitude_scale;
-
-    if (auto_amplitude_scale_) {
-        int end_index = start_index_ + image_width_;
-
-        if (end_index > buffer_size) {
-            end_index = buffer_size;
-        }
-
-        amplitude_scale = WaveformUtil::getAmplitudeScale(buffer, start_index_, end_index);
-    }
-    else {
-        amplitude_scale = amplitude_scale_;
-    }
-
-    log(Info) << "Amplitude scale: " << amplitude_scale << '\n';
+    const double amplitude_scale = waveform_amplitude_scale_;
 
     const int channels = buffer.getChannels();
 
@@ -325,16 +399,21 @@ void GdImageRenderer::drawWaveform(const WaveformBuffer& buffer) const
 
         const int height = waveform_bottom_y - waveform_top_y + 1;
 
-        for (int i = start_index_, x = 0; x < image_width_ && i < buffer_size; ++i, ++x) {
-            // Convert range [-32768, 32727] to [0, 65535]
-            int low  = MathUtil::scale(buffer.getMinSample(channel, i), amplitude_scale) + 32768;
-            int high = MathUtil::scale(buffer.getMaxSample(channel, i), amplitude_scale) + 32768;
+        // Each channel is drawn within its own rows, so skip any channel that
+        // isn't in the strip of rows being drawn
+        if (waveform_bottom_y >= image_buffer_.getStripTop() &&
+            waveform_top_y < image_buffer_.getStripBottom()) {
+            for (int i = start_index_, x = 0; x < image_width_ && i < buffer_size; ++i, ++x) {
+                // Convert range [-32768, 32727] to [0, 65535]
+                int low  = MathUtil::scale(buffer.getMinSample(channel, i), amplitude_scale) + 32768;
+                int high = MathUtil::scale(buffer.getMaxSample(channel, i), amplitude_scale) + 32768;
 
-            // Scale to fit the bitmap
-            int top    = waveform_top_y + height - 1 - high * height / 65536;
-            int bottom = waveform_top_y + height - 1 - low  * height / 65536;
+                // Scale to fit the bitmap
+                int top    = waveform_top_y + height - 1 - high * height / 65536;
+                int bottom = waveform_top_y + height - 1 - low  * height / 65536;
 
-            drawLine(x, top, x, bottom, waveform_color);
+                image_buffer_.drawVerticalLine(x, top, bottom, waveform_color);
+            }
         }
 
         available_height -= row_height + 1;
@@ -386,30 +465,15 @@ static int getBarHeight(const WaveformBuffer& buffer, int channel, int start, in
 
 //------------------------------------------------------------------------------
 
-void GdImageRenderer::drawWaveformBars(const WaveformBuffer& buffer) const
+void GdImageRenderer::drawWaveformBars(const WaveformBuffer& buffer)
 {
+    TRACE_SCOPE("render", "GdImageRenderer::drawWaveformBars");
+
     // Avoid drawing over the top and bottom borders
     const int top_y    = render_axis_labels_ ? 1 : 0;
     const int bottom_y = render_axis_labels_ ? image_height_ - 2 : image_height_ - 1;
 
-    const int buffer_size = buffer.getSize();
-
-    double amplitude_scale;
-
-    if (auto_amplitude_scale_) {
-        int end_index = start_index_ + image_width_;
-
-        if (end_index > buffer_size) {
-            end_index = buffer_size;
-        }
-
-        amplitude_scale = WaveformUtil::getAmplitudeScale(buffer, start_index_, end_index);
-    }
-    else {
-        amplitude_scale = amplitude_scale_;
-    }
-
-    log(Info) << "Amplitude scale: " << amplitude_scale << '\n';
+    const double amplitude_scale = waveform_amplitude_scale_;
 
     const int channels = buffer.getChannels();
 
@@ -459,7 +523,7 @@ void GdImageRenderer::drawWaveformBars(const WaveformBuffer& buffer) const
                     drawRoundedRectangle(x, top, x + bar_width_ - 1, bottom, radius, waveform_color);
                 }
                 else {
-                    drawRectangle(x, top, x + bar_width_ - 1, bottom, waveform_color);
+                    image_buffer_.fillRectangle(x, top, x + bar_width_ - 1, bottom, waveform_color);
                 }
             }
         }
@@ -477,85 +541,39 @@ void GdImageRenderer::drawRoundedRectangle(
     const int right,
     const int bottom,
     const int radius,
-    const int waveform_color) const
- {
+    const int waveform_color)
+{
     const int left_arc_x = left + radius;
     const int top_arc_y = top + radius;
     const int right_arc_x = right - radius;
     const int bottom_arc_y = bottom - radius;
 
     // Draw the vertical bar
-    drawRectangle(left, top_arc_y, right, bottom_arc_y, waveform_color);
+    image_buffer_.fillRectangle(left, top_arc_y, right, bottom_arc_y, waveform_color);
 
     // Draw the top-left corner
-    drawArc(left_arc_x, top_arc_y, radius * 2, radius * 2, 180, 270, waveform_color);
+    image_buffer_.fillPie(left_arc_x, top_arc_y, radius * 2, radius * 2, 180, 270, waveform_color);
     // Draw the top-right corner
-    drawArc(right_arc_x, top_arc_y, radius * 2, radius * 2, 270, 0, waveform_color);
+    image_buffer_.fillPie(right_arc_x, top_arc_y, radius * 2, radius * 2, 270, 0, waveform_color);
 
     // Fill between top-left corner and top-right corner
-    drawRectangle(left_arc_x, top, right_arc_x, top_arc_y, waveform_color);
+    image_buffer_.fillRectangle(left_arc_x, top, right_arc_x, top_arc_y, waveform_color);
 
     // Draw the bottom-left corner
-    drawArc(left_arc_x, bottom_arc_y, radius * 2, radius * 2, 90, 180, waveform_color);
+    image_buffer_.fillPie(left_arc_x, bottom_arc_y, radius * 2, radius * 2, 90, 180, waveform_color);
     // Draw the bottom-right corner
-    drawArc(right_arc_x, bottom_arc_y, radius * 2, radius * 2, 0, 90, waveform_color);
+    image_buffer_.fillPie(right_arc_x, bottom_arc_y, radius * 2, radius * 2, 0, 90, waveform_color);
 
     // Fill between bottom-left corner and bottom-right corner
-    drawRectangle(left_arc_x, bottom_arc_y, right_arc_x, bottom, waveform_color);
+    image_buffer_.fillRectangle(left_arc_x, bottom_arc_y, right_arc_x, bottom, waveform_color);
 }
 
 //------------------------------------------------------------------------------
 
-void GdImageRenderer::drawRectangle(
-    const int left,
-    const int top,
-    const int right,
-    const int bottom,
-    const int waveform_color) const
+void GdImageRenderer::drawTimeAxisLabels()
 {
-    gdImageFilledRectangle(image_, left, top, right, bottom, waveform_color);
-}
-
-//------------------------------------------------------------------------------
+    TRACE_SCOPE("render", "GdImageRenderer::drawTimeAxisLabels");
 
-void GdImageRenderer::drawArc(
-    const int centre_x,
-    const int centre_y,
-    const int width,
-    const int height,
-    const int start,
-    const int end,
-    const int waveform_color) const
-{
-    gdImageFilledArc(
-        image_,
-        centre_x,
-        centre_y,
-        width,
-        height,
-        start,
-        end,
-        waveform_color,
-        gdStyledBrushed
-    );
-}
-
-//------------------------------------------------------------------------------
-
-void GdImageRenderer::drawLine(
-    const int x1,
-    const int y1,
-    const int x2,
-    const int y2,
-    const int waveform_color) const
-{
-    gdImageLine(image_, x1, y1, x2, y2, waveform_color);
-}
-
-//------------------------------------------------------------------------------
-
-void GdImageRenderer::drawTimeAxisLabels() const
-{
     const int marker_height = 10;
 
     // Time interval between axis markers (seconds)
@@ -575,7 +593,15 @@ void GdImageRenderer::drawTimeAxisLabels() const
 
     assert(axis_label_offset_pixels >= 0);
 
-    gdFontPtr font = gdFontGetSmall();
+    const gdFontPtr gd_font = gdFontGetSmall();
+
+    const ImageBuffer::Font font = {
+        gd_font->offset,
+        gd_font->nchars,
+        gd_font->w,
+        gd_font->h,
+        gd_font->data
+    };
 
     int secs = first_axis_label_secs;
 
@@ -591,25 +617,18 @@ void GdImageRenderer::drawTimeAxisLabels() const
             break;
         }
 
-        gdImageLine(image_, x, 0, x, marker_height, border_color_);
-        gdImageLine(image_, x, image_height_ - 1, x, image_height_ - 1 - marker_height, border_color_);
+        image_buffer_.drawVerticalLine(x, 0, marker_height, border_color_);
+        image_buffer_.drawVerticalLine(x, image_height_ - 1, image_height_ - 1 - marker_height, border_color_);
 
         char label[50];
         const int label_length = TimeUtil::secondsToString(label, ARRAY_LENGTH(label), secs);
 
-        const int label_width = font->w * label_length;
+        const int label_width = font.width * label_length;
         const int label_x = x - (label_width / 2) + 1;
-        const int label_y = image_height_ - 1 - marker_height - 1 - font->h;
+        const int label_y = image_height_ - 1 - marker_height - 1 - font.height;
 
         if (label_x >= 0) {
-            gdImageString(
-                image_,
-                font,
-                label_x,
-                label_y,
-                reinterpret_cast<unsigned char*>(label),
-                axis_label_color_
-            );
+            image_buffer_.drawText(label_x, label_y, label, font, axis_label_color_);
         }
 
         secs += axis_label_interval_secs;
@@ -658,9 +677,9 @@ int GdImageRenderer::getAxisLabelScale() const
 
 //------------------------------------------------------------------------------
 
-bool GdImageRenderer::saveAsPng(
-    const char* filename,
-    const int compression_level) const
+// Returns the file to write a PNG image to, or nullptr on error.
+
+static FILE* openPngFile(const char* filename)
 {
     FILE* output_file;
 
@@ -675,20 +694,186 @@ bool GdImageRenderer::saveAsPng(
                        << filename << '\n'
                        << strerror(errno) << '\n';
 
-            return false;
+            return nullptr;
         }
     }
 
     log(Info) << "Output file: "
               << FileUtil::getOutputFilename(filename) << '\n';
 
-    gdImagePngEx(image_, output_file, compression_level);
+    return output_file;
+}
 
+//------------------------------------------------------------------------------
+
+static void closePngFile(FILE* output_file)
+{
     if (output_file != stdout) {
         fclose(output_file);
     }
+}
 
-    return true;
+//------------------------------------------------------------------------------
+
+bool GdImageRenderer::saveAsPng(
+    const char* filename,
+    const PngOptions& options) const
+{
+    StageTimer timer(JobStats::Encode);
+
+    FILE* output_file = openPngFile(filename);
+
+    if (output_file == nullptr) {
+        return false;
+    }
+
+    bool success;
+
+    {
+        TRACE_SCOPE("encode", "PngWriter::write");
+
+        PngWriter writer(options);
+        success = writer.write(output_file, image_buffer_, save_alpha_);
+    }
+
+    closePngFile(output_file);
+
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+void GdImageRenderer::setStripHeight(const int strip_height)
+{
+    strip_height_ = strip_height;
+}
+
+//------------------------------------------------------------------------------
+
+int GdImageRenderer::getStripHeight() const
+{
+    int strip_height = strip_height_;
+
+    if (strip_height <= 0) {
+        strip_height = MAX_STRIP_PIXELS / image_width_;
+
+        if (strip_height < 1) {
+            strip_height = 1;
+        }
+    }
+
+    return strip_height < image_height_ ? strip_height : image_height_;
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the colors that the image is drawn with, which are all the colors
+// in the image, as there is no alpha blending with translucent colors (see
+// init()). If the image is too large to keep in memory, this means the colors
+// don't need to be found from the image before it's written.
+
+std::vector<int> GdImageRenderer::getPalette(const int channels) const
+{
+    std::vector<int> colors;
+
+    colors.push_back(background_color_);
+
+    for (int channel = 0; channel < channels; ++channel) {
+        colors.push_back(getWaveformColor(channel));
+    }
+
+    if (render_axis_labels_) {
+        colors.push_back(border_color_);
+        colors.push_back(axis_label_color_);
+    }
+
+    std::vector<int> palette;
+
+    for (const int color : colors) {
+        if (std::find(palette.begin(), palette.end(), color) == palette.end()) {
+            palette.push_back(color);
+        }
+    }
+
+    return palette;
+}
+
+//------------------------------------------------------------------------------
+
+bool GdImageRenderer::renderAsPng(
+    const WaveformBuffer& buffer,
+    const int image_width,
+    const int image_height,
+    const WaveformColors& colors,
+    const char* filename,
+    const PngOptions& options)
+{
+    TRACE_SCOPE("render", "GdImageRenderer::renderAsPng");
+
+    {
+        StageTimer timer(JobStats::Render);
+
+        if (!init(buffer, image_width, image_height, colors)) {
+            return false;
+        }
+    }
+
+    FILE* output_file = openPngFile(filename);
+
+    if (output_file == nullptr) {
+        return false;
+    }
+
+    const int strip_height = getStripHeight();
+
+    image_buffer_.createStrip(image_width, image_height, strip_height);
+
+    std::vector<int> palette;
+
+    if (options.palette) {
+        palette = getPalette(buffer.getChannels());
+
+        if (palette.size() > 256) {
+            palette.clear();
+        }
+    }
+
+    PngWriter writer(options);
+
+    bool success = writer.start(
+        output_file,
+        image_width,
+        image_height,
+        palette,
+        save_alpha_
+    );
+
+    for (int top = 0; success && top < image_height; top += strip_height) {
+        {
+            StageTimer timer(JobStats::Render);
+
+            image_buffer_.setStripTop(top);
+            draw(buffer);
+        }
+
+        StageTimer timer(JobStats::Encode);
+        TRACE_SCOPE("encode", "PngWriter::writeRow");
+
+        const int bottom = image_buffer_.getStripBottom();
+
+        for (int y = top; success && y < bottom; ++y) {
+            success = writer.writeRow(image_buffer_.getRow(y));
+        }
+    }
+
+    if (success) {
+        StageTimer timer(JobStats::Encode);
+        success = writer.finish();
+    }
+
+    closePngFile(output_file);
+
+    return success;
 }
 
 //------------------------------------------------------------------------------
@@ -26,6 +26,9 @@
 
 //------------------------------------------------------------------------------
 
+#include "ImageBuffer.h"
+#include "PngWriter.h"
+
 #include <gd.h>
 
 #include <vector>
@@ -50,6 +53,14 @@ class GdImageRenderer
     public:
         bool setStartTime(double start_time);
 
+        // Sets the index of the first point to render, instead of a start
+        // time, so that images start at an exact point, e.g., image tiles.
+        void setStartIndex(int start_index);
+
+        // Sets the index of the first point in the waveform buffer, for
+        // rendering from a buffer that starts part way through the audio.
+        void setBufferStartIndex(int buffer_start_index);
+
         bool setBarStyle(
             int bar_width,
             int bar_gap,
@@ -72,19 +83,48 @@ class GdImageRenderer
 
         bool saveAsPng(
             const char* filename,
-            int compression_level = -1
+            const PngOptions& options = PngOptions()
         ) const;
 
+        // Sets the number of rows in each strip drawn by renderAsPng(), or 0
+        // (the default) to choose from the image width.
+        void setStripHeight(int strip_height);
+
+        // Draws the image in strips of rows, and writes each strip to the PNG
+        // file as it's drawn, instead of creating the whole image first, so
+        // that memory use depends on the strip size, not the image size. Gives
+        // the same pixels as create() then saveAsPng().
+        bool renderAsPng(
+            const WaveformBuffer& buffer,
+            int image_width,
+            int image_height,
+            const WaveformColors& colors,
+            const char* filename,
+            const PngOptions& options = PngOptions()
+        );
+
     private:
+        bool init(
+            const WaveformBuffer& buffer,
+            int image_width,
+            int image_height,
+            const WaveformColors& colors
+        );
+
+        void draw(const WaveformBuffer& buffer);
+
+        int getStripHeight() const;
+        std::vector<int> getPalette(int channels) const;
+
         void initColors(const WaveformColors& colors);
         int createColor(const RGBA& color) const;
         int getWaveformColor(int channel) const;
 
-        void drawBackground() const;
-        void drawBorder() const;
+        void drawBackground();
+        void drawBorder();
 
-        void drawWaveform(const WaveformBuffer& buffer) const;
-        void drawWaveformBars(const WaveformBuffer& buffer) const;
+        void drawWaveform(const WaveformBuffer& buffer);
+        void drawWaveformBars(const WaveformBuffer& buffer);
 
         void drawRoundedRectangle(
             const int x1,
@@ -93,35 +133,9 @@ class GdImageRenderer
             const int y2,
             const int radius,
             int waveform_color
-        ) const;
-
-        void drawRectangle(
-            int left,
-            int top,
-            int right,
-            int bottom,
-            int waveform_color
-        ) const;
-
-        void drawArc(
-            int centre_x,
-            int centre_y,
-            int width,
-            int height,
-            int start,
-            int end,
-            int waveform_color
-        ) const;
-
-        void drawLine(
-            int x1,
-            int y1,
-            int x2,
-            int y2,
-            int waveform_color
-        ) const;
+        );
 
-        void drawTimeAxisLabels() const;
+        void drawTimeAxisLabels();
 
         int getAxisLabelScale() const;
 
@@ -135,13 +149,19 @@ class GdImageRenderer
 
     private:
         gdImagePtr image_;
+
+        // Draws into the pixels of image_
+        ImageBuffer image_buffer_;
+
         int image_width_;
         int image_height_;
 
         double start_time_;
+        int start_point_index_; // or -1 to use start_time_
         int sample_rate_;
         int samples_per_pixel_;
         int start_index_;
+        int buffer_start_index_;
 
         int border_color_;
         int background_color_;
@@ -155,8 +175,15 @@ class GdImageRenderer
 
         bool render_axis_labels_;
 
+        bool save_alpha_;
+
         bool auto_amplitude_scale_;
         double amplitude_scale_;
+
+        // The amplitude scale of the image being drawn
+        double waveform_amplitude_scale_;
+
+        int strip_height_;
 };
 
 //------------------------------------------------------------------------------
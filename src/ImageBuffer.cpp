@@ -0,0 +1,570 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "ImageBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+
+//------------------------------------------------------------------------------
+
+// libgd truecolor alpha values: 0 is opaque and 127 is transparent.
+
+const int ALPHA_OPAQUE      = 0;
+const int ALPHA_TRANSPARENT = 127;
+
+//------------------------------------------------------------------------------
+
+static int getAlpha(const int color)
+{
+    return (color & 0x7f000000) >> 24;
+}
+
+static int getRed(const int color)
+{
+    return (color & 0xff0000) >> 16;
+}
+
+static int getGreen(const int color)
+{
+    return (color & 0x00ff00) >> 8;
+}
+
+static int getBlue(const int color)
+{
+    return color & 0x0000ff;
+}
+
+//------------------------------------------------------------------------------
+
+// 1024 * cos(angle) for angles from 0 to 90 degrees, rounded towards zero.
+// These are the values in libgd's gdCosT table, so that pie slices have the
+// same outline as those drawn by gdImageFilledArc().
+
+static const int COS_TABLE[] = {
+    1024, 1023, 1023, 1022, 1021, 1020, 1018, 1016, 1014, 1011,
+    1008, 1005, 1001,  997,  993,  989,  984,  979,  973,  968,
+     962,  955,  949,  942,  935,  928,  920,  912,  904,  895,
+     886,  877,  868,  858,  848,  838,  828,  817,  806,  795,
+     784,  772,  760,  748,  736,  724,  711,  698,  685,  671,
+     658,  644,  630,  616,  601,  587,  572,  557,  542,  527,
+     512,  496,  480,  464,  448,  432,  416,  400,  383,  366,
+     350,  333,  316,  299,  282,  265,  247,  230,  212,  195,
+     177,  160,  142,  124,  107,   89,   71,   53,   35,   17,
+       0
+};
+
+//------------------------------------------------------------------------------
+
+static int getCos(int degrees)
+{
+    degrees %= 360;
+
+    if (degrees <= 90) {
+        return COS_TABLE[degrees];
+    }
+    else if (degrees <= 180) {
+        return -COS_TABLE[180 - degrees];
+    }
+    else if (degrees <= 270) {
+        return -COS_TABLE[degrees - 180];
+    }
+    else {
+        return COS_TABLE[360 - degrees];
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static int getSin(const int degrees)
+{
+    return getCos(degrees + 270);
+}
+
+//------------------------------------------------------------------------------
+
+ImageBuffer::ImageBuffer() :
+    width_(0),
+    height_(0),
+    strip_top_(0),
+    strip_bottom_(0),
+    alpha_blending_(true)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void ImageBuffer::create(const int width, const int height)
+{
+    assert(width > 0);
+    assert(height > 0);
+
+    createStrip(width, height, height);
+}
+
+//------------------------------------------------------------------------------
+
+void ImageBuffer::attach(int** rows, const int width, const int height)
+{
+    assert(rows != nullptr);
+
+    width_  = width;
+    height_ = height;
+
+    strip_top_    = 0;
+    strip_bottom_ = height;
+
+    pixels_.clear();
+    rows_.assign(rows, rows + height);
+}
+
+//------------------------------------------------------------------------------
+
+void ImageBuffer::createStrip(
+    const int width,
+    const int height,
+    const int strip_height)
+{
+    assert(width > 0);
+    assert(height > 0);
+    assert(strip_height > 0 && strip_height <= height);
+
+    width_  = width;
+    height_ = height;
+
+    strip_top_    = 0;
+    strip_bottom_ = strip_height;
+
+    pixels_.assign(static_cast<size_t>(width) * static_cast<size_t>(strip_height), 0);
+    rows_.resize(static_cast<size_t>(strip_height));
+
+    for (int y = 0; y < strip_height; ++y) {
+        rows_[static_cast<size_t>(y)] =
+            &pixels_[static_cast<size_t>(y) * static_cast<size_t>(width)];
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void ImageBuffer::setStripTop(const int y)
+{
+    assert(!pixels_.empty());
+    assert(y >= 0 && y < height_);
+
+    strip_top_    = y;
+    strip_bottom_ = std::min(y + static_cast<int>(rows_.size()), height_);
+
+    std::fill(pixels_.begin(), pixels_.end(), 0);
+}
+
+//------------------------------------------------------------------------------
+
+void ImageBuffer::setAlphaBlending(const bool alpha_blending)
+{
+    alpha_blending_ = alpha_blending;
+}
+
+//------------------------------------------------------------------------------
+
+// Same as libgd's gdAlphaBlend().
+
+int ImageBuffer::blend(const int dst, const int src)
+{
+    const int src_alpha = getAlpha(src);
+
+    if (src_alpha == ALPHA_OPAQUE) {
+        return src;
+    }
+
+    const int dst_alpha = getAlpha(dst);
+
+    if (src_alpha == ALPHA_TRANSPARENT) {
+        return dst;
+    }
+
+    if (dst_alpha == ALPHA_TRANSPARENT) {
+        return src;
+    }
+
+    // The destination weight is reduced as the source becomes more opaque
+
+    const int src_weight = ALPHA_TRANSPARENT - src_alpha;
+    const int dst_weight = (ALPHA_TRANSPARENT - dst_alpha) * src_alpha / ALPHA_TRANSPARENT;
+    const int total_weight = src_weight + dst_weight;
+
+    const int alpha = src_alpha * dst_alpha / ALPHA_TRANSPARENT;
+
+    const int red = (getRed(src) * src_weight + getRed(dst) * dst_weight) / total_weight;
+    const int green = (getGreen(src) * src_weight + getGreen(dst) * dst_weight) / total_weight;
+    const int blue = (getBlue(src) * src_weight + getBlue(dst) * dst_weight) / total_weight;
+
+    return (alpha << 24) + (red << 16) + (green << 8) + blue;
+}
+
+//------------------------------------------------------------------------------
+
+void ImageBuffer::setPixel(const int x, const int y, const int color)
+{
+    if (x >= 0 && x < width_ && y >= strip_top_ && y < strip_bottom_) {
+        int& pixel = getWritableRow(y)[x];
+
+        pixel = alpha_blending_ ? blend(pixel, color) : color;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void ImageBuffer::fillSpan(int* pixels, const int count, const int color)
+{
+    if (!alpha_blending_ || getAlpha(color) == ALPHA_OPAQUE) {
+        std::fill(pixels, pixels + count, color);
+    }
+    else {
+        for (int i = 0; i < count; ++i) {
+            pixels[i] = blend(pixels[i], color);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Same pixels as gdImageLine() for a horizontal line, which is clipped to the
+// image and may be given in either direction.
+
+void ImageBuffer::drawHorizontalLine(const int y, int x1, int x2, const int color)
+{
+    if (y < strip_top_ || y >= strip_bottom_) {
+        return;
+    }
+
+    if (x1 > x2) {
+        std::swap(x1, x2);
+    }
+
+    x1 = std::max(x1, 0);
+    x2 = std::min(x2, width_ - 1);
+
+    if (x1 <= x2) {
+        fillSpan(getWritableRow(y) + x1, x2 - x1 + 1, color);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void ImageBuffer::drawVerticalLine(const int x, int y1, int y2, const int color)
+{
+    if (x < 0 || x >= width_) {
+        return;
+    }
+
+    if (y1 > y2) {
+        std::swap(y1, y2);
+    }
+
+    y1 = std::max(y1, strip_top_);
+    y2 = std::min(y2, strip_bottom_ - 1);
+
+    if (!alpha_blending_ || getAlpha(color) == ALPHA_OPAQUE) {
+        for (int y = y1; y <= y2; ++y) {
+            getWritableRow(y)[x] = color;
+        }
+    }
+    else {
+        for (int y = y1; y <= y2; ++y) {
+            int& pixel = getWritableRow(y)[x];
+            pixel = blend(pixel, color);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Same pixels as gdImageRectangle(): the vertical sides don't include the
+// corners, so translucent corners are only blended once.
+
+void ImageBuffer::drawRectangle(int x1, int y1, int x2, int y2, const int color)
+{
+    if (x1 == x2 && y1 == y2) {
+        setPixel(x1, y1, color);
+        return;
+    }
+
+    if (x1 > x2) {
+        std::swap(x1, x2);
+    }
+
+    if (y1 > y2) {
+        std::swap(y1, y2);
+    }
+
+    if (x1 == x2) {
+        drawVerticalLine(x1, y1, y2, color);
+        return;
+    }
+
+    if (y1 == y2) {
+        drawHorizontalLine(y1, x1, x2, color);
+        return;
+    }
+
+    drawHorizontalLine(y1, x1, x2, color);
+    drawHorizontalLine(y2, x1, x2, color);
+    drawVerticalLine(x1, y1 + 1, y2 - 1, color);
+    drawVerticalLine(x2, y1 + 1, y2 - 1, color);
+}
+
+//------------------------------------------------------------------------------
+
+void ImageBuffer::fillRectangle(int x1, int y1, int x2, int y2, const int color)
+{
+    if (x1 > x2) {
+        std::swap(x1, x2);
+    }
+
+    if (y1 > y2) {
+        std::swap(y1, y2);
+    }
+
+    x1 = std::max(x1, 0);
+    x2 = std::min(x2, width_ - 1);
+    y1 = std::max(y1, strip_top_);
+    y2 = std::min(y2, strip_bottom_ - 1);
+
+    if (x1 > x2) {
+        return;
+    }
+
+    for (int y = y1; y <= y2; ++y) {
+        fillSpan(getWritableRow(y) + x1, x2 - x1 + 1, color);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Same pixels as gdImageFilledArc() with the gdPie style: the outline points
+// are on whole degrees, and points on the same row as the previous point only
+// move the outline outwards.
+
+void ImageBuffer::fillPie(
+    const int centre_x,
+    const int centre_y,
+    const int width,
+    const int height,
+    int start,
+    int end,
+    const int color)
+{
+    if (start % 360 == end % 360) {
+        start = 0;
+        end = 360;
+    }
+    else {
+        if (start > 360) {
+            start %= 360;
+        }
+
+        if (end > 360) {
+            end %= 360;
+        }
+
+        while (start < 0) {
+            start += 360;
+        }
+
+        while (end < start) {
+            end += 360;
+        }
+
+        if (start == end) {
+            start = 0;
+            end = 360;
+        }
+    }
+
+    points_.clear();
+    points_.push_back({ centre_x, centre_y });
+
+    int start_x = 0;
+    int start_y = 0;
+    int end_x   = 0;
+    int end_y   = 0;
+    int last_x  = 0;
+    int last_y  = 0;
+
+    for (int i = start; i <= end; ++i) {
+        const int x = static_cast<int>(static_cast<long>(getCos(i)) * width / 2048) + centre_x;
+        const int y = static_cast<int>(static_cast<long>(getSin(i)) * height / 2048) + centre_y;
+
+        end_x = x;
+        end_y = y;
+
+        if (i == start) {
+            start_x = x;
+            start_y = y;
+
+            points_.push_back({ x, y });
+        }
+        else if (y == last_y) {
+            // As in libgd, angles past 360 degrees are not reduced here
+            if (((i > 270 || i < 90) && x > last_x) ||
+                ((i > 90 && i < 270) && x < last_x)) {
+                points_.back().x = x;
+            }
+        }
+        else {
+            points_.push_back({ x, y });
+        }
+
+        last_x = x;
+        last_y = y;
+    }
+
+    if (end - start < 360) {
+        // Restore the start and end points if they were moved
+
+        if (points_[1].x != start_x && points_[1].y == start_y) {
+            points_.insert(points_.begin() + 1, { start_x, start_y });
+        }
+
+        if (points_.back().x != end_x && points_.back().y == end_y) {
+            points_.push_back({ end_x, end_y });
+        }
+    }
+
+    points_.push_back({ centre_x, centre_y });
+
+    fillPolygon(points_, color);
+}
+
+//------------------------------------------------------------------------------
+
+// Same pixels as gdImageFilledPolygon(), which fills between pairs of edge
+// intersections on each row, rounding the intersections to the nearest pixel.
+
+void ImageBuffer::fillPolygon(const std::vector<Point>& points, const int color)
+{
+    const size_t count = points.size();
+
+    if (count == 0) {
+        return;
+    }
+
+    int min_y = points[0].y;
+    int max_y = points[0].y;
+
+    for (const auto& point : points) {
+        min_y = std::min(min_y, point.y);
+        max_y = std::max(max_y, point.y);
+    }
+
+    if (count > 1 && min_y == max_y) {
+        int min_x = points[0].x;
+        int max_x = points[0].x;
+
+        for (const auto& point : points) {
+            min_x = std::min(min_x, point.x);
+            max_x = std::max(max_x, point.x);
+        }
+
+        drawHorizontalLine(min_y, min_x, max_x, color);
+        return;
+    }
+
+    const int last_y = max_y;
+
+    min_y = std::max(min_y, strip_top_);
+    max_y = std::min(max_y, strip_bottom_ - 1);
+
+    for (int y = min_y; y <= max_y; ++y) {
+        intersections_.clear();
+
+        for (size_t i = 0; i < count; ++i) {
+            const Point& p1 = points[i == 0 ? count - 1 : i - 1];
+            const Point& p2 = points[i];
+
+            if (p1.y == p2.y) {
+                continue;
+            }
+
+            const Point& top    = p1.y < p2.y ? p1 : p2;
+            const Point& bottom = p1.y < p2.y ? p2 : p1;
+
+            if (y >= top.y && y < bottom.y) {
+                // libgd calculates this in single precision, which can round
+                // differently to double precision
+                const float offset =
+                    static_cast<float>((y - top.y) * (bottom.x - top.x)) /
+                    static_cast<float>(bottom.y - top.y);
+
+                intersections_.push_back(static_cast<int>(offset + 0.5 + top.x));
+            }
+            else if (y == last_y && y == bottom.y) {
+                intersections_.push_back(bottom.x);
+            }
+        }
+
+        std::sort(intersections_.begin(), intersections_.end());
+
+        for (size_t i = 0; i + 1 < intersections_.size(); i += 2) {
+            drawHorizontalLine(y, intersections_[i], intersections_[i + 1], color);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Same pixels as gdImageString().
+
+void ImageBuffer::drawText(
+    int x,
+    const int y,
+    const char* text,
+    const Font& font,
+    const int color)
+{
+    const int top    = std::max(y, strip_top_);
+    const int bottom = std::min(y + font.height, strip_bottom_);
+
+    for (const char* p = text; *p != '\0'; ++p, x += font.width) {
+        const int c = static_cast<unsigned char>(*p);
+
+        if (c < font.first_char || c >= font.first_char + font.char_count) {
+            continue;
+        }
+
+        const int left  = std::max(x, 0);
+        const int right = std::min(x + font.width, width_);
+
+        const char* glyph = font.data + (c - font.first_char) * font.width * font.height;
+
+        for (int py = top; py < bottom; ++py) {
+            const char* glyph_row = glyph + (py - y) * font.width;
+
+            for (int px = left; px < right; ++px) {
+                if (glyph_row[px - x] != 0) {
+                    setPixel(px, py, color);
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_IMAGE_BUFFER_H)
+#define INC_IMAGE_BUFFER_H
+
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// An image as rows of packed 32-bit pixels, in the same format as libgd
+// truecolor images: 0xAARRGGBB, where alpha is from 0 (opaque) to 127
+// (transparent).
+//
+// The drawing functions fill spans of pixels directly, instead of setting
+// each pixel separately, but give the same pixels as the equivalent libgd
+// functions, including clipping to the edges of the image and alpha blending.
+// An ImageBuffer can draw into the rows of a libgd image, so that libgd can
+// encode the image without copying the pixels.
+//
+// For images too large to keep in memory, an ImageBuffer can hold a strip of
+// rows of the image. Drawing is clipped to the strip, so drawing the whole
+// image into each strip in turn gives the same pixels as drawing into the
+// whole image.
+
+class ImageBuffer
+{
+    public:
+        // A bitmap font, in the same format as libgd fonts: one byte for each
+        // pixel of each character, non-zero where the pixel is set.
+        struct Font
+        {
+            int first_char;
+            int char_count;
+            int width;
+            int height;
+            const char* data;
+        };
+
+    public:
+        ImageBuffer();
+
+        ImageBuffer(const ImageBuffer&) = delete;
+        ImageBuffer& operator=(const ImageBuffer&) = delete;
+
+    public:
+        // Allocates an image filled with opaque black pixels, as
+        // gdImageCreateTrueColor() does.
+        void create(int width, int height);
+
+        // Draws into rows of pixels owned by the caller, such as the tpixels
+        // of a libgd truecolor image.
+        void attach(int** rows, int width, int height);
+
+        // Allocates a strip of rows of an image, starting at row 0.
+        void createStrip(int width, int height, int strip_height);
+
+        // Moves the strip to start at row y, and fills it with opaque black
+        // pixels.
+        void setStripTop(int y);
+
+        int getWidth() const { return width_; }
+        int getHeight() const { return height_; }
+
+        // The rows that can be drawn into, from top to bottom - 1. Unless
+        // created with createStrip(), these are all the rows of the image.
+        int getStripTop() const { return strip_top_; }
+        int getStripBottom() const { return strip_bottom_; }
+
+        const int* getRow(int y) const { return rows_[static_cast<size_t>(y - strip_top_)]; }
+
+        int getPixel(int x, int y) const
+        {
+            return getRow(y)[x];
+        }
+
+        // If enabled (the default), translucent colors are blended with the
+        // existing pixels, otherwise they replace them.
+        void setAlphaBlending(bool alpha_blending);
+
+        void setPixel(int x, int y, int color);
+
+        void drawHorizontalLine(int y, int x1, int x2, int color);
+        void drawVerticalLine(int x, int y1, int y2, int color);
+
+        void drawRectangle(int x1, int y1, int x2, int y2, int color);
+        void fillRectangle(int x1, int y1, int x2, int y2, int color);
+
+        // Fills the pie slice of the ellipse centred at (centre_x, centre_y)
+        // from start to end degrees, clockwise from 3 o'clock.
+        void fillPie(
+            int centre_x,
+            int centre_y,
+            int width,
+            int height,
+            int start,
+            int end,
+            int color
+        );
+
+        void drawText(int x, int y, const char* text, const Font& font, int color);
+
+        static int blend(int dst, int src);
+
+    private:
+        struct Point
+        {
+            int x;
+            int y;
+        };
+
+        int* getWritableRow(int y) { return rows_[static_cast<size_t>(y - strip_top_)]; }
+
+        void fillSpan(int* pixels, int count, int color);
+
+        void fillPolygon(const std::vector<Point>& points, int color);
+
+    private:
+        int width_;
+        int height_;
+
+        int strip_top_;
+        int strip_bottom_;
+
+        std::vector<int> pixels_;
+        std::vector<int*> rows_;
+
+        bool alpha_blending_;
+
+        std::vector<Point> points_;
+        std::vector<int> intersections_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_IMAGE_BUFFER_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,666 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "JobServer.h"
+#include "Log.h"
+#include "Options.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------
+
+// Requests longer than this are rejected, and the connection closed
+const size_t MAX_REQUEST_LENGTH = 65536;
+
+// How often the server checks whether it should stop, in milliseconds
+const int POLL_INTERVAL = 100;
+
+//------------------------------------------------------------------------------
+
+JobServer::JobServer(
+    const std::string& socket_filename,
+    const int workers,
+    JobHandler handler,
+    const int max_connections) :
+    socket_filename_(socket_filename),
+    workers_(workers < 1 ? 1 : workers),
+    handler_(std::move(handler)),
+    max_connections_(max_connections < 1 ? 1 : static_cast<size_t>(max_connections)),
+    listen_fd_(-1),
+    stopping_(false),
+    workers_stopping_(false),
+    active_count_(0),
+    job_count_(0),
+    failed_count_(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+JobServer::~JobServer()
+{
+#if !defined(_WIN32)
+    if (listen_fd_ != -1) {
+        close(listen_fd_);
+        unlink(socket_filename_.c_str());
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+void JobServer::stop()
+{
+    stopping_ = true;
+}
+
+//------------------------------------------------------------------------------
+
+#if defined(_WIN32)
+
+bool JobServer::listen()
+{
+    log(Error) << "Server mode is not supported on this platform\n";
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+void JobServer::run()
+{
+}
+
+//------------------------------------------------------------------------------
+
+#else
+
+//------------------------------------------------------------------------------
+
+#if defined(MSG_NOSIGNAL)
+const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+const int SEND_FLAGS = 0; // SO_NOSIGPIPE is set instead
+#endif
+
+//------------------------------------------------------------------------------
+
+class JobServer::Connection
+{
+    public:
+        explicit Connection(int fd) : fd_(fd) {}
+
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+    public:
+        bool readLine(std::string& line);
+        bool write(const std::string& data);
+
+    private:
+        int fd_;
+        std::string buffer_;
+};
+
+//------------------------------------------------------------------------------
+
+bool JobServer::Connection::readLine(std::string& line)
+{
+    for (;;) {
+        const size_t pos = buffer_.find('\n');
+
+        if (pos != std::string::npos) {
+            line.assign(buffer_, 0, pos);
+            buffer_.erase(0, pos + 1);
+
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+
+            return true;
+        }
+
+        if (buffer_.size() > MAX_REQUEST_LENGTH) {
+            return false;
+        }
+
+        char data[4096];
+
+        const ssize_t result = recv(fd_, data, sizeof(data), 0);
+
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (result <= 0) {
+            return false;
+        }
+
+        buffer_.append(data, static_cast<size_t>(result));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool JobServer::Connection::write(const std::string& data)
+{
+    size_t offset = 0;
+
+    while (offset < data.size()) {
+        const ssize_t result = send(
+            fd_,
+            data.data() + offset,
+            data.size() - offset,
+            SEND_FLAGS
+        );
+
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (result <= 0) {
+            return false;
+        }
+
+        offset += static_cast<size_t>(result);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Returns true if another process is accepting connections on the socket.
+
+static bool isSocketInUse(const sockaddr_un& address)
+{
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    const bool in_use = connect(
+        fd,
+        reinterpret_cast<const sockaddr*>(&address),
+        sizeof(address)
+    ) == 0;
+
+    close(fd);
+
+    return in_use;
+}
+
+//------------------------------------------------------------------------------
+
+bool JobServer::listen()
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (socket_filename_.empty() ||
+        socket_filename_.size() >= sizeof(address.sun_path)) {
+        log(Error) << "Invalid socket filename: " << socket_filename_ << '\n';
+        return false;
+    }
+
+    memcpy(address.sun_path, socket_filename_.c_str(), socket_filename_.size());
+
+    // Remove the socket left by a previous server, but not any other file
+    struct stat stat_buf;
+
+    if (lstat(socket_filename_.c_str(), &stat_buf) == 0) {
+        if (!S_ISSOCK(stat_buf.st_mode)) {
+            log(Error) << "File exists and is not a socket: "
+                       << socket_filename_ << '\n';
+            return false;
+        }
+
+        if (isSocketInUse(address)) {
+            log(Error) << "Socket is already in use: "
+                       << socket_filename_ << '\n';
+            return false;
+        }
+
+        unlink(socket_filename_.c_str());
+    }
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listen_fd_ == -1) {
+        log(Error) << "Failed to create socket: " << strerror(errno) << '\n';
+        return false;
+    }
+
+    // Set the permissions before listening, so no client can connect while
+    // the socket has the permissions given by the umask
+    if (bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        chmod(socket_filename_.c_str(), S_IRUSR | S_IWUSR) != 0 ||
+        ::listen(listen_fd_, SOMAXCONN) != 0) {
+        log(Error) << "Failed to listen on socket: " << socket_filename_ << '\n'
+                   << strerror(errno) << '\n';
+
+        close(listen_fd_);
+        listen_fd_ = -1;
+
+        return false;
+    }
+
+    start_time_ = std::chrono::steady_clock::now();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void JobServer::run()
+{
+    for (int i = 0; i < workers_; ++i) {
+        worker_threads_.emplace_back(&JobServer::runWorker, this);
+    }
+
+    while (!stopping_) {
+        {
+            // Leave further clients in the listen queue until a connection
+            // closes
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            if (connections_.size() >= max_connections_) {
+                connection_closed_.wait_for(
+                    lock, std::chrono::milliseconds(POLL_INTERVAL)
+                );
+
+                continue;
+            }
+        }
+
+        pollfd poll_fd;
+        poll_fd.fd      = listen_fd_;
+        poll_fd.events  = POLLIN;
+        poll_fd.revents = 0;
+
+        const int result = poll(&poll_fd, 1, POLL_INTERVAL);
+
+        if (result < 0 && errno != EINTR) {
+            log(Error) << "Failed to wait for connections: "
+                       << strerror(errno) << '\n';
+            break;
+        }
+
+        if (result <= 0) {
+            continue;
+        }
+
+        const int fd = accept(listen_fd_, nullptr, nullptr);
+
+        if (fd == -1) {
+            continue;
+        }
+
+#if defined(SO_NOSIGPIPE)
+        const int value = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+#endif
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_.insert(fd);
+        }
+
+        std::thread(&JobServer::serveConnection, this, fd).detach();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // Wake any connections waiting for requests. Jobs already sent to
+        // the workers still run to completion.
+        for (const int fd : connections_) {
+            shutdown(fd, SHUT_RDWR);
+        }
+
+        connection_closed_.wait(lock, [this] { return connections_.empty(); });
+
+        workers_stopping_ = true;
+    }
+
+    job_available_.notify_all();
+
+    for (auto& thread : worker_threads_) {
+        thread.join();
+    }
+
+    worker_threads_.clear();
+
+    close(listen_fd_);
+    listen_fd_ = -1;
+
+    unlink(socket_filename_.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+void JobServer::runWorker()
+{
+    for (;;) {
+        std::packaged_task<JobUtil::Result()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            job_available_.wait(lock, [this] {
+                return !queue_.empty() || workers_stopping_;
+            });
+
+            if (queue_.empty()) {
+                break;
+            }
+
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        task();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void JobServer::serveConnection(const int fd)
+{
+    {
+        Connection connection(fd);
+        std::string request;
+
+        while (!stopping_ && connection.readLine(request)) {
+            if (!handleRequest(connection, request)) {
+                break;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    connections_.erase(fd);
+    close(fd);
+
+    connection_closed_.notify_all();
+}
+
+//------------------------------------------------------------------------------
+
+// Returns false if the connection should be closed.
+
+bool JobServer::handleRequest(
+    Connection& connection,
+    const std::string& request)
+{
+    const size_t pos = request.find(' ');
+
+    const std::string command = request.substr(0, pos);
+
+    if (command == "run") {
+        return handleRunRequest(
+            connection,
+            pos == std::string::npos ? std::string() : request.substr(pos + 1)
+        );
+    }
+    else if (command == "health") {
+        return connection.write("{\"status\":\"ok\"}\n");
+    }
+    else if (command == "stats") {
+        return connection.write(getStats());
+    }
+    else if (command == "shutdown") {
+        connection.write("{\"status\":\"ok\"}\n");
+        stop();
+        return false;
+    }
+    else if (command.empty()) {
+        return true;
+    }
+    else {
+        return connection.write(
+            "{\"status\":\"error\",\"error\":\"Unknown request: " +
+            JobUtil::escapeJson(command) + "\"}\n"
+        );
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Returns true if the job writes to standard output, in which case the output
+// is sent in the response instead. Removes "-o -" from the arguments, so that
+// an output filename can be added.
+
+static bool removeStdoutOption(std::vector<std::string>& args)
+{
+    bool has_output_filename = false;
+    bool has_output_format = false;
+
+    auto i = args.begin();
+
+    while (i != args.end()) {
+        const std::string& arg = *i;
+
+        if ((arg == "-o" || arg == "--output-filename") &&
+            std::next(i) != args.end()) {
+            if (*std::next(i) == "-") {
+                i = args.erase(i, std::next(i, 2));
+                continue;
+            }
+
+            has_output_filename = true;
+        }
+        else if (arg == "-o-" || arg == "--output-filename=-") {
+            i = args.erase(i);
+            continue;
+        }
+        else if (arg.compare(0, 2, "-o") == 0 ||
+                 arg.compare(0, 18, "--output-filename=") == 0) {
+            has_output_filename = true;
+        }
+        else if (arg.compare(0, 15, "--output-format") == 0) {
+            has_output_format = true;
+        }
+
+        ++i;
+    }
+
+    return has_output_format && !has_output_filename;
+}
+
+//------------------------------------------------------------------------------
+
+static bool readFile(const boost::filesystem::path& filename, std::string& data)
+{
+    std::ifstream file(filename.string(), std::ios::in | std::ios::binary);
+
+    if (!file) {
+        return false;
+    }
+
+    data.assign(
+        std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()
+    );
+
+    return !file.bad();
+}
+
+//------------------------------------------------------------------------------
+
+bool JobServer::handleRunRequest(
+    Connection& connection,
+    const std::string& command_line)
+{
+    std::vector<std::string> args;
+
+    try {
+        args = boost::program_options::split_unix(command_line);
+    }
+    catch (const std::exception& e) {
+        return connection.write(
+            "{\"status\":\"error\",\"error\":\"" +
+            JobUtil::escapeJson(e.what()) + "\"}\n"
+        );
+    }
+
+    const bool send_output = removeStdoutOption(args);
+
+    boost::filesystem::path output_filename;
+    JobHandler handler = handler_;
+
+    if (send_output) {
+        output_filename = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("audiowaveform-%%%%-%%%%-%%%%-%%%%");
+
+        args.push_back("-o");
+        args.push_back(output_filename.string());
+
+        handler = [this](const Options& options) {
+            if (options.getSamplesPerPixelValues().size() > 1 ||
+                options.getPixelsPerSecondValues().size() > 1) {
+                log(Error) << "Cannot write multiple zoom levels to standard output\n";
+                return false;
+            }
+
+            return handler_(options);
+        };
+    }
+
+    JobUtil::Result result = runJob(args, handler);
+
+    std::string data;
+
+    if (send_output) {
+        if (result.success && !readFile(output_filename, data)) {
+            result.success = false;
+            result.error = "Failed to read output file";
+        }
+
+        boost::system::error_code error_code;
+        boost::filesystem::remove(output_filename, error_code);
+
+        result.output_filename = "-";
+    }
+
+    std::ostringstream response;
+
+    response << '{';
+    JobUtil::writeResult(response, result);
+
+    if (send_output && result.success) {
+        response << ",\"size\":" << data.size();
+    }
+
+    response << "}\n";
+
+    return connection.write(response.str()) &&
+           (data.empty() || connection.write(data));
+}
+
+//------------------------------------------------------------------------------
+
+// Runs the job on one of the worker threads, and waits for it to finish.
+
+JobUtil::Result JobServer::runJob(
+    const std::vector<std::string>& args,
+    const JobHandler& handler)
+{
+    std::packaged_task<JobUtil::Result()> task([this, &args, &handler] {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++active_count_;
+        }
+
+        JobUtil::Result result = JobUtil::runJob(args, handler);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        --active_count_;
+        ++job_count_;
+
+        if (!result.success) {
+            ++failed_count_;
+        }
+
+        return result;
+    });
+
+    std::future<JobUtil::Result> future = task.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+
+    job_available_.notify_one();
+
+    return future.get();
+}
+
+//------------------------------------------------------------------------------
+
+std::string JobServer::getStats()
+{
+    const std::chrono::duration<double> uptime =
+        std::chrono::steady_clock::now() - start_time_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::ostringstream stats;
+
+    stats << "{\"status\":\"ok\""
+          << ",\"workers\":" << workers_
+          << ",\"connections\":" << connections_.size()
+          << ",\"active\":" << active_count_
+          << ",\"queued\":" << queue_.size()
+          << ",\"jobs\":" << job_count_
+          << ",\"failed\":" << failed_count_
+          << ",\"uptime\":" << std::fixed << std::setprecision(3)
+          << uptime.count()
+          << "}\n";
+
+    return stats.str();
+}
+
+//------------------------------------------------------------------------------
+
+#endif // #if defined(_WIN32)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_JOB_SERVER_H)
+#define INC_JOB_SERVER_H
+
+//------------------------------------------------------------------------------
+
+#include "JobUtil.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// Runs jobs sent to a Unix domain socket on a fixed pool of worker threads,
+// so that each job avoids the cost of starting a new process.
+//
+// Each request is a line of text, and each response is a line of JSON:
+//
+//   run <options>  Runs a job with the given command line options, e.g.,
+//                  "run -i test.mp3 -o test.dat -b 8". If the job writes to
+//                  standard output (with --output-format and no output
+//                  filename, or "-o -"), the response gives the "size" of the
+//                  output, which follows the response line.
+//   health         Responds with {"status":"ok"}.
+//   stats          Responds with the number of connections and jobs.
+//   shutdown       Stops the server.
+//
+// A client can send any number of requests over one connection. Requests on
+// the same connection are handled in turn. Each connection is served on its
+// own thread, up to max_connections at a time. Further clients wait to be
+// accepted until a connection closes.
+//
+// The socket is created with permissions 0600, so only the user running the
+// server can connect, whatever the process umask.
+
+class JobServer
+{
+    public:
+        typedef JobUtil::Handler JobHandler;
+
+    public:
+        JobServer(
+            const std::string& socket_filename,
+            int workers,
+            JobHandler handler,
+            int max_connections = 64
+        );
+
+        ~JobServer();
+
+        JobServer(const JobServer&) = delete;
+        JobServer& operator=(const JobServer&) = delete;
+
+    public:
+        // Creates the socket. Returns false if this fails, or if another
+        // server is already using the socket.
+        bool listen();
+
+        // Handles connections until stop() is called or a shutdown request is
+        // received, then removes the socket.
+        void run();
+
+        void stop();
+
+    private:
+        class Connection;
+
+        void runWorker();
+        void serveConnection(int fd);
+
+        bool handleRequest(Connection& connection, const std::string& request);
+        bool handleRunRequest(Connection& connection, const std::string& command_line);
+
+        JobUtil::Result runJob(
+            const std::vector<std::string>& args,
+            const JobHandler& handler
+        );
+
+        std::string getStats();
+
+    private:
+        std::string socket_filename_;
+        int workers_;
+        JobHandler handler_;
+        size_t max_connections_;
+
+        int listen_fd_;
+        std::atomic<bool> stopping_;
+        std::chrono::steady_clock::time_point start_time_;
+
+        std::vector<std::thread> worker_threads_;
+
+        // The following are guarded by mutex_
+        std::mutex mutex_;
+
+        std::deque<std::packaged_task<JobUtil::Result()>> queue_;
+        std::condition_variable job_available_;
+        bool workers_stopping_;
+
+        std::set<int> connections_;
+        std::condition_variable connection_closed_;
+
+        int active_count_;
+        int job_count_;
+        int failed_count_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_JOB_SERVER_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,408 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "JobStats.h"
+#include "Config.h"
+#include "JobUtil.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <ostream>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+//------------------------------------------------------------------------------
+
+#if ENABLE_ALLOCATION_STATS
+
+// Counts all allocations made with operator new, so --stats can report them.
+// This replaces the global operator new and delete, so is only enabled in
+// builds configured with ENABLE_ALLOCATION_STATS=1, as it would hide
+// mismatched allocations from tools such as AddressSanitizer and valgrind.
+
+static std::atomic<long long> allocations_(0);
+static std::atomic<long long> allocated_bytes_(0);
+
+static void* allocate(std::size_t size)
+{
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes_.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size)
+{
+    void* ptr = allocate(size);
+
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* ptr = allocate(size);
+
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+#if defined(__cpp_sized_deallocation)
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
+
+static long long getAllocations()
+{
+    return allocations_.load(std::memory_order_relaxed);
+}
+
+static long long getAllocatedBytes()
+{
+    return allocated_bytes_.load(std::memory_order_relaxed);
+}
+
+#else
+
+static long long getAllocations()
+{
+    return 0;
+}
+
+static long long getAllocatedBytes()
+{
+    return 0;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+static double getThreadCpuTime()
+{
+#if defined(_WIN32)
+    return 0.0;
+#else
+    timespec time;
+
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+        return 0.0;
+    }
+
+    return static_cast<double>(time.tv_sec) +
+           static_cast<double>(time.tv_nsec) / 1e9;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+static double getProcessCpuTime()
+{
+#if defined(_WIN32)
+    return 0.0;
+#else
+    rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the peak resident set size of the process, in bytes.
+
+static long long getPeakMemory()
+{
+#if defined(_WIN32)
+    return 0;
+#else
+    rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+
+#if defined(__APPLE__)
+    return static_cast<long long>(usage.ru_maxrss);
+#else
+    // Linux gives the size in kilobytes
+    return static_cast<long long>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+static thread_local JobStats* thread_stats_ = nullptr;
+
+//------------------------------------------------------------------------------
+
+JobStats::JobStats() :
+    start_time_(now()),
+    start_process_cpu_time_(getProcessCpuTime()),
+    start_allocations_(getAllocations()),
+    start_allocated_bytes_(getAllocatedBytes()),
+    frames_(0)
+{
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        stage_times_[i].wall = 0.0;
+        stage_times_[i].cpu  = 0.0;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void JobStats::setThreadStats(JobStats* stats)
+{
+    thread_stats_ = stats;
+}
+
+//------------------------------------------------------------------------------
+
+JobStats* JobStats::getThreadStats()
+{
+    return thread_stats_;
+}
+
+//------------------------------------------------------------------------------
+
+JobStats::Time JobStats::now()
+{
+    const auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+
+    Time time;
+
+    time.wall = std::chrono::duration<double>(elapsed).count();
+    time.cpu  = getThreadCpuTime();
+
+    return time;
+}
+
+//------------------------------------------------------------------------------
+
+void JobStats::addTime(const Stage stage, const Time& time)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    stage_times_[stage].wall += time.wall;
+    stage_times_[stage].cpu  += time.cpu;
+}
+
+//------------------------------------------------------------------------------
+
+void JobStats::addFrames(const long long frames)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    frames_ += frames;
+}
+
+//------------------------------------------------------------------------------
+
+static const char* getStageName(const JobStats::Stage stage)
+{
+    switch (stage) {
+        case JobStats::Open:
+            return "open";
+
+        case JobStats::Decode:
+            return "decode";
+
+        case JobStats::Process:
+            return "process";
+
+        case JobStats::Rescale:
+            return "rescale";
+
+        case JobStats::Render:
+            return "render";
+
+        case JobStats::Encode:
+            return "encode";
+
+        case JobStats::Write:
+        default:
+            return "write";
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void JobStats::write(
+    std::ostream& stream,
+    const std::string& input_filename,
+    const std::string& output_filename,
+    const long long input_bytes,
+    const long long output_bytes,
+    const bool success)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const Time end_time = now();
+
+    const double wall_time = end_time.wall - start_time_.wall;
+    const double cpu_time  = getProcessCpuTime() - start_process_cpu_time_;
+
+    const double frames_per_second = wall_time > 0.0 ?
+        static_cast<double>(frames_) / wall_time : 0.0;
+
+    // Written to a string first, so the record is written to the stream in
+    // one piece
+    std::ostringstream record;
+
+    record << std::fixed << std::setprecision(6)
+           << "{\"input\":\"" << JobUtil::escapeJson(input_filename) << "\""
+           << ",\"output\":\"" << JobUtil::escapeJson(output_filename) << "\""
+           << ",\"status\":\"" << (success ? "ok" : "error") << "\""
+           << ",\"wall_time\":" << wall_time
+           << ",\"cpu_time\":" << cpu_time
+           << ",\"stages\":{";
+
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        if (i > 0) {
+            record << ',';
+        }
+
+        record << '"' << getStageName(static_cast<Stage>(i)) << "\":"
+               << "{\"wall_time\":" << stage_times_[i].wall
+               << ",\"cpu_time\":" << stage_times_[i].cpu << '}';
+    }
+
+    record << "},\"frames\":" << frames_
+           << std::setprecision(1)
+           << ",\"frames_per_second\":" << frames_per_second
+           << ",\"input_bytes\":" << input_bytes
+           << ",\"output_bytes\":" << output_bytes
+           << ",\"peak_memory\":" << getPeakMemory();
+
+#if ENABLE_ALLOCATION_STATS
+    record << ",\"allocations\":" << getAllocations() - start_allocations_
+           << ",\"allocated_bytes\":" << getAllocatedBytes() - start_allocated_bytes_;
+#endif
+
+    record << "}\n";
+
+    stream << record.str() << std::flush;
+}
+
+//------------------------------------------------------------------------------
+
+StageTimer::StageTimer(const JobStats::Stage stage) :
+    stats_(JobStats::getThreadStats()),
+    stage_(stage)
+{
+    excluded_.wall = 0.0;
+    excluded_.cpu  = 0.0;
+
+    if (stats_ != nullptr) {
+        start_ = JobStats::now();
+    }
+    else {
+        start_ = excluded_;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+StageTimer::~StageTimer()
+{
+    if (stats_ != nullptr) {
+        const JobStats::Time end = JobStats::now();
+
+        JobStats::Time time;
+
+        time.wall = end.wall - start_.wall - excluded_.wall;
+        time.cpu  = end.cpu  - start_.cpu  - excluded_.cpu;
+
+        // Measurements of separate stages may not add up exactly
+        time.wall = time.wall < 0.0 ? 0.0 : time.wall;
+        time.cpu  = time.cpu  < 0.0 ? 0.0 : time.cpu;
+
+        stats_->addTime(stage_, time);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void StageTimer::exclude(const JobStats::Time& time)
+{
+    excluded_.wall += time.wall;
+    excluded_.cpu  += time.cpu;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_JOB_STATS_H)
+#define INC_JOB_STATS_H
+
+//------------------------------------------------------------------------------
+
+#include <iosfwd>
+#include <mutex>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+// Records the time spent in each stage of a job, for the --stats option.
+//
+// The JobStats for a job is set for the thread that runs the job, and code
+// that does the work of each stage measures it with a StageTimer. If no
+// JobStats is set, nothing is measured.
+//
+// Stage times are added up over all the threads that run each stage, e.g.,
+// with --threads, so may be more than the elapsed time of the job. The total
+// CPU time, peak memory use, and allocation counts are for the whole process,
+// so in batch or server mode include any other jobs running at the same time.
+
+class JobStats
+{
+    public:
+        enum Stage {
+            Open,    // Opening the input file
+            Decode,  // Reading audio or waveform data
+            Process, // AudioProcessor::process(), e.g., WaveformGenerator
+            Rescale,
+            Render,  // Drawing images
+            Encode,  // Encoding and writing images
+            Write,   // Writing waveform data
+            STAGE_COUNT
+        };
+
+        struct Time
+        {
+            double wall; // seconds
+            double cpu;  // seconds
+        };
+
+    public:
+        JobStats();
+
+        JobStats(const JobStats&) = delete;
+        JobStats& operator=(const JobStats&) = delete;
+
+    public:
+        // Sets the JobStats that StageTimers on the calling thread record to,
+        // or nullptr to stop recording.
+        static void setThreadStats(JobStats* stats);
+        static JobStats* getThreadStats();
+
+        // Returns the elapsed time, and the CPU time used by the calling
+        // thread.
+        static Time now();
+
+        // These may be called from any thread.
+        void addTime(Stage stage, const Time& time);
+        void addFrames(long long frames);
+
+        // Ends the job, and writes the results as a single line of JSON.
+        void write(
+            std::ostream& stream,
+            const std::string& input_filename,
+            const std::string& output_filename,
+            long long input_bytes,
+            long long output_bytes,
+            bool success
+        );
+
+    private:
+        Time start_time_;
+        double start_process_cpu_time_;
+        long long start_allocations_;
+        long long start_allocated_bytes_;
+
+        std::mutex mutex_;
+
+        Time stage_times_[STAGE_COUNT];
+
+        long long frames_;
+};
+
+//------------------------------------------------------------------------------
+
+// Adds the time from construction to destruction to the given stage of the
+// calling thread's JobStats, if any.
+
+class StageTimer
+{
+    public:
+        explicit StageTimer(JobStats::Stage stage);
+        ~StageTimer();
+
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+    public:
+        // Subtracts time that is recorded as another stage.
+        void exclude(const JobStats::Time& time);
+
+    private:
+        JobStats* stats_;
+        JobStats::Stage stage_;
+        JobStats::Time start_;
+        JobStats::Time excluded_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_JOB_STATS_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "JobUtil.h"
+#include "FileUtil.h"
+#include "Log.h"
+#include "Options.h"
+
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+//------------------------------------------------------------------------------
+
+namespace JobUtil {
+
+//------------------------------------------------------------------------------
+
+Result::Result() :
+    parsed(false),
+    success(false),
+    seconds(0.0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+static std::string trimNewlines(std::string value)
+{
+    while (!value.empty() && (value.back() == '\n' || value.back() == '\r')) {
+        value.pop_back();
+    }
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+
+// Jobs run alongside each other, so can't use stdin or stdout.
+
+static bool validateOptions(const Options& options)
+{
+    if (options.getHelp() || options.getVersion() ||
+        !options.getBatchFilename().empty() ||
+        !options.getServeFilename().empty()) {
+        log(Error) << "Invalid job: --help, --version, --batch, and --serve are not allowed\n";
+        return false;
+    }
+
+    if (!options.getTraceFilename().empty()) {
+        log(Error) << "Invalid job: --trace is not allowed, use it with --batch or --serve instead\n";
+        return false;
+    }
+
+    bool stdio = FileUtil::isStdioFilename(options.getInputFilename().c_str());
+
+    for (const auto& output_file : options.getOutputFiles()) {
+        if (FileUtil::isStdioFilename(output_file.filename.c_str())) {
+            stdio = true;
+        }
+    }
+
+    if (stdio) {
+        log(Error) << "Invalid job: input and output must be files\n";
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+static bool parseAndRun(
+    const std::vector<std::string>& args,
+    const Handler& handler,
+    Result& result)
+{
+    std::vector<const char*> argv;
+    argv.push_back("audiowaveform");
+
+    for (const auto& arg : args) {
+        argv.push_back(arg.c_str());
+    }
+
+    Options options;
+
+    if (!options.parseCommandLine(static_cast<int>(argv.size()), argv.data())) {
+        return false;
+    }
+
+    result.parsed = true;
+    result.input_filename  = options.getInputFilename().string();
+    result.output_filename = options.getOutputFilename().string();
+
+    return validateOptions(options) && handler(options);
+}
+
+//------------------------------------------------------------------------------
+
+Result runJob(const std::vector<std::string>& args, const Handler& handler)
+{
+    const auto start_time = std::chrono::steady_clock::now();
+
+    // Errors from the job are logged to this stream, so they can be included
+    // in the result. Other messages are discarded.
+    std::ostringstream errors;
+    setThreadErrorStream(&errors);
+
+    Result result;
+
+    try {
+        result.success = parseAndRun(args, handler, result);
+    }
+    catch (const std::exception& e) {
+        log(Error) << e.what() << '\n';
+        result.success = false;
+    }
+
+    setThreadErrorStream(nullptr);
+
+    const std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start_time;
+
+    result.seconds = duration.count();
+
+    if (!result.success) {
+        result.error = trimNewlines(errors.str());
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+Result runJob(const std::string& command_line, const Handler& handler)
+{
+    std::vector<std::string> args;
+
+    try {
+        args = boost::program_options::split_unix(command_line);
+    }
+    catch (const std::exception& e) {
+        // e.g., an unmatched quote
+        Result result;
+        result.error = e.what();
+        return result;
+    }
+
+    return runJob(args, handler);
+}
+
+//------------------------------------------------------------------------------
+
+void writeResult(std::ostream& stream, const Result& result)
+{
+    if (result.parsed) {
+        stream << "\"input\":\"" << escapeJson(result.input_filename) << "\","
+               << "\"output\":\"" << escapeJson(result.output_filename) << "\",";
+    }
+
+    stream << "\"status\":\"" << (result.success ? "ok" : "error") << '"'
+           << ",\"seconds\":" << std::fixed << std::setprecision(3)
+           << result.seconds;
+
+    if (!result.success) {
+        stream << ",\"error\":\"" << escapeJson(result.error) << '"';
+    }
+}
+
+//------------------------------------------------------------------------------
+
+std::string escapeJson(const std::string& value)
+{
+    std::ostringstream stream;
+
+    for (const char c : value) {
+        switch (c) {
+            case '"':  stream << "\\\""; break;
+            case '\\': stream << "\\\\"; break;
+            case '\n': stream << "\\n"; break;
+            case '\r': stream << "\\r"; break;
+            case '\t': stream << "\\t"; break;
+
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    stream << "\\u"
+                           << std::hex << std::setw(4) << std::setfill('0')
+                           << static_cast<int>(c)
+                           << std::dec;
+                }
+                else {
+                    stream << c;
+                }
+                break;
+        }
+    }
+
+    return stream.str();
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace JobUtil
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_JOB_UTIL_H)
+#define INC_JOB_UTIL_H
+
+//------------------------------------------------------------------------------
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+class Options;
+
+//------------------------------------------------------------------------------
+
+// Functions for running jobs given as command line options, as used by the
+// --batch and --serve modes.
+
+namespace JobUtil {
+    typedef std::function<bool(const Options&)> Handler;
+
+    struct Result
+    {
+        Result();
+
+        // True if the job's options were valid, in which case the input and
+        // output filenames are set
+        bool parsed;
+
+        std::string input_filename;
+        std::string output_filename;
+
+        bool success;
+        double seconds;
+
+        // Errors logged by the job
+        std::string error;
+    };
+
+    // Parses the job's options and, if they're valid, runs the job with the
+    // given handler. Errors logged by the job on the calling thread are
+    // returned in the result, instead of being written to the error stream.
+    Result runJob(const std::string& command_line, const Handler& handler);
+    Result runJob(const std::vector<std::string>& args, const Handler& handler);
+
+    // Writes the result as JSON object members, without enclosing braces.
+    void writeResult(std::ostream& stream, const Result& result);
+
+    std::string escapeJson(const std::string& value);
+}
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_JOB_UTIL_H)
+
+//------------------------------------------------------------------------------
@@ -37,14 +37,21 @@ class NullStreamBuf : public std::streambuf
         }
 };
 
-static NullStreamBuf null_streambuf;
+// These are thread local so that threads discarding log output don't share
+// stream state.
 
-static std::ostream null_stream(&null_streambuf);
+static thread_local NullStreamBuf null_streambuf;
+
+static thread_local std::ostream null_stream(&null_streambuf);
 
 //------------------------------------------------------------------------------
 
+// Set only from the main thread, before any other threads are started. Batch
+// and server mode jobs don't change it.
 static bool quiet_ = false;
 
+static thread_local std::ostream* thread_error_stream_ = nullptr;
+
 //------------------------------------------------------------------------------
 
 void setLogLevel(bool quiet)
@@ -54,8 +61,19 @@ void setLogLevel(bool quiet)
 
 //------------------------------------------------------------------------------
 
+void setThreadErrorStream(std::ostream* stream)
+{
+    thread_error_stream_ = stream;
+}
+
+//------------------------------------------------------------------------------
+
 std::ostream& log(LogLevel level)
 {
+    if (thread_error_stream_ != nullptr) {
+        return level == Error ? *thread_error_stream_ : null_stream;
+    }
+
     switch (level) {
         case Error:
             return error_stream;
@@ -37,6 +37,11 @@ enum LogLevel {
 
 void setLogLevel(bool quiet);
 
+// Sends error messages logged from the calling thread to the given stream,
+// and discards all other messages, until called again with nullptr. This
+// allows worker threads to log errors for the main thread to report.
+void setThreadErrorStream(std::ostream* stream);
+
 std::ostream& log(LogLevel level);
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "MappedFile.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------
+
+MappedFile::MappedFile() :
+    data_(nullptr),
+    size_(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+//------------------------------------------------------------------------------
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const char* /* filename */)
+{
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+void MappedFile::close()
+{
+}
+
+//------------------------------------------------------------------------------
+
+#else
+
+bool MappedFile::open(const char* filename)
+{
+    close();
+
+    const int fd = ::open(filename, O_RDONLY);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat stat_buf;
+
+    if (fstat(fd, &stat_buf) != 0 ||
+        !S_ISREG(stat_buf.st_mode) ||
+        stat_buf.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(stat_buf.st_size);
+
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping remains valid after the file is closed
+    ::close(fd);
+
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+#if defined(POSIX_MADV_SEQUENTIAL)
+    posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+    data_ = static_cast<const unsigned char*>(data);
+    size_ = size;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void MappedFile::close()
+{
+    if (data_ != nullptr) {
+        munmap(const_cast<unsigned char*>(data_), size_);
+
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+#endif
+
+//------------------------------------------------------------------------------
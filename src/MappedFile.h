@@ -1,8 +1,6 @@
 //------------------------------------------------------------------------------
 //
-// Copyright 2022 BBC Research and Development
-//
-// Author: Chris Needham
+// Copyright 2026 BBC Research and Development
 //
 // This file is part of Audio Waveform Image Generator.
 //
@@ -21,52 +19,44 @@
 //
 //------------------------------------------------------------------------------
 
-#if !defined(INC_AUDIO_LOADER_H)
-#define INC_AUDIO_LOADER_H
+#if !defined(INC_MAPPED_FILE_H)
+#define INC_MAPPED_FILE_H
 
 //------------------------------------------------------------------------------
 
-#include "AudioProcessor.h"
-
-#include <vector>
+#include <cstddef>
 
 //------------------------------------------------------------------------------
 
-class AudioLoader : public AudioProcessor
+// Maps a regular file into memory, read only.
+//
+// open() returns false, without logging an error, if the file can't be
+// mapped, e.g., if it's empty, not a regular file, or memory mapping isn't
+// supported, so callers can read the file another way instead.
+
+class MappedFile
 {
     public:
-        AudioLoader();
+        MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
 
-        virtual bool init(
-            int sample_rate,
-            int channels,
-            long frame_count,
-            int buffer_size
-        );
+        ~MappedFile();
 
-        virtual bool shouldContinue() const;
-
-        virtual bool process(
-            const short* input_buffer,
-            int input_frame_count
-        );
-
-        virtual void done();
-
-        double getDuration() const;
+    public:
+        bool open(const char* filename);
+        void close();
 
-        const std::vector<short>& getData() const { return audio_samples_; }
-        int getSampleRate() const { return sample_rate_; }
-        int getChannels() const { return channels_; }
+        const unsigned char* getData() const { return data_; }
+        size_t getSize() const { return size_; }
 
     private:
-        int sample_rate_;
-        int channels_;
-        std::vector<short> audio_samples_;
+        const unsigned char* data_;
+        size_t size_;
 };
 
 //------------------------------------------------------------------------------
 
-#endif // #if !defined(INC_AUDIO_LOADER_H)
+#endif // #if !defined(INC_MAPPED_FILE_H)
 
 //------------------------------------------------------------------------------
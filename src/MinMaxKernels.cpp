@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "MinMaxKernels.h"
+
+//------------------------------------------------------------------------------
+
+namespace MinMaxKernels {
+
+//------------------------------------------------------------------------------
+
+// Sum samples from each input channel to make a single (mono) waveform.
+// See BlockFile::CalcSummary in Audacity.
+
+void mixScalar(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int low  = min[0];
+    int high = max[0];
+
+    for (int i = 0; i < frames; ++i) {
+        int sample = 0;
+
+        for (int channel = 0; channel < channels; ++channel) {
+            sample += input[channel];
+        }
+
+        // The average of short values always fits in a short, so no
+        // clamping is needed here.
+        sample /= channels;
+
+        if (sample < low) {
+            low = sample;
+        }
+
+        if (sample > high) {
+            high = sample;
+        }
+
+        input += channels;
+    }
+
+    min[0] = low;
+    max[0] = high;
+}
+
+//------------------------------------------------------------------------------
+
+void splitScalar(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    for (int i = 0; i < frames; ++i) {
+        for (int channel = 0; channel < channels; ++channel) {
+            const int sample = input[channel];
+
+            if (sample < min[channel]) {
+                min[channel] = sample;
+            }
+
+            if (sample > max[channel]) {
+                max[channel] = sample;
+            }
+        }
+
+        input += channels;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void mixFloat(
+    const float* input,
+    const int frames,
+    const int channels,
+    float* min,
+    float* max)
+{
+    float low  = min[0];
+    float high = max[0];
+
+    const float scale = 1.0f / static_cast<float>(channels);
+
+    for (int i = 0; i < frames; ++i) {
+        float sample = 0.0f;
+
+        for (int channel = 0; channel < channels; ++channel) {
+            sample += input[channel];
+        }
+
+        sample *= scale;
+
+        low  = sample < low  ? sample : low;
+        high = sample > high ? sample : high;
+
+        input += channels;
+    }
+
+    min[0] = low;
+    max[0] = high;
+}
+
+//------------------------------------------------------------------------------
+
+void splitFloat(
+    const float* input,
+    const int frames,
+    const int channels,
+    float* min,
+    float* max)
+{
+    for (int i = 0; i < frames; ++i) {
+        for (int channel = 0; channel < channels; ++channel) {
+            const float sample = input[channel];
+
+            min[channel] = sample < min[channel] ? sample : min[channel];
+            max[channel] = sample > max[channel] ? sample : max[channel];
+        }
+
+        input += channels;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+FloatKernel selectFloatKernel(const bool split_channels)
+{
+    return split_channels ? splitFloat : mixFloat;
+}
+
+//------------------------------------------------------------------------------
+
+const KernelSet& getScalarKernelSet()
+{
+    static const KernelSet kernel_set = {
+        "scalar",
+        splitScalar,
+        mixScalar,
+        splitScalar,
+        mixScalar,
+        splitScalar
+    };
+
+    return kernel_set;
+}
+
+//------------------------------------------------------------------------------
+
+static const KernelSet& selectKernelSet()
+{
+    const KernelSet* kernel_set = getAvx2KernelSet();
+
+    if (kernel_set == nullptr) {
+        kernel_set = getSse2KernelSet();
+    }
+
+    if (kernel_set == nullptr) {
+        kernel_set = getNeonKernelSet();
+    }
+
+    if (kernel_set == nullptr) {
+        kernel_set = &getScalarKernelSet();
+    }
+
+    return *kernel_set;
+}
+
+//------------------------------------------------------------------------------
+
+const KernelSet& getKernelSet()
+{
+    static const KernelSet& kernel_set = selectKernelSet();
+
+    return kernel_set;
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<const KernelSet*> getSupportedKernelSets()
+{
+    std::vector<const KernelSet*> kernel_sets;
+
+    kernel_sets.push_back(&getScalarKernelSet());
+
+    const KernelSet* candidates[] = {
+        getSse2KernelSet(),
+        getAvx2KernelSet(),
+        getNeonKernelSet()
+    };
+
+    for (const KernelSet* kernel_set : candidates) {
+        if (kernel_set != nullptr) {
+            kernel_sets.push_back(kernel_set);
+        }
+    }
+
+    return kernel_sets;
+}
+
+//------------------------------------------------------------------------------
+
+Kernel selectKernel(
+    const KernelSet& kernel_set,
+    const int channels,
+    const bool split_channels)
+{
+    if (channels == 1) {
+        return kernel_set.mono;
+    }
+    else if (channels == 2) {
+        return split_channels ? kernel_set.stereo_split : kernel_set.stereo_mix;
+    }
+    else {
+        return split_channels ? kernel_set.multi_split : kernel_set.multi_mix;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace MinMaxKernels
+
+//------------------------------------------------------------------------------
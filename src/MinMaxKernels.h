@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_MIN_MAX_KERNELS_H)
+#define INC_MIN_MAX_KERNELS_H
+
+//------------------------------------------------------------------------------
+
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// Functions that update running minimum and maximum values from a run of
+// interleaved 16-bit audio frames. Each function reads frames * channels
+// samples from input, and updates min[channel] and max[channel] for each
+// output channel: one channel when mixing down to mono, or one per input
+// channel when splitting channels.
+//
+// Mono downmix computes (sum of samples) / channels for each frame, with
+// integer division truncating towards zero. All implementations give
+// identical results.
+
+namespace MinMaxKernels {
+    typedef void (*Kernel)(
+        const short* input,
+        int frames,
+        int channels,
+        int* min,
+        int* max
+    );
+
+    struct KernelSet
+    {
+        const char* name;
+
+        Kernel mono;         // 1 input channel
+        Kernel stereo_mix;   // 2 input channels, mixed to 1 output channel
+        Kernel stereo_split; // 2 input channels, 2 output channels
+        Kernel multi_mix;    // N input channels, mixed to 1 output channel
+        Kernel multi_split;  // N input channels, N output channels
+    };
+
+    // Returns the fastest kernel set supported by the CPU.
+    const KernelSet& getKernelSet();
+
+    // Returns all kernel sets supported by the CPU, starting with the
+    // portable scalar implementation.
+    std::vector<const KernelSet*> getSupportedKernelSets();
+
+    Kernel selectKernel(
+        const KernelSet& kernel_set,
+        int channels,
+        bool split_channels
+    );
+
+    // Portable implementations, also used by the vectorised kernels to
+    // process any frames left over after the last full vector.
+    void mixScalar(
+        const short* input,
+        int frames,
+        int channels,
+        int* min,
+        int* max
+    );
+
+    void splitScalar(
+        const short* input,
+        int frames,
+        int channels,
+        int* min,
+        int* max
+    );
+
+    const KernelSet& getScalarKernelSet();
+
+    // Floating point versions, used for floating point audio, so that the
+    // samples are only converted to 16-bit once per output point.
+    typedef void (*FloatKernel)(
+        const float* input,
+        int frames,
+        int channels,
+        float* min,
+        float* max
+    );
+
+    void mixFloat(
+        const float* input,
+        int frames,
+        int channels,
+        float* min,
+        float* max
+    );
+
+    void splitFloat(
+        const float* input,
+        int frames,
+        int channels,
+        float* min,
+        float* max
+    );
+
+    FloatKernel selectFloatKernel(bool split_channels);
+
+    // Implementations, defined in the architecture specific source files.
+    // These return nullptr if not supported by the compiler or the CPU.
+    const KernelSet* getSse2KernelSet();
+    const KernelSet* getAvx2KernelSet();
+    const KernelSet* getNeonKernelSet();
+}
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_MIN_MAX_KERNELS_H)
+
+//------------------------------------------------------------------------------
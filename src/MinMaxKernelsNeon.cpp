@@ -0,0 +1,328 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+// NEON implementations of the functions in MinMaxKernels.h. NEON is always
+// available on AArch64, so no runtime check is needed.
+
+#include "MinMaxKernels.h"
+#include "WaveformBuffer.h"
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define MIN_MAX_KERNELS_NEON
+#endif
+
+#if defined(MIN_MAX_KERNELS_NEON)
+#include <arm_neon.h>
+#endif
+
+//------------------------------------------------------------------------------
+
+namespace MinMaxKernels {
+
+//------------------------------------------------------------------------------
+
+#if defined(MIN_MAX_KERNELS_NEON)
+
+//------------------------------------------------------------------------------
+
+const int MAX_CHANNELS = WaveformBuffer::MAX_CHANNELS;
+
+//------------------------------------------------------------------------------
+
+// Returns (a + b) / 2, rounding towards zero to match integer division.
+
+static inline int32x4_t average(int32x4_t sum)
+{
+    const uint32x4_t sign = vshrq_n_u32(vreinterpretq_u32_s32(sum), 31);
+
+    return vshrq_n_s32(vaddq_s32(sum, vreinterpretq_s32_u32(sign)), 1);
+}
+
+//------------------------------------------------------------------------------
+
+static void monoNeon(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8) {
+        int16x8_t min_value = vdupq_n_s16(static_cast<short>(min[0]));
+        int16x8_t max_value = vdupq_n_s16(static_cast<short>(max[0]));
+
+        for (; i + 16 <= frames; i += 16) {
+            const int16x8_t a = vld1q_s16(input + i);
+            const int16x8_t b = vld1q_s16(input + i + 8);
+
+            min_value = vminq_s16(min_value, vminq_s16(a, b));
+            max_value = vmaxq_s16(max_value, vmaxq_s16(a, b));
+        }
+
+        for (; i + 8 <= frames; i += 8) {
+            const int16x8_t a = vld1q_s16(input + i);
+
+            min_value = vminq_s16(min_value, a);
+            max_value = vmaxq_s16(max_value, a);
+        }
+
+        min[0] = vminvq_s16(min_value);
+        max[0] = vmaxvq_s16(max_value);
+    }
+
+    splitScalar(input + i, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+static void stereoMixNeon(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8) {
+        int32x4_t min_value = vdupq_n_s32(min[0]);
+        int32x4_t max_value = vdupq_n_s32(max[0]);
+
+        for (; i + 8 <= frames; i += 8) {
+            // Load 8 frames, de-interleaving left and right channels
+            const int16x8x2_t samples = vld2q_s16(input + i * 2);
+
+            const int32x4_t a = average(vaddl_s16(
+                vget_low_s16(samples.val[0]),
+                vget_low_s16(samples.val[1])
+            ));
+
+            const int32x4_t b = average(vaddl_high_s16(
+                samples.val[0],
+                samples.val[1]
+            ));
+
+            min_value = vminq_s32(min_value, vminq_s32(a, b));
+            max_value = vmaxq_s32(max_value, vmaxq_s32(a, b));
+        }
+
+        min[0] = vminvq_s32(min_value);
+        max[0] = vmaxvq_s32(max_value);
+    }
+
+    mixScalar(input + i * 2, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+static void stereoSplitNeon(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8) {
+        int16x8_t left_min  = vdupq_n_s16(static_cast<short>(min[0]));
+        int16x8_t left_max  = vdupq_n_s16(static_cast<short>(max[0]));
+        int16x8_t right_min = vdupq_n_s16(static_cast<short>(min[1]));
+        int16x8_t right_max = vdupq_n_s16(static_cast<short>(max[1]));
+
+        for (; i + 8 <= frames; i += 8) {
+            const int16x8x2_t samples = vld2q_s16(input + i * 2);
+
+            left_min  = vminq_s16(left_min,  samples.val[0]);
+            left_max  = vmaxq_s16(left_max,  samples.val[0]);
+            right_min = vminq_s16(right_min, samples.val[1]);
+            right_max = vmaxq_s16(right_max, samples.val[1]);
+        }
+
+        min[0] = vminvq_s16(left_min);
+        max[0] = vmaxvq_s16(left_max);
+        min[1] = vminvq_s16(right_min);
+        max[1] = vmaxvq_s16(right_max);
+    }
+
+    splitScalar(input + i * 2, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+// See the comment on multiMixSse2() in MinMaxKernelsX86.cpp regarding
+// floating point division.
+
+static void multiMixNeon(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8 && channels <= MAX_CHANNELS) {
+        int32x4_t min_value = vdupq_n_s32(min[0]);
+        int32x4_t max_value = vdupq_n_s32(max[0]);
+
+        const float32x4_t divisor = vdupq_n_f32(static_cast<float>(channels));
+
+        int sums[4];
+
+        for (; i + 4 <= frames; i += 4) {
+            const short* p = input + i * channels;
+
+            for (int j = 0; j < 4; ++j) {
+                int sum = 0;
+
+                for (int channel = 0; channel < channels; ++channel) {
+                    sum += p[channel];
+                }
+
+                sums[j] = sum;
+                p += channels;
+            }
+
+            const int32x4_t value = vcvtq_s32_f32(
+                vdivq_f32(vcvtq_f32_s32(vld1q_s32(sums)), divisor)
+            );
+
+            min_value = vminq_s32(min_value, value);
+            max_value = vmaxq_s32(max_value, value);
+        }
+
+        min[0] = vminvq_s32(min_value);
+        max[0] = vmaxvq_s32(max_value);
+    }
+
+    mixScalar(input + i * channels, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+// Each group of 8 frames occupies exactly channels vectors, and lane j of
+// vector k always holds a sample from channel (8 * k + j) % channels.
+
+static void multiSplitNeon(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8 && channels <= MAX_CHANNELS) {
+        int16x8_t min_values[MAX_CHANNELS];
+        int16x8_t max_values[MAX_CHANNELS];
+
+        short lanes[8];
+
+        for (int k = 0; k < channels; ++k) {
+            for (int j = 0; j < 8; ++j) {
+                lanes[j] = static_cast<short>(min[(8 * k + j) % channels]);
+            }
+
+            min_values[k] = vld1q_s16(lanes);
+
+            for (int j = 0; j < 8; ++j) {
+                lanes[j] = static_cast<short>(max[(8 * k + j) % channels]);
+            }
+
+            max_values[k] = vld1q_s16(lanes);
+        }
+
+        for (; i + 8 <= frames; i += 8) {
+            const short* p = input + i * channels;
+
+            for (int k = 0; k < channels; ++k) {
+                const int16x8_t value = vld1q_s16(p + 8 * k);
+
+                min_values[k] = vminq_s16(min_values[k], value);
+                max_values[k] = vmaxq_s16(max_values[k], value);
+            }
+        }
+
+        for (int k = 0; k < channels; ++k) {
+            vst1q_s16(lanes, min_values[k]);
+
+            for (int j = 0; j < 8; ++j) {
+                const int channel = (8 * k + j) % channels;
+
+                if (lanes[j] < min[channel]) {
+                    min[channel] = lanes[j];
+                }
+            }
+
+            vst1q_s16(lanes, max_values[k]);
+
+            for (int j = 0; j < 8; ++j) {
+                const int channel = (8 * k + j) % channels;
+
+                if (lanes[j] > max[channel]) {
+                    max[channel] = lanes[j];
+                }
+            }
+        }
+    }
+
+    splitScalar(input + i * channels, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+const KernelSet* getNeonKernelSet()
+{
+    static const KernelSet kernel_set = {
+        "neon",
+        monoNeon,
+        stereoMixNeon,
+        stereoSplitNeon,
+        multiMixNeon,
+        multiSplitNeon
+    };
+
+    return &kernel_set;
+}
+
+//------------------------------------------------------------------------------
+
+#else
+
+//------------------------------------------------------------------------------
+
+const KernelSet* getNeonKernelSet()
+{
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+#endif // #if defined(MIN_MAX_KERNELS_NEON)
+
+//------------------------------------------------------------------------------
+
+} // namespace MinMaxKernels
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,764 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+// SSE2 and AVX2 implementations of the functions in MinMaxKernels.h.
+//
+// The functions are compiled using target attributes rather than compiler
+// flags, so that the rest of the program doesn't require these instruction
+// sets, and the CPU is checked at runtime before they're used.
+
+#include "MinMaxKernels.h"
+#include "WaveformBuffer.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MIN_MAX_KERNELS_X86
+#endif
+
+#if defined(MIN_MAX_KERNELS_X86)
+
+#include <immintrin.h>
+
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+
+#endif
+
+//------------------------------------------------------------------------------
+
+namespace MinMaxKernels {
+
+//------------------------------------------------------------------------------
+
+#if defined(MIN_MAX_KERNELS_X86)
+
+//------------------------------------------------------------------------------
+
+const int MAX_CHANNELS = WaveformBuffer::MAX_CHANNELS;
+
+//------------------------------------------------------------------------------
+
+TARGET_SSE2
+static inline short horizontalMinSse2(__m128i value)
+{
+    value = _mm_min_epi16(value, _mm_srli_si128(value, 8));
+    value = _mm_min_epi16(value, _mm_srli_si128(value, 4));
+    value = _mm_min_epi16(value, _mm_srli_si128(value, 2));
+
+    return static_cast<short>(_mm_cvtsi128_si32(value));
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_SSE2
+static inline short horizontalMaxSse2(__m128i value)
+{
+    value = _mm_max_epi16(value, _mm_srli_si128(value, 8));
+    value = _mm_max_epi16(value, _mm_srli_si128(value, 4));
+    value = _mm_max_epi16(value, _mm_srli_si128(value, 2));
+
+    return static_cast<short>(_mm_cvtsi128_si32(value));
+}
+
+//------------------------------------------------------------------------------
+
+// Returns a vector containing a, b, a, b, ...
+
+TARGET_SSE2
+static inline __m128i interleaveSse2(int a, int b)
+{
+    return _mm_unpacklo_epi16(
+        _mm_set1_epi16(static_cast<short>(a)),
+        _mm_set1_epi16(static_cast<short>(b))
+    );
+}
+
+//------------------------------------------------------------------------------
+
+// Returns (a + b) / 2 for each pair of adjacent 16-bit values, as 32-bit
+// values, rounding towards zero to match integer division.
+
+TARGET_SSE2
+static inline __m128i averagePairsSse2(__m128i value)
+{
+    const __m128i sum = _mm_madd_epi16(value, _mm_set1_epi16(1));
+
+    return _mm_srai_epi32(_mm_add_epi32(sum, _mm_srli_epi32(sum, 31)), 1);
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_SSE2
+static void monoSse2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8) {
+        __m128i min_value = _mm_set1_epi16(static_cast<short>(min[0]));
+        __m128i max_value = _mm_set1_epi16(static_cast<short>(max[0]));
+
+        for (; i + 16 <= frames; i += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+
+            min_value = _mm_min_epi16(min_value, _mm_min_epi16(a, b));
+            max_value = _mm_max_epi16(max_value, _mm_max_epi16(a, b));
+        }
+
+        for (; i + 8 <= frames; i += 8) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+            min_value = _mm_min_epi16(min_value, a);
+            max_value = _mm_max_epi16(max_value, a);
+        }
+
+        min[0] = horizontalMinSse2(min_value);
+        max[0] = horizontalMaxSse2(max_value);
+    }
+
+    splitScalar(input + i, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_SSE2
+static void stereoMixSse2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8) {
+        __m128i min_value = _mm_set1_epi16(static_cast<short>(min[0]));
+        __m128i max_value = _mm_set1_epi16(static_cast<short>(max[0]));
+
+        for (; i + 8 <= frames; i += 8) {
+            const short* p = input + i * 2;
+
+            const __m128i a = averagePairsSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            const __m128i b = averagePairsSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8)));
+
+            // The averages are always in 16-bit range, so saturation
+            // doesn't change any values
+            const __m128i value = _mm_packs_epi32(a, b);
+
+            min_value = _mm_min_epi16(min_value, value);
+            max_value = _mm_max_epi16(max_value, value);
+        }
+
+        min[0] = horizontalMinSse2(min_value);
+        max[0] = horizontalMaxSse2(max_value);
+    }
+
+    mixScalar(input + i * 2, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_SSE2
+static void stereoSplitSse2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 4) {
+        // Even lanes hold left channel samples, odd lanes hold right channel
+        // samples
+
+        __m128i min_value = interleaveSse2(min[0], min[1]);
+        __m128i max_value = interleaveSse2(max[0], max[1]);
+
+        for (; i + 8 <= frames; i += 8) {
+            const short* p = input + i * 2;
+
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8));
+
+            min_value = _mm_min_epi16(min_value, _mm_min_epi16(a, b));
+            max_value = _mm_max_epi16(max_value, _mm_max_epi16(a, b));
+        }
+
+        for (; i + 4 <= frames; i += 4) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2));
+
+            min_value = _mm_min_epi16(min_value, a);
+            max_value = _mm_max_epi16(max_value, a);
+        }
+
+        min_value = _mm_min_epi16(min_value, _mm_srli_si128(min_value, 8));
+        min_value = _mm_min_epi16(min_value, _mm_srli_si128(min_value, 4));
+
+        max_value = _mm_max_epi16(max_value, _mm_srli_si128(max_value, 8));
+        max_value = _mm_max_epi16(max_value, _mm_srli_si128(max_value, 4));
+
+        min[0] = static_cast<short>(_mm_extract_epi16(min_value, 0));
+        min[1] = static_cast<short>(_mm_extract_epi16(min_value, 1));
+        max[0] = static_cast<short>(_mm_extract_epi16(max_value, 0));
+        max[1] = static_cast<short>(_mm_extract_epi16(max_value, 1));
+    }
+
+    splitScalar(input + i * 2, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+// Sums the samples in each of count frames, for mixing to mono.
+
+static inline void sumFrames(
+    const short* input,
+    const int count,
+    const int channels,
+    int* sums)
+{
+    for (int i = 0; i < count; ++i) {
+        int sum = 0;
+
+        for (int channel = 0; channel < channels; ++channel) {
+            sum += input[channel];
+        }
+
+        sums[i] = sum;
+        input += channels;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Mixing N channels uses single precision floating point division, which
+// gives exactly the same result as integer division here: the sum of up to
+// MAX_CHANNELS 16-bit values is exactly representable, and a non-integer
+// quotient is never closer than 1 / channels to an integer, which is much
+// larger than the rounding error, so truncation gives the same value.
+
+TARGET_SSE2
+static void multiMixSse2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8 && channels <= MAX_CHANNELS) {
+        __m128i min_value = _mm_set1_epi16(static_cast<short>(min[0]));
+        __m128i max_value = _mm_set1_epi16(static_cast<short>(max[0]));
+
+        const __m128 divisor = _mm_set1_ps(static_cast<float>(channels));
+
+        alignas(16) int sums[8];
+
+        for (; i + 8 <= frames; i += 8) {
+            sumFrames(input + i * channels, 8, channels, sums);
+
+            const __m128i a = _mm_cvttps_epi32(_mm_div_ps(
+                _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(sums))),
+                divisor
+            ));
+
+            const __m128i b = _mm_cvttps_epi32(_mm_div_ps(
+                _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(sums + 4))),
+                divisor
+            ));
+
+            const __m128i value = _mm_packs_epi32(a, b);
+
+            min_value = _mm_min_epi16(min_value, value);
+            max_value = _mm_max_epi16(max_value, value);
+        }
+
+        min[0] = horizontalMinSse2(min_value);
+        max[0] = horizontalMaxSse2(max_value);
+    }
+
+    mixScalar(input + i * channels, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+// Each group of 8 frames occupies exactly channels vectors, and lane j of
+// vector k always holds a sample from channel (8 * k + j) % channels, so we
+// keep separate running values for each vector in the group.
+
+TARGET_SSE2
+static void multiSplitSse2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8 && channels <= MAX_CHANNELS) {
+        __m128i min_values[MAX_CHANNELS];
+        __m128i max_values[MAX_CHANNELS];
+
+        alignas(16) short lanes[8];
+
+        for (int k = 0; k < channels; ++k) {
+            for (int j = 0; j < 8; ++j) {
+                lanes[j] = static_cast<short>(min[(8 * k + j) % channels]);
+            }
+
+            min_values[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes));
+
+            for (int j = 0; j < 8; ++j) {
+                lanes[j] = static_cast<short>(max[(8 * k + j) % channels]);
+            }
+
+            max_values[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes));
+        }
+
+        for (; i + 8 <= frames; i += 8) {
+            const short* p = input + i * channels;
+
+            for (int k = 0; k < channels; ++k) {
+                const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8 * k));
+
+                min_values[k] = _mm_min_epi16(min_values[k], value);
+                max_values[k] = _mm_max_epi16(max_values[k], value);
+            }
+        }
+
+        for (int k = 0; k < channels; ++k) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), min_values[k]);
+
+            for (int j = 0; j < 8; ++j) {
+                const int channel = (8 * k + j) % channels;
+
+                if (lanes[j] < min[channel]) {
+                    min[channel] = lanes[j];
+                }
+            }
+
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), max_values[k]);
+
+            for (int j = 0; j < 8; ++j) {
+                const int channel = (8 * k + j) % channels;
+
+                if (lanes[j] > max[channel]) {
+                    max[channel] = lanes[j];
+                }
+            }
+        }
+    }
+
+    splitScalar(input + i * channels, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_AVX2
+static inline __m128i combineMinAvx2(__m256i value)
+{
+    return _mm_min_epi16(
+        _mm256_castsi256_si128(value),
+        _mm256_extracti128_si256(value, 1)
+    );
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_AVX2
+static inline __m128i combineMaxAvx2(__m256i value)
+{
+    return _mm_max_epi16(
+        _mm256_castsi256_si128(value),
+        _mm256_extracti128_si256(value, 1)
+    );
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_AVX2
+static inline short horizontalMinAvx2(__m256i value)
+{
+    __m128i result = combineMinAvx2(value);
+
+    result = _mm_min_epi16(result, _mm_srli_si128(result, 8));
+    result = _mm_min_epi16(result, _mm_srli_si128(result, 4));
+    result = _mm_min_epi16(result, _mm_srli_si128(result, 2));
+
+    return static_cast<short>(_mm_cvtsi128_si32(result));
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_AVX2
+static inline short horizontalMaxAvx2(__m256i value)
+{
+    __m128i result = combineMaxAvx2(value);
+
+    result = _mm_max_epi16(result, _mm_srli_si128(result, 8));
+    result = _mm_max_epi16(result, _mm_srli_si128(result, 4));
+    result = _mm_max_epi16(result, _mm_srli_si128(result, 2));
+
+    return static_cast<short>(_mm_cvtsi128_si32(result));
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_AVX2
+static inline __m256i averagePairsAvx2(__m256i value)
+{
+    const __m256i sum = _mm256_madd_epi16(value, _mm256_set1_epi16(1));
+
+    return _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_srli_epi32(sum, 31)), 1);
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_AVX2
+static void monoAvx2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 16) {
+        __m256i min_value = _mm256_set1_epi16(static_cast<short>(min[0]));
+        __m256i max_value = _mm256_set1_epi16(static_cast<short>(max[0]));
+
+        for (; i + 32 <= frames; i += 32) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i + 16));
+
+            min_value = _mm256_min_epi16(min_value, _mm256_min_epi16(a, b));
+            max_value = _mm256_max_epi16(max_value, _mm256_max_epi16(a, b));
+        }
+
+        for (; i + 16 <= frames; i += 16) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+
+            min_value = _mm256_min_epi16(min_value, a);
+            max_value = _mm256_max_epi16(max_value, a);
+        }
+
+        min[0] = horizontalMinAvx2(min_value);
+        max[0] = horizontalMaxAvx2(max_value);
+    }
+
+    splitScalar(input + i, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_AVX2
+static void stereoMixAvx2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 16) {
+        __m256i min_value = _mm256_set1_epi16(static_cast<short>(min[0]));
+        __m256i max_value = _mm256_set1_epi16(static_cast<short>(max[0]));
+
+        for (; i + 16 <= frames; i += 16) {
+            const short* p = input + i * 2;
+
+            const __m256i a = averagePairsAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+            const __m256i b = averagePairsAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 16)));
+
+            // Packing interleaves the 128-bit lanes, but the order of the
+            // values doesn't matter here
+            const __m256i value = _mm256_packs_epi32(a, b);
+
+            min_value = _mm256_min_epi16(min_value, value);
+            max_value = _mm256_max_epi16(max_value, value);
+        }
+
+        min[0] = horizontalMinAvx2(min_value);
+        max[0] = horizontalMaxAvx2(max_value);
+    }
+
+    mixScalar(input + i * 2, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+TARGET_AVX2
+static void stereoSplitAvx2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8) {
+        __m256i min_value = _mm256_broadcastsi128_si256(interleaveSse2(min[0], min[1]));
+        __m256i max_value = _mm256_broadcastsi128_si256(interleaveSse2(max[0], max[1]));
+
+        for (; i + 16 <= frames; i += 16) {
+            const short* p = input + i * 2;
+
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 16));
+
+            min_value = _mm256_min_epi16(min_value, _mm256_min_epi16(a, b));
+            max_value = _mm256_max_epi16(max_value, _mm256_max_epi16(a, b));
+        }
+
+        for (; i + 8 <= frames; i += 8) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i * 2));
+
+            min_value = _mm256_min_epi16(min_value, a);
+            max_value = _mm256_max_epi16(max_value, a);
+        }
+
+        __m128i min_result = combineMinAvx2(min_value);
+        __m128i max_result = combineMaxAvx2(max_value);
+
+        min_result = _mm_min_epi16(min_result, _mm_srli_si128(min_result, 8));
+        min_result = _mm_min_epi16(min_result, _mm_srli_si128(min_result, 4));
+
+        max_result = _mm_max_epi16(max_result, _mm_srli_si128(max_result, 8));
+        max_result = _mm_max_epi16(max_result, _mm_srli_si128(max_result, 4));
+
+        min[0] = static_cast<short>(_mm_extract_epi16(min_result, 0));
+        min[1] = static_cast<short>(_mm_extract_epi16(min_result, 1));
+        max[0] = static_cast<short>(_mm_extract_epi16(max_result, 0));
+        max[1] = static_cast<short>(_mm_extract_epi16(max_result, 1));
+    }
+
+    splitScalar(input + i * 2, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+// See the comment on multiMixSse2() regarding floating point division.
+
+TARGET_AVX2
+static void multiMixAvx2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 8 && channels <= MAX_CHANNELS) {
+        __m256i min_value = _mm256_set1_epi32(min[0]);
+        __m256i max_value = _mm256_set1_epi32(max[0]);
+
+        const __m256 divisor = _mm256_set1_ps(static_cast<float>(channels));
+
+        alignas(32) int sums[8];
+
+        for (; i + 8 <= frames; i += 8) {
+            sumFrames(input + i * channels, 8, channels, sums);
+
+            const __m256i value = _mm256_cvttps_epi32(_mm256_div_ps(
+                _mm256_cvtepi32_ps(_mm256_load_si256(reinterpret_cast<const __m256i*>(sums))),
+                divisor
+            ));
+
+            min_value = _mm256_min_epi32(min_value, value);
+            max_value = _mm256_max_epi32(max_value, value);
+        }
+
+        alignas(32) int lanes[8];
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), min_value);
+
+        for (int j = 0; j < 8; ++j) {
+            if (lanes[j] < min[0]) {
+                min[0] = lanes[j];
+            }
+        }
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), max_value);
+
+        for (int j = 0; j < 8; ++j) {
+            if (lanes[j] > max[0]) {
+                max[0] = lanes[j];
+            }
+        }
+    }
+
+    mixScalar(input + i * channels, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+// As multiSplitSse2(), but each group is 16 frames.
+
+TARGET_AVX2
+static void multiSplitAvx2(
+    const short* input,
+    const int frames,
+    const int channels,
+    int* min,
+    int* max)
+{
+    int i = 0;
+
+    if (frames >= 16 && channels <= MAX_CHANNELS) {
+        __m256i min_values[MAX_CHANNELS];
+        __m256i max_values[MAX_CHANNELS];
+
+        alignas(32) short lanes[16];
+
+        for (int k = 0; k < channels; ++k) {
+            for (int j = 0; j < 16; ++j) {
+                lanes[j] = static_cast<short>(min[(16 * k + j) % channels]);
+            }
+
+            min_values[k] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+
+            for (int j = 0; j < 16; ++j) {
+                lanes[j] = static_cast<short>(max[(16 * k + j) % channels]);
+            }
+
+            max_values[k] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+        }
+
+        for (; i + 16 <= frames; i += 16) {
+            const short* p = input + i * channels;
+
+            for (int k = 0; k < channels; ++k) {
+                const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 16 * k));
+
+                min_values[k] = _mm256_min_epi16(min_values[k], value);
+                max_values[k] = _mm256_max_epi16(max_values[k], value);
+            }
+        }
+
+        for (int k = 0; k < channels; ++k) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), min_values[k]);
+
+            for (int j = 0; j < 16; ++j) {
+                const int channel = (16 * k + j) % channels;
+
+                if (lanes[j] < min[channel]) {
+                    min[channel] = lanes[j];
+                }
+            }
+
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), max_values[k]);
+
+            for (int j = 0; j < 16; ++j) {
+                const int channel = (16 * k + j) % channels;
+
+                if (lanes[j] > max[channel]) {
+                    max[channel] = lanes[j];
+                }
+            }
+        }
+    }
+
+    splitScalar(input + i * channels, frames - i, channels, min, max);
+}
+
+//------------------------------------------------------------------------------
+
+static bool isCpuFeatureSupported(bool avx2)
+{
+    __builtin_cpu_init();
+
+    return avx2 ? __builtin_cpu_supports("avx2") != 0 :
+                  __builtin_cpu_supports("sse2") != 0;
+}
+
+//------------------------------------------------------------------------------
+
+const KernelSet* getSse2KernelSet()
+{
+    static const KernelSet kernel_set = {
+        "sse2",
+        monoSse2,
+        stereoMixSse2,
+        stereoSplitSse2,
+        multiMixSse2,
+        multiSplitSse2
+    };
+
+    static const bool supported = isCpuFeatureSupported(false);
+
+    return supported ? &kernel_set : nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+const KernelSet* getAvx2KernelSet()
+{
+    static const KernelSet kernel_set = {
+        "avx2",
+        monoAvx2,
+        stereoMixAvx2,
+        stereoSplitAvx2,
+        multiMixAvx2,
+        multiSplitAvx2
+    };
+
+    static const bool supported = isCpuFeatureSupported(true);
+
+    return supported ? &kernel_set : nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+#else
+
+//------------------------------------------------------------------------------
+
+const KernelSet* getSse2KernelSet()
+{
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+const KernelSet* getAvx2KernelSet()
+{
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+#endif // #if defined(MIN_MAX_KERNELS_X86)
+
+//------------------------------------------------------------------------------
+
+} // namespace MinMaxKernels
+
+//------------------------------------------------------------------------------
@@ -55,13 +55,17 @@
 #include "BStdFile.h"
 #include "Error.h"
 #include "FileUtil.h"
+#include "JobStats.h"
 #include "Log.h"
+#include "Mp3FrameIndex.h"
 #include "ProgressReporter.h"
+#include "Trace.h"
 
 #include <sys/stat.h>
 #include <id3tag.h>
 #include <mad.h>
 
+#include <cassert>
 #include <climits>
 #include <cstdio>
 #include <cstring>
@@ -164,6 +168,27 @@ MadSynth::~MadSynth()
 const int INPUT_BUFFER_SIZE  = 5 * 8192;
 const int OUTPUT_BUFFER_SIZE = 8192;
 
+// When skipping to the start of a frame range, the frames just before the
+// range are decoded, but not output. A layer III frame can use data from up to
+// 511 bytes of earlier frames (the bit reservoir), and the output from each
+// frame depends on the previous frame, so decoding these frames ensures the
+// output from the range matches the output from decoding the whole file.
+
+const int PRIMING_FRAMES = 10;
+
+//------------------------------------------------------------------------------
+
+// Returns true if the error is one of libmad's frame level errors, which are
+// numbered 0x0201 (MAD_ERROR_BADCRC) to 0x0239 (MAD_ERROR_BADSTEREO), see
+// enum mad_error in mad.h. Unlike header errors (0x01xx), these are reported
+// after the frame header has been decoded, and the stream has moved past the
+// frame.
+
+static bool isFrameError(const enum mad_error error)
+{
+    return (error & 0xff00) == 0x0200;
+}
+
 //------------------------------------------------------------------------------
 
 // Print human readable information about an audio MPEG frame.
@@ -326,8 +351,11 @@ static short MadFixedToShort(mad_fixed_t fixed)
 Mp3AudioFileReader::Mp3AudioFileReader() :
     show_info_(true),
     file_size_(0),
+    seekable_(false),
     sample_rate_(0),
-    frames_(0)
+    frames_(0),
+    start_frame_(0),
+    end_frame_(-1)
 {
 }
 
@@ -342,17 +370,27 @@ Mp3AudioFileReader::~Mp3AudioFileReader()
 
 bool Mp3AudioFileReader::open(const char* filename, bool show_info)
 {
+    StageTimer timer(JobStats::Open);
+
     show_info_ = show_info;
 
     if (!file_.open(filename)) {
         return false;
     }
 
+    filename_ = filename;
+
     if (!file_.isStdio()) {
         if (!getFileSize()) {
             log(Error) << "Failed to determine file size: " << filename << '\n'
                        << strerror(errno) << '\n';
         }
+
+        if (seekable_ && !readSampleRate()) {
+            log(Error) << "Failed to read file: " << filename << '\n'
+                       << strerror(errno) << '\n';
+            return false;
+        }
     }
 
     log(Info) << "Input file: "
@@ -382,6 +420,111 @@ bool Mp3AudioFileReader::getFileSize()
 
     file_size_ = stat_buf.st_size;
 
+    // Only regular files can be seeked, not named pipes or devices
+    seekable_ = S_ISREG(stat_buf.st_mode);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Reads the sample rate from the first MPEG frame, then returns to the start
+// of the file. The sample rate is left as 0 if no valid frame is found, in
+// which case run() reports the error.
+
+bool Mp3AudioFileReader::readSampleRate()
+{
+    FILE* file = file_.get();
+
+    unsigned char input_buffer[INPUT_BUFFER_SIZE + MAD_BUFFER_GUARD];
+
+    size_t read_size = fread(input_buffer, 1, ID3_TAG_QUERYSIZE, file);
+
+    long id3_tag_size = 0;
+
+    if (read_size == ID3_TAG_QUERYSIZE) {
+        id3_tag_size = id3_tag_query(input_buffer, ID3_TAG_QUERYSIZE);
+
+        if (id3_tag_size < 0) {
+            id3_tag_size = 0;
+        }
+    }
+
+    if (fseek(file, id3_tag_size, SEEK_SET) != 0) {
+        return false;
+    }
+
+    read_size = fread(input_buffer, 1, INPUT_BUFFER_SIZE, file);
+
+    memset(input_buffer + read_size, 0, MAD_BUFFER_GUARD);
+
+    MadStream stream;
+    MadFrame frame;
+
+    mad_stream_buffer(&stream, input_buffer, read_size + MAD_BUFFER_GUARD);
+
+    while (mad_frame_decode(&frame, &stream) != 0) {
+        if (!MAD_RECOVERABLE(stream.error)) {
+            break;
+        }
+    }
+
+    if (stream.error == MAD_ERROR_NONE) {
+        sample_rate_ = static_cast<int>(frame.header.samplerate);
+    }
+
+    return fseek(file, 0, SEEK_SET) == 0;
+}
+
+//------------------------------------------------------------------------------
+
+bool Mp3AudioFileReader::setFrameRange(
+    const long long start_frame,
+    const long long end_frame)
+{
+    assert(start_frame >= 0);
+    assert(end_frame < 0 || start_frame <= end_frame);
+
+    start_frame_ = start_frame;
+    end_frame_   = end_frame;
+
+    if (start_frame_ > 0 && !frame_index_filename_.empty() && seekable_) {
+        if (!loadFrameIndex()) {
+            log(Info) << "Reading MP3 file without frame index\n";
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Loads the frame index if it was created for the current version of the
+// input file, otherwise creates the index and saves it for next time.
+
+bool Mp3AudioFileReader::loadFrameIndex()
+{
+    const char* index_filename = frame_index_filename_.c_str();
+
+    std::unique_ptr<Mp3FrameIndex> frame_index(new Mp3FrameIndex);
+
+    if (!frame_index->load(index_filename, filename_.c_str())) {
+        log(Info) << "Creating MP3 frame index: " << index_filename << '\n';
+
+        if (!frame_index->build(filename_.c_str())) {
+            return false;
+        }
+
+        // The index can still be used if it can't be saved
+        frame_index->save(index_filename, filename_.c_str());
+    }
+
+    if (frame_index->getFrameCount() == 0) {
+        return false;
+    }
+
+    frame_index_ = std::move(frame_index);
+
     return true;
 }
 
@@ -419,7 +562,12 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
     short output_buffer[OUTPUT_BUFFER_SIZE];
     short* output_ptr = output_buffer;
     const short* const output_buffer_end = output_buffer + OUTPUT_BUFFER_SIZE;
-    int samples_to_skip = 0;
+    long long samples_to_skip = 0;
+    bool skipped_frames = false;
+    long long frames_remaining = end_frame_ >= 0 ? end_frame_ - start_frame_ : -1;
+    size_t frame_number = 0;
+    bool use_frame_index = frame_index_ != nullptr;
+    bool check_frame_index = false;
     bool started = false;
     bool first = true;
     size_t id3_bytes_to_skip = 0;
@@ -451,6 +599,50 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
     // This is the decoding loop.
 
     for (;;) {
+        // Seek to the frame to start decoding from, so that the output from
+        // the start of the frame range is the same as when decoding the whole
+        // file. The decoder state is reset, as if starting a new file.
+
+        if (use_frame_index && started && samples_to_skip > 0) {
+            use_frame_index = false;
+
+            const long long frame_samples = frame_index_->getSamplesPerFrame();
+
+            const size_t preroll_frame = frame_index_->getPrerollFrame(
+                frame_number + static_cast<size_t>(samples_to_skip / frame_samples)
+            );
+
+            if (preroll_frame > frame_number) {
+                const long offset = static_cast<long>(
+                    frame_index_->getFrameOffset(preroll_frame)
+                );
+
+                if (!bstd_file.seek(offset)) {
+                    log(Error) << "\nFailed to seek to frame " << preroll_frame
+                               << ": " << strerror(errno) << '\n';
+                    status = STATUS_READ_ERROR;
+                    break;
+                }
+
+                const long long skipped_samples =
+                    static_cast<long long>(preroll_frame - frame_number) * frame_samples;
+
+                frame_count += static_cast<unsigned long>(preroll_frame - frame_number);
+                samples_to_skip -= skipped_samples;
+                frame_number = preroll_frame;
+                skipped_frames = true;
+                check_frame_index = true;
+
+                mad_frame_mute(&frame);
+                mad_synth_mute(&synth);
+
+                stream.md_len     = 0;
+                stream.next_frame = nullptr;
+                stream.error      = MAD_ERROR_BUFLEN;
+                guard_ptr         = nullptr;
+            }
+        }
+
         // The input bucket must be filled if it becomes empty or if it's the
         // first execution of the loop.
 
@@ -490,7 +682,10 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
             // the decoding loop. If the end of stream is reached we also leave
             // the loop but the return status is left untouched.
 
-            read_size = bstd_file.read(read_start, 1, read_size);
+            {
+                TRACE_SCOPE("decode", "Mp3AudioFileReader::read");
+                read_size = bstd_file.read(read_start, 1, read_size);
+            }
 
             if (read_size <= 0) {
                 if (file_.hasError()) {
@@ -558,6 +753,41 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
             }
         }
 
+        // Skip frames before the start of the frame range by decoding only
+        // the frame headers, which gives their duration. The frame size is
+        // assumed not to change between frames.
+
+        if (started && !frame_index_ &&
+            samples_to_skip >= 32 * MAD_NSBSAMPLES(&frame.header) * (PRIMING_FRAMES + 1)) {
+            if (mad_header_decode(&frame.header, &stream)) {
+                if (MAD_RECOVERABLE(stream.error) || stream.error == MAD_ERROR_BUFLEN) {
+                    continue;
+                }
+                else {
+                    log(Error) << "\nUnrecoverable frame level error: "
+                               << mad_stream_errorstr(&stream) << '\n';
+                    status = STATUS_READ_ERROR;
+                    break;
+                }
+            }
+
+            // mad_header_decode() marks the frame as incomplete, which would
+            // make the next mad_frame_decode() call decode this frame's data
+            // rather than the next frame
+
+            frame.header.flags &= ~MAD_FLAG_INCOMPLETE;
+
+            frame_count++;
+            frame_number++;
+
+            mad_timer_add(&timer, frame.header.duration);
+
+            samples_to_skip -= 32 * MAD_NSBSAMPLES(&frame.header);
+            skipped_frames = true;
+
+            continue;
+        }
+
         // Decode the next MPEG frame. The streams is read from the buffer, its
         // constituents are broken down and stored the the frame structure,
         // ready for examination/alteration or PCM synthesis. Decoding options
@@ -582,8 +812,46 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
         // one can call again mad_frame_decode() in order to skip the faulty
         // part and re-sync to the next frame.
 
-        if (mad_frame_decode(&frame, &stream)) {
+        const bool decoded = mad_frame_decode(&frame, &stream) == 0;
+
+        // After seeking, the first frame must be at the start of the buffer,
+        // otherwise the index doesn't match the file
+
+        if (check_frame_index) {
+            check_frame_index = false;
+
+            if (stream.this_frame != input_buffer ||
+                (!decoded && !isFrameError(stream.error))) {
+                log(Error) << "\nMP3 frame index doesn't match the input file\n";
+                status = STATUS_READ_ERROR;
+                break;
+            }
+        }
+
+        if (!decoded) {
             if (MAD_RECOVERABLE(stream.error)) {
+                TRACE_INSTANT("decode", "Recoverable frame level error");
+
+                // Frame level errors (unlike header errors) consume the frame
+                if (isFrameError(stream.error)) {
+                    frame_number++;
+                }
+
+                // The first frames decoded after skipping may need data from
+                // the skipped frames. Count their samples as skipped, so the
+                // following frames are output at the right position.
+
+                if (skipped_frames &&
+                    samples_to_skip > 0 &&
+                    stream.error == MAD_ERROR_BADDATAPTR) {
+                    const long long frame_samples = 32 * MAD_NSBSAMPLES(&frame.header);
+
+                    samples_to_skip -= frame_samples < samples_to_skip ?
+                        frame_samples : samples_to_skip;
+
+                    continue;
+                }
+
                 // Do not print a message if the error is a loss of
                 // synchronization and this loss is due to the end of stream
                 // guard bytes. (See the comment marked {3} above for more
@@ -619,6 +887,8 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
             }
         }
 
+        frame_number++;
+
         // Look for a Xing/Info header that contains encoding delay and padding
         // values, used for gapless playback. We use these to skip the delay
         // at the start of the file.
@@ -701,6 +971,16 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
                 break;
             }
 
+            samples_to_skip += start_frame_;
+
+            if (frame_index_ &&
+                (frame_index_->getSampleRate() != sample_rate ||
+                 frame_index_->getSamplesPerFrame() != 32 * MAD_NSBSAMPLES(&frame.header))) {
+                log(Info) << "MP3 frame index doesn't match the input file\n";
+                frame_index_.reset();
+                use_frame_index = false;
+            }
+
             frames_ = 0;
             sample_rate_ = sample_rate;
 
@@ -732,7 +1012,7 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
         // is flushed when full.
 
         for (int i = 0; i < synth.pcm.length; i++) {
-            if (samples_to_skip == 0) {
+            if (samples_to_skip == 0 && frames_remaining != 0) {
                 // Left channel
                 if (output_ptr < output_buffer_end) {
                     *output_ptr++ = MadFixedToShort(synth.pcm.samples[0][i]);
@@ -744,8 +1024,12 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
                 if (MAD_NCHANNELS(&frame.header) == 2 && output_ptr < output_buffer_end) {
                     *output_ptr++ = MadFixedToShort(synth.pcm.samples[1][i]);
                 }
+
+                if (frames_remaining > 0) {
+                    frames_remaining--;
+                }
             }
-            else {
+            else if (samples_to_skip > 0) {
                 samples_to_skip--;
             }
 
@@ -770,6 +1054,11 @@ bool Mp3AudioFileReader::run(AudioProcessor& processor)
                 output_ptr = output_buffer;
             }
         }
+
+        // Stop at the end of the frame range
+        if (frames_remaining == 0) {
+            break;
+        }
     }
 
     // If the output buffer is not empty and no error occurred during the last
@@ -31,6 +31,12 @@
 #include "FileHandle.h"
 
 #include <cstdio>
+#include <memory>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+class Mp3FrameIndex;
 
 //------------------------------------------------------------------------------
 
@@ -48,17 +54,40 @@ class Mp3AudioFileReader : public AudioFileReader
 
         virtual bool run(AudioProcessor& processor);
 
+        // Returns 0 if reading from standard input, or from another input
+        // that can't be seeked, such as a pipe.
+        virtual int getSampleRate() const { return sample_rate_; }
+
+        // Frames before start_frame are skipped without being fully decoded,
+        // so this also works when reading from standard input.
+        virtual bool setFrameRange(long long start_frame, long long end_frame);
+
+        // If set, setFrameRange() loads the frame index from this file, or
+        // creates it, so that run() can seek close to start_frame.
+        void setFrameIndexFilename(const std::string& filename)
+        {
+            frame_index_filename_ = filename;
+        }
+
     private:
         void close();
         bool getFileSize();
         bool skipId3Tags();
+        bool readSampleRate();
+        bool loadFrameIndex();
 
     private:
         bool show_info_;
         FileHandle file_;
+        std::string filename_;
         long file_size_;
+        bool seekable_;
         int sample_rate_;
         int frames_;
+        long long start_frame_;
+        long long end_frame_;
+        std::string frame_index_filename_;
+        std::unique_ptr<Mp3FrameIndex> frame_index_;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,615 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Mp3FrameIndex.h"
+#include "FileHandle.h"
+#include "Log.h"
+
+#include <boost/filesystem.hpp>
+
+#include <id3tag.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <errno.h>
+#include <fstream>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+struct FrameHeader
+{
+    int sample_rate;
+    int samples;
+    int length;
+    int main_data_begin;
+    int main_data_size;
+};
+
+enum class HeaderStatus {
+    Valid,
+    Invalid,
+    FreeFormat
+};
+
+//------------------------------------------------------------------------------
+
+// Reads the input file in blocks, and gives access to a range of bytes from
+// any position at or after the last position requested.
+
+class InputBuffer
+{
+    public:
+        InputBuffer(FILE* file, long long offset);
+
+        // Returns nullptr if fewer than size bytes remain in the file.
+        const unsigned char* get(long long position, size_t size);
+
+    private:
+        FILE* file_;
+        std::vector<unsigned char> data_;
+        long long offset_;
+        bool eof_;
+};
+
+}
+
+//------------------------------------------------------------------------------
+
+const size_t READ_SIZE = 65536;
+
+// Enough for the frame header, CRC, and the start of the layer III side
+// information
+const size_t HEADER_SIZE = 8;
+
+const char MAGIC[4] = { 'M', 'P', '3', 'I' };
+
+const int32_t VERSION = 1;
+
+// Each frame is stored as the offset from the previous frame, and the main
+// data begin and size
+const unsigned long long INDEX_FRAME_SIZE = 4 + 2 + 2;
+
+//------------------------------------------------------------------------------
+
+InputBuffer::InputBuffer(FILE* file, long long offset) :
+    file_(file),
+    offset_(offset),
+    eof_(false)
+{
+}
+
+//------------------------------------------------------------------------------
+
+const unsigned char* InputBuffer::get(long long position, size_t size)
+{
+    const size_t start = static_cast<size_t>(position - offset_);
+
+    if (start + size <= data_.size()) {
+        return &data_[start];
+    }
+
+    if (eof_) {
+        return nullptr;
+    }
+
+    data_.erase(
+        data_.begin(),
+        data_.begin() + static_cast<std::ptrdiff_t>(std::min(start, data_.size()))
+    );
+
+    offset_ = position;
+
+    const size_t old_size = data_.size();
+    const size_t read_size = std::max(size - old_size, READ_SIZE);
+
+    data_.resize(old_size + read_size);
+
+    const size_t bytes_read = fread(&data_[old_size], 1, read_size, file_);
+
+    data_.resize(old_size + bytes_read);
+
+    if (bytes_read < read_size) {
+        eof_ = true;
+    }
+
+    return size <= data_.size() ? &data_[0] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+static bool isSyncWord(const unsigned char* data)
+{
+    return data[0] == 0xff && (data[1] & 0xe0) == 0xe0;
+}
+
+//------------------------------------------------------------------------------
+
+// Bit rates in kbit/s, from ISO/IEC 11172-3 and ISO/IEC 13818-3.
+
+static const int BIT_RATES[5][15] = {
+    // MPEG-1 Layer I
+    { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+    // MPEG-1 Layer II
+    { 0, 32, 48, 56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 384 },
+    // MPEG-1 Layer III
+    { 0, 32, 40, 48,  56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320 },
+    // MPEG-2 LSF Layer I
+    { 0, 32, 48, 56,  64,  80,  96, 112, 128, 144, 160, 176, 192, 224, 256 },
+    // MPEG-2 LSF Layer II and III
+    { 0,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160 }
+};
+
+static const int SAMPLE_RATES[3] = { 44100, 48000, 32000 };
+
+//------------------------------------------------------------------------------
+
+// Decodes a frame header, rejecting the same headers as libmad's
+// decode_header() function.
+
+static HeaderStatus parseHeader(const unsigned char* data, FrameHeader& header)
+{
+    const bool mpeg_2_5 = (data[1] & 0x10) == 0;
+    const bool lsf      = (data[1] & 0x08) == 0;
+
+    if (mpeg_2_5 && !lsf) {
+        return HeaderStatus::Invalid;
+    }
+
+    const int layer = 4 - ((data[1] >> 1) & 0x03);
+
+    if (layer == 4) {
+        return HeaderStatus::Invalid;
+    }
+
+    const bool has_crc = (data[1] & 0x01) == 0;
+
+    const int bit_rate_index = data[2] >> 4;
+
+    if (bit_rate_index == 15) {
+        return HeaderStatus::Invalid;
+    }
+
+    const int sample_rate_index = (data[2] >> 2) & 0x03;
+
+    if (sample_rate_index == 3) {
+        return HeaderStatus::Invalid;
+    }
+
+    if (bit_rate_index == 0) {
+        return HeaderStatus::FreeFormat;
+    }
+
+    const int padding = (data[2] >> 1) & 0x01;
+    const bool mono   = (data[3] >> 6) == 3;
+
+    const int bit_rate = 1000 * BIT_RATES[lsf ? (layer == 1 ? 3 : 4) : layer - 1][bit_rate_index];
+
+    header.sample_rate = SAMPLE_RATES[sample_rate_index];
+
+    if (lsf) {
+        header.sample_rate /= mpeg_2_5 ? 4 : 2;
+    }
+
+    if (layer == 1) {
+        header.samples = 384;
+        header.length  = (12 * bit_rate / header.sample_rate + padding) * 4;
+    }
+    else {
+        const int slots = layer == 3 && lsf ? 72 : 144;
+
+        header.samples = layer == 3 && lsf ? 576 : 1152;
+        header.length  = slots * bit_rate / header.sample_rate + padding;
+    }
+
+    header.main_data_begin = 0;
+    header.main_data_size  = 0;
+
+    if (layer == 3) {
+        const unsigned char* side_info = data + (has_crc ? 6 : 4);
+
+        int side_info_size;
+
+        if (lsf) {
+            header.main_data_begin = side_info[0];
+            side_info_size = mono ? 9 : 17;
+        }
+        else {
+            header.main_data_begin = (side_info[0] << 1) | (side_info[1] >> 7);
+            side_info_size = mono ? 17 : 32;
+        }
+
+        header.main_data_size = std::max(
+            header.length - (has_crc ? 6 : 4) - side_info_size,
+            0
+        );
+    }
+
+    return HeaderStatus::Valid;
+}
+
+//------------------------------------------------------------------------------
+
+Mp3FrameIndex::Mp3FrameIndex() :
+    sample_rate_(0),
+    samples_per_frame_(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+// Like Mp3AudioFileReader, this skips any ID3 tag at the start of the file,
+// and expects the first frame to follow immediately. Otherwise, as in libmad,
+// a possible frame is only accepted if it's followed by another frame header.
+
+bool Mp3FrameIndex::build(const char* filename)
+{
+    frames_.clear();
+    sample_rate_       = 0;
+    samples_per_frame_ = 0;
+
+    FileHandle file;
+
+    if (!file.open(filename)) {
+        return false;
+    }
+
+    long id3_tag_size = 0;
+
+    unsigned char id3_header[ID3_TAG_QUERYSIZE];
+
+    if (fread(id3_header, 1, ID3_TAG_QUERYSIZE, file.get()) == ID3_TAG_QUERYSIZE) {
+        id3_tag_size = id3_tag_query(id3_header, ID3_TAG_QUERYSIZE);
+
+        if (id3_tag_size < 0) {
+            id3_tag_size = 0;
+        }
+    }
+
+    if (fseek(file.get(), id3_tag_size, SEEK_SET) != 0) {
+        log(Error) << "Failed to read file: " << filename << '\n'
+                   << strerror(errno) << '\n';
+        return false;
+    }
+
+    InputBuffer buffer(file.get(), id3_tag_size);
+
+    long long position = id3_tag_size;
+    bool synced = true;
+
+    for (;;) {
+        const unsigned char* data = buffer.get(position, HEADER_SIZE);
+
+        if (data == nullptr) {
+            break;
+        }
+
+        if (!isSyncWord(data)) {
+            ++position;
+            synced = false;
+            continue;
+        }
+
+        FrameHeader header;
+
+        const HeaderStatus status = parseHeader(data, header);
+
+        if (status == HeaderStatus::FreeFormat && synced) {
+            log(Error) << "Free format MP3 files are not supported\n";
+            return false;
+        }
+
+        if (status != HeaderStatus::Valid) {
+            ++position;
+            synced = false;
+            continue;
+        }
+
+        const size_t length = static_cast<size_t>(header.length);
+
+        if (synced) {
+            if (buffer.get(position, length) == nullptr) {
+                break;
+            }
+        }
+        else {
+            data = buffer.get(position, length + 2);
+
+            if (data == nullptr || !isSyncWord(data + length)) {
+                ++position;
+                continue;
+            }
+        }
+
+        if (frames_.empty()) {
+            sample_rate_       = header.sample_rate;
+            samples_per_frame_ = header.samples;
+        }
+
+        Frame frame;
+
+        frame.offset          = position;
+        frame.main_data_begin = header.main_data_begin;
+        frame.main_data_size  = header.main_data_size;
+
+        frames_.push_back(frame);
+
+        position += header.length;
+        synced = true;
+    }
+
+    if (file.hasError()) {
+        log(Error) << "Failed to read file: " << filename << '\n'
+                   << strerror(errno) << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Decoding a layer III frame exactly needs its audio data from the bit
+// reservoir, and the state left by exactly decoding the two frames before it.
+// So we go back until each of these three frames has all of its reservoir,
+// plus one more frame, as libmad only keeps the part of each frame's audio
+// data not used by the frame itself.
+
+size_t Mp3FrameIndex::getPrerollFrame(size_t frame) const
+{
+    if (frames_.empty()) {
+        return 0;
+    }
+
+    if (frame >= frames_.size()) {
+        frame = frames_.size() - 1;
+    }
+
+    size_t first = frame >= 2 ? frame - 2 : 0;
+
+    for (size_t i = first; i <= frame; ++i) {
+        int bytes_needed = frames_[i].main_data_begin;
+        size_t j = i;
+
+        while (bytes_needed > 0 && j > 0) {
+            --j;
+            bytes_needed -= frames_[j].main_data_size;
+        }
+
+        first = std::min(first, j);
+    }
+
+    return first > 0 ? first - 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+
+std::string Mp3FrameIndex::getIndexFilename(const std::string& filename)
+{
+    return filename + ".idx";
+}
+
+//------------------------------------------------------------------------------
+
+template<typename T>
+static T read(std::istream& stream)
+{
+    T value;
+    stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+}
+
+//------------------------------------------------------------------------------
+
+template<typename T>
+static void write(std::ostream& stream, T value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+//------------------------------------------------------------------------------
+
+// The index is only valid for the file with the same size and modification
+// time as when the index was created.
+
+static bool getFileInfo(const char* filename, int64_t& size, int64_t& time)
+{
+    boost::system::error_code error;
+
+    const boost::uintmax_t file_size = boost::filesystem::file_size(filename, error);
+
+    if (error) {
+        return false;
+    }
+
+    const std::time_t file_time = boost::filesystem::last_write_time(filename, error);
+
+    if (error) {
+        return false;
+    }
+
+    size = static_cast<int64_t>(file_size);
+    time = static_cast<int64_t>(file_time);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool Mp3FrameIndex::load(const char* index_filename, const char* filename)
+{
+    int64_t file_size;
+    int64_t file_time;
+
+    if (!getFileInfo(filename, file_size, file_time)) {
+        return false;
+    }
+
+    std::ifstream input(index_filename, std::ios::in | std::ios::binary);
+
+    if (!input) {
+        return false;
+    }
+
+    input.exceptions(std::ios::badbit | std::ios::failbit | std::ios::eofbit);
+
+    try {
+        char magic[sizeof(MAGIC)];
+        input.read(magic, sizeof(magic));
+
+        if (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            read<int32_t>(input) != VERSION ||
+            read<int64_t>(input) != file_size ||
+            read<int64_t>(input) != file_time) {
+            return false;
+        }
+
+        const int32_t sample_rate       = read<int32_t>(input);
+        const int32_t samples_per_frame = read<int32_t>(input);
+        const uint32_t frame_count      = read<uint32_t>(input);
+
+        if (sample_rate <= 0 || samples_per_frame <= 0) {
+            return false;
+        }
+
+        // Check the file is large enough for the frames before allocating
+        // memory for them
+
+        const std::streamoff frames_start = input.tellg();
+
+        input.seekg(0, std::ios::end);
+
+        const std::streamoff frames_size = input.tellg() - frames_start;
+
+        input.seekg(frames_start, std::ios::beg);
+
+        if (frames_size < 0 ||
+            static_cast<unsigned long long>(frames_size) <
+                static_cast<unsigned long long>(frame_count) * INDEX_FRAME_SIZE) {
+            return false;
+        }
+
+        std::vector<Frame> frames;
+        frames.reserve(frame_count);
+
+        long long offset = 0;
+
+        for (uint32_t i = 0; i < frame_count; ++i) {
+            Frame frame;
+
+            offset += read<uint32_t>(input);
+
+            frame.offset          = offset;
+            frame.main_data_begin = read<uint16_t>(input);
+            frame.main_data_size  = read<uint16_t>(input);
+
+            frames.push_back(frame);
+        }
+
+        sample_rate_       = sample_rate;
+        samples_per_frame_ = samples_per_frame;
+        frames_.swap(frames);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool Mp3FrameIndex::save(const char* index_filename, const char* filename) const
+{
+    int64_t file_size;
+    int64_t file_time;
+
+    if (!getFileInfo(filename, file_size, file_time)) {
+        log(Error) << "Failed to read file: " << filename << '\n';
+        return false;
+    }
+
+    // Write to a temporary file in the same directory and then rename it, so
+    // a reader never sees a partly written index, and an interrupted write
+    // leaves any existing index in place.
+
+    const boost::filesystem::path index_path(index_filename);
+
+    const boost::filesystem::path temp_path = index_path.parent_path() / (
+        index_path.filename().string() +
+        boost::filesystem::unique_path(".%%%%-%%%%-%%%%-%%%%.tmp").string()
+    );
+
+    boost::system::error_code error_code;
+
+    try {
+        std::ofstream output;
+
+        output.exceptions(std::ios::badbit | std::ios::failbit);
+        output.open(temp_path.c_str(), std::ios::out | std::ios::binary);
+
+        output.write(MAGIC, sizeof(MAGIC));
+
+        write<int32_t>(output, VERSION);
+        write<int64_t>(output, file_size);
+        write<int64_t>(output, file_time);
+        write<int32_t>(output, sample_rate_);
+        write<int32_t>(output, samples_per_frame_);
+        write<uint32_t>(output, static_cast<uint32_t>(frames_.size()));
+
+        long long offset = 0;
+
+        for (const auto& frame : frames_) {
+            write<uint32_t>(output, static_cast<uint32_t>(frame.offset - offset));
+            write<uint16_t>(output, static_cast<uint16_t>(frame.main_data_begin));
+            write<uint16_t>(output, static_cast<uint16_t>(frame.main_data_size));
+
+            offset = frame.offset;
+        }
+
+        output.close();
+    }
+    catch (const std::exception&) {
+        log(Error) << "Failed to write file: " << index_filename << '\n'
+                   << strerror(errno) << '\n';
+
+        boost::filesystem::remove(temp_path, error_code);
+        return false;
+    }
+
+    boost::filesystem::rename(temp_path, index_path, error_code);
+
+    if (error_code) {
+        log(Error) << "Failed to write file: " << index_filename << '\n'
+                   << error_code.message() << '\n';
+
+        boost::filesystem::remove(temp_path, error_code);
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_MP3_FRAME_INDEX_H)
+#define INC_MP3_FRAME_INDEX_H
+
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// Holds the position of each MPEG audio frame in an MP3 file, so that
+// Mp3AudioFileReader can seek to any frame without decoding the frames before
+// it.
+//
+// The index is built by reading only the frame headers, following the same
+// rules as libmad for finding frames, so frame N in the index is the Nth
+// frame that libmad decodes. The index can be saved to a file, and is only
+// loaded from it if the MP3 file hasn't changed since.
+
+class Mp3FrameIndex
+{
+    public:
+        Mp3FrameIndex();
+
+    public:
+        bool build(const char* filename);
+
+        bool load(const char* index_filename, const char* filename);
+        bool save(const char* index_filename, const char* filename) const;
+
+        static std::string getIndexFilename(const std::string& filename);
+
+        size_t getFrameCount() const { return frames_.size(); }
+
+        long long getFrameOffset(size_t frame) const { return frames_[frame].offset; }
+
+        int getSampleRate() const { return sample_rate_; }
+        int getSamplesPerFrame() const { return samples_per_frame_; }
+
+        // Returns the frame to start decoding from so that the given frame is
+        // decoded exactly as when decoding the whole file.
+        size_t getPrerollFrame(size_t frame) const;
+
+    private:
+        struct Frame
+        {
+            long long offset;
+
+            // Layer III only: the number of bytes of this frame's audio data
+            // that are in earlier frames (the bit reservoir), and the space
+            // for audio data in this frame
+            int main_data_begin;
+            int main_data_size;
+        };
+
+        int sample_rate_;
+        int samples_per_frame_;
+
+        std::vector<Frame> frames_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_MP3_FRAME_INDEX_H)
+
+//------------------------------------------------------------------------------
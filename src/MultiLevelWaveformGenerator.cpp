@@ -0,0 +1,277 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "MultiLevelWaveformGenerator.h"
+#include "Log.h"
+#include "WaveformBuffer.h"
+#include "WaveformGenerator.h"
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+
+//------------------------------------------------------------------------------
+
+const int MAX_SAMPLE = std::numeric_limits<short>::max();
+const int MIN_SAMPLE = std::numeric_limits<short>::min();
+
+//------------------------------------------------------------------------------
+
+MultiLevelWaveformGenerator::MultiLevelWaveformGenerator(bool split_channels) :
+    split_channels_(split_channels),
+    output_channels_(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+MultiLevelWaveformGenerator::~MultiLevelWaveformGenerator()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void MultiLevelWaveformGenerator::addLevel(
+    WaveformBuffer& buffer,
+    const ScaleFactor& scale_factor)
+{
+    Level level;
+
+    level.buffer            = &buffer;
+    level.scale_factor      = &scale_factor;
+    level.samples_per_pixel = 0;
+    level.source            = -1;
+    level.ratio             = 0;
+    level.source_index      = 0;
+    level.count             = 0;
+
+    levels_.push_back(std::move(level));
+}
+
+//------------------------------------------------------------------------------
+
+bool MultiLevelWaveformGenerator::init(
+    const int sample_rate,
+    const int channels,
+    const long frame_count,
+    const int buffer_size)
+{
+    if (levels_.empty()) {
+        log(Error) << "No zoom levels specified\n";
+        return false;
+    }
+
+    output_channels_ = split_channels_ ? channels : 1;
+
+    order_.clear();
+
+    for (size_t i = 0; i < levels_.size(); ++i) {
+        Level& level = levels_[i];
+
+        level.samples_per_pixel = level.scale_factor->getSamplesPerPixel(sample_rate);
+
+        order_.push_back(i);
+    }
+
+    std::stable_sort(
+        order_.begin(),
+        order_.end(),
+        [this](size_t a, size_t b) {
+            return levels_[a].samples_per_pixel < levels_[b].samples_per_pixel;
+        }
+    );
+
+    for (size_t i = 0; i < order_.size(); ++i) {
+        Level& level = levels_[order_[i]];
+
+        // Fold from the coarsest finer level whose samples per pixel divides
+        // this level's, as that has the fewest points to read
+        for (size_t j = i; j-- > 0; ) {
+            const Level& source = levels_[order_[j]];
+
+            if (source.samples_per_pixel >= 2 &&
+                level.samples_per_pixel % source.samples_per_pixel == 0) {
+                level.source = static_cast<int>(order_[j]);
+                level.ratio  = level.samples_per_pixel / source.samples_per_pixel;
+                break;
+            }
+        }
+
+        if (level.source == -1) {
+            level.generator.reset(new WaveformGenerator(
+                *level.buffer,
+                split_channels_,
+                *level.scale_factor
+            ));
+
+            if (!level.generator->init(sample_rate, channels, frame_count, buffer_size)) {
+                return false;
+            }
+        }
+        else {
+            level.buffer->setSamplesPerPixel(level.samples_per_pixel);
+            level.buffer->setSampleRate(sample_rate);
+            level.buffer->setChannels(output_channels_);
+
+            level.min.resize(static_cast<size_t>(output_channels_), MAX_SAMPLE);
+            level.max.resize(static_cast<size_t>(output_channels_), MIN_SAMPLE);
+
+            log(Info) << "Samples per pixel: " << level.samples_per_pixel
+                      << " (from " << levels_[static_cast<size_t>(level.source)].samples_per_pixel
+                      << ")\n";
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool MultiLevelWaveformGenerator::shouldContinue() const
+{
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void MultiLevelWaveformGenerator::appendSamples(Level& level)
+{
+    for (int channel = 0; channel < output_channels_; ++channel) {
+        const size_t i = static_cast<size_t>(channel);
+
+        level.buffer->appendSamples(
+            static_cast<short>(level.min[i]),
+            static_cast<short>(level.max[i])
+        );
+
+        level.min[i] = MAX_SAMPLE;
+        level.max[i] = MIN_SAMPLE;
+    }
+
+    level.count = 0;
+}
+
+//------------------------------------------------------------------------------
+
+// Combines any new points from the source level into this level.
+
+void MultiLevelWaveformGenerator::fold(Level& level)
+{
+    const WaveformBuffer& source = *levels_[static_cast<size_t>(level.source)].buffer;
+
+    const int size = source.getSize();
+
+    for (; level.source_index < size; ++level.source_index) {
+        for (int channel = 0; channel < output_channels_; ++channel) {
+            const size_t i = static_cast<size_t>(channel);
+
+            const int min = source.getMinSample(channel, level.source_index);
+            const int max = source.getMaxSample(channel, level.source_index);
+
+            if (min < level.min[i]) {
+                level.min[i] = min;
+            }
+
+            if (max > level.max[i]) {
+                level.max[i] = max;
+            }
+        }
+
+        if (++level.count == level.ratio) {
+            appendSamples(level);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Levels are processed from finest to coarsest, so each source level is up
+// to date before any levels folded from it.
+
+bool MultiLevelWaveformGenerator::process(
+    const short* input_buffer,
+    const int input_frame_count)
+{
+    for (size_t i : order_) {
+        Level& level = levels_[i];
+
+        if (level.generator) {
+            level.generator->process(input_buffer, input_frame_count);
+        }
+        else {
+            fold(level);
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool MultiLevelWaveformGenerator::supportsFloat() const
+{
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool MultiLevelWaveformGenerator::processFloat(
+    const float* input_buffer,
+    const int input_frame_count)
+{
+    for (size_t i : order_) {
+        Level& level = levels_[i];
+
+        if (level.generator) {
+            level.generator->processFloat(input_buffer, input_frame_count);
+        }
+        else {
+            fold(level);
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void MultiLevelWaveformGenerator::done()
+{
+    for (size_t i : order_) {
+        Level& level = levels_[i];
+
+        if (level.generator) {
+            level.generator->done();
+        }
+        else {
+            fold(level);
+
+            // The last point covers any remaining samples
+            if (level.count > 0) {
+                appendSamples(level);
+            }
+
+            log(Info) << "Generated " << level.buffer->getSize() << " points\n";
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
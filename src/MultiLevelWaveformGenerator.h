@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_MULTI_LEVEL_WAVEFORM_GENERATOR_H)
+#define INC_MULTI_LEVEL_WAVEFORM_GENERATOR_H
+
+//------------------------------------------------------------------------------
+
+#include "AudioProcessor.h"
+
+#include <memory>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+class ScaleFactor;
+class WaveformBuffer;
+class WaveformGenerator;
+
+//------------------------------------------------------------------------------
+
+// Generates waveform data at several zoom levels from a single pass over the
+// audio.
+//
+// The finest level is computed from the audio samples. Each coarser level
+// whose samples per pixel is an exact multiple of a finer level's is folded
+// from that level's output points as they are produced, which gives the same
+// result as computing it from the audio samples. Any other level is computed
+// from the audio samples by its own WaveformGenerator.
+
+class MultiLevelWaveformGenerator : public AudioProcessor
+{
+    public:
+        MultiLevelWaveformGenerator(bool split_channels);
+        ~MultiLevelWaveformGenerator();
+
+        MultiLevelWaveformGenerator(const MultiLevelWaveformGenerator&) = delete;
+        MultiLevelWaveformGenerator& operator=(const MultiLevelWaveformGenerator&) = delete;
+
+    public:
+        void addLevel(WaveformBuffer& buffer, const ScaleFactor& scale_factor);
+
+        virtual bool init(
+            int sample_rate,
+            int channels,
+            long frame_count,
+            int buffer_size
+        );
+
+        virtual bool shouldContinue() const;
+
+        virtual bool process(
+            const short* input_buffer,
+            int input_frame_count
+        );
+
+        virtual bool supportsFloat() const;
+
+        virtual bool processFloat(
+            const float* input_buffer,
+            int input_frame_count
+        );
+
+        virtual void done();
+
+    private:
+        struct Level
+        {
+            WaveformBuffer* buffer;
+            const ScaleFactor* scale_factor;
+            int samples_per_pixel;
+
+            // Set if this level is computed from the audio samples
+            std::unique_ptr<WaveformGenerator> generator;
+
+            // Otherwise, the index of the level this level is folded from,
+            // and the number of source points per output point
+            int source;
+            int ratio;
+
+            int source_index;
+            int count;
+            std::vector<int> min;
+            std::vector<int> max;
+        };
+
+        void fold(Level& level);
+        void appendSamples(Level& level);
+
+    private:
+        bool split_channels_;
+        int output_channels_;
+
+        std::vector<Level> levels_;
+
+        // Level indexes, in increasing order of samples per pixel
+        std::vector<size_t> order_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_MULTI_LEVEL_WAVEFORM_GENERATOR_H)
+
+//------------------------------------------------------------------------------
@@ -24,30 +24,68 @@
 #include "OptionHandler.h"
 #include "Config.h"
 
-#include "AudioLoader.h"
+#include "BatchRunner.h"
 #include "DurationCalculator.h"
 #include "Error.h"
 #include "FileFormat.h"
 #include "FileUtil.h"
 #include "GdImageRenderer.h"
+#include "JobServer.h"
+#include "JobStats.h"
+#include "JobUtil.h"
 #include "Mp3AudioFileReader.h"
+#include "Mp3FrameIndex.h"
 #include "Log.h"
+#include "MultiLevelWaveformGenerator.h"
 #include "Options.h"
+#include "ParallelWaveformGenerator.h"
+#include "PipelinedAudioProcessor.h"
 #include "SndFileAudioFileReader.h"
 #include "Streams.h"
-#include "VectorAudioFileReader.h"
+#include "TileRenderer.h"
+#include "TimedAudioProcessor.h"
+#include "Trace.h"
 #include "WaveformBuffer.h"
 #include "WaveformColors.h"
 #include "WaveformGenerator.h"
 #include "WaveformRescaler.h"
 #include "WaveformUtil.h"
+#include "WaveformWriter.h"
 #include "WavFileWriter.h"
 
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+static std::unique_ptr<SndFileAudioFileReader> createSndFileAudioFileReader(
+    const FileFormat::FileFormat input_format,
+    const Options& options)
+{
+    std::unique_ptr<SndFileAudioFileReader> reader(new SndFileAudioFileReader);
+
+    if (input_format == FileFormat::Raw) {
+        reader->configure(
+            options.getRawAudioChannels(),
+            options.getRawAudioSampleRate(),
+            options.getRawAudioFormat()
+        );
+    }
+
+    return reader;
+}
 
 //------------------------------------------------------------------------------
 
@@ -61,21 +99,21 @@ static std::unique_ptr<AudioFileReader> createAudioFileReader(
     if (input_format == FileFormat::Wav ||
         input_format == FileFormat::Flac ||
         input_format == FileFormat::Ogg ||
-        input_format == FileFormat::Opus) {
-        reader.reset(new SndFileAudioFileReader);
+        input_format == FileFormat::Opus ||
+        input_format == FileFormat::Raw) {
+        reader = createSndFileAudioFileReader(input_format, options);
     }
     else if (input_format == FileFormat::Mp3) {
-        reader.reset(new Mp3AudioFileReader);
-    }
-    else if (input_format == FileFormat::Raw) {
-        SndFileAudioFileReader* sndfile_audio_file_reader = new SndFileAudioFileReader;
-        reader.reset(sndfile_audio_file_reader);
+        std::unique_ptr<Mp3AudioFileReader> mp3_reader(new Mp3AudioFileReader);
 
-        sndfile_audio_file_reader->configure(
-            options.getRawAudioChannels(),
-            options.getRawAudioSampleRate(),
-            options.getRawAudioFormat()
-        );
+        if (options.getMp3Index() &&
+            !FileUtil::isStdioFilename(input_filename.string().c_str())) {
+            mp3_reader->setFrameIndexFilename(
+                Mp3FrameIndex::getIndexFilename(input_filename.string())
+            );
+        }
+
+        reader = std::move(mp3_reader);
     }
     else {
         throwError("Unknown file type: %1%", input_filename);
@@ -86,9 +124,84 @@ static std::unique_ptr<AudioFileReader> createAudioFileReader(
 
 //------------------------------------------------------------------------------
 
-static std::unique_ptr<ScaleFactor> createScaleFactor(const Options& options)
+// Returns true if the input can be split into frame ranges that are decoded
+// separately. This needs a seekable file of known length, in a format where
+// decoding from a seek point gives exactly the same samples as decoding from
+// the start. libsndfile doesn't guarantee this for Ogg Vorbis or Opus.
+
+static bool isParallelDecodingSupported(
+    const AudioFileReader& audio_file_reader,
+    const boost::filesystem::path& input_filename,
+    const FileFormat::FileFormat input_format)
 {
-    std::unique_ptr<ScaleFactor> scale_factor;
+    if (input_format != FileFormat::Wav &&
+        input_format != FileFormat::Flac &&
+        input_format != FileFormat::Raw) {
+        return false;
+    }
+
+    if (FileUtil::isStdioFilename(input_filename.string().c_str())) {
+        return false;
+    }
+
+    const SndFileAudioFileReader& reader =
+        static_cast<const SndFileAudioFileReader&>(audio_file_reader);
+
+    return reader.isSeekable() && reader.getFrameCount() > 0;
+}
+
+//------------------------------------------------------------------------------
+
+// Runs the reader, and records the time spent decoding the audio separately
+// from the time spent in the processor, for --stats. If pipelined is set, the
+// processor runs on a separate thread, see PipelinedAudioProcessor.
+
+static bool runAudioFileReader(
+    AudioFileReader& audio_file_reader,
+    AudioProcessor& processor,
+    const bool pipelined)
+{
+    TimedAudioProcessor timed_processor(processor);
+
+    StageTimer timer(JobStats::Decode);
+
+    if (pipelined) {
+        PipelinedAudioProcessor pipeline(timed_processor);
+
+        return audio_file_reader.run(pipeline) && !pipeline.hasError();
+    }
+
+    const bool success = audio_file_reader.run(timed_processor);
+
+    // The processor ran on this thread, within the reader
+    timer.exclude(timed_processor.getTime());
+
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+static bool runAudioFileReader(
+    AudioFileReader& audio_file_reader,
+    AudioProcessor& processor,
+    const Options& options)
+{
+    return runAudioFileReader(
+        audio_file_reader,
+        processor,
+        options.getThreads() > 1
+    );
+}
+
+//------------------------------------------------------------------------------
+
+// Returns a scale factor for each zoom level given by the --zoom,
+// --pixels-per-second, or --end options.
+
+static std::vector<std::unique_ptr<ScaleFactor>> createScaleFactors(
+    const Options& options)
+{
+    std::vector<std::unique_ptr<ScaleFactor>> scale_factors;
 
     if (options.hasSamplesPerPixel() && options.hasEndTime()) {
         throwError("Specify either --end or --zoom but not both");
@@ -100,24 +213,58 @@ static std::unique_ptr<ScaleFactor> createScaleFactor(const Options& options)
         throwError("Specify either --zoom or --pixels-per-second but not both");
     }
     else if (options.hasEndTime()) {
-        scale_factor.reset(new DurationScaleFactor(
+        scale_factors.emplace_back(new DurationScaleFactor(
             options.getStartTime(),
             options.getEndTime(),
             options.getImageWidth()
         ));
     }
     else if (options.hasPixelsPerSecond()) {
-        scale_factor.reset(
-            new PixelsPerSecondScaleFactor(options.getPixelsPerSecond())
-        );
+        for (int pixels_per_second : options.getPixelsPerSecondValues()) {
+            scale_factors.emplace_back(
+                new PixelsPerSecondScaleFactor(pixels_per_second)
+            );
+        }
     }
     else {
-        scale_factor.reset(
-            new SamplesPerPixelScaleFactor(options.getSamplesPerPixel())
-        );
+        for (int samples_per_pixel : options.getSamplesPerPixelValues()) {
+            scale_factors.emplace_back(
+                new SamplesPerPixelScaleFactor(samples_per_pixel)
+            );
+        }
+    }
+
+    return scale_factors;
+}
+
+//------------------------------------------------------------------------------
+
+static std::unique_ptr<ScaleFactor> createScaleFactor(const Options& options)
+{
+    std::vector<std::unique_ptr<ScaleFactor>> scale_factors =
+        createScaleFactors(options);
+
+    if (scale_factors.size() != 1) {
+        throwError("Multiple zoom levels can only be used when generating waveform data from audio");
     }
 
-    return scale_factor;
+    return std::move(scale_factors[0]);
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the output filename for one of several zoom levels, e.g.,
+// test.dat -> test-256.dat
+
+static boost::filesystem::path getZoomLevelFilename(
+    const boost::filesystem::path& filename,
+    const int zoom)
+{
+    const std::string level_filename =
+        filename.stem().string() + "-" + std::to_string(zoom) +
+        filename.extension().string();
+
+    return filename.parent_path() / level_filename;
 }
 
 //------------------------------------------------------------------------------
@@ -154,8 +301,12 @@ static std::pair<bool, double> getDuration(
 
     DurationCalculator duration_calculator;
 
-    if (!audio_file_reader->run(duration_calculator)) {
-        return std::make_pair(false, 0);
+    {
+        StageTimer timer(JobStats::Decode);
+
+        if (!audio_file_reader->run(duration_calculator)) {
+            return std::make_pair(false, 0);
+        }
     }
 
     const double duration = duration_calculator.getDuration();
@@ -200,7 +351,180 @@ bool OptionHandler::convertAudioFormat(
 
     WavFileWriter writer(output_filename.string().c_str());
 
-    return reader->run(writer);
+    return runAudioFileReader(*reader, writer, false);
+}
+
+//------------------------------------------------------------------------------
+
+static void applyAutoAmplitudeScale(
+    WaveformBuffer& buffer,
+    const Options& options)
+{
+    if (options.isAutoAmplitudeScale() && buffer.getSize() > 0) {
+        const double amplitude_scale = WaveformUtil::getAmplitudeScale(
+            buffer, 0, buffer.getSize()
+        );
+
+        WaveformUtil::scaleWaveformAmplitude(buffer, amplitude_scale);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static bool writeWaveformData(
+    const WaveformBuffer& buffer,
+    const boost::filesystem::path& output_filename,
+    const FileFormat::FileFormat output_format,
+    const int bits,
+    const Options& options)
+{
+    assert(output_format == FileFormat::Dat ||
+           output_format == FileFormat::Json);
+
+    if (output_format == FileFormat::Dat) {
+        return buffer.save(
+            output_filename.string().c_str(),
+            bits,
+            options.getFormatVersion(),
+            options.getBlockSize()
+        );
+    }
+    else {
+        return buffer.saveAsJson(output_filename.string().c_str(), bits);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static bool saveWaveformData(
+    WaveformBuffer& buffer,
+    const boost::filesystem::path& output_filename,
+    const FileFormat::FileFormat output_format,
+    const Options& options)
+{
+    applyAutoAmplitudeScale(buffer, options);
+
+    return writeWaveformData(
+        buffer,
+        output_filename,
+        output_format,
+        options.getBits(),
+        options
+    );
+}
+
+//------------------------------------------------------------------------------
+
+// Generates waveform data at a single zoom level, writing it to the output
+// file as it is generated. If generating the data fails, the incomplete
+// output file is removed.
+
+static bool streamWaveformData(
+    AudioFileReader& audio_file_reader,
+    const ScaleFactor& scale_factor,
+    const boost::filesystem::path& output_filename,
+    const FileFormat::FileFormat output_format,
+    const Options& options)
+{
+    assert(output_format == FileFormat::Dat ||
+           output_format == FileFormat::Json);
+
+    const std::string filename = output_filename.string();
+
+    bool success = false;
+
+    {
+        WaveformBuffer buffer;
+
+        WaveformGenerator generator(buffer, options.getSplitChannels(), scale_factor);
+
+        WaveformWriter writer(
+            generator,
+            buffer,
+            output_format,
+            options.getBits(),
+            options.getFormatVersion()
+        );
+
+        if (!writer.open(filename.c_str())) {
+            return false;
+        }
+
+        success = runAudioFileReader(audio_file_reader, writer, options) &&
+                  !writer.hasError();
+    }
+
+    // The output file is closed before being removed
+    if (!success && !FileUtil::isStdioFilename(filename.c_str())) {
+        boost::system::error_code error_code;
+        boost::filesystem::remove(output_filename, error_code);
+    }
+
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+// Generates waveform data at each of the given scales from a single pass over
+// the audio. If parallel is set, the audio is split into frame ranges that are
+// decoded on separate threads, see ParallelWaveformGenerator.
+
+static bool generateLevels(
+    AudioFileReader& audio_file_reader,
+    const boost::filesystem::path& input_filename,
+    const FileFormat::FileFormat input_format,
+    const bool parallel,
+    const std::vector<std::unique_ptr<ScaleFactor>>& scale_factors,
+    const std::vector<std::unique_ptr<WaveformBuffer>>& buffers,
+    const Options& options)
+{
+    assert(scale_factors.size() == buffers.size());
+
+    const bool split_channels = options.getSplitChannels();
+
+    if (parallel) {
+        const SndFileAudioFileReader& reader =
+            static_cast<const SndFileAudioFileReader&>(audio_file_reader);
+
+        ParallelWaveformGenerator processor(options.getThreads(), split_channels);
+
+        for (size_t i = 0; i < scale_factors.size(); ++i) {
+            processor.addLevel(*buffers[i], *scale_factors[i]);
+        }
+
+        // The time spent opening, decoding, and processing each range of the
+        // audio is recorded by the worker threads
+        return processor.run(
+            [&](long long start_frame, long long end_frame) -> std::unique_ptr<AudioFileReader> {
+                std::unique_ptr<SndFileAudioFileReader> range_reader =
+                    createSndFileAudioFileReader(input_format, options);
+
+                if (!range_reader->open(input_filename.string().c_str(), false) ||
+                    !range_reader->setFrameRange(start_frame, end_frame)) {
+                    return nullptr;
+                }
+
+                return std::unique_ptr<AudioFileReader>(range_reader.release());
+            },
+            reader.getSampleRate(),
+            reader.getFrameCount()
+        );
+    }
+    else if (scale_factors.size() > 1) {
+        // Generate all zoom levels from a single pass over the audio
+        MultiLevelWaveformGenerator processor(split_channels);
+
+        for (size_t i = 0; i < scale_factors.size(); ++i) {
+            processor.addLevel(*buffers[i], *scale_factors[i]);
+        }
+
+        return runAudioFileReader(audio_file_reader, processor, options);
+    }
+    else {
+        WaveformGenerator processor(*buffers[0], split_channels, *scale_factors[0]);
+
+        return runAudioFileReader(audio_file_reader, processor, options);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -212,9 +536,15 @@ bool OptionHandler::generateWaveformData(
     const FileFormat::FileFormat output_format,
     const Options& options)
 {
-    const std::unique_ptr<ScaleFactor> scale_factor = createScaleFactor(options);
+    const std::vector<std::unique_ptr<ScaleFactor>> scale_factors =
+        createScaleFactors(options);
 
-    const boost::filesystem::path output_file_ext = output_filename.extension();
+    const bool multiple_levels = scale_factors.size() > 1;
+
+    if (multiple_levels &&
+        FileUtil::isStdioFilename(output_filename.string().c_str())) {
+        throwError("Cannot write multiple zoom levels to standard output");
+    }
 
     const std::unique_ptr<AudioFileReader> audio_file_reader =
         createAudioFileReader(input_filename, input_format, options);
@@ -223,33 +553,71 @@ bool OptionHandler::generateWaveformData(
         return false;
     }
 
-    WaveformBuffer buffer;
-    const bool split_channels = options.getSplitChannels();
-    WaveformGenerator processor(buffer, split_channels, *scale_factor);
+    const int threads = options.getThreads();
 
-    if (!audio_file_reader->run(processor)) {
-        return false;
+    const bool parallel = threads > 1 && isParallelDecodingSupported(
+        *audio_file_reader,
+        input_filename,
+        input_format
+    );
+
+    if (threads > 1 && !parallel) {
+        log(Info) << "Decoding audio and generating waveform data on separate threads\n";
     }
 
-    if (options.isAutoAmplitudeScale() && buffer.getSize() > 0) {
-        const double amplitude_scale = WaveformUtil::getAmplitudeScale(
-            buffer, 0, buffer.getSize()
+    // Auto amplitude scaling needs all the waveform data, so can't be used
+    // when writing the data as it is generated. Nor can an indexed .dat
+    // file, as the size of the index depends on the length
+    const bool indexed = output_format == FileFormat::Dat && options.getBlockSize() > 0;
+
+    if (!parallel && !multiple_levels && !options.isAutoAmplitudeScale() && !indexed) {
+        return streamWaveformData(
+            *audio_file_reader,
+            *scale_factors[0],
+            output_filename,
+            output_format,
+            options
         );
+    }
 
-        WaveformUtil::scaleWaveformAmplitude(buffer, amplitude_scale);
+    std::vector<std::unique_ptr<WaveformBuffer>> buffers;
+
+    for (size_t i = 0; i < scale_factors.size(); ++i) {
+        buffers.emplace_back(new WaveformBuffer);
     }
 
-    assert(output_format == FileFormat::Dat ||
-           output_format == FileFormat::Json);
+    const bool success = generateLevels(
+        *audio_file_reader,
+        input_filename,
+        input_format,
+        parallel,
+        scale_factors,
+        buffers,
+        options
+    );
 
-    const int bits = options.getBits();
+    if (!success) {
+        return false;
+    }
 
-    if (output_format == FileFormat::Dat) {
-        return buffer.save(output_filename.string().c_str(), bits);
+    if (!multiple_levels) {
+        return saveWaveformData(*buffers[0], output_filename, output_format, options);
     }
-    else {
-        return buffer.saveAsJson(output_filename.string().c_str(), bits);
+
+    const std::vector<int>& zoom_levels = options.hasPixelsPerSecond() ?
+        options.getPixelsPerSecondValues() :
+        options.getSamplesPerPixelValues();
+
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        const boost::filesystem::path level_filename =
+            getZoomLevelFilename(output_filename, zoom_levels[i]);
+
+        if (!saveWaveformData(*buffers[i], level_filename, output_format, options)) {
+            return false;
+        }
     }
+
+    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -293,7 +661,12 @@ bool OptionHandler::convertWaveformData(
     const boost::filesystem::path output_file_ext = output_filename.extension();
 
     if (output_format == FileFormat::Dat) {
-        success = buffer.save(output_filename.string().c_str(), bits);
+        success = buffer.save(
+            output_filename.string().c_str(),
+            bits,
+            options.getFormatVersion(),
+            options.getBlockSize()
+        );
     }
     else if (output_format == FileFormat::Json) {
         success = buffer.saveAsJson(output_filename.string().c_str(), bits);
@@ -380,50 +753,383 @@ static bool isBarStyleRounded(const Options& options)
 
 //------------------------------------------------------------------------------
 
-bool OptionHandler::renderWaveformImage(
-    const boost::filesystem::path& input_filename,
-    const FileFormat::FileFormat input_format,
-    const boost::filesystem::path& output_filename,
-    const Options& options)
+static PngFilter getPngFilter(const Options& options)
 {
-    std::unique_ptr<ScaleFactor> scale_factor;
+    const std::string& filter = options.getPngFilter();
 
-    const bool calculate_duration = options.isAutoSamplesPerPixel();
+    PngFilter png_filter = PngFilter::Default;
 
-    if (!calculate_duration) {
-        scale_factor = createScaleFactor(options);
+    if (filter == "default") {
+        png_filter = PngFilter::Default;
     }
-
-    const WaveformColors colors = createWaveformColors(options);
-
-    GdImageRenderer renderer;
-
-    if (!renderer.setStartTime(options.getStartTime())) {
-        return false;
+    else if (filter == "none") {
+        png_filter = PngFilter::None;
     }
-
-    if (isWaveformStyleBars(options)) {
-        if (!renderer.setBarStyle(
-            options.getBarWidth(),
-            options.getBarGap(),
-            isBarStyleRounded(options)))
-        {
-            return false;
-        }
+    else if (filter == "sub") {
+        png_filter = PngFilter::Sub;
+    }
+    else if (filter == "up") {
+        png_filter = PngFilter::Up;
+    }
+    else if (filter == "average") {
+        png_filter = PngFilter::Average;
+    }
+    else if (filter == "paeth") {
+        png_filter = PngFilter::Paeth;
+    }
+    else if (filter == "all") {
+        png_filter = PngFilter::All;
+    }
+    else {
+        throwError("Unknown PNG filter: %1%", filter);
     }
 
-    renderer.setAmplitudeScale(
-        options.isAutoAmplitudeScale(),
-        options.getAmplitudeScale()
-    );
+    return png_filter;
+}
 
-    renderer.enableAxisLabels(options.getRenderAxisLabels());
+//------------------------------------------------------------------------------
 
-    int output_samples_per_pixel = 0;
+static PngStrategy getPngStrategy(const Options& options)
+{
+    const std::string& strategy = options.getPngStrategy();
+
+    PngStrategy png_strategy = PngStrategy::Default;
+
+    if (strategy == "default") {
+        png_strategy = PngStrategy::Default;
+    }
+    else if (strategy == "filtered") {
+        png_strategy = PngStrategy::Filtered;
+    }
+    else if (strategy == "huffman") {
+        png_strategy = PngStrategy::HuffmanOnly;
+    }
+    else if (strategy == "rle") {
+        png_strategy = PngStrategy::Rle;
+    }
+    else if (strategy == "fixed") {
+        png_strategy = PngStrategy::Fixed;
+    }
+    else {
+        throwError("Unknown PNG strategy: %1%", strategy);
+    }
+
+    return png_strategy;
+}
+
+//------------------------------------------------------------------------------
+
+static PngOptions createPngOptions(const Options& options)
+{
+    PngOptions png_options;
+
+    png_options.compression_level = options.getPngCompressionLevel();
+    png_options.filter            = getPngFilter(options);
+    png_options.strategy          = getPngStrategy(options);
+    png_options.palette           = options.getPngPalette();
+
+    return png_options;
+}
+
+//------------------------------------------------------------------------------
+
+static bool configureRenderer(GdImageRenderer& renderer, const Options& options)
+{
+    if (!renderer.setStartTime(options.getStartTime())) {
+        return false;
+    }
+
+    if (isWaveformStyleBars(options)) {
+        if (!renderer.setBarStyle(
+            options.getBarWidth(),
+            options.getBarGap(),
+            isBarStyleRounded(options)))
+        {
+            return false;
+        }
+    }
+
+    renderer.setAmplitudeScale(
+        options.isAutoAmplitudeScale(),
+        options.getAmplitudeScale()
+    );
+
+    renderer.enableAxisLabels(options.getRenderAxisLabels());
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Renders the waveform data to a PNG file, first rescaling it if the image
+// has more samples per pixel than the waveform data.
+
+static bool saveWaveformImage(
+    GdImageRenderer& renderer,
+    const WaveformBuffer& input_buffer,
+    const int output_samples_per_pixel,
+    const boost::filesystem::path& output_filename,
+    const int image_width,
+    const int image_height,
+    const WaveformColors& colors,
+    const Options& options)
+{
+    WaveformBuffer output_buffer;
+    const WaveformBuffer* render_buffer = nullptr;
+
+    const int input_samples_per_pixel = input_buffer.getSamplesPerPixel();
+
+    if (output_samples_per_pixel == input_samples_per_pixel) {
+        // No need to rescale
+        render_buffer = &input_buffer;
+    }
+    else if (output_samples_per_pixel > input_samples_per_pixel) {
+        WaveformRescaler rescaler(options.getThreads());
+
+        rescaler.rescale(
+            input_buffer,
+            output_buffer,
+            output_samples_per_pixel
+        );
+
+        render_buffer = &output_buffer;
+    }
+    else {
+        log(Error) << "Invalid zoom, minimum: " << input_samples_per_pixel << '\n';
+        return false;
+    }
+
+    renderer.setBufferStartIndex(render_buffer->getStartIndex());
+
+    // Draw and write the image a strip at a time, so that very large images
+    // don't need to be kept in memory
+    return renderer.renderAsPng(
+        *render_buffer,
+        image_width,
+        image_height,
+        colors,
+        output_filename.string().c_str(),
+        createPngOptions(options)
+    );
+}
+
+//------------------------------------------------------------------------------
+
+// Finds the range of points shown in the image at the given scale. The range
+// starts on a pixel boundary, and at the start of a bar if rendering bars, so
+// the image is the same as from using all the points. Returns false if the
+// whole waveform should be used instead.
+
+static bool getRenderRange(
+    const int sample_rate,
+    const int samples_per_pixel,
+    const Options& options,
+    int& first_index,
+    long long& end_index)
+{
+    const int image_width = options.getImageWidth();
+
+    // Leave any errors to be reported by WaveformGenerator or GdImageRenderer
+    if (sample_rate <= 0 || samples_per_pixel < 2 || image_width < 1) {
+        return false;
+    }
+
+    int bar_total = 1;
+
+    if (isWaveformStyleBars(options)) {
+        bar_total = options.getBarWidth() + options.getBarGap();
+
+        if (bar_total < 1) {
+            return false;
+        }
+    }
+
+    // Same as GdImageRenderer::secondsToPixels()
+    const int start_index = static_cast<int>(
+        options.getStartTime() * sample_rate / samples_per_pixel
+    );
+
+    first_index = (start_index / bar_total) * bar_total;
+
+    // Bars can extend up to bar_total points past the edge of the image
+    end_index = static_cast<long long>(start_index) + image_width + bar_total;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Returns true if the reader can skip to a frame range and give exactly the
+// same samples as decoding from the start. As with parallel decoding, this
+// excludes Ogg Vorbis and Opus, and inputs that can't be seeked, such as
+// pipes. Mp3AudioFileReader decodes and drops frames if it can't seek, and
+// leaves the sample rate unknown for inputs that can't be seeked.
+
+static bool isFrameRangeSupported(
+    const AudioFileReader& audio_file_reader,
+    const boost::filesystem::path& input_filename,
+    const FileFormat::FileFormat input_format)
+{
+    if (FileUtil::isStdioFilename(input_filename.string().c_str())) {
+        return false;
+    }
+
+    if (input_format == FileFormat::Mp3) {
+        return true;
+    }
+
+    if (input_format != FileFormat::Wav &&
+        input_format != FileFormat::Flac &&
+        input_format != FileFormat::Raw) {
+        return false;
+    }
+
+    const SndFileAudioFileReader& reader =
+        static_cast<const SndFileAudioFileReader&>(audio_file_reader);
+
+    return reader.isSeekable();
+}
+
+//------------------------------------------------------------------------------
+
+// Restricts the audio file reader to the frames needed to render the image,
+// so that audio before the start time or after the end of the image isn't
+// decoded. Returns the index of the first pixel that will be read, or -1 on
+// failure. Returns 0 if the whole input should be decoded instead.
+
+static int setRenderFrameRange(
+    AudioFileReader& audio_file_reader,
+    const boost::filesystem::path& input_filename,
+    const FileFormat::FileFormat input_format,
+    const ScaleFactor& scale_factor,
+    const Options& options)
+{
+    if (!isFrameRangeSupported(audio_file_reader, input_filename, input_format)) {
+        return 0;
+    }
+
+    const int sample_rate = audio_file_reader.getSampleRate();
+
+    if (sample_rate <= 0) {
+        return 0;
+    }
+
+    const int samples_per_pixel = scale_factor.getSamplesPerPixel(sample_rate);
+
+    int first_index;
+    long long end_index;
+
+    if (!getRenderRange(sample_rate, samples_per_pixel, options, first_index, end_index)) {
+        return 0;
+    }
+
+    if (!audio_file_reader.setFrameRange(
+        static_cast<long long>(first_index) * samples_per_pixel,
+        end_index * samples_per_pixel))
+    {
+        return -1;
+    }
+
+    return first_index;
+}
+
+//------------------------------------------------------------------------------
+
+// Loads the part of a .dat file needed to render the image. For an indexed
+// file, only the blocks that contain these points are read. If the image is
+// rendered at a larger scale than the file, the range starts at the first
+// point used by the first rescaled point, see WaveformRescaler.
+
+static bool loadRenderRange(
+    WaveformBuffer& buffer,
+    const boost::filesystem::path& input_filename,
+    const ScaleFactor& scale_factor,
+    const Options& options)
+{
+    const std::string filename = input_filename.string();
+
+    // The file can only be read once from standard input
+    if (FileUtil::isStdioFilename(filename.c_str())) {
+        return buffer.load(filename.c_str());
+    }
+
+    // Read the header, to find the sample rate and scale
+    if (!buffer.load(filename.c_str(), 0, 0)) {
+        return false;
+    }
+
+    const int sample_rate = buffer.getSampleRate();
+    const int input_samples_per_pixel = buffer.getSamplesPerPixel();
+    const int output_samples_per_pixel = scale_factor.getSamplesPerPixel(sample_rate);
+
+    int first_index;
+    long long end_index;
+
+    if (output_samples_per_pixel < input_samples_per_pixel ||
+        !getRenderRange(sample_rate, output_samples_per_pixel, options, first_index, end_index)) {
+        return buffer.load(filename.c_str());
+    }
+
+    const long long start = static_cast<long long>(first_index) *
+        output_samples_per_pixel / input_samples_per_pixel;
+
+    const long long end = end_index * output_samples_per_pixel / input_samples_per_pixel;
+
+    const long long max_index = std::numeric_limits<int>::max();
+
+    return buffer.load(
+        filename.c_str(),
+        static_cast<int>(std::min(start, max_index)),
+        static_cast<int>(std::min(end, max_index))
+    );
+}
+
+//------------------------------------------------------------------------------
+
+// Limits on the number of points when generating waveform data to fit the
+// image width from audio of unknown duration. See renderWaveformImage().
+
+const int AUTO_ZOOM_MAX_POINTS = 1 << 20;
+const int AUTO_ZOOM_MIN_POINTS_PER_PIXEL = 16;
+
+//------------------------------------------------------------------------------
+
+bool OptionHandler::renderWaveformImage(
+    const boost::filesystem::path& input_filename,
+    const FileFormat::FileFormat input_format,
+    const boost::filesystem::path& output_filename,
+    const Options& options)
+{
+    std::unique_ptr<ScaleFactor> scale_factor;
+
+    const bool calculate_duration = options.isAutoSamplesPerPixel();
+
+    if (!calculate_duration) {
+        scale_factor = createScaleFactor(options);
+    }
+
+    const WaveformColors colors = createWaveformColors(options);
+
+    GdImageRenderer renderer;
+
+    if (!configureRenderer(renderer, options)) {
+        return false;
+    }
+
+    int output_samples_per_pixel = 0;
 
     WaveformBuffer input_buffer;
 
-    if (input_format == FileFormat::Dat || input_format == FileFormat::Json) {
+    if (input_format == FileFormat::Dat && !calculate_duration) {
+        if (!loadRenderRange(input_buffer, input_filename, *scale_factor, options)) {
+            return false;
+        }
+
+        output_samples_per_pixel = scale_factor->getSamplesPerPixel(
+            input_buffer.getSampleRate()
+        );
+    }
+    else if (input_format == FileFormat::Dat || input_format == FileFormat::Json) {
         if (!loadWaveformData(input_buffer, input_filename, input_format)) {
             return false;
         }
@@ -442,7 +1148,10 @@ bool OptionHandler::renderWaveformImage(
     }
     else {
         // Seeking to the start of the audio won't work if reading from a pipe
-        // or a socket, so we buffer the entire audio data in memory.
+        // or a socket, so the duration isn't known until all the audio has
+        // been read. The waveform data is generated in the same pass, with
+        // the samples per pixel doubled whenever the number of points reaches
+        // a limit, then rescaled to the image width.
 
         if (FileUtil::isStdioFilename(input_filename.string().c_str()) &&
             !FileUtil::isStdinSeekable() &&
@@ -456,27 +1165,41 @@ bool OptionHandler::renderWaveformImage(
                 return false;
             }
 
-            AudioLoader loader;
+            const bool split_channels = options.getSplitChannels();
+
+            SamplesPerPixelScaleFactor initial_scale_factor(1);
 
-            if (!audio_file_reader->run(loader)) {
+            WaveformGenerator processor(input_buffer, split_channels, initial_scale_factor);
+
+            // Audio shorter than the limit is kept at one sample per pixel,
+            // so the result is the same as generating the waveform data at
+            // the final scale. Otherwise the samples per pixel stays well
+            // below the final scale, so rescaling loses little accuracy.
+            processor.setMaxSize(std::max(
+                AUTO_ZOOM_MAX_POINTS,
+                options.getImageWidth() * AUTO_ZOOM_MIN_POINTS_PER_PIXEL
+            ));
+
+            if (!runAudioFileReader(*audio_file_reader, processor, options)) {
                 return false;
             }
 
+            const double duration =
+                static_cast<double>(processor.getFrameCount()) /
+                static_cast<double>(input_buffer.getSampleRate());
+
             scale_factor.reset(
-                new DurationScaleFactor(0.0, loader.getDuration(), options.getImageWidth())
+                new DurationScaleFactor(0.0, duration, options.getImageWidth())
             );
 
-            const bool split_channels = options.getSplitChannels();
-
-            WaveformGenerator processor(input_buffer, split_channels, *scale_factor);
-
-            VectorAudioFileReader reader(loader.getData(), loader.getSampleRate(), loader.getChannels());
+            output_samples_per_pixel = scale_factor->getSamplesPerPixel(
+                input_buffer.getSampleRate()
+            );
 
-            if (!reader.run(processor)) {
+            if (output_samples_per_pixel < 2) {
+                log(Error) << "Invalid zoom: minimum 2\n";
                 return false;
             }
-
-            output_samples_per_pixel = input_buffer.getSamplesPerPixel();
         }
         else {
             if (calculate_duration) {
@@ -501,96 +1224,398 @@ bool OptionHandler::renderWaveformImage(
                 return false;
             }
 
-            const bool split_channels = options.getSplitChannels();
+            const int buffer_start_index = setRenderFrameRange(
+                *audio_file_reader,
+                input_filename,
+                input_format,
+                *scale_factor,
+                options
+            );
+
+            if (buffer_start_index < 0) {
+                return false;
+            }
+
+            input_buffer.setStartIndex(buffer_start_index);
+
+            const bool split_channels = options.getSplitChannels();
+
+            WaveformGenerator processor(input_buffer, split_channels, *scale_factor);
+
+            if (!runAudioFileReader(*audio_file_reader, processor, options)) {
+                return false;
+            }
+
+            output_samples_per_pixel = input_buffer.getSamplesPerPixel();
+        }
+    }
+
+    return saveWaveformImage(
+        renderer,
+        input_buffer,
+        output_samples_per_pixel,
+        output_filename,
+        options.getImageWidth(),
+        options.getImageHeight(),
+        colors,
+        options
+    );
+}
+
+//------------------------------------------------------------------------------
+
+bool OptionHandler::resampleWaveformData(
+    const boost::filesystem::path& input_filename,
+    FileFormat::FileFormat input_format,
+    const boost::filesystem::path& output_filename,
+    FileFormat::FileFormat output_format,
+    const Options& options)
+{
+    WaveformBuffer input_buffer;
+
+    if (!loadWaveformData(input_buffer, input_filename, input_format)) {
+        return false;
+    }
+
+    std::unique_ptr<ScaleFactor> scale_factor = createScaleFactor(options);
+
+    int output_samples_per_pixel = scale_factor->getSamplesPerPixel(
+        input_buffer.getSampleRate()
+    );
+
+    WaveformBuffer output_buffer;
+    WaveformRescaler rescaler(options.getThreads());
+
+    rescaler.rescale(
+        input_buffer,
+        output_buffer,
+        output_samples_per_pixel
+    );
+
+    const int bits = options.hasBits() ? options.getBits() : input_buffer.getBits();
+
+    if (output_format == FileFormat::Dat) {
+        return output_buffer.save(
+            output_filename.string().c_str(),
+            bits,
+            options.getFormatVersion(),
+            options.getBlockSize()
+        );
+    }
+    else {
+        return output_buffer.saveAsJson(output_filename.string().c_str(), bits);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the scale factor for one of several output files, from the zoom
+// given for that file, or else from the --zoom, --pixels-per-second, or --end
+// options. Returns nullptr if the zoom is 'auto', as this depends on the
+// duration of the audio.
+
+static std::unique_ptr<ScaleFactor> createScaleFactor(
+    const OutputFile& output_file,
+    const Options& options)
+{
+    if (output_file.has_samples_per_pixel) {
+        if (output_file.auto_samples_per_pixel) {
+            return nullptr;
+        }
+
+        return std::unique_ptr<ScaleFactor>(
+            new SamplesPerPixelScaleFactor(output_file.samples_per_pixel)
+        );
+    }
+    else if (output_file.has_pixels_per_second) {
+        return std::unique_ptr<ScaleFactor>(
+            new PixelsPerSecondScaleFactor(output_file.pixels_per_second)
+        );
+    }
+    else if (options.isAutoSamplesPerPixel()) {
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<ScaleFactor>> scale_factors =
+        createScaleFactors(options);
+
+    if (scale_factors.size() != 1) {
+        throwError("Multiple zoom levels can't be used with more than one output file");
+    }
+
+    if (options.hasEndTime()) {
+        // Fit the time range to this file's image width
+        return std::unique_ptr<ScaleFactor>(new DurationScaleFactor(
+            options.getStartTime(),
+            options.getEndTime(),
+            output_file.image_width
+        ));
+    }
+
+    return std::move(scale_factors[0]);
+}
+
+//------------------------------------------------------------------------------
+
+// Writes several output files from a single pass over the input. From audio,
+// the waveform data for every output file is generated together, see
+// MultiLevelWaveformGenerator. Waveform data input is loaded once, and
+// rescaled once for each different zoom level.
+
+bool OptionHandler::generateOutputFiles(
+    const boost::filesystem::path& input_filename,
+    const FileFormat::FileFormat input_format,
+    const Options& options)
+{
+    const std::vector<OutputFile>& output_files = options.getOutputFiles();
+
+    const bool audio_input = FileFormat::isAudioFormat(input_format);
+
+    if (!FileFormat::isSupported(input_format) ||
+        (!audio_input && !FileFormat::isWaveformDataFormat(input_format))) {
+        throwError(
+            "Can't generate output files from %1% format input",
+            FileFormat::toString(input_format)
+        );
+    }
+
+    bool render_images = false;
+
+    for (const auto& output_file : output_files) {
+        if (output_file.format != FileFormat::Dat &&
+            output_file.format != FileFormat::Json &&
+            output_file.format != FileFormat::Png) {
+            throwError(
+                "Can't generate %1% format output with more than one output file",
+                FileFormat::toString(output_file.format)
+            );
+        }
+
+        if (output_file.format == FileFormat::Png) {
+            render_images = true;
+        }
+    }
+
+    const WaveformColors colors = render_images ?
+        createWaveformColors(options) :
+        WaveformColors();
+
+    // Check the image options before reading the input
+    std::vector<std::unique_ptr<GdImageRenderer>> renderers;
+
+    for (const auto& output_file : output_files) {
+        std::unique_ptr<GdImageRenderer> renderer;
+
+        if (output_file.format == FileFormat::Png) {
+            renderer.reset(new GdImageRenderer);
+
+            if (!configureRenderer(*renderer, options)) {
+                return false;
+            }
+        }
+
+        renderers.push_back(std::move(renderer));
+    }
+
+    std::vector<std::unique_ptr<ScaleFactor>> scale_factors;
+
+    bool calculate_duration = false;
+
+    for (const auto& output_file : output_files) {
+        scale_factors.push_back(createScaleFactor(output_file, options));
+
+        if (!scale_factors.back()) {
+            calculate_duration = true;
+        }
+    }
+
+    double duration = 0.0;
+
+    WaveformBuffer input_buffer;
+
+    if (audio_input && calculate_duration) {
+        if (FileUtil::isStdioFilename(input_filename.string().c_str()) &&
+            !FileUtil::isStdinSeekable()) {
+            throwError("Can't use --zoom auto with more than one output file when reading audio from a pipe");
+        }
+
+        auto result = getDuration(input_filename, input_format, options);
+
+        if (!result.first) {
+            return false;
+        }
+
+        duration = result.second;
+    }
+    else if (!audio_input) {
+        if (!loadWaveformData(input_buffer, input_filename, input_format)) {
+            return false;
+        }
+
+        duration = getDuration(input_buffer);
+    }
+
+    for (size_t i = 0; i < output_files.size(); ++i) {
+        if (!scale_factors[i]) {
+            scale_factors[i].reset(
+                new DurationScaleFactor(0.0, duration, output_files[i].image_width)
+            );
+        }
+    }
+
+    std::vector<std::unique_ptr<WaveformBuffer>> buffers;
+
+    // The waveform data for each output file, some of which may be shared
+    std::vector<WaveformBuffer*> output_buffers;
+
+    int bits = options.getBits();
+
+    if (audio_input) {
+        const std::unique_ptr<AudioFileReader> audio_file_reader =
+            createAudioFileReader(input_filename, input_format, options);
+
+        if (!audio_file_reader->open(input_filename.string().c_str(), !calculate_duration)) {
+            return false;
+        }
+
+        const int threads = options.getThreads();
+
+        const bool parallel = threads > 1 && isParallelDecodingSupported(
+            *audio_file_reader,
+            input_filename,
+            input_format
+        );
 
-            WaveformGenerator processor(input_buffer, split_channels, *scale_factor);
+        if (threads > 1 && !parallel) {
+            log(Info) << "Decoding audio and generating waveform data on separate threads\n";
+        }
 
-            if (!audio_file_reader->run(processor)) {
-                return false;
-            }
+        for (size_t i = 0; i < output_files.size(); ++i) {
+            buffers.emplace_back(new WaveformBuffer);
+            output_buffers.push_back(buffers.back().get());
+        }
 
-            output_samples_per_pixel = input_buffer.getSamplesPerPixel();
+        if (!generateLevels(
+            *audio_file_reader,
+            input_filename,
+            input_format,
+            parallel,
+            scale_factors,
+            buffers,
+            options))
+        {
+            return false;
         }
     }
+    else {
+        if (!options.hasBits()) {
+            bits = input_buffer.getBits();
+        }
 
-    WaveformBuffer output_buffer;
-    WaveformBuffer* render_buffer = nullptr;
+        const int input_samples_per_pixel = input_buffer.getSamplesPerPixel();
 
-    const int input_samples_per_pixel = input_buffer.getSamplesPerPixel();
+        const bool has_resampling_option = options.hasSamplesPerPixel() ||
+                                           options.hasPixelsPerSecond() ||
+                                           options.hasEndTime();
 
-    if (output_samples_per_pixel == input_samples_per_pixel) {
-        // No need to rescale
-        render_buffer = &input_buffer;
-    }
-    else if (output_samples_per_pixel > input_samples_per_pixel) {
-        WaveformRescaler rescaler;
+        for (size_t i = 0; i < output_files.size(); ++i) {
+            const OutputFile& output_file = output_files[i];
 
-        rescaler.rescale(
-            input_buffer,
-            output_buffer,
-            output_samples_per_pixel
-        );
+            // Waveform data files are converted without resampling, unless
+            // a zoom level is given
+            const bool convert = output_file.format != FileFormat::Png &&
+                                 !output_file.has_samples_per_pixel &&
+                                 !output_file.has_pixels_per_second &&
+                                 !has_resampling_option;
 
-        render_buffer = &output_buffer;
-    }
-    else {
-        log(Error) << "Invalid zoom, minimum: " << input_samples_per_pixel << '\n';
-        return false;
-    }
+            const int output_samples_per_pixel = convert ?
+                input_samples_per_pixel :
+                scale_factors[i]->getSamplesPerPixel(input_buffer.getSampleRate());
 
-    if (!renderer.create(
-        *render_buffer,
-        options.getImageWidth(),
-        options.getImageHeight(),
-        colors))
-    {
-        return false;
-    }
+            WaveformBuffer* output_buffer = nullptr;
 
-    return renderer.saveAsPng(
-        output_filename.string().c_str(),
-        options.getPngCompressionLevel()
-    );
-}
+            if (output_samples_per_pixel == input_samples_per_pixel) {
+                output_buffer = &input_buffer;
+            }
+            else if (output_samples_per_pixel > input_samples_per_pixel) {
+                for (const auto& buffer : buffers) {
+                    if (buffer->getSamplesPerPixel() == output_samples_per_pixel) {
+                        output_buffer = buffer.get();
+                    }
+                }
 
-//------------------------------------------------------------------------------
+                if (output_buffer == nullptr) {
+                    buffers.emplace_back(new WaveformBuffer);
+                    output_buffer = buffers.back().get();
 
-bool OptionHandler::resampleWaveformData(
-    const boost::filesystem::path& input_filename,
-    FileFormat::FileFormat input_format,
-    const boost::filesystem::path& output_filename,
-    FileFormat::FileFormat output_format,
-    const Options& options)
-{
-    WaveformBuffer input_buffer;
+                    WaveformRescaler rescaler(options.getThreads());
 
-    if (!loadWaveformData(input_buffer, input_filename, input_format)) {
-        return false;
+                    rescaler.rescale(
+                        input_buffer,
+                        *output_buffer,
+                        output_samples_per_pixel
+                    );
+                }
+            }
+            else {
+                log(Error) << "Invalid zoom, minimum: " << input_samples_per_pixel << '\n';
+                return false;
+            }
+
+            output_buffers.push_back(output_buffer);
+        }
     }
 
-    std::unique_ptr<ScaleFactor> scale_factor = createScaleFactor(options);
+    // Render the images first, as auto amplitude scaling changes the waveform
+    // data before it's saved
+    for (size_t i = 0; i < output_files.size(); ++i) {
+        const OutputFile& output_file = output_files[i];
+
+        if (output_file.format == FileFormat::Png) {
+            if (!saveWaveformImage(
+                *renderers[i],
+                *output_buffers[i],
+                output_buffers[i]->getSamplesPerPixel(),
+                output_file.filename,
+                output_file.image_width,
+                output_file.image_height,
+                colors,
+                options))
+            {
+                return false;
+            }
+        }
+    }
 
-    int output_samples_per_pixel = scale_factor->getSamplesPerPixel(
-        input_buffer.getSampleRate()
-    );
+    std::vector<WaveformBuffer*> scaled_buffers;
 
-    WaveformBuffer output_buffer;
-    WaveformRescaler rescaler;
+    for (size_t i = 0; i < output_files.size(); ++i) {
+        const OutputFile& output_file = output_files[i];
 
-    rescaler.rescale(
-        input_buffer,
-        output_buffer,
-        output_samples_per_pixel
-    );
+        if (output_file.format == FileFormat::Png) {
+            continue;
+        }
 
-    const int bits = options.hasBits() ? options.getBits() : input_buffer.getBits();
+        WaveformBuffer* buffer = output_buffers[i];
 
-    if (output_format == FileFormat::Dat) {
-        return output_buffer.save(output_filename.string().c_str(), bits);
-    }
-    else {
-        return output_buffer.saveAsJson(output_filename.string().c_str(), bits);
+        // A buffer shared by several output files is only scaled once
+        if (std::find(scaled_buffers.begin(), scaled_buffers.end(), buffer) == scaled_buffers.end()) {
+            applyAutoAmplitudeScale(*buffer, options);
+            scaled_buffers.push_back(buffer);
+        }
+
+        if (!writeWaveformData(
+            *buffer,
+            output_file.filename,
+            output_file.format,
+            bits,
+            options))
+        {
+            return false;
+        }
     }
+
+    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -675,6 +1700,279 @@ static bool shouldResampleWaveformData(
 
 //------------------------------------------------------------------------------
 
+// Renders image tiles at each zoom level, see TileRenderer. The most detailed
+// level is generated from the audio, or loaded from waveform data, just once,
+// and each coarser level is made from it by rescaling.
+
+bool OptionHandler::generateTiles(
+    const boost::filesystem::path& input_filename,
+    const FileFormat::FileFormat input_format,
+    const boost::filesystem::path& output_directory,
+    const Options& options)
+{
+    const bool audio_input = FileFormat::isAudioFormat(input_format);
+
+    if (!FileFormat::isSupported(input_format) ||
+        (!audio_input && !FileFormat::isWaveformDataFormat(input_format))) {
+        throwError(
+            "Can't generate tiles from %1% format input",
+            FileFormat::toString(input_format)
+        );
+    }
+
+    if (FileUtil::isStdioFilename(output_directory.string().c_str())) {
+        throwError("Can't write tiles to standard output");
+    }
+
+    if (options.isAutoSamplesPerPixel() || options.hasEndTime()) {
+        throwError("Can't use --zoom auto or --end with --tiles");
+    }
+
+    const TileRenderer::RendererConfig configure_renderer =
+        [&options](GdImageRenderer& renderer) {
+            return configureRenderer(renderer, options);
+        };
+
+    // Check the image options before reading the input
+    GdImageRenderer renderer;
+
+    if (!configure_renderer(renderer)) {
+        return false;
+    }
+
+    TileRenderer tile_renderer(options.getThreads(), configure_renderer);
+
+    if (!tile_renderer.setTileSize(options.getTileWidth(), options.getImageHeight())) {
+        return false;
+    }
+
+    tile_renderer.setAmplitudeScale(
+        options.isAutoAmplitudeScale(),
+        options.getAmplitudeScale()
+    );
+
+    tile_renderer.setPngOptions(createPngOptions(options));
+
+    const WaveformColors colors = createWaveformColors(options);
+
+    std::unique_ptr<ScaleFactor> scale_factor = createScaleFactor(options);
+
+    WaveformBuffer input_buffer;
+    WaveformBuffer output_buffer;
+
+    const WaveformBuffer* render_buffer = nullptr;
+
+    if (audio_input) {
+        const std::unique_ptr<AudioFileReader> audio_file_reader =
+            createAudioFileReader(input_filename, input_format, options);
+
+        if (!audio_file_reader->open(input_filename.string().c_str())) {
+            return false;
+        }
+
+        const bool parallel = options.getThreads() > 1 && isParallelDecodingSupported(
+            *audio_file_reader,
+            input_filename,
+            input_format
+        );
+
+        std::vector<std::unique_ptr<ScaleFactor>> scale_factors;
+        scale_factors.push_back(std::move(scale_factor));
+
+        std::vector<std::unique_ptr<WaveformBuffer>> buffers;
+        buffers.emplace_back(new WaveformBuffer);
+
+        if (!generateLevels(
+            *audio_file_reader,
+            input_filename,
+            input_format,
+            parallel,
+            scale_factors,
+            buffers,
+            options))
+        {
+            return false;
+        }
+
+        return tile_renderer.render(*buffers[0], colors, output_directory);
+    }
+    else {
+        if (!loadWaveformData(input_buffer, input_filename, input_format)) {
+            return false;
+        }
+
+        const int input_samples_per_pixel = input_buffer.getSamplesPerPixel();
+
+        // Waveform data is used at its own zoom level, unless one is given
+        const int output_samples_per_pixel =
+            options.hasSamplesPerPixel() || options.hasPixelsPerSecond() ?
+            scale_factor->getSamplesPerPixel(input_buffer.getSampleRate()) :
+            input_samples_per_pixel;
+
+        if (output_samples_per_pixel == input_samples_per_pixel) {
+            render_buffer = &input_buffer;
+        }
+        else if (output_samples_per_pixel > input_samples_per_pixel) {
+            WaveformRescaler rescaler(options.getThreads());
+
+            rescaler.rescale(
+                input_buffer,
+                output_buffer,
+                output_samples_per_pixel
+            );
+
+            render_buffer = &output_buffer;
+        }
+        else {
+            log(Error) << "Invalid zoom, minimum: " << input_samples_per_pixel << '\n';
+            return false;
+        }
+    }
+
+    return tile_renderer.render(*render_buffer, colors, output_directory);
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the size of the given file, or 0 if it isn't a regular file, e.g.,
+// when reading from standard input.
+
+static long long getFileSize(const boost::filesystem::path& filename)
+{
+    boost::system::error_code error_code;
+
+    if (!boost::filesystem::is_regular_file(filename, error_code)) {
+        return 0;
+    }
+
+    const auto size = boost::filesystem::file_size(filename, error_code);
+
+    return error_code ? 0 : static_cast<long long>(size);
+}
+
+//------------------------------------------------------------------------------
+
+// Jobs in batch or server mode may write stats to the same file
+static std::mutex stats_mutex;
+
+// Writes the stats for the job to the --stats file, or to standard error.
+// Each job's stats are appended to the file as one line of JSON.
+
+static void writeStats(
+    JobStats& stats,
+    const Options& options,
+    const bool success)
+{
+    long long output_bytes = 0;
+
+    for (const auto& output_file : options.getOutputFiles()) {
+        output_bytes += getFileSize(output_file.filename);
+    }
+
+    const std::string& filename = options.getStatsFilename();
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+
+    if (FileUtil::isStdioFilename(filename.c_str())) {
+        stats.write(
+            error_stream,
+            options.getInputFilename().string(),
+            options.getOutputFilename().string(),
+            getFileSize(options.getInputFilename()),
+            output_bytes,
+            success
+        );
+    }
+    else {
+        std::ofstream file(filename, std::ios::out | std::ios::app);
+
+        if (!file) {
+            log(Error) << "Failed to write stats file: " << filename << '\n'
+                       << strerror(errno) << '\n';
+            return;
+        }
+
+        stats.write(
+            file,
+            options.getInputFilename().string(),
+            options.getOutputFilename().string(),
+            getFileSize(options.getInputFilename()),
+            output_bytes,
+            success
+        );
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Runs a job from a batch manifest, or sent to the server. Jobs can't use
+// --help, --version, or --trace, see JobUtil, so this skips run(), which would
+// also set the log level for the whole process from the job's options. Info
+// messages from jobs are discarded anyway, see setThreadErrorStream().
+
+bool OptionHandler::runJob(const Options& options)
+{
+    OptionHandler option_handler;
+    return option_handler.runSingleJob(options);
+}
+
+//------------------------------------------------------------------------------
+
+// Runs each job in the batch manifest with its own OptionHandler, and writes
+// the status of each job to standard output.
+
+bool OptionHandler::runBatch(const Options& options)
+{
+    const std::string& filename = options.getBatchFilename();
+
+    std::ifstream file;
+
+    if (!FileUtil::isStdioFilename(filename.c_str())) {
+        file.open(filename);
+
+        if (!file) {
+            log(Error) << "Failed to read file: " << filename << '\n'
+                       << strerror(errno) << '\n';
+            return false;
+        }
+    }
+
+    std::istream& manifest = file.is_open() ? file : std::cin;
+
+    log(Info) << "Running jobs from: "
+              << (file.is_open() ? filename : "(stdin)")
+              << "\nJobs: " << options.getJobs() << '\n';
+
+    BatchRunner runner(options.getJobs(), runJob);
+
+    const bool success = runner.run(manifest, output_stream);
+
+    log(Info) << "Finished " << runner.getJobCount() << " jobs, "
+              << runner.getFailedCount() << " failed\n";
+
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+bool OptionHandler::runServer(const Options& options)
+{
+    JobServer server(options.getServeFilename(), options.getJobs(), runJob);
+
+    if (!server.listen()) {
+        return false;
+    }
+
+    log(Info) << "Listening on: " << options.getServeFilename()
+              << "\nWorkers: " << options.getJobs() << '\n';
+
+    server.run();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
 bool OptionHandler::run(const Options& options)
 {
     if (options.getHelp()) {
@@ -688,6 +1986,43 @@ bool OptionHandler::run(const Options& options)
 
     setLogLevel(options.getQuiet());
 
+    const std::string& trace_filename = options.getTraceFilename();
+
+    if (!trace_filename.empty()) {
+        Trace::start();
+    }
+
+    bool success;
+
+    if (!options.getBatchFilename().empty()) {
+        success = runBatch(options);
+    }
+    else if (!options.getServeFilename().empty()) {
+        success = runServer(options);
+    }
+    else {
+        success = runSingleJob(options);
+    }
+
+    if (!trace_filename.empty()) {
+        if (!Trace::stop(trace_filename)) {
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+bool OptionHandler::runSingleJob(const Options& options)
+{
+    std::unique_ptr<JobStats> stats(
+        options.hasStats() ? new JobStats : nullptr
+    );
+
+    JobStats::setThreadStats(stats.get());
+
     bool success = true;
 
     try {
@@ -703,7 +2038,22 @@ bool OptionHandler::run(const Options& options)
         const FileFormat::FileFormat output_format =
             options.getOutputFormat();
 
-        if (shouldConvertAudioFormat(input_format, output_format)) {
+        if (options.getTiles()) {
+            success = generateTiles(
+                input_filename,
+                input_format,
+                output_filename,
+                options
+            );
+        }
+        else if (options.getOutputFiles().size() > 1) {
+            success = generateOutputFiles(
+                input_filename,
+                input_format,
+                options
+            );
+        }
+        else if (shouldConvertAudioFormat(input_format, output_format)) {
             success = convertAudioFormat(
                 input_filename,
                 input_format,
@@ -760,6 +2110,12 @@ bool OptionHandler::run(const Options& options)
         success = false;
     }
 
+    JobStats::setThreadStats(nullptr);
+
+    if (stats) {
+        writeStats(*stats, options, success);
+    }
+
     if (success) {
         log(Info) << "Done\n";
     }
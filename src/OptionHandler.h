@@ -48,6 +48,12 @@ class OptionHandler
         bool run(const Options& options);
 
     private:
+        static bool runJob(const Options& options);
+
+        bool runSingleJob(const Options& options);
+        bool runBatch(const Options& options);
+        bool runServer(const Options& options);
+
         bool convertAudioFormat(
             const boost::filesystem::path& input_filename,
             const FileFormat::FileFormat input_format,
@@ -85,6 +91,19 @@ class OptionHandler
             FileFormat::FileFormat output_format,
             const Options& options
         );
+
+        bool generateOutputFiles(
+            const boost::filesystem::path& input_filename,
+            FileFormat::FileFormat input_format,
+            const Options& options
+        );
+
+        bool generateTiles(
+            const boost::filesystem::path& input_filename,
+            FileFormat::FileFormat input_format,
+            const boost::filesystem::path& output_directory,
+            const Options& options
+        );
 };
 
 //------------------------------------------------------------------------------
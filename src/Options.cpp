@@ -31,8 +31,10 @@
 #include "Rgba.h"
 #include "AudioFileReader.h"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <utility>
 
@@ -55,21 +57,30 @@ Options::Options() :
     start_time_(0.0),
     end_time_(0.0),
     has_end_time_(false),
-    samples_per_pixel_(0),
+    samples_per_pixel_(1, 0),
     auto_samples_per_pixel_(false),
     has_samples_per_pixel_(false),
-    pixels_per_second_(0),
+    pixels_per_second_(1, 0),
     has_pixels_per_second_(false),
     image_width_(0),
     image_height_(0),
     bits_(16),
     has_bits_(false),
+    format_version_(0),
+    block_size_(0),
     bar_width_(1),
     bar_gap_(0),
     render_axis_labels_(true),
     auto_amplitude_scale_(false),
     amplitude_scale_(1.0),
     png_compression_level_(-1), // default
+    png_palette_(true),
+    threads_(1),
+    mp3_index_(false),
+    tiles_(false),
+    tile_width_(512),
+    has_stats_(false),
+    jobs_(1),
     raw_sample_rate_(0),
     raw_channels_(0)
 {
@@ -108,6 +119,71 @@ static bool parseWaveformColors(
 
 //------------------------------------------------------------------------------
 
+// Parses a comma separated list of integers, e.g., "64,128,256". Throws
+// std::invalid_argument or std::out_of_range if any value is invalid.
+
+static std::vector<int> parseIntegerList(const std::string& option_value)
+{
+    std::vector<int> values;
+
+    std::istringstream stream(option_value);
+    std::string value;
+
+    while (std::getline(stream, value, ',')) {
+        size_t length = 0;
+
+        values.push_back(std::stoi(value, &length));
+
+        if (length != value.size()) {
+            throw std::invalid_argument(value);
+        }
+    }
+
+    // getline() doesn't return an empty value after a trailing comma
+    if (values.empty() || option_value.back() == ',') {
+        throw std::invalid_argument(option_value);
+    }
+
+    return values;
+}
+
+//------------------------------------------------------------------------------
+
+// Returns true if any value appears more than once in the list, and sets
+// duplicate to the first such value.
+
+static bool findDuplicate(const std::vector<int>& values, int& duplicate)
+{
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (std::find(values.begin(), values.begin() + i, values[i]) != values.begin() + i) {
+            duplicate = values[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+// Parses an integer, e.g., "64". Throws std::invalid_argument or
+// std::out_of_range if the value is invalid.
+
+static int parseInteger(const std::string& option_value)
+{
+    size_t length = 0;
+
+    const int value = std::stoi(option_value, &length);
+
+    if (length != option_value.size()) {
+        throw std::invalid_argument(option_value);
+    }
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+
 static std::string getFileExtension(const boost::filesystem::path& filename)
 {
     std::string extension = filename.extension().string();
@@ -135,13 +211,14 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
     program_name_ = argv[0];
 
     std::string input_filename;
-    std::string output_filename;
+    std::vector<std::string> output_filenames;
 
     std::string input_format;
     std::string output_format;
 
     std::string amplitude_scale;
     std::string samples_per_pixel;
+    std::string pixels_per_second;
     std::string waveform_color;
 
     desc_.add_options()(
@@ -161,8 +238,8 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
             "input file name (.mp3, .wav, .flac, .ogg, .oga, .dat, .json)"
     )(
         "output-filename,o",
-        po::value<std::string>(&output_filename),
-        "output file name (.wav, .dat, .png, .json)"
+        po::value<std::vector<std::string>>(&output_filenames),
+        "output file name (.wav, .dat, .png, .json), can be given more than once"
     )(
         "split-channels",
         "output multi-channel waveform data or image files"
@@ -179,15 +256,23 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
     )(
         "zoom,z",
         po::value<std::string>(&samples_per_pixel)->default_value("256"),
-        "zoom level (samples per pixel)"
+        "zoom level (samples per pixel), or comma separated list of zoom levels"
     )(
         "pixels-per-second",
-        po::value<int>(&pixels_per_second_)->default_value(100),
-        "zoom level (pixels per second)"
+        po::value<std::string>(&pixels_per_second)->default_value("100"),
+        "zoom level (pixels per second), or comma separated list of zoom levels"
     )(
         "bits,b",
         po::value<int>(&bits_)->default_value(16),
         "bits (8 or 16)"
+    )(
+        "format-version",
+        po::value<int>(&format_version_),
+        "data file format version (2 or 3)"
+    )(
+        "block-size",
+        po::value<int>(&block_size_),
+        "write an indexed data file with this many points per block"
     )(
         "start,s",
         po::value<double>(&start_time_)->default_value(0.0),
@@ -246,6 +331,13 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
     )(
         "with-axis-labels",
         "render waveform image with axis labels (default)"
+    )(
+        "tiles",
+        "render image tiles at each zoom level into the output directory"
+    )(
+        "tile-width",
+        po::value<int>(&tile_width_)->default_value(512),
+        "tile width (pixels)"
     )(
         "amplitude-scale",
         po::value<std::string>(&amplitude_scale)->default_value("1.0"),
@@ -254,6 +346,47 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
         "compression",
         po::value<int>(&png_compression_level_)->default_value(-1),
         "PNG compression level: 0 (none) to 9 (best), or -1 (default)"
+    )(
+        "png-filter",
+        po::value<std::string>(&png_filter_)->default_value("default"),
+        "PNG row filter (default, none, sub, up, average, paeth, or all)"
+    )(
+        "png-strategy",
+        po::value<std::string>(&png_strategy_)->default_value("default"),
+        "PNG compression strategy (default, filtered, huffman, rle, or fixed)"
+    )(
+        "no-png-palette",
+        "always write truecolor PNG images, instead of indexed color images "
+        "where possible"
+    )(
+        "threads",
+        po::value<int>(&threads_)->default_value(1),
+        "number of threads to use when decoding audio"
+    )(
+        "mp3-index",
+        "use an index file to seek within MP3 input (<input>.idx)"
+    )(
+        "stats",
+        po::value<std::string>(&stats_filename_)->implicit_value("-"),
+        "write time and memory use of each stage as JSON, "
+        "to standard error or with --stats=<file>, appended to the file"
+    )(
+        "trace",
+        po::value<std::string>(&trace_filename_),
+        "write a timeline of each stage to the given file, "
+        "in Chrome trace event format"
+    )(
+        "batch",
+        po::value<std::string>(&batch_filename_),
+        "run the jobs listed in the given file, one per line"
+    )(
+        "serve",
+        po::value<std::string>(&serve_filename_),
+        "run jobs sent to the given Unix domain socket"
+    )(
+        "jobs",
+        po::value<int>(&jobs_)->default_value(1),
+        "number of jobs to run at once in batch or server mode"
     )(
         "raw-samplerate",
         po::value<int>(&raw_sample_rate_),
@@ -289,6 +422,10 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
         split_channels_ = variables_map.count("split-channels") != 0;
 
         render_axis_labels_ = variables_map.count("no-axis-labels") == 0;
+        mp3_index_ = variables_map.count("mp3-index") != 0;
+        tiles_ = variables_map.count("tiles") != 0;
+        png_palette_ = variables_map.count("no-png-palette") == 0;
+        has_stats_ = variables_map.count("stats") != 0;
 
         has_end_time_ = !variables_map["end"].defaulted();
 
@@ -299,6 +436,24 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
 
         po::notify(variables_map);
 
+        // Each job in the batch, or sent to the server, has its own options
+        const bool has_batch = hasOptionValue(variables_map, "batch");
+        const bool has_serve = hasOptionValue(variables_map, "serve");
+
+        if (has_batch || has_serve) {
+            if (has_batch && has_serve) {
+                reportError("Can't use --batch and --serve together");
+                return false;
+            }
+
+            if (jobs_ < 1) {
+                reportError("Invalid jobs: must be greater than zero");
+                return false;
+            }
+
+            return true;
+        }
+
         has_border_color_     = hasOptionValue(variables_map, "border-color");
         has_background_color_ = hasOptionValue(variables_map, "background-color");
         has_waveform_color_   = hasOptionValue(variables_map, "waveform-color");
@@ -315,7 +470,10 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
         // containing spaces.
         // See https://github.com/boostorg/program_options/issues/69
         input_filename_ = input_filename;
-        output_filename_ = output_filename;
+
+        if (!output_filenames.empty()) {
+            output_filename_ = output_filenames.front();
+        }
 
         has_input_format_  = hasOptionValue(variables_map, "input-format");
         has_output_format_ = hasOptionValue(variables_map, "output-format");
@@ -335,6 +493,7 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
 
         handleAmplitudeScaleOption(amplitude_scale);
         handleZoomOption(samples_per_pixel);
+        handlePixelsPerSecondOption(pixels_per_second);
 
         if (output_filename_.empty() && !has_output_format_) {
             reportError("Must specify either output filename or output format");
@@ -345,16 +504,73 @@ bool Options::parseCommandLine(int argc, const char* const* argv)
             FileFormat::fromString(output_format) :
             getFormatFromFileExtension(output_filename_);
 
+        if (output_filenames.size() > 1) {
+            if (has_output_format_) {
+                reportError("Can't use --output-format with more than one output file");
+                return false;
+            }
+
+            for (const auto& value : output_filenames) {
+                output_files_.push_back(parseOutputFile(value));
+            }
+
+            output_filename_ = output_files_.front().filename;
+            output_format_   = output_files_.front().format;
+        }
+        else {
+            OutputFile output_file;
+
+            output_file.filename               = output_filename_;
+            output_file.format                 = output_format_;
+            output_file.has_samples_per_pixel  = false;
+            output_file.auto_samples_per_pixel = false;
+            output_file.samples_per_pixel      = 0;
+            output_file.has_pixels_per_second  = false;
+            output_file.pixels_per_second      = 0;
+            output_file.image_width            = image_width_;
+            output_file.image_height           = image_height_;
+
+            output_files_.push_back(output_file);
+        }
+
+        if (tiles_) {
+            if (output_files_.size() > 1) {
+                reportError("Can't use --tiles with more than one output file");
+                return false;
+            }
+
+            if (tile_width_ < 1) {
+                reportError("Invalid tile width: must be greater than zero");
+                return false;
+            }
+        }
+
         if (bits_ != 8 && bits_ != 16) {
             reportError("Invalid bits: must be either 8 or 16");
             return false;
         }
 
+        if (hasOptionValue(variables_map, "format-version") &&
+            format_version_ != 2 && format_version_ != 3) {
+            reportError("Invalid format version: must be either 2 or 3");
+            return false;
+        }
+
+        if (hasOptionValue(variables_map, "block-size") && block_size_ < 1) {
+            reportError("Invalid block size: must be greater than zero");
+            return false;
+        }
+
         if (png_compression_level_ < -1 || png_compression_level_ > 9) {
             reportError("Invalid compression level: must be from 0 (none) to 9 (best), or -1 (default)");
             return false;
         }
 
+        if (threads_ < 1) {
+            reportError("Invalid threads: must be greater than zero");
+            return false;
+        }
+
         if (input_format_ == FileFormat::Raw) {
             if (!has_raw_sample_rate) {
                 reportError("Missing --raw-samplerate option");
@@ -417,7 +633,7 @@ void Options::handleZoomOption(const std::string& option_value)
     }
     else {
         try {
-            samples_per_pixel_ = std::stoi(option_value);
+            samples_per_pixel_ = parseIntegerList(option_value);
         }
         catch (std::invalid_argument& e) {
             throwError("Invalid zoom: must be a number or 'auto'");
@@ -425,7 +641,115 @@ void Options::handleZoomOption(const std::string& option_value)
         catch (std::out_of_range& e) {
             throwError("Invalid zoom: number too large");
         }
+
+        int duplicate = 0;
+
+        if (findDuplicate(samples_per_pixel_, duplicate)) {
+            throwError("Invalid zoom: %1% is given more than once", duplicate);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void Options::handlePixelsPerSecondOption(const std::string& option_value)
+{
+    try {
+        pixels_per_second_ = parseIntegerList(option_value);
+    }
+    catch (std::invalid_argument& e) {
+        throwError("Invalid pixels per second: must be a number");
+    }
+    catch (std::out_of_range& e) {
+        throwError("Invalid pixels per second: number too large");
+    }
+
+    int duplicate = 0;
+
+    if (findDuplicate(pixels_per_second_, duplicate)) {
+        throwError("Invalid pixels per second: %1% is given more than once", duplicate);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Parses an output filename, followed by any settings for that file, e.g.,
+// "preview.png:zoom=auto,width=1800,height=140". A ':' that isn't followed by
+// settings is part of the filename.
+
+OutputFile Options::parseOutputFile(const std::string& option_value) const
+{
+    OutputFile output_file;
+
+    output_file.has_samples_per_pixel  = false;
+    output_file.auto_samples_per_pixel = false;
+    output_file.samples_per_pixel      = 0;
+    output_file.has_pixels_per_second  = false;
+    output_file.pixels_per_second      = 0;
+    output_file.image_width            = image_width_;
+    output_file.image_height           = image_height_;
+
+    const size_t separator = option_value.rfind(':');
+
+    std::string filename = option_value;
+    std::string settings;
+
+    if (separator != std::string::npos &&
+        option_value.find('=', separator) != std::string::npos) {
+        filename = option_value.substr(0, separator);
+        settings = option_value.substr(separator + 1);
+    }
+
+    output_file.filename = filename;
+    output_file.format   = getFormatFromFileExtension(output_file.filename);
+
+    std::istringstream stream(settings);
+    std::string setting;
+
+    while (std::getline(stream, setting, ',')) {
+        const size_t equals = setting.find('=');
+
+        const std::string name  = setting.substr(0, equals);
+        const std::string value = equals != std::string::npos ? setting.substr(equals + 1) : "";
+
+        try {
+            if (name == "zoom") {
+                output_file.has_samples_per_pixel = true;
+
+                if (value == "auto") {
+                    output_file.auto_samples_per_pixel = true;
+                }
+                else {
+                    output_file.samples_per_pixel = parseInteger(value);
+                }
+            }
+            else if (name == "pixels-per-second") {
+                output_file.has_pixels_per_second = true;
+                output_file.pixels_per_second = parseInteger(value);
+            }
+            else if (name == "width") {
+                output_file.image_width = parseInteger(value);
+            }
+            else if (name == "height") {
+                output_file.image_height = parseInteger(value);
+            }
+            else {
+                throwError("Unknown setting for output file %1%: %2%", filename, name);
+            }
+        }
+        catch (const std::invalid_argument&) {
+            throwError("Invalid %1% for output file %2%: %3%", name, filename, value);
+        }
+        catch (const std::out_of_range&) {
+            throwError("Invalid %1% for output file %2%: number too large", name, filename);
+        }
+    }
+
+    if (output_file.has_samples_per_pixel && output_file.has_pixels_per_second) {
+        throwError("Specify either zoom or pixels-per-second for output file %1% but not both", filename);
     }
+
+    return output_file;
 }
 
 //------------------------------------------------------------------------------
@@ -35,6 +35,31 @@
 #include <iosfwd>
 #include <stdexcept>
 #include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// An output file. More than one can be given, to write several files from a
+// single pass over the input. Each may have its own zoom and image size,
+// e.g., -o preview.png:zoom=auto,width=1800,height=140. The image size is
+// otherwise taken from --width and --height, and the zoom from --zoom,
+// --pixels-per-second or --end.
+
+struct OutputFile
+{
+    boost::filesystem::path filename;
+    FileFormat::FileFormat format;
+
+    bool has_samples_per_pixel;
+    bool auto_samples_per_pixel;
+    int samples_per_pixel;
+
+    bool has_pixels_per_second;
+    int pixels_per_second;
+
+    int image_width;
+    int image_height;
+};
 
 //------------------------------------------------------------------------------
 
@@ -59,6 +84,11 @@ class Options
             return output_filename_;
         }
 
+        const std::vector<OutputFile>& getOutputFiles() const
+        {
+            return output_files_;
+        }
+
         bool getSplitChannels() const { return split_channels_; }
 
         bool hasInputFormat() const { return has_input_format_; }
@@ -79,15 +109,19 @@ class Options
         double getEndTime() const { return end_time_; }
         bool hasEndTime() const { return has_end_time_; }
 
-        int getSamplesPerPixel() const { return samples_per_pixel_; }
+        int getSamplesPerPixel() const { return samples_per_pixel_.front(); }
+        const std::vector<int>& getSamplesPerPixelValues() const { return samples_per_pixel_; }
         bool isAutoSamplesPerPixel() const { return auto_samples_per_pixel_; }
         bool hasSamplesPerPixel() const { return has_samples_per_pixel_; }
 
-        int getPixelsPerSecond() const { return pixels_per_second_; }
+        int getPixelsPerSecond() const { return pixels_per_second_.front(); }
+        const std::vector<int>& getPixelsPerSecondValues() const { return pixels_per_second_; }
         bool hasPixelsPerSecond() const { return has_pixels_per_second_; }
 
         int getBits() const { return bits_; }
         bool hasBits() const { return has_bits_; }
+        int getFormatVersion() const { return format_version_; }
+        int getBlockSize() const { return block_size_; }
         int getImageWidth() const { return image_width_; }
         int getImageHeight() const { return image_height_; }
 
@@ -119,6 +153,25 @@ class Options
         double getAmplitudeScale() const { return amplitude_scale_; }
 
         int getPngCompressionLevel() const { return png_compression_level_; }
+        const std::string& getPngFilter() const { return png_filter_; }
+        const std::string& getPngStrategy() const { return png_strategy_; }
+        bool getPngPalette() const { return png_palette_; }
+
+        int getThreads() const { return threads_; }
+
+        bool getMp3Index() const { return mp3_index_; }
+
+        bool getTiles() const { return tiles_; }
+        int getTileWidth() const { return tile_width_; }
+
+        bool hasStats() const { return has_stats_; }
+        const std::string& getStatsFilename() const { return stats_filename_; }
+
+        const std::string& getTraceFilename() const { return trace_filename_; }
+
+        const std::string& getBatchFilename() const { return batch_filename_; }
+        const std::string& getServeFilename() const { return serve_filename_; }
+        int getJobs() const { return jobs_; }
 
         bool getQuiet() const { return quiet_; }
 
@@ -133,6 +186,9 @@ class Options
     private:
         void handleAmplitudeScaleOption(const std::string& option_value);
         void handleZoomOption(const std::string& option_value);
+        void handlePixelsPerSecondOption(const std::string& option_value);
+
+        OutputFile parseOutputFile(const std::string& option_value) const;
 
     private:
         boost::program_options::options_description desc_;
@@ -145,6 +201,7 @@ class Options
 
         boost::filesystem::path input_filename_;
         boost::filesystem::path output_filename_;
+        std::vector<OutputFile> output_files_;
 
         bool split_channels_;
 
@@ -158,17 +215,19 @@ class Options
         double end_time_;
         bool has_end_time_;
 
-        int samples_per_pixel_;
+        std::vector<int> samples_per_pixel_;
         bool auto_samples_per_pixel_;
         bool has_samples_per_pixel_;
 
-        int pixels_per_second_;
+        std::vector<int> pixels_per_second_;
         bool has_pixels_per_second_;
 
         int image_width_;
         int image_height_;
         int bits_;
         bool has_bits_;
+        int format_version_;
+        int block_size_;
 
         std::string color_scheme_;
 
@@ -194,6 +253,25 @@ class Options
         double amplitude_scale_;
 
         int png_compression_level_;
+        std::string png_filter_;
+        std::string png_strategy_;
+        bool png_palette_;
+
+        int threads_;
+
+        bool mp3_index_;
+
+        bool tiles_;
+        int tile_width_;
+
+        bool has_stats_;
+        std::string stats_filename_;
+
+        std::string trace_filename_;
+
+        std::string batch_filename_;
+        std::string serve_filename_;
+        int jobs_;
 
         int raw_sample_rate_;
         int raw_channels_;
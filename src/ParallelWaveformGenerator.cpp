@@ -0,0 +1,301 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "ParallelWaveformGenerator.h"
+#include "AudioFileReader.h"
+#include "JobStats.h"
+#include "Log.h"
+#include "MultiLevelWaveformGenerator.h"
+#include "TimedAudioProcessor.h"
+#include "Trace.h"
+#include "WaveformBuffer.h"
+#include "WaveformGenerator.h"
+
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+struct Range
+{
+    long long start_frame;
+    long long end_frame; // or -1 for the end of the input
+
+    std::vector<std::unique_ptr<WaveformBuffer>> buffers;
+
+    std::ostringstream errors;
+    bool success;
+};
+
+}
+
+//------------------------------------------------------------------------------
+
+static long long getGreatestCommonDivisor(long long a, long long b)
+{
+    while (b != 0) {
+        const long long remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+
+    return a;
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the smallest number of frames that is a whole number of output
+// points at every zoom level, or a value greater than frame_count if there is
+// no such number within the input. Returns 0 if any zoom level is invalid.
+
+static long long getRangeAlignment(
+    const std::vector<const ScaleFactor*>& scale_factors,
+    const int sample_rate,
+    const long long frame_count)
+{
+    long long alignment = 1;
+
+    for (const ScaleFactor* scale_factor : scale_factors) {
+        const long long samples_per_pixel =
+            scale_factor->getSamplesPerPixel(sample_rate);
+
+        if (samples_per_pixel < 2) {
+            return 0;
+        }
+
+        const long long multiplier =
+            alignment / getGreatestCommonDivisor(alignment, samples_per_pixel);
+
+        if (multiplier > frame_count / samples_per_pixel) {
+            return frame_count + 1;
+        }
+
+        alignment = multiplier * samples_per_pixel;
+    }
+
+    return alignment;
+}
+
+//------------------------------------------------------------------------------
+
+static void runRange(
+    Range& range,
+    const ParallelWaveformGenerator::ReaderFactory& create_reader,
+    const bool split_channels,
+    const std::vector<const ScaleFactor*>& scale_factors)
+{
+    TRACE_SCOPE("decode", "ParallelWaveformGenerator::runRange");
+
+    try {
+        std::unique_ptr<AudioFileReader> reader =
+            create_reader(range.start_frame, range.end_frame);
+
+        if (reader) {
+            MultiLevelWaveformGenerator generator(split_channels);
+
+            for (size_t i = 0; i < scale_factors.size(); ++i) {
+                generator.addLevel(*range.buffers[i], *scale_factors[i]);
+            }
+
+            TimedAudioProcessor timed_generator(generator);
+
+            StageTimer timer(JobStats::Decode);
+
+            range.success = reader->run(timed_generator);
+
+            // The generator ran on this thread, within the reader
+            timer.exclude(timed_generator.getTime());
+        }
+    }
+    catch (const std::exception& e) {
+        log(Error) << e.what() << '\n';
+        range.success = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+ParallelWaveformGenerator::ParallelWaveformGenerator(
+    const int threads,
+    const bool split_channels) :
+    threads_(threads < 1 ? 1 : threads),
+    split_channels_(split_channels)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void ParallelWaveformGenerator::addLevel(
+    WaveformBuffer& buffer,
+    const ScaleFactor& scale_factor)
+{
+    buffers_.push_back(&buffer);
+    scale_factors_.push_back(&scale_factor);
+}
+
+//------------------------------------------------------------------------------
+
+bool ParallelWaveformGenerator::run(
+    const ReaderFactory& create_reader,
+    const int sample_rate,
+    const long long frame_count)
+{
+    const long long alignment = getRangeAlignment(
+        scale_factors_,
+        sample_rate,
+        frame_count
+    );
+
+    long long frames_per_range = frame_count;
+
+    if (alignment > 0 && alignment <= frame_count) {
+        const long long blocks = (frame_count + alignment - 1) / alignment;
+        const long long blocks_per_range = (blocks + threads_ - 1) / threads_;
+
+        frames_per_range = blocks_per_range * alignment;
+    }
+
+    std::vector<std::unique_ptr<Range>> ranges;
+
+    long long start_frame = 0;
+
+    do {
+        std::unique_ptr<Range> range(new Range);
+
+        range->start_frame = start_frame;
+        range->success     = false;
+
+        start_frame += frames_per_range;
+
+        // The last range reads up to the end of the input, in case this is
+        // different to frame_count
+        range->end_frame = start_frame < frame_count ? start_frame : -1;
+
+        for (size_t i = 0; i < buffers_.size(); ++i) {
+            range->buffers.emplace_back(new WaveformBuffer);
+        }
+
+        ranges.push_back(std::move(range));
+    }
+    while (start_frame < frame_count);
+
+    if (ranges.size() == 1) {
+        // Nothing to gain from a separate thread, and this way any progress
+        // information is shown
+        runRange(*ranges[0], create_reader, split_channels_, scale_factors_);
+    }
+    else {
+        log(Info) << "Generating waveform data using " << ranges.size()
+                  << " threads...\n";
+
+        // Each thread records the time it spends in each stage to the job's
+        // stats, if any
+        JobStats* stats = JobStats::getThreadStats();
+
+        std::vector<std::thread> threads;
+
+        for (const auto& range : ranges) {
+            Range* range_ptr = range.get();
+
+            threads.emplace_back([this, range_ptr, &create_reader, stats]() {
+                setThreadErrorStream(&range_ptr->errors);
+                JobStats::setThreadStats(stats);
+
+                runRange(*range_ptr, create_reader, split_channels_, scale_factors_);
+
+                JobStats::setThreadStats(nullptr);
+                setThreadErrorStream(nullptr);
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    bool success = true;
+
+    for (const auto& range : ranges) {
+        const std::string errors = range->errors.str();
+
+        if (!errors.empty()) {
+            log(Error) << errors;
+        }
+
+        if (!range->success) {
+            success = false;
+        }
+    }
+
+    if (!success) {
+        return false;
+    }
+
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        WaveformBuffer& buffer = *buffers_[i];
+        const WaveformBuffer& first_buffer = *ranges[0]->buffers[i];
+
+        buffer.setSampleRate(first_buffer.getSampleRate());
+        buffer.setSamplesPerPixel(first_buffer.getSamplesPerPixel());
+        buffer.setChannels(first_buffer.getChannels());
+
+        for (size_t j = 0; j < ranges.size(); ++j) {
+            const Range& range = *ranges[j];
+            const WaveformBuffer& range_buffer = *range.buffers[i];
+
+            // Each range except the last must give whole output points,
+            // otherwise the input was shorter than its reported length
+            if (range.end_frame >= 0) {
+                const long long expected_size =
+                    (range.end_frame - range.start_frame) / buffer.getSamplesPerPixel();
+
+                if (range_buffer.getSize() != expected_size) {
+                    log(Error) << "Failed to read audio frames "
+                               << range.start_frame << " to "
+                               << range.end_frame << '\n';
+                    return false;
+                }
+            }
+
+            for (int index = 0; index < range_buffer.getSize(); ++index) {
+                for (int channel = 0; channel < range_buffer.getChannels(); ++channel) {
+                    buffer.appendSamples(
+                        range_buffer.getMinSample(channel, index),
+                        range_buffer.getMaxSample(channel, index)
+                    );
+                }
+            }
+        }
+
+        if (ranges.size() > 1) {
+            log(Info) << "Samples per pixel: " << buffer.getSamplesPerPixel()
+                      << "\nGenerated " << buffer.getSize() << " points\n";
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
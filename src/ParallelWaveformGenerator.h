@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_PARALLEL_WAVEFORM_GENERATOR_H)
+#define INC_PARALLEL_WAVEFORM_GENERATOR_H
+
+//------------------------------------------------------------------------------
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+class AudioFileReader;
+class ScaleFactor;
+class WaveformBuffer;
+
+//------------------------------------------------------------------------------
+
+// Generates waveform data from a seekable audio input using several threads.
+//
+// The input is split into frame ranges that start on output point boundaries
+// for every zoom level. Each range is decoded by its own reader on its own
+// thread, and the waveform data from each range is then joined in order, which
+// gives the same result as a single-threaded run.
+
+class ParallelWaveformGenerator
+{
+    public:
+        // Returns a reader that is open and restricted to the given range of
+        // frames, or nullptr on failure. Called from the worker threads.
+        typedef std::function<
+            std::unique_ptr<AudioFileReader>(long long start_frame, long long end_frame)
+        > ReaderFactory;
+
+        ParallelWaveformGenerator(int threads, bool split_channels);
+
+        ParallelWaveformGenerator(const ParallelWaveformGenerator&) = delete;
+        ParallelWaveformGenerator& operator=(const ParallelWaveformGenerator&) = delete;
+
+    public:
+        void addLevel(WaveformBuffer& buffer, const ScaleFactor& scale_factor);
+
+        bool run(
+            const ReaderFactory& create_reader,
+            int sample_rate,
+            long long frame_count
+        );
+
+    private:
+        int threads_;
+        bool split_channels_;
+
+        std::vector<WaveformBuffer*> buffers_;
+        std::vector<const ScaleFactor*> scale_factors_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_PARALLEL_WAVEFORM_GENERATOR_H)
+
+//------------------------------------------------------------------------------
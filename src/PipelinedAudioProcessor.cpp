@@ -0,0 +1,266 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "PipelinedAudioProcessor.h"
+#include "Log.h"
+
+#include <ostream>
+#include <stdexcept>
+
+//------------------------------------------------------------------------------
+
+PipelinedAudioProcessor::PipelinedAudioProcessor(
+    AudioProcessor& processor,
+    const int blocks) :
+    processor_(processor),
+    channels_(0),
+    blocks_(static_cast<size_t>(blocks < 2 ? 2 : blocks)),
+    write_count_(0),
+    read_count_(0),
+    finished_(false),
+    failed_(false)
+{
+}
+
+//------------------------------------------------------------------------------
+
+PipelinedAudioProcessor::~PipelinedAudioProcessor()
+{
+    stop();
+}
+
+//------------------------------------------------------------------------------
+
+bool PipelinedAudioProcessor::init(
+    const int sample_rate,
+    const int channels,
+    const long frame_count,
+    const int buffer_size)
+{
+    channels_ = channels;
+
+    write_count_ = 0;
+    read_count_  = 0;
+    finished_    = false;
+    failed_      = false;
+
+    return processor_.init(sample_rate, channels, frame_count, buffer_size);
+}
+
+//------------------------------------------------------------------------------
+
+bool PipelinedAudioProcessor::shouldContinue() const
+{
+    return processor_.shouldContinue();
+}
+
+//------------------------------------------------------------------------------
+
+// Waits until there is a free block in the ring, and returns it, or nullptr
+// if the other processor has failed. The block can then be written without
+// holding the mutex.
+
+PipelinedAudioProcessor::Block* PipelinedAudioProcessor::getFreeBlock()
+{
+    if (!thread_.joinable()) {
+        thread_ = std::thread(&PipelinedAudioProcessor::consume, this);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    block_read_.wait(lock, [this] {
+        return write_count_ - read_count_ < blocks_.size() || failed_;
+    });
+
+    if (failed_) {
+        return nullptr;
+    }
+
+    return &blocks_[write_count_ % blocks_.size()];
+}
+
+//------------------------------------------------------------------------------
+
+// Passes the block returned by getFreeBlock() to the other thread.
+
+void PipelinedAudioProcessor::addBlock()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++write_count_;
+    }
+
+    block_written_.notify_one();
+}
+
+//------------------------------------------------------------------------------
+
+bool PipelinedAudioProcessor::process(
+    const short* input_buffer,
+    const int input_frame_count)
+{
+    Block* block = getFreeBlock();
+
+    if (block == nullptr) {
+        return false;
+    }
+
+    block->samples.assign(
+        input_buffer,
+        input_buffer + input_frame_count * channels_
+    );
+
+    block->is_float    = false;
+    block->frame_count = input_frame_count;
+
+    addBlock();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool PipelinedAudioProcessor::supportsFloat() const
+{
+    return processor_.supportsFloat();
+}
+
+//------------------------------------------------------------------------------
+
+bool PipelinedAudioProcessor::processFloat(
+    const float* input_buffer,
+    const int input_frame_count)
+{
+    Block* block = getFreeBlock();
+
+    if (block == nullptr) {
+        return false;
+    }
+
+    block->float_samples.assign(
+        input_buffer,
+        input_buffer + input_frame_count * channels_
+    );
+
+    block->is_float    = true;
+    block->frame_count = input_frame_count;
+
+    addBlock();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void PipelinedAudioProcessor::done()
+{
+    stop();
+
+    const std::string errors = errors_.str();
+
+    if (!errors.empty()) {
+        log(Error) << errors;
+        errors_.str(std::string());
+    }
+
+    processor_.done();
+}
+
+//------------------------------------------------------------------------------
+
+// Waits for the remaining blocks to be processed, then stops the thread.
+
+void PipelinedAudioProcessor::stop()
+{
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+    }
+
+    block_written_.notify_one();
+
+    thread_.join();
+}
+
+//------------------------------------------------------------------------------
+
+void PipelinedAudioProcessor::consume()
+{
+    setThreadErrorStream(&errors_);
+
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        block_written_.wait(lock, [this] {
+            return read_count_ < write_count_ || finished_;
+        });
+
+        if (read_count_ == write_count_) {
+            break;
+        }
+
+        const Block& block = blocks_[read_count_ % blocks_.size()];
+
+        lock.unlock();
+
+        bool success;
+
+        try {
+            if (block.is_float) {
+                success = processor_.processFloat(
+                    block.float_samples.data(),
+                    block.frame_count
+                );
+            }
+            else {
+                success = processor_.process(block.samples.data(), block.frame_count);
+            }
+        }
+        catch (const std::exception& e) {
+            log(Error) << e.what() << '\n';
+            success = false;
+        }
+
+        lock.lock();
+
+        ++read_count_;
+
+        if (!success) {
+            failed_ = true;
+        }
+
+        lock.unlock();
+
+        block_read_.notify_one();
+
+        if (!success) {
+            break;
+        }
+    }
+
+    setThreadErrorStream(nullptr);
+}
+
+//------------------------------------------------------------------------------
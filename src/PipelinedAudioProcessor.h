@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_PIPELINED_AUDIO_PROCESSOR_H)
+#define INC_PIPELINED_AUDIO_PROCESSOR_H
+
+//------------------------------------------------------------------------------
+
+#include "AudioProcessor.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// Passes audio to another AudioProcessor on a separate thread, so that an
+// AudioFileReader can decode the next block of audio while the previous block
+// is being processed.
+//
+// init(), shouldContinue(), and supportsFloat() are forwarded on the calling
+// thread. Each block given to process() or processFloat() is copied into a
+// fixed size ring of blocks, which the other thread empties. If the other
+// processor's process() fails, the next call to process() returns false, so
+// the reader stops as it would without the pipeline. done() waits until all
+// blocks have been processed.
+
+class PipelinedAudioProcessor : public AudioProcessor
+{
+    public:
+        explicit PipelinedAudioProcessor(AudioProcessor& processor, int blocks = 8);
+        virtual ~PipelinedAudioProcessor();
+
+        PipelinedAudioProcessor(const PipelinedAudioProcessor&) = delete;
+        PipelinedAudioProcessor& operator=(const PipelinedAudioProcessor&) = delete;
+
+    public:
+        virtual bool init(
+            int sample_rate,
+            int channels,
+            long frame_count,
+            int buffer_size
+        );
+
+        virtual bool shouldContinue() const;
+
+        virtual bool process(
+            const short* input_buffer,
+            int input_frame_count
+        );
+
+        virtual bool supportsFloat() const;
+
+        virtual bool processFloat(
+            const float* input_buffer,
+            int input_frame_count
+        );
+
+        virtual void done();
+
+        // Returns true if the other processor's process() failed. This may
+        // happen after the last call to process(), so callers should check
+        // this after the reader has finished.
+        bool hasError() const { return failed_; }
+
+    private:
+        struct Block
+        {
+            std::vector<short> samples;
+            std::vector<float> float_samples;
+            bool is_float;
+            int frame_count;
+        };
+
+        Block* getFreeBlock();
+        void addBlock();
+
+        void consume();
+        void stop();
+
+    private:
+        AudioProcessor& processor_;
+        int channels_;
+
+        std::vector<Block> blocks_;
+
+        // Total number of blocks written and read. Each block is only
+        // accessed by one thread at a time, so only these need the mutex.
+        size_t write_count_;
+        size_t read_count_;
+
+        bool finished_;
+        bool failed_;
+
+        std::mutex mutex_;
+        std::condition_variable block_written_;
+        std::condition_variable block_read_;
+
+        std::thread thread_;
+        std::ostringstream errors_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_PIPELINED_AUDIO_PROCESSOR_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,479 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "PngWriter.h"
+#include "ImageBuffer.h"
+#include "Log.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cassert>
+#include <csetjmp>
+#include <iostream>
+
+//------------------------------------------------------------------------------
+
+const int MAX_PALETTE_SIZE = 256;
+
+//------------------------------------------------------------------------------
+
+static int getAlpha(const int color)
+{
+    return (color & 0x7f000000) >> 24;
+}
+
+static png_byte getRed(const int color)
+{
+    return static_cast<png_byte>((color & 0xff0000) >> 16);
+}
+
+static png_byte getGreen(const int color)
+{
+    return static_cast<png_byte>((color & 0x00ff00) >> 8);
+}
+
+static png_byte getBlue(const int color)
+{
+    return static_cast<png_byte>(color & 0x0000ff);
+}
+
+// Converts a libgd alpha value, from 0 (opaque) to 127 (transparent), to a
+// PNG alpha value, from 255 (opaque) to 0 (transparent), as libgd does.
+
+static png_byte getPngAlpha(const int color)
+{
+    const int alpha = getAlpha(color);
+
+    return static_cast<png_byte>(255 - ((alpha << 1) + (alpha >> 6)));
+}
+
+// Pixels are compared without their alpha values if these aren't saved.
+
+static int getColorMask(const bool save_alpha)
+{
+    return save_alpha ? 0x7fffffff : 0x00ffffff;
+}
+
+//------------------------------------------------------------------------------
+
+static int getFilterFlags(const PngFilter filter)
+{
+    switch (filter) {
+        case PngFilter::None:    return PNG_FILTER_NONE;
+        case PngFilter::Sub:     return PNG_FILTER_SUB;
+        case PngFilter::Up:      return PNG_FILTER_UP;
+        case PngFilter::Average: return PNG_FILTER_AVG;
+        case PngFilter::Paeth:   return PNG_FILTER_PAETH;
+        case PngFilter::All:     return PNG_ALL_FILTERS;
+
+        default:
+            assert(false);
+            return PNG_ALL_FILTERS;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static int getZlibStrategy(const PngStrategy strategy)
+{
+    switch (strategy) {
+        case PngStrategy::Filtered:    return Z_FILTERED;
+        case PngStrategy::HuffmanOnly: return Z_HUFFMAN_ONLY;
+        case PngStrategy::Rle:         return Z_RLE;
+        case PngStrategy::Fixed:       return Z_FIXED;
+
+        default:
+            assert(false);
+            return Z_DEFAULT_STRATEGY;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// libpng calls this function on error, which must not return.
+
+static void handleError(png_structp png, png_const_charp message)
+{
+    log(Error) << "Failed to write PNG file: " << message << '\n';
+
+    png_longjmp(png, 1);
+}
+
+//------------------------------------------------------------------------------
+
+static void handleWarning(png_structp /* png */, png_const_charp /* message */)
+{
+}
+
+//------------------------------------------------------------------------------
+
+PngOptions::PngOptions() :
+    compression_level(-1),
+    filter(PngFilter::Default),
+    strategy(PngStrategy::Default),
+    palette(true)
+{
+}
+
+//------------------------------------------------------------------------------
+
+PngWriter::PngWriter(const PngOptions& options) :
+    options_(options),
+    png_(nullptr),
+    info_(nullptr),
+    width_(0),
+    save_alpha_(false),
+    bit_depth_(0),
+    last_color_(0),
+    last_index_(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+PngWriter::~PngWriter()
+{
+    destroy();
+}
+
+//------------------------------------------------------------------------------
+
+void PngWriter::destroy()
+{
+    if (png_ != nullptr) {
+        png_destroy_write_struct(&png_, &info_);
+
+        png_  = nullptr;
+        info_ = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<int> PngWriter::findPalette(
+    const ImageBuffer& image,
+    const bool save_alpha)
+{
+    const int mask = getColorMask(save_alpha);
+
+    std::vector<int> palette;
+
+    const int width  = image.getWidth();
+    const int height = image.getHeight();
+
+    for (int y = 0; y < height; ++y) {
+        const int* row = image.getRow(y);
+
+        // Colors are never negative, so this never matches the first pixel
+        int last_color = -1;
+
+        for (int x = 0; x < width; ++x) {
+            const int color = row[x] & mask;
+
+            if (color == last_color) {
+                continue;
+            }
+
+            last_color = color;
+
+            if (std::find(palette.begin(), palette.end(), color) == palette.end()) {
+                if (palette.size() == MAX_PALETTE_SIZE) {
+                    return std::vector<int>();
+                }
+
+                palette.push_back(color);
+            }
+        }
+    }
+
+    return palette;
+}
+
+//------------------------------------------------------------------------------
+
+bool PngWriter::setPalette(const std::vector<int>& palette)
+{
+    if (palette.size() > MAX_PALETTE_SIZE) {
+        log(Error) << "Invalid PNG palette: maximum " << MAX_PALETTE_SIZE
+                   << " colors\n";
+        return false;
+    }
+
+    const int mask = getColorMask(save_alpha_);
+
+    palette_.clear();
+
+    for (const int color : palette) {
+        palette_.push_back(color & mask);
+    }
+
+    // Put translucent colors first, so the tRNS chunk only needs alpha
+    // values for these
+
+    std::stable_partition(
+        palette_.begin(),
+        palette_.end(),
+        [](int color) { return getAlpha(color) != 0; }
+    );
+
+    const size_t size = palette_.size();
+
+    bit_depth_ = size == 0  ? 8 :
+                 size <= 2  ? 1 :
+                 size <= 4  ? 2 :
+                 size <= 16 ? 4 : 8;
+
+    last_color_ = size > 0 ? palette_[0] : 0;
+    last_index_ = 0;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void PngWriter::setHeader(const int width, const int height)
+{
+    const int color_type =
+        !palette_.empty() ? PNG_COLOR_TYPE_PALETTE :
+        save_alpha_       ? PNG_COLOR_TYPE_RGB_ALPHA : PNG_COLOR_TYPE_RGB;
+
+    png_set_IHDR(
+        png_,
+        info_,
+        static_cast<png_uint_32>(width),
+        static_cast<png_uint_32>(height),
+        bit_depth_,
+        color_type,
+        PNG_INTERLACE_NONE,
+        PNG_COMPRESSION_TYPE_DEFAULT,
+        PNG_FILTER_TYPE_DEFAULT
+    );
+
+    if (!palette_.empty()) {
+        std::vector<png_color> colors;
+        std::vector<png_byte> alpha;
+
+        for (const int color : palette_) {
+            png_color png_color = { getRed(color), getGreen(color), getBlue(color) };
+            colors.push_back(png_color);
+
+            if (getAlpha(color) != 0) {
+                alpha.push_back(getPngAlpha(color));
+            }
+        }
+
+        png_set_PLTE(png_, info_, colors.data(), static_cast<int>(colors.size()));
+
+        if (!alpha.empty()) {
+            png_set_tRNS(png_, info_, alpha.data(), static_cast<int>(alpha.size()), nullptr);
+        }
+    }
+
+    if (options_.compression_level != -1) {
+        png_set_compression_level(png_, options_.compression_level);
+    }
+
+    if (options_.filter != PngFilter::Default) {
+        png_set_filter(png_, PNG_FILTER_TYPE_BASE, getFilterFlags(options_.filter));
+    }
+
+    if (options_.strategy != PngStrategy::Default) {
+        png_set_compression_strategy(png_, getZlibStrategy(options_.strategy));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool PngWriter::start(
+    FILE* file,
+    const int width,
+    const int height,
+    const std::vector<int>& palette,
+    const bool save_alpha)
+{
+    destroy();
+
+    width_      = width;
+    save_alpha_ = save_alpha;
+
+    if (!setPalette(palette)) {
+        return false;
+    }
+
+    png_ = png_create_write_struct(
+        PNG_LIBPNG_VER_STRING,
+        nullptr,
+        handleError,
+        handleWarning
+    );
+
+    if (png_ != nullptr) {
+        info_ = png_create_info_struct(png_);
+    }
+
+    if (png_ == nullptr || info_ == nullptr) {
+        log(Error) << "Failed to create PNG writer\n";
+        destroy();
+        return false;
+    }
+
+    // Each row is written with one byte per palette index, which libpng packs
+    // into the image bit depth, or 3 or 4 bytes per truecolor pixel
+
+    const size_t bytes_per_pixel = !palette_.empty() ? 1 : save_alpha ? 4 : 3;
+
+    row_.resize(static_cast<size_t>(width) * bytes_per_pixel);
+
+    if (setjmp(png_jmpbuf(png_))) {
+        destroy();
+        return false;
+    }
+
+    png_init_io(png_, file);
+
+    setHeader(width, height);
+
+    png_write_info(png_, info_);
+
+    if (bit_depth_ < 8) {
+        png_set_packing(png_);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool PngWriter::toIndexes(const int* pixels)
+{
+    const int mask = getColorMask(save_alpha_);
+
+    for (int x = 0; x < width_; ++x) {
+        const int color = pixels[x] & mask;
+
+        if (color != last_color_) {
+            auto i = std::find(palette_.begin(), palette_.end(), color);
+
+            if (i == palette_.end()) {
+                log(Error) << "Failed to write PNG file: color not in palette\n";
+                return false;
+            }
+
+            last_color_ = color;
+            last_index_ = static_cast<png_byte>(i - palette_.begin());
+        }
+
+        row_[static_cast<size_t>(x)] = last_index_;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void PngWriter::toTruecolor(const int* pixels)
+{
+    png_byte* output = row_.data();
+
+    for (int x = 0; x < width_; ++x) {
+        const int color = pixels[x];
+
+        *output++ = getRed(color);
+        *output++ = getGreen(color);
+        *output++ = getBlue(color);
+
+        if (save_alpha_) {
+            *output++ = getPngAlpha(color);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool PngWriter::writeRow(const int* pixels)
+{
+    assert(png_ != nullptr);
+
+    if (!palette_.empty()) {
+        if (!toIndexes(pixels)) {
+            destroy();
+            return false;
+        }
+    }
+    else {
+        toTruecolor(pixels);
+    }
+
+    if (setjmp(png_jmpbuf(png_))) {
+        destroy();
+        return false;
+    }
+
+    png_write_row(png_, row_.data());
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool PngWriter::finish()
+{
+    assert(png_ != nullptr);
+
+    if (setjmp(png_jmpbuf(png_))) {
+        destroy();
+        return false;
+    }
+
+    png_write_end(png_, nullptr);
+
+    destroy();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool PngWriter::write(
+    FILE* file,
+    const ImageBuffer& image,
+    const bool save_alpha)
+{
+    const std::vector<int> palette = options_.palette ?
+        findPalette(image, save_alpha) : std::vector<int>();
+
+    const int height = image.getHeight();
+
+    if (!start(file, image.getWidth(), height, palette, save_alpha)) {
+        return false;
+    }
+
+    for (int y = 0; y < height; ++y) {
+        if (!writeRow(image.getRow(y))) {
+            return false;
+        }
+    }
+
+    return finish();
+}
+
+//------------------------------------------------------------------------------
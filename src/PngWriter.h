@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_PNG_WRITER_H)
+#define INC_PNG_WRITER_H
+
+//------------------------------------------------------------------------------
+
+#include <png.h>
+
+#include <cstdio>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+class ImageBuffer;
+
+//------------------------------------------------------------------------------
+
+// The PNG row filter. Default leaves the choice to libpng, which uses no
+// filter for indexed color images, and chooses a filter for each row of
+// truecolor images.
+
+enum class PngFilter {
+    Default,
+    None,
+    Sub,
+    Up,
+    Average,
+    Paeth,
+    All
+};
+
+// The zlib compression strategy. Default leaves the choice to libpng.
+
+enum class PngStrategy {
+    Default,
+    Filtered,
+    HuffmanOnly,
+    Rle,
+    Fixed
+};
+
+//------------------------------------------------------------------------------
+
+struct PngOptions
+{
+    PngOptions();
+
+    // 0 (none) to 9 (best), or -1 (default)
+    int compression_level;
+
+    PngFilter filter;
+    PngStrategy strategy;
+
+    // If enabled (the default), images with no more than 256 colors are
+    // written as indexed color images, with 1, 2, 4, or 8 bits per pixel.
+    bool palette;
+};
+
+//------------------------------------------------------------------------------
+
+// Writes PNG images from pixels in libgd truecolor format (see ImageBuffer).
+// If save_alpha is false the alpha values are ignored and pixels are written
+// as opaque, otherwise translucent colors are written with alpha values, as
+// gdImagePngEx() does.
+//
+// An image can be written all at once, with write(), or row by row, with
+// start(), writeRow(), and finish(), so that the whole image doesn't need to
+// be in memory at once.
+
+class PngWriter
+{
+    public:
+        explicit PngWriter(const PngOptions& options = PngOptions());
+        ~PngWriter();
+
+        PngWriter(const PngWriter&) = delete;
+        PngWriter& operator=(const PngWriter&) = delete;
+
+    public:
+        bool write(FILE* file, const ImageBuffer& image, bool save_alpha);
+
+        // Starts writing an image. If the palette is empty, the image is
+        // written as a truecolor image, otherwise each pixel must be one of
+        // the palette colors. The palette may have up to 256 colors.
+        bool start(
+            FILE* file,
+            int width,
+            int height,
+            const std::vector<int>& palette,
+            bool save_alpha
+        );
+
+        bool writeRow(const int* pixels);
+
+        bool finish();
+
+        // Returns the distinct colors in the image, or an empty vector if
+        // there are more than 256.
+        static std::vector<int> findPalette(
+            const ImageBuffer& image,
+            bool save_alpha
+        );
+
+        int getBitDepth() const { return bit_depth_; }
+
+    private:
+        bool setPalette(const std::vector<int>& palette);
+        void setHeader(int width, int height);
+        bool toIndexes(const int* pixels);
+        void toTruecolor(const int* pixels);
+
+        void destroy();
+
+    private:
+        PngOptions options_;
+
+        png_structp png_;
+        png_infop info_;
+
+        int width_;
+        bool save_alpha_;
+        int bit_depth_;
+
+        std::vector<int> palette_;
+        int last_color_;
+        png_byte last_index_;
+
+        std::vector<png_byte> row_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_PNG_WRITER_H)
+
+//------------------------------------------------------------------------------
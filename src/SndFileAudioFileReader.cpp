@@ -25,8 +25,10 @@
 #include "AudioProcessor.h"
 #include "Error.h"
 #include "FileUtil.h"
+#include "JobStats.h"
 #include "Log.h"
 #include "ProgressReporter.h"
+#include "Trace.h"
 
 #include <cassert>
 #include <cstring>
@@ -49,7 +51,9 @@ static void showInfo(std::ostream& stream, const SF_INFO& info)
 //------------------------------------------------------------------------------
 
 SndFileAudioFileReader::SndFileAudioFileReader() :
-    input_file_(nullptr)
+    input_file_(nullptr),
+    start_frame_(0),
+    end_frame_(-1)
 {
     memset(&info_, 0, sizeof(info_));
 }
@@ -136,6 +140,8 @@ void SndFileAudioFileReader::configure(int channels, int sample_rate, const std:
 
 bool SndFileAudioFileReader::open(const char* input_filename, bool show_info)
 {
+    StageTimer timer(JobStats::Open);
+
     assert(input_file_ == nullptr);
 
     if (FileUtil::isStdioFilename(input_filename)) {
@@ -171,6 +177,40 @@ bool SndFileAudioFileReader::open(const char* input_filename, bool show_info)
 
 //------------------------------------------------------------------------------
 
+bool SndFileAudioFileReader::setFrameRange(
+    const long long start_frame,
+    const long long end_frame)
+{
+    assert(input_file_ != nullptr);
+    assert(start_frame >= 0);
+    assert(end_frame < 0 || start_frame <= end_frame);
+
+    if (!info_.seekable) {
+        log(Error) << "Input is not seekable\n";
+        return false;
+    }
+
+    // Seeking past the end of the input fails, so read nothing instead
+    sf_count_t seek_frame = start_frame;
+
+    if (seek_frame > info_.frames) {
+        seek_frame = info_.frames;
+    }
+
+    if (sf_seek(input_file_, seek_frame, SEEK_SET) != seek_frame) {
+        log(Error) << "Failed to seek to frame " << start_frame << ": "
+                   << sf_strerror(input_file_) << '\n';
+        return false;
+    }
+
+    start_frame_ = seek_frame;
+    end_frame_   = end_frame >= 0 && end_frame < seek_frame ? seek_frame : end_frame;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
 void SndFileAudioFileReader::close()
 {
     if (input_file_ != nullptr) {
@@ -204,18 +244,59 @@ bool SndFileAudioFileReader::run(AudioProcessor& processor)
 
     sf_count_t total_frames_read = 0;
 
-    bool success = processor.init(info_.samplerate, info_.channels, info_.frames, BUFFER_SIZE);
+    const bool has_frame_range = end_frame_ >= 0;
+
+    const sf_count_t total_frames = has_frame_range ?
+        end_frame_ - start_frame_ : info_.frames - start_frame_;
+
+    bool success = processor.init(info_.samplerate, info_.channels, total_frames, BUFFER_SIZE);
 
     if (success && processor.shouldContinue()) {
-        progress_reporter.update(0.0, 0, info_.frames);
+        // Floating point samples are passed directly to processors that
+        // support them, which avoids converting every sample to 16-bit
+        const bool use_float = is_floating_point && processor.supportsFloat();
+
+        progress_reporter.update(0.0, 0, total_frames);
 
         while (success && frames_read == frames_to_read) {
-            if (is_floating_point) {
-                frames_read = sf_readf_float(
-                    input_file_,
+            if (has_frame_range) {
+                const sf_count_t frames_remaining = total_frames - total_frames_read;
+
+                if (frames_remaining == 0) {
+                    break;
+                }
+
+                if (frames_to_read > frames_remaining) {
+                    frames_to_read = frames_remaining;
+                }
+            }
+
+            if (use_float) {
+                {
+                    TRACE_SCOPE("decode", "sf_readf_float");
+
+                    frames_read = sf_readf_float(
+                        input_file_,
+                        float_buffer,
+                        frames_to_read
+                    );
+                }
+
+                success = processor.processFloat(
                     float_buffer,
-                    frames_to_read
+                    static_cast<int>(frames_read)
                 );
+            }
+            else if (is_floating_point) {
+                {
+                    TRACE_SCOPE("decode", "sf_readf_float");
+
+                    frames_read = sf_readf_float(
+                        input_file_,
+                        float_buffer,
+                        frames_to_read
+                    );
+                }
 
                 // Scale floating-point samples from [-1.0, 1.0] to 16-bit
                 // integer range. Note: we don't use SFC_SET_SCALE_FLOAT_INT_READ
@@ -227,27 +308,36 @@ bool SndFileAudioFileReader::run(AudioProcessor& processor)
                         float_buffer[i] * std::numeric_limits<short>::max()
                     );
                 }
+
+                success = processor.process(
+                    input_buffer,
+                    static_cast<int>(frames_read)
+                );
             }
             else {
-                frames_read = sf_readf_short(
-                    input_file_,
+                {
+                    TRACE_SCOPE("decode", "sf_readf_short");
+
+                    frames_read = sf_readf_short(
+                        input_file_,
+                        input_buffer,
+                        frames_to_read
+                    );
+                }
+
+                success = processor.process(
                     input_buffer,
-                    frames_to_read
+                    static_cast<int>(frames_read)
                 );
             }
 
-            success = processor.process(
-                input_buffer,
-                static_cast<int>(frames_read)
-            );
-
             total_frames_read += frames_read;
 
             const double seconds =
                 static_cast<double>(total_frames_read) /
                 static_cast<double>(info_.samplerate);
 
-            progress_reporter.update(seconds, total_frames_read, info_.frames);
+            progress_reporter.update(seconds, total_frames_read, total_frames);
         }
 
         log(Info) << "\nRead " << total_frames_read << " frames\n";
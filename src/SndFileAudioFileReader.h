@@ -50,12 +50,23 @@ class SndFileAudioFileReader : public AudioFileReader
 
         virtual bool run(AudioProcessor& processor);
 
+        virtual int getSampleRate() const { return info_.samplerate; }
+        int getChannels() const { return info_.channels; }
+        long long getFrameCount() const { return info_.frames; }
+        bool isSeekable() const { return info_.seekable != 0; }
+
+        // The input must be open and seekable.
+        virtual bool setFrameRange(long long start_frame, long long end_frame);
+
     private:
         void close();
 
     private:
         SNDFILE* input_file_;
         SF_INFO info_;
+
+        sf_count_t start_frame_;
+        sf_count_t end_frame_;
 };
 
 //------------------------------------------------------------------------------
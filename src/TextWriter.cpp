@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "TextWriter.h"
+
+#include <cstring>
+#include <ostream>
+
+//------------------------------------------------------------------------------
+
+const size_t BUFFER_SIZE = 65536;
+
+// The two decimal digits of each number from 0 to 99
+static const char DIGIT_PAIRS[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+//------------------------------------------------------------------------------
+
+TextWriter::TextWriter(std::ostream& stream) :
+    stream_(stream),
+    buffer_(BUFFER_SIZE),
+    size_(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+// Formats the digits from the end, two at a time, then copies them to the
+// output.
+
+size_t TextWriter::formatInt(const int value, char* output)
+{
+    char digits[MAX_INT_LENGTH];
+    char* const end = digits + sizeof(digits);
+    char* p = end;
+
+    // Negate as unsigned, so that INT_MIN doesn't overflow
+    unsigned int n = value < 0 ?
+        0U - static_cast<unsigned int>(value) :
+        static_cast<unsigned int>(value);
+
+    while (n >= 100) {
+        const unsigned int index = (n % 100) * 2;
+        n /= 100;
+
+        *--p = DIGIT_PAIRS[index + 1];
+        *--p = DIGIT_PAIRS[index];
+    }
+
+    if (n >= 10) {
+        const unsigned int index = n * 2;
+
+        *--p = DIGIT_PAIRS[index + 1];
+        *--p = DIGIT_PAIRS[index];
+    }
+    else {
+        *--p = static_cast<char>('0' + n);
+    }
+
+    if (value < 0) {
+        *--p = '-';
+    }
+
+    const size_t length = static_cast<size_t>(end - p);
+
+    memcpy(output, p, length);
+
+    return length;
+}
+
+//------------------------------------------------------------------------------
+
+void TextWriter::write(const char* str)
+{
+    size_t length = strlen(str);
+
+    while (length > 0) {
+        if (size_ == buffer_.size()) {
+            flush();
+        }
+
+        size_t count = buffer_.size() - size_;
+
+        if (count > length) {
+            count = length;
+        }
+
+        memcpy(&buffer_[size_], str, count);
+
+        size_ += count;
+        str += count;
+        length -= count;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void TextWriter::flush()
+{
+    if (size_ > 0) {
+        stream_.write(&buffer_[0], static_cast<std::streamsize>(size_));
+        size_ = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_TEXT_WRITER_H)
+#define INC_TEXT_WRITER_H
+
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// Writes text to a stream in large blocks, formatting integers without the
+// locale handling and per-value virtual calls of std::ostream::operator<<.
+//
+// Text is held in a fixed size buffer until the buffer is full or flush() is
+// called. The destructor doesn't flush the buffer, as writing to the stream
+// may throw an exception, so callers must call flush() when done.
+
+class TextWriter
+{
+    public:
+        explicit TextWriter(std::ostream& stream);
+
+        TextWriter(const TextWriter&) = delete;
+        TextWriter& operator=(const TextWriter&) = delete;
+
+    public:
+        // Maximum number of characters written by formatInt()
+        static const size_t MAX_INT_LENGTH = 11;
+
+        // Writes the decimal representation of value to output, which must
+        // have space for MAX_INT_LENGTH characters. Returns the number of
+        // characters written. The output is the same as std::to_string().
+        static size_t formatInt(int value, char* output);
+
+    public:
+        void write(char c)
+        {
+            if (size_ == buffer_.size()) {
+                flush();
+            }
+
+            buffer_[size_++] = c;
+        }
+
+        void write(const char* str);
+
+        void writeInt(int value)
+        {
+            if (buffer_.size() - size_ < MAX_INT_LENGTH) {
+                flush();
+            }
+
+            size_ += formatInt(value, &buffer_[size_]);
+        }
+
+        void flush();
+
+    private:
+        std::ostream& stream_;
+        std::vector<char> buffer_;
+        size_t size_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_TEXT_WRITER_H)
+
+//------------------------------------------------------------------------------
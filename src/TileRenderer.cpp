@@ -0,0 +1,349 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "TileRenderer.h"
+#include "GdImageRenderer.h"
+#include "Log.h"
+#include "Trace.h"
+#include "WaveformBuffer.h"
+#include "WaveformRescaler.h"
+#include "WaveformUtil.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+//------------------------------------------------------------------------------
+
+TileRenderer::TileRenderer(
+    const int threads,
+    const RendererConfig& configure_renderer) :
+    threads_(threads),
+    configure_renderer_(configure_renderer),
+    tile_width_(512),
+    tile_height_(250),
+    auto_amplitude_scale_(false),
+    amplitude_scale_(1.0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+bool TileRenderer::setTileSize(const int tile_width, const int tile_height)
+{
+    if (tile_width < 1) {
+        log(Error) << "Invalid tile width: minimum 1\n";
+        return false;
+    }
+
+    if (tile_height < 1) {
+        log(Error) << "Invalid image height: minimum 1\n";
+        return false;
+    }
+
+    tile_width_  = tile_width;
+    tile_height_ = tile_height;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void TileRenderer::setAmplitudeScale(
+    const bool auto_amplitude_scale,
+    const double amplitude_scale)
+{
+    auto_amplitude_scale_ = auto_amplitude_scale;
+    amplitude_scale_      = amplitude_scale;
+}
+
+//------------------------------------------------------------------------------
+
+void TileRenderer::setPngOptions(const PngOptions& png_options)
+{
+    png_options_ = png_options;
+}
+
+//------------------------------------------------------------------------------
+
+static bool createDirectory(const boost::filesystem::path& directory)
+{
+    boost::system::error_code error_code;
+
+    boost::filesystem::create_directories(directory, error_code);
+
+    if (error_code) {
+        log(Error) << "Failed to create directory: " << directory.string() << '\n'
+                   << error_code.message() << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool TileRenderer::render(
+    const WaveformBuffer& buffer,
+    const WaveformColors& colors,
+    const boost::filesystem::path& output_directory)
+{
+    TRACE_SCOPE("render", "TileRenderer::render");
+
+    if (buffer.getSize() < 1) {
+        log(Error) << "Empty waveform buffer\n";
+        return false;
+    }
+
+    if (buffer.getSamplesPerPixel() < 1) {
+        log(Error) << "Invalid waveform scale: " << buffer.getSamplesPerPixel() << '\n';
+        return false;
+    }
+
+    std::vector<const WaveformBuffer*> levels;
+    levels.push_back(&buffer);
+
+    std::vector<std::unique_ptr<WaveformBuffer>> rescaled_buffers;
+
+    WaveformRescaler rescaler(threads_);
+
+    while (levels.back()->getSize() > tile_width_ &&
+           levels.back()->getSamplesPerPixel() <= std::numeric_limits<int>::max() / 2) {
+        const WaveformBuffer& previous_level = *levels.back();
+
+        rescaled_buffers.emplace_back(new WaveformBuffer);
+
+        rescaler.rescale(
+            previous_level,
+            *rescaled_buffers.back(),
+            previous_level.getSamplesPerPixel() * 2
+        );
+
+        levels.push_back(rescaled_buffers.back().get());
+    }
+
+    // Every tile uses the same amplitude scale, so that adjacent tiles and
+    // levels match
+    const double amplitude_scale = auto_amplitude_scale_ ?
+        WaveformUtil::getAmplitudeScale(buffer, 0, buffer.getSize()) :
+        amplitude_scale_;
+
+    std::vector<Tile> tiles;
+
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const WaveformBuffer& level = *levels[i];
+
+        const int size = level.getSize();
+        const int tile_count = (size + tile_width_ - 1) / tile_width_;
+
+        log(Info) << "Level " << i << ": "
+                  << level.getSamplesPerPixel() << " samples per pixel, "
+                  << tile_count << " tiles\n";
+
+        if (!createDirectory(output_directory / std::to_string(i))) {
+            return false;
+        }
+
+        for (int j = 0; j < tile_count; ++j) {
+            Tile tile;
+
+            tile.buffer      = &level;
+            tile.level       = static_cast<int>(i);
+            tile.index       = j;
+            tile.start_index = level.getStartIndex() + j * tile_width_;
+            tile.width       = std::min(tile_width_, size - j * tile_width_);
+
+            tiles.push_back(tile);
+        }
+    }
+
+    log(Info) << "Rendering " << tiles.size() << " tiles using "
+              << std::min(static_cast<size_t>(threads_), tiles.size())
+              << " threads...\n";
+
+    if (!renderTiles(tiles, colors, amplitude_scale, output_directory)) {
+        return false;
+    }
+
+    return writeManifest(levels, output_directory);
+}
+
+//------------------------------------------------------------------------------
+
+bool TileRenderer::renderTiles(
+    const std::vector<Tile>& tiles,
+    const WaveformColors& colors,
+    const double amplitude_scale,
+    const boost::filesystem::path& output_directory) const
+{
+    const size_t thread_count = std::min(static_cast<size_t>(threads_), tiles.size());
+
+    std::atomic<size_t> next_tile(0);
+    std::atomic<bool> failed(false);
+
+    // Errors from each thread, reported once all threads have finished
+    std::vector<std::unique_ptr<std::ostringstream>> errors;
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        errors.emplace_back(new std::ostringstream);
+
+        std::ostringstream* thread_errors = errors.back().get();
+
+        threads.emplace_back([&, thread_errors]() {
+            setThreadErrorStream(thread_errors);
+
+            try {
+                for (;;) {
+                    const size_t index = next_tile.fetch_add(1);
+
+                    if (index >= tiles.size() || failed) {
+                        break;
+                    }
+
+                    if (!renderTile(tiles[index], colors, amplitude_scale, output_directory)) {
+                        failed = true;
+                    }
+                }
+            }
+            catch (const std::exception& e) {
+                log(Error) << e.what() << '\n';
+                failed = true;
+            }
+
+            setThreadErrorStream(nullptr);
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& thread_errors : errors) {
+        const std::string message = thread_errors->str();
+
+        if (!message.empty()) {
+            log(Error) << message;
+        }
+    }
+
+    return !failed;
+}
+
+//------------------------------------------------------------------------------
+
+bool TileRenderer::renderTile(
+    const Tile& tile,
+    const WaveformColors& colors,
+    const double amplitude_scale,
+    const boost::filesystem::path& output_directory) const
+{
+    TRACE_SCOPE("render", "TileRenderer::renderTile");
+
+    GdImageRenderer renderer;
+
+    if (!configure_renderer_(renderer)) {
+        return false;
+    }
+
+    renderer.setStartIndex(tile.start_index);
+    renderer.setBufferStartIndex(tile.buffer->getStartIndex());
+    renderer.setAmplitudeScale(false, amplitude_scale);
+
+    // Axis labels and borders would be broken at the edges of each tile
+    renderer.enableAxisLabels(false);
+
+    if (!renderer.create(*tile.buffer, tile.width, tile_height_, colors)) {
+        return false;
+    }
+
+    const boost::filesystem::path filename =
+        output_directory /
+        std::to_string(tile.level) /
+        (std::to_string(tile.index) + ".png");
+
+    return renderer.saveAsPng(filename.string().c_str(), png_options_);
+}
+
+//------------------------------------------------------------------------------
+
+bool TileRenderer::writeManifest(
+    const std::vector<const WaveformBuffer*>& levels,
+    const boost::filesystem::path& output_directory) const
+{
+    const boost::filesystem::path filename = output_directory / "manifest.json";
+
+    std::ofstream file(filename.string());
+
+    if (!file) {
+        log(Error) << "Failed to write manifest file: " << filename.string() << '\n'
+                   << strerror(errno) << '\n';
+        return false;
+    }
+
+    const WaveformBuffer& buffer = *levels.front();
+
+    file << "{\n"
+         << "  \"version\": 1,\n"
+         << "  \"sample_rate\": " << buffer.getSampleRate() << ",\n"
+         << "  \"channels\": " << buffer.getChannels() << ",\n"
+         << "  \"tile_width\": " << tile_width_ << ",\n"
+         << "  \"tile_height\": " << tile_height_ << ",\n"
+         << "  \"levels\": [\n";
+
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const WaveformBuffer& level = *levels[i];
+
+        const int tile_count = (level.getSize() + tile_width_ - 1) / tile_width_;
+
+        file << "    {"
+             << "\"samples_per_pixel\": " << level.getSamplesPerPixel()
+             << ", \"width\": " << level.getSize()
+             << ", \"tiles\": " << tile_count
+             << "}" << (i + 1 < levels.size() ? ",\n" : "\n");
+    }
+
+    file << "  ]\n"
+         << "}\n";
+
+    file.close();
+
+    if (!file) {
+        log(Error) << "Failed to write manifest file: " << filename.string() << '\n'
+                   << strerror(errno) << '\n';
+        return false;
+    }
+
+    log(Info) << "Output file: " << filename.string() << '\n';
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
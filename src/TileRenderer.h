@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_TILE_RENDERER_H)
+#define INC_TILE_RENDERER_H
+
+//------------------------------------------------------------------------------
+
+#include "PngWriter.h"
+#include "WaveformColors.h"
+
+#include <boost/filesystem.hpp>
+
+#include <functional>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+class GdImageRenderer;
+class WaveformBuffer;
+
+//------------------------------------------------------------------------------
+
+// Renders waveform data as a pyramid of fixed width PNG image tiles, for
+// viewers that show a scrollable, zoomable waveform.
+//
+// Level 0 is rendered from the given waveform data. Each following level has
+// twice the samples per pixel of the one before, and is made by rescaling it,
+// until the whole waveform fits in one tile. Each tile is written to
+// <directory>/<level>/<tile>.png, and the levels are described in
+// <directory>/manifest.json. Tiles are rendered on worker threads, each tile
+// with its own GdImageRenderer.
+
+class TileRenderer
+{
+    public:
+        // Sets the renderer options, such as bar style, for each tile. Called
+        // from the worker threads.
+        typedef std::function<bool(GdImageRenderer&)> RendererConfig;
+
+        TileRenderer(int threads, const RendererConfig& configure_renderer);
+
+        TileRenderer(const TileRenderer&) = delete;
+        TileRenderer& operator=(const TileRenderer&) = delete;
+
+    public:
+        bool setTileSize(int tile_width, int tile_height);
+
+        void setAmplitudeScale(bool auto_amplitude_scale, double amplitude_scale);
+
+        void setPngOptions(const PngOptions& png_options);
+
+        bool render(
+            const WaveformBuffer& buffer,
+            const WaveformColors& colors,
+            const boost::filesystem::path& output_directory
+        );
+
+    private:
+        struct Tile
+        {
+            const WaveformBuffer* buffer;
+            int level;
+            int index;
+            int start_index;
+            int width;
+        };
+
+        bool renderTiles(
+            const std::vector<Tile>& tiles,
+            const WaveformColors& colors,
+            double amplitude_scale,
+            const boost::filesystem::path& output_directory
+        ) const;
+
+        bool renderTile(
+            const Tile& tile,
+            const WaveformColors& colors,
+            double amplitude_scale,
+            const boost::filesystem::path& output_directory
+        ) const;
+
+        bool writeManifest(
+            const std::vector<const WaveformBuffer*>& levels,
+            const boost::filesystem::path& output_directory
+        ) const;
+
+    private:
+        int threads_;
+        RendererConfig configure_renderer_;
+
+        int tile_width_;
+        int tile_height_;
+
+        bool auto_amplitude_scale_;
+        double amplitude_scale_;
+
+        PngOptions png_options_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_TILE_RENDERER_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,158 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "TimedAudioProcessor.h"
+#include "Trace.h"
+
+//------------------------------------------------------------------------------
+
+TimedAudioProcessor::TimedAudioProcessor(AudioProcessor& processor) :
+    processor_(processor),
+    stats_(JobStats::getThreadStats()),
+    frame_count_(0)
+{
+    start_.wall = 0.0;
+    start_.cpu  = 0.0;
+
+    time_ = start_;
+}
+
+//------------------------------------------------------------------------------
+
+TimedAudioProcessor::~TimedAudioProcessor()
+{
+    if (stats_ != nullptr) {
+        stats_->addTime(JobStats::Process, time_);
+        stats_->addFrames(frame_count_);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void TimedAudioProcessor::start()
+{
+    if (stats_ != nullptr) {
+        start_ = JobStats::now();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void TimedAudioProcessor::stop()
+{
+    if (stats_ != nullptr) {
+        const JobStats::Time end = JobStats::now();
+
+        time_.wall += end.wall - start_.wall;
+        time_.cpu  += end.cpu  - start_.cpu;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool TimedAudioProcessor::init(
+    const int sample_rate,
+    const int channels,
+    const long frame_count,
+    const int buffer_size)
+{
+    TRACE_SCOPE("process", "AudioProcessor::init");
+
+    start();
+
+    const bool success = processor_.init(
+        sample_rate,
+        channels,
+        frame_count,
+        buffer_size
+    );
+
+    stop();
+
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+bool TimedAudioProcessor::shouldContinue() const
+{
+    return processor_.shouldContinue();
+}
+
+//------------------------------------------------------------------------------
+
+bool TimedAudioProcessor::process(
+    const short* input_buffer,
+    const int input_frame_count)
+{
+    TRACE_SCOPE("process", "AudioProcessor::process");
+
+    start();
+
+    const bool success = processor_.process(input_buffer, input_frame_count);
+
+    stop();
+
+    frame_count_ += input_frame_count;
+
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+bool TimedAudioProcessor::supportsFloat() const
+{
+    return processor_.supportsFloat();
+}
+
+//------------------------------------------------------------------------------
+
+bool TimedAudioProcessor::processFloat(
+    const float* input_buffer,
+    const int input_frame_count)
+{
+    TRACE_SCOPE("process", "AudioProcessor::processFloat");
+
+    start();
+
+    const bool success = processor_.processFloat(input_buffer, input_frame_count);
+
+    stop();
+
+    frame_count_ += input_frame_count;
+
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+void TimedAudioProcessor::done()
+{
+    TRACE_SCOPE("process", "AudioProcessor::done");
+
+    start();
+
+    processor_.done();
+
+    stop();
+}
+
+//------------------------------------------------------------------------------
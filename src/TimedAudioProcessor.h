@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_TIMED_AUDIO_PROCESSOR_H)
+#define INC_TIMED_AUDIO_PROCESSOR_H
+
+//------------------------------------------------------------------------------
+
+#include "AudioProcessor.h"
+#include "JobStats.h"
+
+//------------------------------------------------------------------------------
+
+// Passes audio to another AudioProcessor, and measures the time it spends
+// processing the audio, for the --stats option. The time and number of frames
+// are added to the JobStats of the thread that creates this object, when this
+// object is destroyed. If that thread has no JobStats, nothing is measured.
+//
+// Any thread may call process(), e.g., from a PipelinedAudioProcessor.
+
+class TimedAudioProcessor : public AudioProcessor
+{
+    public:
+        explicit TimedAudioProcessor(AudioProcessor& processor);
+        virtual ~TimedAudioProcessor();
+
+        TimedAudioProcessor(const TimedAudioProcessor&) = delete;
+        TimedAudioProcessor& operator=(const TimedAudioProcessor&) = delete;
+
+    public:
+        virtual bool init(
+            int sample_rate,
+            int channels,
+            long frame_count,
+            int buffer_size
+        );
+
+        virtual bool shouldContinue() const;
+
+        virtual bool process(
+            const short* input_buffer,
+            int input_frame_count
+        );
+
+        virtual bool supportsFloat() const;
+
+        virtual bool processFloat(
+            const float* input_buffer,
+            int input_frame_count
+        );
+
+        virtual void done();
+
+        // Returns the time spent in the other processor.
+        const JobStats::Time& getTime() const { return time_; }
+
+    private:
+        void start();
+        void stop();
+
+    private:
+        AudioProcessor& processor_;
+        JobStats* stats_;
+
+        JobStats::Time start_;
+        JobStats::Time time_;
+
+        long long frame_count_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_TIMED_AUDIO_PROCESSOR_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Trace.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace {
+    struct Event
+    {
+        const char* category;
+        const char* name;
+        char phase;
+        double start_time;
+        double duration;
+        int thread_id;
+    };
+
+    // Limits the memory used if tracing is left on for a long time, e.g.,
+    // in server mode. Each event uses about 40 bytes.
+    const size_t MAX_EVENTS = 4000000;
+
+    std::mutex events_mutex;
+    std::vector<Event> events;
+    size_t dropped_events = 0;
+
+    std::chrono::steady_clock::time_point trace_start_time;
+
+    std::atomic<int> next_thread_id(1);
+}
+
+//------------------------------------------------------------------------------
+
+namespace Trace {
+
+std::atomic<bool> enabled(false);
+
+//------------------------------------------------------------------------------
+
+// Returns a small number that identifies the calling thread in the trace.
+
+static int getThreadId()
+{
+    static thread_local int thread_id = next_thread_id.fetch_add(1);
+    return thread_id;
+}
+
+//------------------------------------------------------------------------------
+
+static void recordEvent(const Event& event)
+{
+    std::lock_guard<std::mutex> lock(events_mutex);
+
+    if (events.size() < MAX_EVENTS) {
+        events.push_back(event);
+    }
+    else {
+        dropped_events++;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void start()
+{
+    {
+        std::lock_guard<std::mutex> lock(events_mutex);
+
+        events.clear();
+        dropped_events = 0;
+    }
+
+    trace_start_time = std::chrono::steady_clock::now();
+
+    enabled.store(true, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+
+static void writeEvent(std::ostream& stream, const Event& event)
+{
+    stream << "{\"name\":\"" << event.name << '"'
+           << ",\"cat\":\"" << event.category << '"'
+           << ",\"ph\":\"" << event.phase << '"'
+           << ",\"ts\":" << event.start_time;
+
+    if (event.phase == 'X') {
+        stream << ",\"dur\":" << event.duration;
+    }
+    else {
+        // Instant events are shown on their thread's track
+        stream << ",\"s\":\"t\"";
+    }
+
+    stream << ",\"pid\":1,\"tid\":" << event.thread_id << '}';
+}
+
+//------------------------------------------------------------------------------
+
+bool stop(const std::string& filename)
+{
+    enabled.store(false, std::memory_order_release);
+
+    std::vector<Event> recorded_events;
+    size_t dropped;
+
+    {
+        std::lock_guard<std::mutex> lock(events_mutex);
+
+        recorded_events.swap(events);
+        dropped = dropped_events;
+    }
+
+    if (dropped > 0) {
+        log(Error) << "Trace events dropped: " << dropped << '\n';
+    }
+
+    std::ofstream file(filename);
+
+    if (!file) {
+        log(Error) << "Failed to write trace file: " << filename << '\n'
+                   << strerror(errno) << '\n';
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(3)
+         << "{\"traceEvents\":[\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+         << "\"args\":{\"name\":\"audiowaveform\"}}";
+
+    for (const auto& event : recorded_events) {
+        file << ",\n";
+        writeEvent(file, event);
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    file.close();
+
+    if (!file) {
+        log(Error) << "Failed to write trace file: " << filename << '\n'
+                   << strerror(errno) << '\n';
+        return false;
+    }
+
+    log(Info) << "Trace events: " << recorded_events.size() << '\n';
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+double now()
+{
+    const auto elapsed = std::chrono::steady_clock::now() - trace_start_time;
+
+    return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+//------------------------------------------------------------------------------
+
+void addEvent(
+    const char* category,
+    const char* name,
+    const double start_time,
+    const double duration)
+{
+    Event event;
+
+    event.category   = category;
+    event.name       = name;
+    event.phase      = 'X';
+    event.start_time = start_time;
+    event.duration   = duration;
+    event.thread_id  = getThreadId();
+
+    recordEvent(event);
+}
+
+//------------------------------------------------------------------------------
+
+void addInstantEvent(const char* category, const char* name)
+{
+    Event event;
+
+    event.category   = category;
+    event.name       = name;
+    event.phase      = 'i';
+    event.start_time = now();
+    event.duration   = 0.0;
+    event.thread_id  = getThreadId();
+
+    recordEvent(event);
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace Trace
+
+//------------------------------------------------------------------------------
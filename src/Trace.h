@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_TRACE_H)
+#define INC_TRACE_H
+
+//------------------------------------------------------------------------------
+
+#include "Config.h"
+
+#include <atomic>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+// Records trace events for the --trace option, written as a JSON file in the
+// Chrome trace event format, which can be loaded into chrome://tracing or
+// https://ui.perfetto.dev to see a timeline of each thread.
+//
+// Code is instrumented with the TRACE_SCOPE and TRACE_INSTANT macros. While
+// tracing isn't started, each trace point costs only an atomic load,
+// and if audiowaveform is built with ENABLE_TRACE=0 they're removed entirely.
+//
+// Event names and categories must be string literals, as only the pointers
+// are stored.
+
+namespace Trace {
+    // Set while trace events are being recorded
+    extern std::atomic<bool> enabled;
+
+    // Starts recording trace events, from all threads.
+    void start();
+
+    // Stops recording, and writes the events recorded to the given file.
+    bool stop(const std::string& filename);
+
+    inline bool isEnabled()
+    {
+        return enabled.load(std::memory_order_acquire);
+    }
+
+    // Returns the time since tracing started, in microseconds.
+    double now();
+
+    void addEvent(
+        const char* category,
+        const char* name,
+        double start_time,
+        double duration
+    );
+
+    void addInstantEvent(const char* category, const char* name);
+}
+
+//------------------------------------------------------------------------------
+
+// Records a trace event for the time from construction to destruction.
+
+class TraceScope
+{
+    public:
+        TraceScope(const char* category, const char* name) :
+            category_(category),
+            name_(name),
+            start_time_(Trace::isEnabled() ? Trace::now() : -1.0)
+        {
+        }
+
+        ~TraceScope()
+        {
+            if (start_time_ >= 0.0) {
+                Trace::addEvent(
+                    category_,
+                    name_,
+                    start_time_,
+                    Trace::now() - start_time_
+                );
+            }
+        }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+    private:
+        const char* category_;
+        const char* name_;
+        double start_time_;
+};
+
+//------------------------------------------------------------------------------
+
+#if ENABLE_TRACE
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#define TRACE_SCOPE(category, name) \
+    TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(category, name)
+
+#define TRACE_INSTANT(category, name) \
+    do { \
+        if (Trace::isEnabled()) { \
+            Trace::addInstantEvent(category, name); \
+        } \
+    } while (0)
+
+#else
+
+#define TRACE_SCOPE(category, name) do { } while (0)
+#define TRACE_INSTANT(category, name) do { } while (0)
+
+#endif
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_TRACE_H)
+
+//------------------------------------------------------------------------------
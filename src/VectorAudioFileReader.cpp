@@ -36,7 +36,9 @@ VectorAudioFileReader::VectorAudioFileReader(
     int channels) :
     samples_(samples),
     sample_rate_(sample_rate),
-    channels_(channels)
+    channels_(channels),
+    start_frame_(0),
+    end_frame_(samples.size() / channels)
 {
 }
 
@@ -55,6 +57,27 @@ bool VectorAudioFileReader::open(const char* /* input_filename */, bool /* show_
 
 //------------------------------------------------------------------------------
 
+bool VectorAudioFileReader::setFrameRange(
+    const long long start_frame,
+    const long long end_frame)
+{
+    const size_t frame_count = samples_.size() / channels_;
+
+    if (start_frame < 0 || static_cast<size_t>(start_frame) > frame_count) {
+        log(Error) << "Invalid start frame: " << start_frame << '\n';
+        return false;
+    }
+
+    start_frame_ = static_cast<size_t>(start_frame);
+
+    end_frame_ = end_frame < 0 || static_cast<size_t>(end_frame) > frame_count ?
+        frame_count : static_cast<size_t>(end_frame);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
 void VectorAudioFileReader::close()
 {
 }
@@ -67,9 +90,9 @@ bool VectorAudioFileReader::run(AudioProcessor& processor)
 
     const size_t BUFFER_SIZE = 16384;
 
-    const size_t total_frames = samples_.size() / channels_;
+    const size_t total_frames = end_frame_ - start_frame_;
     size_t frames_to_read = total_frames;
-    size_t index = 0;
+    size_t index = start_frame_ * channels_;
     size_t total_frames_read = 0;
 
     bool success = processor.init(sample_rate_, channels_, total_frames, BUFFER_SIZE);
@@ -28,6 +28,7 @@
 
 #include "AudioFileReader.h"
 
+#include <cstddef>
 #include <vector>
 
 //------------------------------------------------------------------------------
@@ -55,6 +56,10 @@ class VectorAudioFileReader : public AudioFileReader
 
         virtual bool run(AudioProcessor& processor);
 
+        virtual int getSampleRate() const { return sample_rate_; }
+
+        virtual bool setFrameRange(long long start_frame, long long end_frame);
+
     private:
         void close();
 
@@ -62,6 +67,9 @@ class VectorAudioFileReader : public AudioFileReader
         const std::vector<short>& samples_;
         int sample_rate_;
         int channels_;
+
+        size_t start_frame_;
+        size_t end_frame_;
 };
 
 //------------------------------------------------------------------------------
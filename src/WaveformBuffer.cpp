@@ -24,16 +24,23 @@
 #include "WaveformBuffer.h"
 #include "FileHandle.h"
 #include "FileUtil.h"
+#include "JobStats.h"
 #include "Log.h"
+#include "MappedFile.h"
+#include "TextWriter.h"
+#include "Trace.h"
+#include "WaveformCodec.h"
 
 #include "pdjson/pdjson.h"
 
 #include <boost/format.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <sstream>
 #include <stdexcept>
@@ -107,7 +114,7 @@ static void writeVector(std::ostream& stream, const std::vector<T>& values)
     static_assert(std::is_integral<T>::value, "T must be integral type");
 
     stream.write(
-        reinterpret_cast<const char*>(&values[0]),
+        reinterpret_cast<const char*>(values.data()),
         static_cast<std::streamsize>(values.size() * sizeof(T))
     );
 }
@@ -130,7 +137,261 @@ static void reportWriteError(const char* filename, const char* message)
 
 //------------------------------------------------------------------------------
 
-const uint32_t FLAG_8_BIT = 0x00000001U;
+const uint32_t FLAG_8_BIT   = 0x00000001U;
+const uint32_t FLAG_INDEXED = 0x00000002U;
+
+// Size of the version 2 and 3 header. Version 1 headers are 4 bytes smaller
+const size_t MAX_HEADER_SIZE = 24;
+
+// Size of the block size and block count fields in an indexed file, which
+// are followed by the block offsets
+const size_t INDEX_HEADER_SIZE = 8;
+
+//------------------------------------------------------------------------------
+
+static bool checkVersion(const char* filename, const int32_t version)
+{
+    if (version < 1 || version > 3) {
+        reportReadError(
+            filename,
+            boost::str(boost::format("Cannot load data file version: %1%") % version).c_str()
+        );
+
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+static bool checkSampleRate(const char* filename, const int sample_rate)
+{
+    if (sample_rate < 1) {
+        reportReadError(
+            filename,
+            boost::str(
+                boost::format("Invalid sample rate: %1% Hz, minimum 1 Hz") % sample_rate
+            ).c_str()
+        );
+
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+static bool checkSamplesPerPixel(const char* filename, const int samples_per_pixel)
+{
+    if (samples_per_pixel < 2) {
+        reportReadError(
+            filename,
+            boost::str(
+                boost::format("Invalid samples per pixel: %1%, minimum 2") % samples_per_pixel
+            ).c_str()
+        );
+
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+static bool checkChannels(const char* filename, const int channels)
+{
+    if (channels < 1 || channels > WaveformBuffer::MAX_CHANNELS) {
+        reportReadError(
+            filename,
+            boost::str(boost::format("Cannot load data file with %1% channels") % channels).c_str()
+        );
+
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+static T getValue(const unsigned char* data)
+{
+    T value;
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+
+// Converts 8-bit values to 16-bit. This is a simple loop so that the compiler
+// can vectorize it.
+
+static void widen8BitValues(const int8_t* input, const size_t count, short* output)
+{
+    for (size_t i = 0; i < count; ++i) {
+        output[i] = static_cast<short>(input[i] * 256);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static bool readFile(FILE* file, std::vector<char>& buffer)
+{
+    const size_t chunk_size = 65536;
+
+    for (;;) {
+        const size_t offset = buffer.size();
+
+        buffer.resize(offset + chunk_size);
+
+        const size_t count = fread(&buffer[offset], 1, chunk_size, file);
+
+        buffer.resize(offset + count);
+
+        if (count < chunk_size) {
+            return !ferror(file);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static bool isJsonSpace(const char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+//------------------------------------------------------------------------------
+
+// Reads the values of a JSON data array straight from the buffer being
+// parsed, which is much faster than reading each value as a separate JSON
+// token. This is called after pdjson has read the opening '['.
+//
+// Only arrays of integers that are in range for the given number of bits are
+// read. If the array contains anything else, such as numbers with a fraction
+// or exponent, or isn't valid JSON, this returns false without changing
+// the parser position, and the array is read by pdjson instead. Otherwise,
+// the parser is moved to the closing ']'.
+
+static bool readDataArray(
+    json_stream* json,
+    const char* data,
+    const size_t size,
+    const int bits,
+    const size_t expected_values,
+    std::vector<short>& values)
+{
+    const char* p   = data + json_get_position(json);
+    const char* end = data + size;
+
+    const int min_value = bits == 8 ? INT8_MIN : INT16_MIN;
+    const int max_value = bits == 8 ? INT8_MAX : INT16_MAX;
+    const int scale     = bits == 8 ? 256 : 1;
+
+    const size_t offset = values.size();
+
+    // Each value takes at least two characters, including the separator, so
+    // an invalid length field can't cause a very large allocation
+    values.reserve(offset + std::min(
+        expected_values,
+        static_cast<size_t>(end - p) / 2 + 1
+    ));
+
+    size_t lines = 0;
+
+    auto skipSpace = [&p, end, &lines]() {
+        while (p != end && isJsonSpace(*p)) {
+            if (*p == '\n') {
+                ++lines;
+            }
+
+            ++p;
+        }
+    };
+
+    auto fail = [&values, offset]() {
+        values.resize(offset);
+        return false;
+    };
+
+    skipSpace();
+
+    // An empty array needs no further checks
+    if (p == end || *p != ']') {
+        for (;;) {
+            if (p == end) {
+                return fail();
+            }
+
+            const bool negative = *p == '-';
+
+            if (negative && ++p == end) {
+                return fail();
+            }
+
+            if (*p < '0' || *p > '9') {
+                return fail();
+            }
+
+            int value = *p++ - '0';
+
+            // JSON doesn't allow leading zeros, so a zero must be followed by
+            // a separator, which is checked below. Any value with more than
+            // five digits is out of range.
+            if (value != 0) {
+                int digits = 1;
+
+                while (p != end && *p >= '0' && *p <= '9') {
+                    if (++digits > 5) {
+                        return fail();
+                    }
+
+                    value = value * 10 + (*p++ - '0');
+                }
+            }
+
+            if (negative) {
+                value = -value;
+            }
+
+            if (value < min_value || value > max_value) {
+                return fail();
+            }
+
+            values.push_back(static_cast<short>(value * scale));
+
+            skipSpace();
+
+            if (p == end) {
+                return fail();
+            }
+
+            if (*p == ']') {
+                break;
+            }
+
+            if (*p != ',') {
+                return fail();
+            }
+
+            ++p;
+
+            skipSpace();
+        }
+    }
+
+    // pdjson has no function to skip input, so update its position and line
+    // number directly. This is only valid for a json_open_buffer() stream.
+    json->source.position = static_cast<size_t>(p - data);
+    json->lineno += lines;
+
+    return true;
+}
 
 //------------------------------------------------------------------------------
 
@@ -138,21 +399,405 @@ WaveformBuffer::WaveformBuffer() :
     sample_rate_(0),
     samples_per_pixel_(0),
     bits_(16),
-    channels_(1)
+    channels_(1),
+    start_index_(0)
 {
 }
 
 //------------------------------------------------------------------------------
 
 bool WaveformBuffer::load(const char* filename)
+{
+    return load(filename, 0, std::numeric_limits<int>::max());
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformBuffer::load(
+    const char* filename,
+    const int start_index,
+    const int end_index)
+{
+    StageTimer timer(JobStats::Decode);
+    TRACE_SCOPE("decode", "WaveformBuffer::load");
+
+    start_index_ = start_index;
+
+    if (!FileUtil::isStdioFilename(filename)) {
+        MappedFile file;
+
+        // Small files, including any with an incomplete header, are read
+        // from a stream instead
+        if (file.open(filename) && file.getSize() >= MAX_HEADER_SIZE) {
+            log(Info) << "Input file: " << filename << '\n';
+
+            return loadFromMemory(
+                filename,
+                file.getData(),
+                file.getSize(),
+                start_index,
+                end_index
+            );
+        }
+    }
+
+    return loadFromStream(filename, start_index, end_index);
+}
+
+//------------------------------------------------------------------------------
+
+// Removes all values after offset except from first_value up to last_value,
+// relative to offset.
+
+void WaveformBuffer::trim(
+    const size_t offset,
+    size_t first_value,
+    size_t last_value)
+{
+    last_value  = std::min(last_value, data_.size() - offset);
+    first_value = std::min(first_value, last_value);
+
+    data_.resize(offset + last_value);
+
+    data_.erase(
+        data_.begin() + static_cast<std::ptrdiff_t>(offset),
+        data_.begin() + static_cast<std::ptrdiff_t>(offset + first_value)
+    );
+}
+
+//------------------------------------------------------------------------------
+
+void WaveformBuffer::logInfo(const uint32_t expected_size, const bool complete) const
+{
+    if (complete) {
+        log(Info) << "Channels: " << channels_
+                  << "\nSample rate: " << sample_rate_ << " Hz"
+                  << "\nBits: " << bits_
+                  << "\nSamples per pixel: " << samples_per_pixel_;
+
+        if (start_index_ > 0) {
+            log(Info) << "\nStart index: " << start_index_;
+        }
+
+        log(Info) << "\nLength: " << getSize() << " points" << std::endl;
+    }
+    else {
+        log(Info) << "Expected " << expected_size << " points, read "
+                  << getSize() << " min and max points\n";
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Loads a data file that has been mapped into memory, copying all values at
+// once instead of reading each value from a stream.
+
+bool WaveformBuffer::loadFromMemory(
+    const char* filename,
+    const unsigned char* data,
+    const size_t size,
+    const int start_index,
+    const int end_index)
+{
+    static_assert(sizeof(short) == sizeof(int16_t), "short must be 16 bits");
+
+    const int32_t version = getValue<int32_t>(data);
+
+    if (!checkVersion(filename, version)) {
+        return false;
+    }
+
+    const uint32_t flags = getValue<uint32_t>(data + 4);
+
+    sample_rate_ = getValue<int32_t>(data + 8);
+
+    if (!checkSampleRate(filename, sample_rate_)) {
+        return false;
+    }
+
+    samples_per_pixel_ = getValue<int32_t>(data + 12);
+
+    if (!checkSamplesPerPixel(filename, samples_per_pixel_)) {
+        return false;
+    }
+
+    const uint32_t expected_size = getValue<uint32_t>(data + 16);
+
+    size_t header_size = 20;
+
+    if (version >= 2) {
+        channels_ = getValue<int32_t>(data + 20);
+        header_size += 4;
+    }
+    else {
+        channels_ = 1;
+    }
+
+    if (!checkChannels(filename, channels_)) {
+        return false;
+    }
+
+    bits_ = (flags & FLAG_8_BIT) != 0 ? 8 : 16;
+
+    const size_t point_size = static_cast<size_t>(channels_) * 2;
+
+    if ((flags & FLAG_INDEXED) != 0) {
+        return loadIndexed(
+            filename,
+            data,
+            size,
+            header_size,
+            version,
+            expected_size,
+            start_index,
+            end_index
+        );
+    }
+
+    if (version == 3) {
+        return loadCompressed(
+            filename,
+            data + header_size,
+            size - header_size,
+            expected_size,
+            start_index,
+            end_index
+        );
+    }
+
+    const size_t value_size = bits_ == 8 ? sizeof(int8_t) : sizeof(int16_t);
+
+    const size_t available_values = (size - header_size) / value_size;
+
+    // As when reading from a stream, a file that ends before the expected
+    // number of points is not an error
+    const size_t expected_values = expected_size == UNKNOWN_LENGTH ?
+        available_values - available_values % point_size :
+        static_cast<size_t>(expected_size) * point_size;
+
+    const size_t values = std::min(expected_values, available_values);
+
+    // Only the values in the requested range are copied
+    const size_t last_value = std::min(
+        static_cast<size_t>(end_index) * point_size,
+        values
+    );
+
+    const size_t first_value = std::min(
+        static_cast<size_t>(start_index) * point_size,
+        last_value
+    );
+
+    const size_t offset = data_.size();
+
+    data_.resize(offset + last_value - first_value);
+
+    if (last_value > first_value) {
+        const unsigned char* body = data + header_size + first_value * value_size;
+
+        if (bits_ == 8) {
+            widen8BitValues(
+                reinterpret_cast<const int8_t*>(body),
+                last_value - first_value,
+                &data_[offset]
+            );
+        }
+        else {
+            memcpy(&data_[offset], body, (last_value - first_value) * value_size);
+        }
+    }
+
+    logInfo(expected_size, values == expected_values);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Loads the data from a version 3 file, after the header has been read.
+
+bool WaveformBuffer::loadCompressed(
+    const char* filename,
+    const unsigned char* data,
+    const size_t size,
+    const uint32_t expected_size,
+    const int start_index,
+    const int end_index)
+{
+    const size_t point_size = static_cast<size_t>(channels_) * 2;
+
+    const size_t expected_values = expected_size == UNKNOWN_LENGTH ?
+        std::numeric_limits<size_t>::max() :
+        static_cast<size_t>(expected_size) * point_size;
+
+    // Each value depends on the values before it, so decoding starts from
+    // the beginning, but stops at the end of the requested range
+    const size_t last_value = std::min(
+        static_cast<size_t>(end_index) * point_size,
+        expected_values
+    );
+
+    const size_t offset = data_.size();
+
+    if (!WaveformCodec::decode(data, size, channels_, bits_, last_value, data_)) {
+        reportReadError(filename, "Invalid compressed data");
+        return false;
+    }
+
+    const size_t values = data_.size() - offset;
+
+    // Discard any incomplete point at the end of the file
+    const size_t complete_values = values - values % point_size;
+
+    trim(offset, static_cast<size_t>(start_index) * point_size, complete_values);
+
+    logInfo(
+        expected_size,
+        expected_size == UNKNOWN_LENGTH || values == last_value
+    );
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Loads the blocks of an indexed file that contain the points from
+// start_index up to end_index, after the header has been read.
+
+bool WaveformBuffer::loadIndexed(
+    const char* filename,
+    const unsigned char* data,
+    const size_t size,
+    const size_t header_size,
+    const int version,
+    const uint32_t expected_size,
+    const int start_index,
+    const int end_index)
+{
+    const size_t index_start = header_size + INDEX_HEADER_SIZE;
+
+    if (expected_size == UNKNOWN_LENGTH || size < index_start) {
+        reportReadError(filename, "Invalid block index");
+        return false;
+    }
+
+    const uint32_t block_size  = getValue<uint32_t>(data + header_size);
+    const uint32_t block_count = getValue<uint32_t>(data + header_size + 4);
+
+    // The index has an offset for each block, and the offset of the end of
+    // the data
+    const size_t index_end = index_start +
+        (static_cast<size_t>(block_count) + 1) * sizeof(uint64_t);
+
+    if (block_size == 0 ||
+        block_count != (static_cast<uint64_t>(expected_size) + block_size - 1) / block_size ||
+        size < index_end) {
+        reportReadError(filename, "Invalid block index");
+        return false;
+    }
+
+    const size_t point_size = static_cast<size_t>(channels_) * 2;
+    const size_t value_size = bits_ == 8 ? sizeof(int8_t) : sizeof(int16_t);
+
+    const size_t total_size = expected_size;
+
+    const size_t start = std::min(static_cast<size_t>(start_index), total_size);
+    const size_t end   = std::min(static_cast<size_t>(end_index), total_size);
+
+    const size_t first_block = start / block_size;
+    const size_t last_block  = end > start ? (end + block_size - 1) / block_size : first_block;
+
+    const size_t offset = data_.size();
+
+    bool complete = true;
+
+    for (size_t block = first_block; block < last_block; ++block) {
+        const uint64_t block_start = getValue<uint64_t>(data + index_start + block * sizeof(uint64_t));
+        uint64_t block_end = getValue<uint64_t>(data + index_start + (block + 1) * sizeof(uint64_t));
+
+        if (block_start < index_end || block_end < block_start) {
+            reportReadError(filename, "Invalid block index");
+            return false;
+        }
+
+        // As for other files, a file that ends before the expected number
+        // of points is not an error
+        if (block_end > size) {
+            block_end = size;
+            complete = false;
+        }
+
+        if (block_start >= block_end) {
+            complete = false;
+            break;
+        }
+
+        const size_t block_values = std::min<size_t>(
+            block_size,
+            total_size - block * block_size
+        ) * point_size;
+
+        const unsigned char* block_data = data + block_start;
+        const size_t block_data_size = static_cast<size_t>(block_end - block_start);
+
+        const size_t block_offset = data_.size();
+
+        if (version == 3) {
+            // Each block is compressed separately, so can be decoded on its own
+            if (!WaveformCodec::decode(block_data, block_data_size, channels_, bits_, block_values, data_)) {
+                reportReadError(filename, "Invalid compressed data");
+                return false;
+            }
+        }
+        else {
+            const size_t values = std::min(block_data_size / value_size, block_values);
+
+            data_.resize(block_offset + values);
+
+            if (bits_ == 8) {
+                widen8BitValues(reinterpret_cast<const int8_t*>(block_data), values, &data_[block_offset]);
+            }
+            else if (values > 0) {
+                memcpy(&data_[block_offset], block_data, values * value_size);
+            }
+        }
+
+        if (data_.size() - block_offset < block_values) {
+            complete = false;
+            break;
+        }
+    }
+
+    const size_t first_value = (start - first_block * block_size) * point_size;
+
+    trim(offset, first_value, first_value + (end - start) * point_size);
+
+    // Discard any incomplete point at the end of the file
+    setSize(getSize());
+
+    logInfo(expected_size, complete);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformBuffer::loadFromStream(
+    const char* filename,
+    const int start_index,
+    const int end_index)
 {
     bool success = true;
 
     std::ifstream file;
-    std::istream* input;
+    std::istream* input = &file;
 
     uint32_t size = 0;
 
+    bool unknown_length = false;
+
+    const size_t offset = data_.size();
+
     try {
         if (FileUtil::isStdioFilename(filename)) {
             input = &std::cin;
@@ -172,12 +817,7 @@ bool WaveformBuffer::load(const char* filename)
 
         const int32_t version = readInt32(*input);
 
-        if (version != 1 && version != 2) {
-            reportReadError(
-                filename,
-                boost::str(boost::format("Cannot load data file version: %1%") % version).c_str()
-            );
-
+        if (!checkVersion(filename, version)) {
             return false;
         }
 
@@ -185,52 +825,93 @@ bool WaveformBuffer::load(const char* filename)
 
         sample_rate_ = readInt32(*input);
 
-        if (sample_rate_ < 1) {
-            reportReadError(
-                filename,
-                boost::str(
-                    boost::format("Invalid sample rate: %1% Hz, minimum 1 Hz") % sample_rate_
-                ).c_str()
-            );
-
+        if (!checkSampleRate(filename, sample_rate_)) {
             return false;
         }
 
         samples_per_pixel_ = readInt32(*input);
 
-        if (samples_per_pixel_ < 2) {
-            reportReadError(
-                filename,
-                boost::str(
-                    boost::format("Invalid samples per pixel: %1%, minimum 2") % samples_per_pixel_
-                ).c_str()
-            );
-
+        if (!checkSamplesPerPixel(filename, samples_per_pixel_)) {
             return false;
         }
 
         size = readUInt32(*input);
 
-        if (version == 2) {
+        unknown_length = size == UNKNOWN_LENGTH;
+
+        size_t header_size = 20;
+
+        if (version >= 2) {
             channels_ = readInt32(*input);
+            header_size += 4;
         }
         else {
             channels_ = 1;
         }
 
-        if (channels_ < 1 || channels_ > MAX_CHANNELS) {
-            reportReadError(
+        if (!checkChannels(filename, channels_)) {
+            return false;
+        }
+
+        if ((flags & FLAG_INDEXED) != 0) {
+            bits_ = (flags & FLAG_8_BIT) != 0 ? 8 : 16;
+
+            // The block offsets are from the start of the file, so the rest
+            // of the file is read after space for the header
+            std::vector<unsigned char> data(header_size);
+
+            data.insert(
+                data.end(),
+                std::istreambuf_iterator<char>(*input),
+                std::istreambuf_iterator<char>()
+            );
+
+            return loadIndexed(
                 filename,
-                boost::str(boost::format("Cannot load data file with %1% channels") % channels_).c_str()
+                data.data(),
+                data.size(),
+                header_size,
+                version,
+                size,
+                start_index,
+                end_index
             );
+        }
 
-            return false;
+        if (version == 3) {
+            bits_ = (flags & FLAG_8_BIT) != 0 ? 8 : 16;
+
+            // The compressed data is read all at once, then decoded
+            const std::vector<unsigned char> data(
+                (std::istreambuf_iterator<char>(*input)),
+                std::istreambuf_iterator<char>()
+            );
+
+            return loadCompressed(
+                filename,
+                data.data(),
+                data.size(),
+                size,
+                start_index,
+                end_index
+            );
         }
 
+        const uint32_t count = size * static_cast<uint32_t>(channels_);
+
+        // If the length is unknown, read points until the end of the file
+        uint32_t i = 0;
+
+        auto hasMorePoints = [&]() {
+            return unknown_length ?
+                input->peek() != std::char_traits<char>::eof() :
+                i < count;
+        };
+
         if ((flags & FLAG_8_BIT) != 0) {
             bits_ = 8;
 
-            for (uint32_t i = 0; i < size * channels_; ++i) {
+            for (; hasMorePoints(); ++i) {
                 int8_t min_value = readInt8(*input);
                 data_.push_back(static_cast<int16_t>(min_value * 256));
 
@@ -241,7 +922,7 @@ bool WaveformBuffer::load(const char* filename)
         else {
             bits_ = 16;
 
-            for (uint32_t i = 0; i < size * channels_; ++i) {
+            for (; hasMorePoints(); ++i) {
                 int16_t min_value = readInt16(*input);
                 data_.push_back(min_value);
 
@@ -267,26 +948,61 @@ bool WaveformBuffer::load(const char* filename)
         // See https://gcc.gnu.org/bugzilla/show_bug.cgi?id=66145
         // and http://stackoverflow.com/questions/38471518
 
-        if (!file.eof()) {
+        if (!input->eof()) {
             reportReadError(filename, strerror(errno));
             success = false;
         }
     }
 
-    const int actual_size = getSize();
+    if (unknown_length) {
+        // Discard any incomplete point at the end of the file
+        setSize(getSize());
+    }
+    else {
+        const int actual_size = getSize();
 
-    if (size != static_cast<uint32_t>(actual_size)) {
-        log(Info) << "Expected " << size << " points, read "
-                  << actual_size << " min and max points\n";
+        if (size != static_cast<uint32_t>(actual_size)) {
+            log(Info) << "Expected " << size << " points, read "
+                      << actual_size << " min and max points\n";
+        }
     }
 
+    // All points are read from the stream, then any outside the requested
+    // range are removed
+    const size_t point_size = static_cast<size_t>(channels_) * 2;
+
+    trim(
+        offset,
+        static_cast<size_t>(start_index) * point_size,
+        static_cast<size_t>(end_index) * point_size
+    );
+
     return success;
 }
 
 //------------------------------------------------------------------------------
 
+// JSON files are parsed from memory, so that the data array can be read
+// without pdjson, see readDataArray().
+
 bool WaveformBuffer::loadJson(const char* filename)
 {
+    StageTimer timer(JobStats::Decode);
+    TRACE_SCOPE("decode", "WaveformBuffer::loadJson");
+
+    if (!FileUtil::isStdioFilename(filename)) {
+        MappedFile file;
+
+        if (file.open(filename)) {
+            log(Info) << "Input file: " << filename << '\n';
+
+            return parseJson(
+                reinterpret_cast<const char*>(file.getData()),
+                file.getSize()
+            );
+        }
+    }
+
     FileHandle file;
 
     if (!file.open(filename)) {
@@ -296,8 +1012,24 @@ bool WaveformBuffer::loadJson(const char* filename)
     log(Info) << "Input file: "
               << FileUtil::getInputFilename(filename) << '\n';
 
+    std::vector<char> buffer;
+
+    if (!readFile(file.get(), buffer)) {
+        log(Error) << "Failed to read file: "
+                   << FileUtil::getInputFilename(filename) << '\n'
+                   << strerror(errno) << '\n';
+        return false;
+    }
+
+    return parseJson(buffer.data(), buffer.size());
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformBuffer::parseJson(const char* data, const size_t size)
+{
     json_stream json;
-    json_open_stream(&json, file.get());
+    json_open_buffer(&json, data, size);
 
     enum json_type type = json_next(&json);
     bool error = false;
@@ -474,8 +1206,15 @@ bool WaveformBuffer::loadJson(const char* filename)
         }
         else if (state == State::Data) {
             if (type == JSON_ARRAY) {
-                state = State::DataValues;
                 found_data = true;
+
+                const size_t expected_values = found_length ?
+                    static_cast<size_t>(length) * static_cast<size_t>(channels_) * 2 : 0;
+
+                // If this succeeds, only the closing ']' is left to read
+                readDataArray(&json, data, size, bits_, expected_values, data_);
+
+                state = State::DataValues;
             }
             else {
                 log(Error) << "Expected data to be an array\n";
@@ -496,7 +1235,7 @@ bool WaveformBuffer::loadJson(const char* filename)
                     }
                 }
                 else if (bits_ == 16) {
-                    if (value >= INT16_MIN || value <= INT16_MAX) {
+                    if (value >= INT16_MIN && value <= INT16_MAX) {
                         data_.push_back(static_cast<short>(value));
                     }
                     else {
@@ -619,26 +1358,52 @@ static bool openOutputStream(const char* filename, bool binary, Writer writer)
 
 //------------------------------------------------------------------------------
 
-bool WaveformBuffer::save(const char* filename, const int bits) const
+bool WaveformBuffer::save(
+    const char* filename,
+    const int bits,
+    const int version,
+    const int block_size) const
 {
+    StageTimer timer(JobStats::Write);
+    TRACE_SCOPE("write", "WaveformBuffer::save");
+
     if (bits != 8 && bits != 16) {
         log(Error) << "Invalid bits: must be either 8 or 16\n";
         return false;
     }
 
-    return openOutputStream(filename, true, [this, bits](std::ostream& output) {
+    if (version != 0 && version != 2 && version != 3) {
+        log(Error) << "Invalid format version: must be either 2 or 3\n";
+        return false;
+    }
+
+    if (block_size < 0) {
+        log(Error) << "Invalid block size: must be greater than zero\n";
+        return false;
+    }
+
+    return openOutputStream(filename, true, [this, bits, version, block_size](std::ostream& output) {
         log(Info) << "Resolution: " << bits << " bits\n"
                   << "Channels: " << channels_ << std::endl;
 
-        save(output, bits);
+        save(output, bits, version, block_size);
     });
 }
 
 //------------------------------------------------------------------------------
 
-void WaveformBuffer::save(std::ostream& stream, int bits) const
+void WaveformBuffer::save(
+    std::ostream& stream,
+    const int bits,
+    int version,
+    const int block_size) const
 {
-    const int32_t version = channels_ == 1 ? 1 : 2;
+    const bool indexed = block_size > 0;
+
+    if (version == 0) {
+        version = channels_ == 1 && !indexed ? 1 : 2;
+    }
+
     writeInt32(stream, version);
 
     uint32_t flags = 0;
@@ -647,6 +1412,10 @@ void WaveformBuffer::save(std::ostream& stream, int bits) const
         flags |= FLAG_8_BIT;
     }
 
+    if (indexed) {
+        flags |= FLAG_INDEXED;
+    }
+
     writeUInt32(stream, flags);
     writeInt32(stream, sample_rate_);
     writeInt32(stream, samples_per_pixel_);
@@ -655,11 +1424,23 @@ void WaveformBuffer::save(std::ostream& stream, int bits) const
 
     writeUInt32(stream, static_cast<uint32_t>(size));
 
-    if (version == 2) {
+    if (version >= 2) {
         writeInt32(stream, channels_);
     }
 
-    if ((flags & FLAG_8_BIT) != 0) {
+    if (indexed) {
+        saveIndexed(stream, bits, version, block_size);
+    }
+    else if (version == 3) {
+        WaveformCodec::Encoder encoder(channels_, bits);
+
+        std::vector<char> data;
+        encoder.encode(*this, data);
+        encoder.finish(data);
+
+        writeVector(stream, data);
+    }
+    else if ((flags & FLAG_8_BIT) != 0) {
         for (int i = 0; i < size; ++i) {
             for (int channel = 0; channel < channels_; ++channel) {
                 int8_t min_value = static_cast<int8_t>(getMinSample(channel, i) / 256);
@@ -677,116 +1458,167 @@ void WaveformBuffer::save(std::ostream& stream, int bits) const
 
 //------------------------------------------------------------------------------
 
-bool WaveformBuffer::saveAsText(const char* filename, int bits) const
+// Writes the block index and data of an indexed file, after the header.
+
+void WaveformBuffer::saveIndexed(
+    std::ostream& stream,
+    const int bits,
+    const int version,
+    const int block_size) const
 {
-    if (bits != 8 && bits != 16) {
-        log(Error) << "Invalid bits: must be either 8 or 16\n";
-        return false;
-    }
+    const int size = getSize();
 
-    return openOutputStream(filename, false, [this, bits](std::ostream& output) {
-        saveAsText(output, bits);
-    });
-}
+    const int block_count = static_cast<int>(
+        (static_cast<long long>(size) + block_size - 1) / block_size
+    );
 
-//------------------------------------------------------------------------------
+    writeUInt32(stream, static_cast<uint32_t>(block_size));
+    writeUInt32(stream, static_cast<uint32_t>(block_count));
 
-void WaveformBuffer::saveAsText(std::ostream& stream, int bits) const
-{
-    const int size = getSize();
+    const uint64_t data_offset = MAX_HEADER_SIZE + INDEX_HEADER_SIZE +
+        (static_cast<uint64_t>(block_count) + 1) * sizeof(uint64_t);
 
-    if (bits == 8) {
-        for (int i = 0; i < size; ++i) {
-            for (int channel = 0; channel < channels_; ++channel) {
-                const int min_value = getMinSample(channel, i) / 256;
-                const int max_value = getMaxSample(channel, i) / 256;
+    std::vector<uint64_t> offsets;
+    offsets.reserve(static_cast<size_t>(block_count) + 1);
 
-                if (channel > 0) {
-                    stream << ',';
-                }
+    offsets.push_back(data_offset);
 
-                stream << min_value << ',' << max_value;
-            }
+    if (version == 3) {
+        // Each block is compressed separately, so that it can be decoded
+        // without the blocks before it
+        std::vector<char> data;
 
-            stream << '\n';
+        for (int block = 0; block < block_count; ++block) {
+            const int start = block * block_size;
+            const int end   = start + std::min(block_size, size - start);
+
+            WaveformCodec::Encoder encoder(channels_, bits);
+
+            encoder.encode(*this, start, end, data);
+            encoder.finish(data);
+
+            offsets.push_back(data_offset + data.size());
         }
+
+        writeVector(stream, offsets);
+        writeVector(stream, data);
     }
     else {
-        for (int i = 0; i < size; ++i) {
-            for (int channel = 0; channel < channels_; ++channel) {
-                if (channel > 0) {
-                    stream << ',';
-                }
+        const uint64_t value_size = bits == 8 ? sizeof(int8_t) : sizeof(int16_t);
+        const uint64_t point_size = static_cast<uint64_t>(channels_) * 2 * value_size;
 
-                stream << getMinSample(channel, i) << ','
-                       << getMaxSample(channel, i);
-            }
+        for (int block = 0; block < block_count; ++block) {
+            const int start = block * block_size;
+            const int end   = start + std::min(block_size, size - start);
 
-            stream << '\n';
+            offsets.push_back(data_offset + static_cast<uint64_t>(end) * point_size);
+        }
+
+        writeVector(stream, offsets);
+
+        if (bits == 8) {
+            for (const short value : data_) {
+                writeInt8(stream, static_cast<int8_t>(value / 256));
+            }
+        }
+        else {
+            writeVector(stream, data_);
         }
     }
 }
 
 //------------------------------------------------------------------------------
 
-bool WaveformBuffer::saveAsJson(const char* filename, const int bits) const
+bool WaveformBuffer::saveAsText(const char* filename, int bits) const
 {
+    StageTimer timer(JobStats::Write);
+    TRACE_SCOPE("write", "WaveformBuffer::saveAsText");
+
     if (bits != 8 && bits != 16) {
         log(Error) << "Invalid bits: must be either 8 or 16\n";
         return false;
     }
 
     return openOutputStream(filename, false, [this, bits](std::ostream& output) {
-        saveAsJson(output, bits);
+        saveAsText(output, bits);
     });
 }
 
 //------------------------------------------------------------------------------
 
-static void writeAsJsonArray(
-    std::ostream& stream,
-    const std::vector<short>& data,
-    int divisor)
+void WaveformBuffer::saveAsText(std::ostream& stream, int bits) const
 {
-    auto i = data.begin();
+    const int size = getSize();
+    const int divisor = bits == 8 ? 256 : 1;
+
+    TextWriter writer(stream);
 
-    stream << '[';
+    for (int i = 0; i < size; ++i) {
+        for (int channel = 0; channel < channels_; ++channel) {
+            if (channel > 0) {
+                writer.write(',');
+            }
+
+            writer.writeInt(getMinSample(channel, i) / divisor);
+            writer.write(',');
+            writer.writeInt(getMaxSample(channel, i) / divisor);
+        }
 
-    if (i != data.end()) {
-        stream << (*i / divisor);
-        ++i;
+        writer.write('\n');
     }
 
-    for (; i != data.end(); ++i) {
-        stream << ',' << (*i / divisor);
+    writer.flush();
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformBuffer::saveAsJson(const char* filename, const int bits) const
+{
+    StageTimer timer(JobStats::Write);
+    TRACE_SCOPE("write", "WaveformBuffer::saveAsJson");
+
+    if (bits != 8 && bits != 16) {
+        log(Error) << "Invalid bits: must be either 8 or 16\n";
+        return false;
     }
 
-    stream << ']';
+    return openOutputStream(filename, false, [this, bits](std::ostream& output) {
+        saveAsJson(output, bits);
+    });
 }
 
 //------------------------------------------------------------------------------
 
 void WaveformBuffer::saveAsJson(std::ostream& stream, int bits) const
 {
-    const int size = getSize();
-    const int version = 2;
-
-    stream << "{\"version\":" << version
-           << ",\"channels\":" << channels_
-           << ",\"sample_rate\":" << sample_rate_
-           << ",\"samples_per_pixel\":" << samples_per_pixel_
-           << ",\"bits\":" << bits
-           << ",\"length\":" << size
-           << ",\"data\":";
+    const int divisor = bits == 8 ? 256 : 1;
+
+    TextWriter writer(stream);
+
+    writer.write("{\"version\":");
+    writer.writeInt(2);
+    writer.write(",\"channels\":");
+    writer.writeInt(channels_);
+    writer.write(",\"sample_rate\":");
+    writer.writeInt(sample_rate_);
+    writer.write(",\"samples_per_pixel\":");
+    writer.writeInt(samples_per_pixel_);
+    writer.write(",\"bits\":");
+    writer.writeInt(bits);
+    writer.write(",\"length\":");
+    writer.writeInt(getSize());
+    writer.write(",\"data\":[");
+
+    for (auto i = data_.begin(); i != data_.end(); ++i) {
+        if (i != data_.begin()) {
+            writer.write(',');
+        }
 
-    if (bits == 8) {
-        writeAsJsonArray(stream, data_, 256);
-    }
-    else {
-        writeAsJsonArray(stream, data_, 1);
+        writer.writeInt(*i / divisor);
     }
 
-    stream << "}\n";
+    writer.write("]}\n");
+    writer.flush();
 }
 
 //------------------------------------------------------------------------------
@@ -26,6 +26,8 @@
 
 //------------------------------------------------------------------------------
 
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
 #include <vector>
 
@@ -42,6 +44,11 @@ class WaveformBuffer
     public:
         static const int MAX_CHANNELS = 24;
 
+        // Length field value in .dat files written to an output that can't
+        // be seeked, where the length isn't known until all points have been
+        // written. The data continues to the end of the file.
+        static const uint32_t UNKNOWN_LENGTH = 0xffffffffU;
+
     public:
         void setSampleRate(int sample_rate)
         {
@@ -60,6 +67,15 @@ class WaveformBuffer
 
         int getChannels() const { return channels_; }
 
+        // Returns the index of the first point in the buffer, if only part
+        // of a file has been loaded
+        int getStartIndex() const { return start_index_; }
+
+        void setStartIndex(int start_index)
+        {
+            start_index_ = start_index;
+        }
+
         void setChannels(int channels)
         {
             channels_ = channels;
@@ -93,6 +109,15 @@ class WaveformBuffer
             return data_[offset];
         }
 
+        // Returns the minimum and maximum values of each channel at the
+        // given index, followed by those of the points after it
+        const short* getSamples(int index) const
+        {
+            const size_type offset = static_cast<size_type>(index * channels_ * 2);
+
+            return data_.data() + offset;
+        }
+
         void appendSamples(short min, short max)
         {
             data_.push_back(min);
@@ -110,13 +135,69 @@ class WaveformBuffer
         }
 
         bool load(const char* filename);
+
+        // Loads the points from start_index up to end_index. For an indexed
+        // .dat file, only the blocks that contain these points are read.
+        bool load(const char* filename, int start_index, int end_index);
+
         bool loadJson(const char* filename);
-        bool save(const char* filename, int bits = 16) const;
+
+        // The version is 2 or 3, or 0 to write version 1 for single channel
+        // data and version 2 otherwise. If block_size is greater than zero,
+        // writes an indexed file with this many points in each block.
+        // See doc/DataFormat.md
+        bool save(
+            const char* filename,
+            int bits = 16,
+            int version = 0,
+            int block_size = 0
+        ) const;
         bool saveAsText(const char* filename, int bits = 16) const;
         bool saveAsJson(const char* filename, int bits = 16) const;
 
     private:
-        void save(std::ostream& stream, int bits) const;
+        bool loadFromStream(
+            const char* filename,
+            int start_index,
+            int end_index
+        );
+
+        bool loadCompressed(
+            const char* filename,
+            const unsigned char* data,
+            size_t size,
+            uint32_t expected_size,
+            int start_index,
+            int end_index
+        );
+
+        bool loadIndexed(
+            const char* filename,
+            const unsigned char* data,
+            size_t size,
+            size_t header_size,
+            int version,
+            uint32_t expected_size,
+            int start_index,
+            int end_index
+        );
+
+        bool parseJson(const char* data, size_t size);
+
+        bool loadFromMemory(
+            const char* filename,
+            const unsigned char* data,
+            size_t size,
+            int start_index,
+            int end_index
+        );
+
+        void trim(size_t offset, size_t first_value, size_t last_value);
+
+        void logInfo(uint32_t expected_size, bool complete) const;
+
+        void save(std::ostream& stream, int bits, int version, int block_size) const;
+        void saveIndexed(std::ostream& stream, int bits, int version, int block_size) const;
         void saveAsText(std::ostream& stream, int bits) const;
         void saveAsJson(std::ostream& stream, int bits) const;
 
@@ -125,6 +206,7 @@ class WaveformBuffer
         int samples_per_pixel_;
         int bits_;
         int channels_;
+        int start_index_;
 
         typedef std::vector<short> vector_type;
         typedef vector_type::size_type size_type;
@@ -0,0 +1,359 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "WaveformCodec.h"
+#include "WaveformBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+//------------------------------------------------------------------------------
+
+namespace WaveformCodec {
+
+//------------------------------------------------------------------------------
+
+// A residual whose Rice code would need this many or more unary bits is
+// written as this many zero bits, then the residual in full.
+const int ESCAPE_LENGTH = 16;
+
+//------------------------------------------------------------------------------
+
+// Maps signed residuals to unsigned values: 0, -1, 1, -2, 2, ... become
+// 0, 1, 2, 3, 4, ..., so that small residuals of either sign have short codes.
+
+static unsigned int zigzag(const int value)
+{
+    return value >= 0 ?
+        static_cast<unsigned int>(value) << 1 :
+        (static_cast<unsigned int>(-(value + 1)) << 1) | 1;
+}
+
+//------------------------------------------------------------------------------
+
+static int unzigzag(const unsigned int value)
+{
+    return (value & 1) != 0 ?
+        -static_cast<int>(value >> 1) - 1 :
+        static_cast<int>(value >> 1);
+}
+
+//------------------------------------------------------------------------------
+
+static uint64_t getMask(const int bits)
+{
+    return (static_cast<uint64_t>(1) << bits) - 1;
+}
+
+//------------------------------------------------------------------------------
+
+static int countTrailingZeros(const uint64_t value)
+{
+    assert(value != 0);
+
+#if defined(__GNUC__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+
+    for (uint64_t v = value; (v & 1) == 0; v >>= 1) {
+        ++count;
+    }
+
+    return count;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the number of bits needed to code the given residuals with Rice
+// parameter k.
+
+static uint64_t getBlockSize(
+    const std::vector<unsigned int>& block,
+    const int k,
+    const int raw_bits)
+{
+    uint64_t size = 0;
+
+    for (const unsigned int value : block) {
+        const unsigned int quotient = value >> k;
+
+        size += quotient < ESCAPE_LENGTH ?
+            quotient + 1 + static_cast<unsigned int>(k) :
+            static_cast<unsigned int>(ESCAPE_LENGTH + raw_bits);
+    }
+
+    return size;
+}
+
+//------------------------------------------------------------------------------
+
+Encoder::Encoder(const int channels, const int bits) :
+    bits_(bits),
+    previous_(static_cast<size_t>(channels) * 2, 0),
+    stream_(0)
+{
+    block_.reserve(BLOCK_SIZE);
+}
+
+//------------------------------------------------------------------------------
+
+void Encoder::encode(const WaveformBuffer& buffer, std::vector<char>& output)
+{
+    encode(buffer, 0, buffer.getSize(), output);
+}
+
+//------------------------------------------------------------------------------
+
+void Encoder::encode(
+    const WaveformBuffer& buffer,
+    const int start_index,
+    const int end_index,
+    std::vector<char>& output)
+{
+    const int channels = buffer.getChannels();
+    const int divisor  = bits_ == 8 ? 256 : 1;
+
+    for (int i = start_index; i < end_index; ++i) {
+        for (int channel = 0; channel < channels; ++channel) {
+            encodeValue(buffer.getMinSample(channel, i) / divisor, output);
+            encodeValue(buffer.getMaxSample(channel, i) / divisor, output);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void Encoder::encodeValue(const int value, std::vector<char>& output)
+{
+    block_.push_back(zigzag(value - previous_[stream_]));
+    previous_[stream_] = value;
+
+    if (++stream_ == previous_.size()) {
+        stream_ = 0;
+    }
+
+    if (block_.size() == BLOCK_SIZE) {
+        encodeBlock(output);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void Encoder::finish(std::vector<char>& output)
+{
+    if (!block_.empty()) {
+        encodeBlock(output);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Writes the Rice parameter as one byte, followed by the code for each
+// residual. Bits are written starting from the least significant bit of each
+// byte, and the block is padded with zero bits to a whole number of bytes.
+
+void Encoder::encodeBlock(std::vector<char>& output)
+{
+    const int raw_bits = bits_ + 1;
+
+    // The best parameter is close to log2 of the mean residual, so start
+    // from there and choose the parameter that gives the fewest bits
+    uint64_t sum = 0;
+
+    for (const unsigned int value : block_) {
+        sum += value;
+    }
+
+    int estimate = 0;
+
+    while (estimate < raw_bits &&
+           (static_cast<uint64_t>(block_.size()) << estimate) < sum) {
+        ++estimate;
+    }
+
+    int k = estimate;
+    uint64_t best_size = getBlockSize(block_, k, raw_bits);
+
+    for (int i = std::max(estimate - 2, 0); i <= std::min(estimate + 1, raw_bits); ++i) {
+        const uint64_t size = getBlockSize(block_, i, raw_bits);
+
+        if (size < best_size) {
+            best_size = size;
+            k = i;
+        }
+    }
+
+    output.push_back(static_cast<char>(k));
+
+    uint64_t accumulator = 0;
+    int length = 0;
+
+    auto write = [&output, &accumulator, &length](uint64_t bits, int count) {
+        accumulator |= bits << length;
+        length += count;
+
+        while (length >= 8) {
+            output.push_back(static_cast<char>(accumulator & 0xff));
+            accumulator >>= 8;
+            length -= 8;
+        }
+    };
+
+    for (const unsigned int value : block_) {
+        const unsigned int quotient = value >> k;
+
+        if (quotient < ESCAPE_LENGTH) {
+            // quotient zero bits, a one bit, then the low k bits of the value
+            write(
+                ((value & getMask(k)) << (quotient + 1)) | (1U << quotient),
+                static_cast<int>(quotient) + 1 + k
+            );
+        }
+        else {
+            write(0, ESCAPE_LENGTH);
+            write(value, raw_bits);
+        }
+    }
+
+    if (length > 0) {
+        output.push_back(static_cast<char>(accumulator & 0xff));
+    }
+
+    block_.clear();
+}
+
+//------------------------------------------------------------------------------
+
+// Returns at least the next 56 bits from the given bit position, with zeros
+// after the end of the data. As with the rest of the .dat format, this
+// assumes a little-endian CPU.
+
+static uint64_t readBits(
+    const unsigned char* data,
+    const size_t size,
+    const uint64_t position)
+{
+    const size_t offset = static_cast<size_t>(position / 8);
+
+    uint64_t bits = 0;
+
+    memcpy(&bits, data + offset, std::min<size_t>(sizeof(bits), size - offset));
+
+    return bits >> (position % 8);
+}
+
+//------------------------------------------------------------------------------
+
+bool decode(
+    const unsigned char* data,
+    const size_t size,
+    const int channels,
+    const int bits,
+    const size_t max_values,
+    std::vector<short>& output)
+{
+    const int raw_bits  = bits + 1;
+    const int min_value = bits == 8 ? INT8_MIN : INT16_MIN;
+    const int max_value = bits == 8 ? INT8_MAX : INT16_MAX;
+    const int scale     = bits == 8 ? 256 : 1;
+
+    std::vector<int> previous(static_cast<size_t>(channels) * 2, 0);
+    size_t stream = 0;
+
+    // Each value takes at least one bit
+    output.reserve(output.size() + std::min(max_values, size * 8));
+
+    const uint64_t total_bits = static_cast<uint64_t>(size) * 8;
+
+    size_t offset = 0;
+    size_t count = 0;
+
+    while (count < max_values && offset < size) {
+        const int k = data[offset];
+
+        if (k > raw_bits) {
+            return false;
+        }
+
+        uint64_t position = static_cast<uint64_t>(offset + 1) * 8;
+
+        const size_t block_size = std::min<size_t>(BLOCK_SIZE, max_values - count);
+
+        for (size_t i = 0; i < block_size; ++i) {
+            if (position >= total_bits) {
+                return true;
+            }
+
+            const uint64_t window = readBits(data, size, position);
+
+            unsigned int value;
+
+            if ((window & getMask(ESCAPE_LENGTH)) == 0) {
+                value = static_cast<unsigned int>((window >> ESCAPE_LENGTH) & getMask(raw_bits));
+                position += ESCAPE_LENGTH + raw_bits;
+            }
+            else {
+                const int quotient = countTrailingZeros(window);
+
+                value = static_cast<unsigned int>(
+                    (static_cast<uint64_t>(quotient) << k) |
+                    ((window >> (quotient + 1)) & getMask(k))
+                );
+
+                position += static_cast<uint64_t>(quotient + 1 + k);
+            }
+
+            // The last code is incomplete, so the file has been truncated
+            if (position > total_bits) {
+                return true;
+            }
+
+            const int sample = previous[stream] + unzigzag(value);
+
+            if (sample < min_value || sample > max_value) {
+                return false;
+            }
+
+            previous[stream] = sample;
+
+            if (++stream == previous.size()) {
+                stream = 0;
+            }
+
+            output.push_back(static_cast<short>(sample * scale));
+            ++count;
+        }
+
+        offset = static_cast<size_t>((position + 7) / 8);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace WaveformCodec
+
+//------------------------------------------------------------------------------
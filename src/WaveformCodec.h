@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_WAVEFORM_CODEC_H)
+#define INC_WAVEFORM_CODEC_H
+
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+class WaveformBuffer;
+
+//------------------------------------------------------------------------------
+
+// Lossless compression for the waveform data in version 3 .dat files. See
+// doc/DataFormat.md for a description of the format.
+//
+// Each value is predicted from the previous value of the same channel and
+// the same kind (minimum or maximum), and the difference is stored with a
+// Rice code. The values are coded in blocks, each with its own Rice
+// parameter, so that the code adapts to the amplitude of the audio.
+//
+// Values are given and returned as 16-bit values, as stored in
+// WaveformBuffer. 8-bit data is divided by 256 before encoding, and
+// multiplied by 256 after decoding.
+
+namespace WaveformCodec {
+    // Number of values in each block, except the last
+    const int BLOCK_SIZE = 256;
+
+    class Encoder
+    {
+        public:
+            Encoder(int channels, int bits);
+
+        public:
+            // Encodes all points in the buffer, and appends each completed
+            // block to the output. May be called more than once, e.g., to
+            // encode a buffer each time points are added to it.
+            void encode(const WaveformBuffer& buffer, std::vector<char>& output);
+
+            // Encodes the points from start_index up to end_index.
+            void encode(
+                const WaveformBuffer& buffer,
+                int start_index,
+                int end_index,
+                std::vector<char>& output
+            );
+
+            // Appends any remaining values as a final, shorter block.
+            void finish(std::vector<char>& output);
+
+        private:
+            void encodeValue(int value, std::vector<char>& output);
+            void encodeBlock(std::vector<char>& output);
+
+        private:
+            int bits_;
+
+            // Previous value of each channel's minimum and maximum
+            std::vector<int> previous_;
+
+            size_t stream_;
+
+            // Residuals of the current block, zigzag encoded
+            std::vector<unsigned int> block_;
+    };
+
+    // Decodes up to max_values values from the given data, and appends them
+    // to output. Decoding stops at the end of the data, so a truncated file
+    // gives as many values as are complete. Returns false if the data is
+    // invalid.
+    bool decode(
+        const unsigned char* data,
+        size_t size,
+        int channels,
+        int bits,
+        size_t max_values,
+        std::vector<short>& output
+    );
+}
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_WAVEFORM_CODEC_H)
+
+//------------------------------------------------------------------------------
@@ -28,6 +28,7 @@
 
 #include <boost/format.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
@@ -125,7 +126,12 @@ WaveformGenerator::WaveformGenerator(
     channels_(0),
     output_channels_(0),
     samples_per_pixel_(0),
-    count_(0)
+    kernel_(nullptr),
+    float_kernel_(nullptr),
+    count_(0),
+    size_(0),
+    max_size_(0),
+    frame_count_(0)
 {
 }
 
@@ -147,13 +153,25 @@ bool WaveformGenerator::init(
 
     samples_per_pixel_ = scale_factor_.getSamplesPerPixel(sample_rate);
 
-    if (samples_per_pixel_ < 2) {
+    // If the size is limited, the waveform data is rescaled before use, so
+    // may start at one sample per pixel
+    const int min_samples_per_pixel = max_size_ > 0 ? 1 : 2;
+
+    if (samples_per_pixel_ < min_samples_per_pixel) {
         log(Error) << "Invalid zoom: minimum 2\n";
         return false;
     }
 
     output_channels_ = split_channels_ ? channels : 1;
 
+    kernel_ = MinMaxKernels::selectKernel(
+        MinMaxKernels::getKernelSet(),
+        channels_,
+        split_channels_
+    );
+
+    float_kernel_ = MinMaxKernels::selectFloatKernel(split_channels_);
+
     buffer_.setSamplesPerPixel(samples_per_pixel_);
     buffer_.setSampleRate(sample_rate);
     buffer_.setChannels(output_channels_);
@@ -165,8 +183,13 @@ bool WaveformGenerator::init(
 
     min_.resize(output_channels_, MAX_SAMPLE);
     max_.resize(output_channels_, MIN_SAMPLE);
+    float_min_.resize(output_channels_);
+    float_max_.resize(output_channels_);
     reset();
 
+    size_ = 0;
+    frame_count_ = 0;
+
     return true;
 }
 
@@ -186,11 +209,28 @@ int WaveformGenerator::getSamplesPerPixel() const
 
 //------------------------------------------------------------------------------
 
+void WaveformGenerator::setMaxSize(const int max_size)
+{
+    max_size_ = max_size;
+}
+
+//------------------------------------------------------------------------------
+
+long long WaveformGenerator::getFrameCount() const
+{
+    return frame_count_;
+}
+
+//------------------------------------------------------------------------------
+
 void WaveformGenerator::reset()
 {
     for (int channel = 0; channel < output_channels_; ++channel) {
         min_[channel] = MAX_SAMPLE;
         max_[channel] = MIN_SAMPLE;
+
+        float_min_[channel] = std::numeric_limits<float>::max();
+        float_max_[channel] = std::numeric_limits<float>::lowest();
     }
 
     count_ = 0;
@@ -198,90 +238,161 @@ void WaveformGenerator::reset()
 
 //------------------------------------------------------------------------------
 
-void WaveformGenerator::done()
+// Uses the same scaling as SndFileAudioFileReader when it converts floating
+// point samples to 16-bit, but clips values outside the range -1.0 to 1.0.
+
+static int floatToSample(float value)
 {
-    if (count_ > 0) {
+    if (value > 1.0f) {
+        value = 1.0f;
+    }
+    else if (value < -1.0f) {
+        value = -1.0f;
+    }
+
+    return static_cast<int>(value * MAX_SAMPLE);
+}
+
+//------------------------------------------------------------------------------
+
+void WaveformGenerator::appendSamples()
+{
+    for (int channel = 0; channel < output_channels_; ++channel) {
+        int min = min_[channel];
+        int max = max_[channel];
+
+        if (float_min_[channel] <= float_max_[channel]) {
+            min = std::min(min, floatToSample(float_min_[channel]));
+            max = std::max(max, floatToSample(float_max_[channel]));
+        }
+
+        buffer_.appendSamples(
+            static_cast<short>(min),
+            static_cast<short>(max)
+        );
+    }
+
+    ++size_;
+
+    reset();
+
+    if (max_size_ > 0 && buffer_.getSize() >= max_size_) {
+        combinePoints();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Combines each pair of points in the buffer into one, in place, and doubles
+// the samples per pixel. This is only called at an output point boundary, so
+// the next point starts where the last combined point ends.
+
+void WaveformGenerator::combinePoints()
+{
+    const int size = buffer_.getSize();
+    const int new_size = (size + 1) / 2;
+
+    for (int i = 0; i < new_size; ++i) {
+        const int first = i * 2;
+        const int second = std::min(first + 1, size - 1);
+
         for (int channel = 0; channel < output_channels_; ++channel) {
-            buffer_.appendSamples(
-                static_cast<short>(min_[channel]),
-                static_cast<short>(max_[channel])
+            buffer_.setSamples(
+                channel,
+                i,
+                std::min(buffer_.getMinSample(channel, first), buffer_.getMinSample(channel, second)),
+                std::max(buffer_.getMaxSample(channel, first), buffer_.getMaxSample(channel, second))
             );
         }
+    }
+
+    buffer_.setSize(new_size);
+
+    size_ -= size - new_size;
+
+    samples_per_pixel_ *= 2;
+    buffer_.setSamplesPerPixel(samples_per_pixel_);
+}
+
+//------------------------------------------------------------------------------
 
-        reset();
+void WaveformGenerator::done()
+{
+    if (count_ > 0) {
+        appendSamples();
     }
 
-    log(Info) << "Generated " << buffer_.getSize() << " points\n";
+    log(Info) << "Generated " << size_ << " points\n";
 }
 
 //------------------------------------------------------------------------------
 
-// See BlockFile::CalcSummary in Audacity
+// The input is processed in runs of frames that each end either at the end of
+// the input buffer or at an output point boundary, and the min and max values
+// of each run are computed using a vectorised kernel where available.
+// See MinMaxKernels.h.
 
 bool WaveformGenerator::process(
     const short* input_buffer,
     const int input_frame_count)
 {
-    for (int i = 0; i < input_frame_count; ++i) {
-        const int index = i * channels_;
-
-        if (output_channels_ == 1) {
-            // Sum samples from each input channel to make a single (mono) waveform
-            int sample = 0;
-
-            for (int channel = 0; channel < channels_; ++channel) {
-                sample += input_buffer[index + channel];
-            }
-
-            sample /= channels_;
-
-            // Avoid numeric overflow when converting to short
-            if (sample > MAX_SAMPLE) {
-                sample = MAX_SAMPLE;
-            }
-            else if (sample < MIN_SAMPLE) {
-                sample = MIN_SAMPLE;
-            }
-
-            if (sample < min_[0]) {
-                min_[0] = sample;
-            }
-
-            if (sample > max_[0]) {
-                max_[0] = sample;
-            }
+    frame_count_ += input_frame_count;
+
+    int frames_remaining = input_frame_count;
+
+    while (frames_remaining > 0) {
+        int frames = samples_per_pixel_ - count_;
+
+        if (frames > frames_remaining) {
+            frames = frames_remaining;
+        }
+
+        kernel_(input_buffer, frames, channels_, &min_[0], &max_[0]);
+
+        input_buffer += frames * channels_;
+        frames_remaining -= frames;
+        count_ += frames;
+
+        if (count_ == samples_per_pixel_) {
+            appendSamples();
         }
-        else {
-            for (int channel = 0; channel < channels_; ++channel) {
-                int sample = input_buffer[index + channel];
-
-                // Avoid numeric overflow when converting to short
-                if (sample > MAX_SAMPLE) {
-                    sample = MAX_SAMPLE;
-                }
-                else if (sample < MIN_SAMPLE) {
-                    sample = MIN_SAMPLE;
-                }
-
-                if (sample < min_[channel]) {
-                    min_[channel] = sample;
-                }
-
-                if (sample > max_[channel]) {
-                    max_[channel] = sample;
-                }
-            }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformGenerator::supportsFloat() const
+{
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformGenerator::processFloat(
+    const float* input_buffer,
+    const int input_frame_count)
+{
+    frame_count_ += input_frame_count;
+
+    int frames_remaining = input_frame_count;
+
+    while (frames_remaining > 0) {
+        int frames = samples_per_pixel_ - count_;
+
+        if (frames > frames_remaining) {
+            frames = frames_remaining;
         }
 
-        if (++count_ == samples_per_pixel_) {
-            for (int channel = 0; channel < output_channels_; ++channel) {
-                buffer_.appendSamples(
-                    static_cast<short>(min_[channel]),
-                    static_cast<short>(max_[channel])
-                );
-            }
+        float_kernel_(input_buffer, frames, channels_, &float_min_[0], &float_max_[0]);
+
+        input_buffer += frames * channels_;
+        frames_remaining -= frames;
+        count_ += frames;
 
-            reset();
+        if (count_ == samples_per_pixel_) {
+            appendSamples();
         }
     }
 
@@ -27,6 +27,7 @@
 //------------------------------------------------------------------------------
 
 #include "AudioProcessor.h"
+#include "MinMaxKernels.h"
 
 #include <vector>
 
@@ -119,15 +120,34 @@ class WaveformGenerator : public AudioProcessor
 
         int getSamplesPerPixel() const;
 
+        // Limits the number of points in the buffer, for when the length of
+        // the audio isn't known in advance. When the buffer reaches this
+        // size, which must be even, each pair of points is combined into
+        // one and the samples per pixel is doubled. The samples per pixel
+        // may then start at 1. Call this before init().
+        void setMaxSize(int max_size);
+
+        // Returns the number of audio frames processed.
+        long long getFrameCount() const;
+
         virtual bool process(
             const short* input_buffer,
             int input_frame_count
         );
 
+        virtual bool supportsFloat() const;
+
+        virtual bool processFloat(
+            const float* input_buffer,
+            int input_frame_count
+        );
+
         virtual void done();
 
     private:
         void reset();
+        void appendSamples();
+        void combinePoints();
 
     private:
         WaveformBuffer& buffer_;
@@ -138,9 +158,26 @@ class WaveformGenerator : public AudioProcessor
         int output_channels_;
         int samples_per_pixel_;
 
+        MinMaxKernels::Kernel kernel_;
+        MinMaxKernels::FloatKernel float_kernel_;
+
         int count_;
+
+        // Total number of output points. This may be more than the buffer
+        // size if points are removed from the buffer as they are generated,
+        // see WaveformWriter.
+        int size_;
+
+        int max_size_;
+        long long frame_count_;
+
         std::vector<int> min_;
         std::vector<int> max_;
+
+        // From floating point input, converted to 16-bit when each output
+        // point is complete
+        std::vector<float> float_min_;
+        std::vector<float> float_max_;
 };
 
 //------------------------------------------------------------------------------
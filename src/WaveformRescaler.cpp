@@ -22,122 +22,154 @@
 //------------------------------------------------------------------------------
 
 #include "WaveformRescaler.h"
+#include "JobStats.h"
 #include "Log.h"
+#include "Trace.h"
 #include "WaveformBuffer.h"
 
+#include <algorithm>
 #include <cassert>
-#include <iomanip>
 #include <iostream>
 #include <limits>
+#include <thread>
 
 //------------------------------------------------------------------------------
 
-WaveformRescaler::WaveformRescaler() :
-    sample_rate_(0),
-    channels_(1),
-    output_samples_per_pixel_(0)
+// Fewer output points than this aren't worth dividing between threads.
+const int MIN_POINTS_PER_THREAD = 65536;
+
+// Input points combined without the min/max kernel when there are fewer than
+// this in an output point.
+const int MIN_KERNEL_POINTS = 16;
+
+//------------------------------------------------------------------------------
+
+WaveformRescaler::WaveformRescaler(const int threads) :
+    threads_(threads < 1 ? 1 : threads),
+    kernel_(nullptr)
 {
 }
 
 //------------------------------------------------------------------------------
 
 // See Sequence::GetWaveDisplay in Audacity
+//
+// Output point x uses the input points from (x * output samples per pixel) /
+// input samples per pixel, up to the first input point of output point x + 1.
+//
+// If the input buffer starts part way through a file, the output buffer
+// starts at the first output point that only uses points in the input buffer,
+// so its points are the same as from rescaling the whole file.
 
 void WaveformRescaler::rescale(
     const WaveformBuffer& input_buffer,
     WaveformBuffer& output_buffer,
     int samples_per_pixel)
 {
+    StageTimer timer(JobStats::Rescale);
+    TRACE_SCOPE("rescale", "WaveformRescaler::rescale");
+
     log(Info) << "Rescaling to " << samples_per_pixel << " samples/pixel\n";
 
-    sample_rate_ = input_buffer.getSampleRate();
-    channels_ = input_buffer.getChannels();
-    output_samples_per_pixel_ = samples_per_pixel;
+    const int sample_rate = input_buffer.getSampleRate();
+    const int channels = input_buffer.getChannels();
     const int input_samples_per_pixel = input_buffer.getSamplesPerPixel();
+    const int input_start_index = input_buffer.getStartIndex();
 
-    assert(sample_rate_ > 0);
-    assert(output_samples_per_pixel_ > 0);
+    assert(sample_rate > 0);
+    assert(samples_per_pixel > 0);
     assert(input_samples_per_pixel > 0);
-    assert(output_samples_per_pixel_ > input_samples_per_pixel);
+    assert(samples_per_pixel > input_samples_per_pixel);
 
     const int input_buffer_size = input_buffer.getSize();
 
-    output_buffer.setSampleRate(sample_rate_);
-    output_buffer.setChannels(channels_);
+    output_buffer.setSampleRate(sample_rate);
+    output_buffer.setChannels(channels);
     output_buffer.setSamplesPerPixel(samples_per_pixel);
 
+    const int output_start_index = static_cast<int>(
+        (static_cast<long long>(input_start_index) * input_samples_per_pixel +
+         samples_per_pixel - 1) / samples_per_pixel
+    );
+
+    output_buffer.setStartIndex(output_start_index);
+
     log(Info) << "Input scale: " << input_samples_per_pixel << " samples/pixel"
               << "\nOutput scale: " << samples_per_pixel << " samples/pixel"
               << "\nInput buffer size: " << input_buffer_size << '\n';
 
-    std::vector<short> min(channels_);
-    std::vector<short> max(channels_);
+    // Find the first input point of each output point, stepping the
+    // quotient and remainder instead of dividing for each point
+    const long long start_sample =
+        static_cast<long long>(output_start_index) * samples_per_pixel;
 
-    if (input_buffer_size > 0) {
-        for (int channel = 0; channel < channels_; ++channel) {
-            min[channel] = input_buffer.getMinSample(channel, 0);
-            max[channel] = input_buffer.getMaxSample(channel, 0);
-        }
-    }
+    long long index = start_sample / input_samples_per_pixel - input_start_index;
+    int remainder   = static_cast<int>(start_sample % input_samples_per_pixel);
 
-    int input_index  = 0;
-    int output_index = 0;
+    const int step_index     = samples_per_pixel / input_samples_per_pixel;
+    const int step_remainder = samples_per_pixel % input_samples_per_pixel;
 
-    int last_input_index = 0;
+    boundaries_.clear();
 
-    while (input_index < input_buffer_size) {
-        while (sampleAtPixel(output_index) / input_samples_per_pixel == input_index) {
-            if (output_index > 0) {
-                for (int channel = 0; channel < channels_; ++channel) {
-                    output_buffer.appendSamples(min[channel], max[channel]);
-                }
-            }
-
-            last_input_index = input_index;
-
-            output_index++;
+    while (index < input_buffer_size) {
+        boundaries_.push_back(static_cast<int>(index));
 
-            const int where      = sampleAtPixel(output_index);
-            const int prev_where = sampleAtPixel(output_index - 1);
+        index     += step_index;
+        remainder += step_remainder;
 
-            if (where != prev_where) {
-                for (int channel = 0; channel < channels_; ++channel) {
-                    min[channel] = std::numeric_limits<short>::max();
-                    max[channel] = std::numeric_limits<short>::min();
-                }
-            }
+        if (remainder >= input_samples_per_pixel) {
+            remainder -= input_samples_per_pixel;
+            ++index;
         }
+    }
 
-        const int where = sampleAtPixel(output_index);
-
-        int stop = where / input_samples_per_pixel;
+    const int output_size = static_cast<int>(boundaries_.size());
 
-        if (stop > input_buffer_size) {
-            stop = input_buffer_size;
-        }
+    boundaries_.push_back(input_buffer_size);
 
-        while (input_index < stop) {
-            for (int channel = 0; channel < channels_; ++channel) {
-                short value = input_buffer.getMinSample(channel, input_index);
+    output_buffer.setSize(output_size);
 
-                if (value < min[channel]) {
-                    min[channel] = value;
-                }
+    // Each input point holds the minimum then maximum value of each channel,
+    // so the minimum of the even values and the maximum of the odd values in
+    // a run of points give the output point
+    kernel_ = MinMaxKernels::selectKernel(
+        MinMaxKernels::getKernelSet(),
+        channels * 2,
+        true
+    );
 
-                value = input_buffer.getMaxSample(channel, input_index);
+    const int ranges = std::max(
+        std::min(threads_, output_size / MIN_POINTS_PER_THREAD),
+        1
+    );
 
-                if (value > max[channel]) {
-                    max[channel] = value;
-                }
-            }
-
-            input_index++;
-        }
+    if (ranges == 1) {
+        rescaleRange(input_buffer, output_buffer, 0, output_size);
     }
+    else {
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < ranges; ++i) {
+            const int start_index = static_cast<int>(
+                static_cast<long long>(output_size) * i / ranges
+            );
+
+            const int end_index = static_cast<int>(
+                static_cast<long long>(output_size) * (i + 1) / ranges
+            );
+
+            threads.emplace_back(
+                &WaveformRescaler::rescaleRange,
+                this,
+                std::cref(input_buffer),
+                std::ref(output_buffer),
+                start_index,
+                end_index
+            );
+        }
 
-    if (input_index != last_input_index) {
-        for (int channel = 0; channel < channels_; ++channel) {
-            output_buffer.appendSamples(min[channel], max[channel]);
+        for (auto& thread : threads) {
+            thread.join();
         }
     }
 
@@ -146,9 +178,69 @@ void WaveformRescaler::rescale(
 
 //------------------------------------------------------------------------------
 
-int WaveformRescaler::sampleAtPixel(const int x) const
+// Sets the output points from start_index up to end_index. Each thread sets
+// a different range of points, and the output buffer has already been
+// resized, so no locking is needed.
+
+void WaveformRescaler::rescaleRange(
+    const WaveformBuffer& input_buffer,
+    WaveformBuffer& output_buffer,
+    const int start_index,
+    const int end_index) const
 {
-    return x * output_samples_per_pixel_;
+    TRACE_SCOPE("rescale", "WaveformRescaler::rescaleRange");
+
+    const int channels = input_buffer.getChannels();
+    const int values = channels * 2;
+
+    int min[WaveformBuffer::MAX_CHANNELS * 2];
+    int max[WaveformBuffer::MAX_CHANNELS * 2];
+
+    for (int i = start_index; i < end_index; ++i) {
+        const int first = boundaries_[static_cast<size_t>(i)];
+        const int last  = boundaries_[static_cast<size_t>(i) + 1];
+
+        const short* samples = input_buffer.getSamples(first);
+
+        if (last - first < MIN_KERNEL_POINTS) {
+            // Not worth the call for a few points, so combine these here
+            for (int channel = 0; channel < channels; ++channel) {
+                const short* value = samples + channel * 2;
+
+                short min_value = value[0];
+                short max_value = value[1];
+
+                for (int j = first + 1; j < last; ++j) {
+                    value += values;
+
+                    if (value[0] < min_value) {
+                        min_value = value[0];
+                    }
+
+                    if (value[1] > max_value) {
+                        max_value = value[1];
+                    }
+                }
+
+                output_buffer.setSamples(channel, i, min_value, max_value);
+            }
+        }
+        else {
+            std::fill(min, min + values, std::numeric_limits<short>::max());
+            std::fill(max, max + values, std::numeric_limits<short>::min());
+
+            kernel_(samples, last - first, values, min, max);
+
+            for (int channel = 0; channel < channels; ++channel) {
+                output_buffer.setSamples(
+                    channel,
+                    i,
+                    static_cast<short>(min[channel * 2]),
+                    static_cast<short>(max[channel * 2 + 1])
+                );
+            }
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -26,14 +26,28 @@
 
 //------------------------------------------------------------------------------
 
+#include "MinMaxKernels.h"
+
+#include <vector>
+
+//------------------------------------------------------------------------------
+
 class WaveformBuffer;
 
 //------------------------------------------------------------------------------
 
+// Converts waveform data to a larger number of samples per pixel, where each
+// output point is the minimum and maximum of the input points that start
+// within it.
+//
+// The range of input points for each output point is found before any
+// points are combined, so that large outputs can be divided between threads.
+// The output is the same whatever the number of threads.
+
 class WaveformRescaler
 {
     public:
-        WaveformRescaler();
+        explicit WaveformRescaler(int threads = 1);
 
         WaveformRescaler(const WaveformRescaler&) = delete;
         WaveformRescaler& operator=(const WaveformRescaler&) = delete;
@@ -46,12 +60,21 @@ class WaveformRescaler
         );
 
     private:
-        int sampleAtPixel(int x) const;
+        void rescaleRange(
+            const WaveformBuffer& input_buffer,
+            WaveformBuffer& output_buffer,
+            int start_index,
+            int end_index
+        ) const;
 
     private:
-        int sample_rate_;
-        int channels_;
-        int output_samples_per_pixel_;
+        int threads_;
+
+        // Index of the first input point used by each output point, and the
+        // input buffer size
+        std::vector<int> boundaries_;
+
+        MinMaxKernels::Kernel kernel_;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,413 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "WaveformWriter.h"
+#include "FileUtil.h"
+#include "Log.h"
+#include "TextWriter.h"
+#include "WaveformBuffer.h"
+#include "WaveformGenerator.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+//------------------------------------------------------------------------------
+
+const uint32_t FLAG_8_BIT = 0x00000001U;
+
+// Size of the blocks used to copy the JSON data array to the output
+const size_t COPY_BUFFER_SIZE = 65536;
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+static void writeValue(std::ostream& stream, const T value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+static void appendValue(std::vector<char>& chunk, const T value)
+{
+    const size_t offset = chunk.size();
+
+    chunk.resize(offset + sizeof(value));
+    memcpy(&chunk[offset], &value, sizeof(value));
+}
+
+//------------------------------------------------------------------------------
+
+static void appendNumber(std::vector<char>& chunk, const int value)
+{
+    const size_t offset = chunk.size();
+
+    chunk.resize(offset + TextWriter::MAX_INT_LENGTH);
+    chunk.resize(offset + TextWriter::formatInt(value, &chunk[offset]));
+}
+
+//------------------------------------------------------------------------------
+
+WaveformWriter::WaveformWriter(
+    WaveformGenerator& generator,
+    WaveformBuffer& buffer,
+    const FileFormat::FileFormat format,
+    const int bits,
+    const int version) :
+    generator_(generator),
+    buffer_(buffer),
+    format_(format),
+    bits_(bits),
+    version_(version),
+    output_(nullptr),
+    length_position_(-1),
+    data_file_(nullptr),
+    size_(0),
+    error_(false)
+{
+}
+
+//------------------------------------------------------------------------------
+
+WaveformWriter::~WaveformWriter()
+{
+    if (data_file_ != nullptr) {
+        fclose(data_file_);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformWriter::open(const char* filename)
+{
+    if (bits_ != 8 && bits_ != 16) {
+        log(Error) << "Invalid bits: must be either 8 or 16\n";
+        return false;
+    }
+
+    if (version_ != 0 && version_ != 2 && version_ != 3) {
+        log(Error) << "Invalid format version: must be either 2 or 3\n";
+        return false;
+    }
+
+    filename_ = FileUtil::isStdioFilename(filename) ? "-" : filename;
+
+    if (FileUtil::isStdioFilename(filename)) {
+        output_ = &std::cout;
+    }
+    else {
+        std::ios::openmode mode = std::ios::out;
+
+        if (format_ == FileFormat::Dat) {
+            mode |= std::ios::binary;
+        }
+
+        file_.open(filename, mode);
+
+        if (!file_.is_open()) {
+            reportWriteError();
+            return false;
+        }
+
+        output_ = &file_;
+    }
+
+    log(Info) << "Output file: "
+              << FileUtil::getOutputFilename(filename) << '\n';
+
+    if (format_ == FileFormat::Json) {
+        data_file_ = std::tmpfile();
+
+        if (data_file_ == nullptr) {
+            reportWriteError();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void WaveformWriter::reportWriteError()
+{
+    log(Error) << "Failed to write data file: " << filename_ << '\n'
+               << strerror(errno) << '\n';
+
+    error_ = true;
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformWriter::init(
+    const int sample_rate,
+    const int channels,
+    const long frame_count,
+    const int buffer_size)
+{
+    if (!generator_.init(sample_rate, channels, frame_count, buffer_size)) {
+        return false;
+    }
+
+    size_ = 0;
+
+    return writeHeader();
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformWriter::shouldContinue() const
+{
+    return generator_.shouldContinue();
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformWriter::process(
+    const short* input_buffer,
+    const int input_frame_count)
+{
+    return generator_.process(input_buffer, input_frame_count) &&
+           writePoints();
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformWriter::supportsFloat() const
+{
+    return generator_.supportsFloat();
+}
+
+//------------------------------------------------------------------------------
+
+bool WaveformWriter::processFloat(
+    const float* input_buffer,
+    const int input_frame_count)
+{
+    return generator_.processFloat(input_buffer, input_frame_count) &&
+           writePoints();
+}
+
+//------------------------------------------------------------------------------
+
+void WaveformWriter::done()
+{
+    generator_.done();
+
+    if (!error_ && writePoints()) {
+        finish();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Writes the .dat header. The JSON header is written by finish(), once the
+// length is known.
+
+bool WaveformWriter::writeHeader()
+{
+    if (format_ != FileFormat::Dat) {
+        return true;
+    }
+
+    const int channels = buffer_.getChannels();
+
+    const int32_t version = version_ != 0 ? version_ : channels == 1 ? 1 : 2;
+    const uint32_t flags = bits_ == 8 ? FLAG_8_BIT : 0;
+
+    log(Info) << "Resolution: " << bits_ << " bits\n"
+              << "Channels: " << channels << std::endl;
+
+    writeValue<int32_t>(*output_, version);
+    writeValue<uint32_t>(*output_, flags);
+    writeValue<int32_t>(*output_, buffer_.getSampleRate());
+    writeValue<int32_t>(*output_, buffer_.getSamplesPerPixel());
+
+    // Returns -1 if the output can't be seeked
+    length_position_ = output_->tellp();
+
+    writeValue<uint32_t>(
+        *output_,
+        length_position_ == -1 ? WaveformBuffer::UNKNOWN_LENGTH : 0
+    );
+
+    if (version >= 2) {
+        writeValue<int32_t>(*output_, channels);
+    }
+
+    if (version == 3) {
+        encoder_.reset(new WaveformCodec::Encoder(channels, bits_));
+    }
+
+    if (!*output_) {
+        reportWriteError();
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Writes the points in the generator's buffer, then empties the buffer.
+
+bool WaveformWriter::writePoints()
+{
+    const int size = buffer_.getSize();
+
+    if (size == 0) {
+        return true;
+    }
+
+    const int channels = buffer_.getChannels();
+
+    chunk_.clear();
+
+    if (encoder_) {
+        encoder_->encode(buffer_, chunk_);
+
+        output_->write(chunk_.data(), static_cast<std::streamsize>(chunk_.size()));
+
+        if (!*output_) {
+            reportWriteError();
+            return false;
+        }
+    }
+    else if (format_ == FileFormat::Dat) {
+        for (int i = 0; i < size; ++i) {
+            for (int channel = 0; channel < channels; ++channel) {
+                const short min_value = buffer_.getMinSample(channel, i);
+                const short max_value = buffer_.getMaxSample(channel, i);
+
+                if (bits_ == 8) {
+                    appendValue(chunk_, static_cast<int8_t>(min_value / 256));
+                    appendValue(chunk_, static_cast<int8_t>(max_value / 256));
+                }
+                else {
+                    appendValue(chunk_, static_cast<int16_t>(min_value));
+                    appendValue(chunk_, static_cast<int16_t>(max_value));
+                }
+            }
+        }
+
+        output_->write(chunk_.data(), static_cast<std::streamsize>(chunk_.size()));
+
+        if (!*output_) {
+            reportWriteError();
+            return false;
+        }
+    }
+    else {
+        const int divisor = bits_ == 8 ? 256 : 1;
+
+        for (int i = 0; i < size; ++i) {
+            for (int channel = 0; channel < channels; ++channel) {
+                if (size_ > 0 || i > 0 || channel > 0) {
+                    chunk_.push_back(',');
+                }
+
+                appendNumber(chunk_, buffer_.getMinSample(channel, i) / divisor);
+                chunk_.push_back(',');
+                appendNumber(chunk_, buffer_.getMaxSample(channel, i) / divisor);
+            }
+        }
+
+        if (fwrite(chunk_.data(), 1, chunk_.size(), data_file_) != chunk_.size()) {
+            reportWriteError();
+            return false;
+        }
+    }
+
+    size_ += size;
+
+    buffer_.setSize(0);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+// Completes the output after all points have been written: sets the .dat
+// length field, or writes the JSON header and copies the data array.
+
+bool WaveformWriter::finish()
+{
+    if (format_ == FileFormat::Dat) {
+        if (encoder_) {
+            chunk_.clear();
+            encoder_->finish(chunk_);
+
+            output_->write(chunk_.data(), static_cast<std::streamsize>(chunk_.size()));
+        }
+
+        if (length_position_ != -1) {
+            output_->seekp(length_position_);
+            writeValue<uint32_t>(*output_, static_cast<uint32_t>(size_));
+            output_->seekp(0, std::ios::end);
+        }
+    }
+    else {
+        *output_ << "{\"version\":2"
+                 << ",\"channels\":" << buffer_.getChannels()
+                 << ",\"sample_rate\":" << buffer_.getSampleRate()
+                 << ",\"samples_per_pixel\":" << buffer_.getSamplesPerPixel()
+                 << ",\"bits\":" << bits_
+                 << ",\"length\":" << size_
+                 << ",\"data\":[";
+
+        if (fflush(data_file_) != 0 || fseek(data_file_, 0, SEEK_SET) != 0) {
+            reportWriteError();
+            return false;
+        }
+
+        std::vector<char> buffer(COPY_BUFFER_SIZE);
+
+        size_t count;
+
+        while ((count = fread(buffer.data(), 1, buffer.size(), data_file_)) > 0) {
+            output_->write(buffer.data(), static_cast<std::streamsize>(count));
+        }
+
+        if (ferror(data_file_)) {
+            reportWriteError();
+            return false;
+        }
+
+        *output_ << "]}\n";
+
+        fclose(data_file_);
+        data_file_ = nullptr;
+    }
+
+    output_->flush();
+
+    if (!*output_) {
+        reportWriteError();
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_WAVEFORM_WRITER_H)
+#define INC_WAVEFORM_WRITER_H
+
+//------------------------------------------------------------------------------
+
+#include "AudioProcessor.h"
+#include "FileFormat.h"
+#include "WaveformCodec.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+class WaveformBuffer;
+class WaveformGenerator;
+
+//------------------------------------------------------------------------------
+
+// Writes waveform data in .dat or JSON format while it is being generated, so
+// that the memory used doesn't depend on the length of the audio.
+//
+// Audio is passed to a WaveformGenerator, and after each block of audio, the
+// points the generator has added to its buffer are written to the output and
+// removed from the buffer.
+//
+// The .dat header is written before the first point, so its length field is
+// updated when all points have been written. If the output can't be seeked,
+// e.g., a pipe, the length is set to WaveformBuffer::UNKNOWN_LENGTH instead.
+// The JSON length comes before the data array, so the data array is written
+// to a temporary file, then copied to the output after the header.
+//
+// The .dat format version is as for WaveformBuffer::save().
+
+class WaveformWriter : public AudioProcessor
+{
+    public:
+        WaveformWriter(
+            WaveformGenerator& generator,
+            WaveformBuffer& buffer,
+            FileFormat::FileFormat format,
+            int bits,
+            int version = 0
+        );
+
+        virtual ~WaveformWriter();
+
+        WaveformWriter(const WaveformWriter&) = delete;
+        WaveformWriter& operator=(const WaveformWriter&) = delete;
+
+    public:
+        bool open(const char* filename);
+
+        virtual bool init(
+            int sample_rate,
+            int channels,
+            long frame_count,
+            int buffer_size
+        );
+
+        virtual bool shouldContinue() const;
+
+        virtual bool process(
+            const short* input_buffer,
+            int input_frame_count
+        );
+
+        virtual bool supportsFloat() const;
+
+        virtual bool processFloat(
+            const float* input_buffer,
+            int input_frame_count
+        );
+
+        virtual void done();
+
+        // Returns true if writing the output failed. This may happen in
+        // done(), so callers should check this after the reader has finished.
+        bool hasError() const { return error_; }
+
+        // Returns the number of points written
+        int getSize() const { return size_; }
+
+    private:
+        bool writeHeader();
+        bool writePoints();
+        bool finish();
+
+        void reportWriteError();
+
+    private:
+        WaveformGenerator& generator_;
+        WaveformBuffer& buffer_;
+
+        FileFormat::FileFormat format_;
+        int bits_;
+        int version_;
+
+        std::string filename_;
+        std::ofstream file_;
+        std::ostream* output_;
+
+        // Position of the .dat length field, or -1 if the output can't be
+        // seeked
+        std::streamoff length_position_;
+
+        // Temporary file holding the JSON data array
+        std::FILE* data_file_;
+
+        std::vector<char> chunk_;
+
+        // Used for version 3 .dat files
+        std::unique_ptr<WaveformCodec::Encoder> encoder_;
+
+        int size_;
+        bool error_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_WAVEFORM_WRITER_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,381 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "BatchRunner.h"
+#include "Log.h"
+#include "Options.h"
+#include "util/Streams.h"
+
+#include "gmock/gmock.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::HasSubstr;
+using testing::StartsWith;
+using testing::StrEq;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class BatchRunnerTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+        }
+
+        virtual void TearDown()
+        {
+        }
+};
+
+//------------------------------------------------------------------------------
+
+static std::vector<std::string> getLines(const std::string& text)
+{
+    std::istringstream stream(text);
+    std::vector<std::string> lines;
+    std::string line;
+
+    while (std::getline(stream, line)) {
+        lines.push_back(line);
+    }
+
+    return lines;
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(BatchRunnerTest, shouldRunEachJob)
+{
+    std::vector<std::string> input_filenames;
+
+    BatchRunner runner(1, [&](const Options& options) {
+        input_filenames.push_back(options.getInputFilename().string());
+        return true;
+    });
+
+    std::istringstream manifest(
+        "-i test1.mp3 -o test1.dat -b 8\n"
+        "-i test2.wav -o test2.png\n"
+    );
+
+    std::ostringstream status;
+
+    bool result = runner.run(manifest, status);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(input_filenames.size(), Eq(2U));
+    ASSERT_THAT(input_filenames[0], StrEq("test1.mp3"));
+    ASSERT_THAT(input_filenames[1], StrEq("test2.wav"));
+
+    const std::vector<std::string> lines = getLines(status.str());
+    ASSERT_THAT(lines.size(), Eq(2U));
+
+    ASSERT_THAT(lines[0], StartsWith(
+        "{\"line\":1,\"input\":\"test1.mp3\",\"output\":\"test1.dat\",\"status\":\"ok\",\"seconds\":"
+    ));
+
+    ASSERT_THAT(lines[1], StartsWith(
+        "{\"line\":2,\"input\":\"test2.wav\",\"output\":\"test2.png\",\"status\":\"ok\",\"seconds\":"
+    ));
+
+    ASSERT_THAT(runner.getJobCount(), Eq(2));
+    ASSERT_THAT(runner.getFailedCount(), Eq(0));
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(BatchRunnerTest, shouldPassJobOptionsToHandler)
+{
+    int bits = 0;
+    int end_time = 0;
+
+    BatchRunner runner(1, [&](const Options& options) {
+        bits = options.getBits();
+        end_time = static_cast<int>(options.getEndTime());
+        return true;
+    });
+
+    std::istringstream manifest("-i test.mp3 -o test.dat --bits 8 --end 10\n");
+    std::ostringstream status;
+
+    bool result = runner.run(manifest, status);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(bits, Eq(8));
+    ASSERT_THAT(end_time, Eq(10));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(BatchRunnerTest, shouldContinueAfterFailingJob)
+{
+    BatchRunner runner(1, [](const Options& options) {
+        if (options.getInputFilename() == "test2.mp3") {
+            log(Error) << "Failed to read file: test2.mp3\n";
+            return false;
+        }
+
+        return true;
+    });
+
+    std::istringstream manifest(
+        "-i test1.mp3 -o test1.dat\n"
+        "-i test2.mp3 -o test2.dat\n"
+        "-i test3.mp3 -o test3.dat\n"
+    );
+
+    std::ostringstream status;
+
+    bool result = runner.run(manifest, status);
+    ASSERT_FALSE(result);
+
+    const std::vector<std::string> lines = getLines(status.str());
+    ASSERT_THAT(lines.size(), Eq(3U));
+
+    ASSERT_THAT(lines[0], HasSubstr("\"status\":\"ok\""));
+    ASSERT_THAT(lines[1], HasSubstr("\"status\":\"error\""));
+    ASSERT_THAT(lines[1], HasSubstr(
+        "\"error\":\"Failed to read file: test2.mp3\"}"
+    ));
+    ASSERT_THAT(lines[2], HasSubstr("\"status\":\"ok\""));
+
+    ASSERT_THAT(runner.getJobCount(), Eq(3));
+    ASSERT_THAT(runner.getFailedCount(), Eq(1));
+
+    // Errors are reported in the job status, not logged
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(BatchRunnerTest, shouldReportJobThatThrows)
+{
+    BatchRunner runner(1, [](const Options&) -> bool {
+        throw std::runtime_error("Unexpected \"error\"");
+    });
+
+    std::istringstream manifest("-i test.mp3 -o test.dat\n");
+    std::ostringstream status;
+
+    bool result = runner.run(manifest, status);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(status.str(), HasSubstr(
+        "\"error\":\"Unexpected \\\"error\\\"\"}\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(BatchRunnerTest, shouldReportInvalidOptions)
+{
+    int count = 0;
+
+    BatchRunner runner(1, [&](const Options&) {
+        ++count;
+        return true;
+    });
+
+    std::istringstream manifest(
+        "-i test.mp3 -o test.dat --bits 10\n"
+        "-i test.mp3 -o test.dat --unknown\n"
+    );
+
+    std::ostringstream status;
+
+    bool result = runner.run(manifest, status);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(count, Eq(0));
+
+    const std::vector<std::string> lines = getLines(status.str());
+    ASSERT_THAT(lines.size(), Eq(2U));
+
+    ASSERT_THAT(lines[0], StartsWith("{\"line\":1,\"status\":\"error\""));
+    ASSERT_THAT(lines[0], HasSubstr("\"error\":\"Error: Invalid bits"));
+
+    ASSERT_THAT(lines[1], StartsWith("{\"line\":2,\"status\":\"error\""));
+    ASSERT_THAT(lines[1], HasSubstr("\"error\":\"Error: unrecognised option"));
+
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(BatchRunnerTest, shouldIgnoreBlankLinesAndComments)
+{
+    int count = 0;
+
+    BatchRunner runner(1, [&](const Options&) {
+        ++count;
+        return true;
+    });
+
+    std::istringstream manifest(
+        "# Jobs\n"
+        "\n"
+        "   \n"
+        "-i test1.mp3 -o test1.dat\n"
+        "  # -i test2.mp3 -o test2.dat\n"
+        "-i test3.mp3 -o test3.dat"
+    );
+
+    std::ostringstream status;
+
+    bool result = runner.run(manifest, status);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(count, Eq(2));
+
+    const std::vector<std::string> lines = getLines(status.str());
+    ASSERT_THAT(lines.size(), Eq(2U));
+
+    ASSERT_THAT(lines[0], StartsWith("{\"line\":4,"));
+    ASSERT_THAT(lines[1], StartsWith("{\"line\":6,"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(BatchRunnerTest, shouldRejectJobsUsingStdio)
+{
+    int count = 0;
+
+    BatchRunner runner(1, [&](const Options&) {
+        ++count;
+        return true;
+    });
+
+    std::istringstream manifest(
+        "-i - --input-format mp3 -o test.dat\n"
+        "-i test.mp3 -o - --output-format dat\n"
+        "--batch jobs.txt\n"
+        "-i test.mp3 -o test.dat --trace trace.json\n"
+    );
+
+    std::ostringstream status;
+
+    bool result = runner.run(manifest, status);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(count, Eq(0));
+
+    const std::vector<std::string> lines = getLines(status.str());
+    ASSERT_THAT(lines.size(), Eq(4U));
+
+    ASSERT_THAT(lines[0], HasSubstr("\"error\":\"Invalid job: input and output must be files\""));
+    ASSERT_THAT(lines[1], HasSubstr("\"error\":\"Invalid job: input and output must be files\""));
+    ASSERT_THAT(lines[2], HasSubstr("\"error\":\"Invalid job: --help, --version, --batch, and --serve are not allowed\""));
+    ASSERT_THAT(lines[3], HasSubstr("\"error\":\"Invalid job: --trace is not allowed, use it with --batch or --serve instead\""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(BatchRunnerTest, shouldAllowQuotedFilenames)
+{
+    std::string input_filename;
+
+    BatchRunner runner(1, [&](const Options& options) {
+        input_filename = options.getInputFilename().string();
+        return true;
+    });
+
+    std::istringstream manifest("-i \"test file.mp3\" -o test.dat\n");
+    std::ostringstream status;
+
+    bool result = runner.run(manifest, status);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(input_filename, StrEq("test file.mp3"));
+    ASSERT_THAT(status.str(), HasSubstr("\"input\":\"test file.mp3\""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(BatchRunnerTest, shouldRunJobsOnMultipleThreads)
+{
+    std::mutex mutex;
+    std::condition_variable started;
+    std::set<std::thread::id> thread_ids;
+    bool all_started = true;
+
+    // Each of the first 4 jobs waits until the others have started, so this
+    // only succeeds if they run at the same time
+    BatchRunner runner(4, [&](const Options& options) {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        thread_ids.insert(std::this_thread::get_id());
+        started.notify_all();
+
+        if (!started.wait_for(lock, std::chrono::seconds(5), [&] {
+            return thread_ids.size() == 4;
+        })) {
+            all_started = false;
+        }
+
+        return options.getInputFilename() != "test5.mp3";
+    });
+
+    std::ostringstream manifest_text;
+
+    for (int i = 1; i <= 16; ++i) {
+        manifest_text << "-i test" << i << ".mp3 -o test" << i << ".dat\n";
+    }
+
+    std::istringstream manifest(manifest_text.str());
+    std::ostringstream status;
+
+    bool result = runner.run(manifest, status);
+    ASSERT_FALSE(result);
+
+    ASSERT_TRUE(all_started);
+    ASSERT_THAT(thread_ids.size(), Eq(4U));
+    ASSERT_THAT(thread_ids.count(std::this_thread::get_id()), Eq(0U));
+
+    ASSERT_THAT(runner.getJobCount(), Eq(16));
+    ASSERT_THAT(runner.getFailedCount(), Eq(1));
+
+    const std::vector<std::string> lines = getLines(status.str());
+    ASSERT_THAT(lines.size(), Eq(16U));
+
+    for (const auto& line : lines) {
+        ASSERT_THAT(line, StartsWith("{\"line\":"));
+    }
+}
+
+//------------------------------------------------------------------------------
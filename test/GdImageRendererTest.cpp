@@ -26,16 +26,20 @@
 #include "WaveformColors.h"
 #include "util/FileDeleter.h"
 #include "util/FileUtil.h"
+#include "util/ImageUtil.h"
 #include "util/Streams.h"
 
 #include "gmock/gmock.h"
 
+#include <functional>
+
 //------------------------------------------------------------------------------
 
 using testing::EndsWith;
 using testing::Eq;
 using testing::Gt;
 using testing::MatchesRegex;
+using testing::NotNull;
 using testing::StartsWith;
 using testing::StrEq;
 using testing::Test;
@@ -228,6 +232,195 @@ TEST_F(GdImageRendererTest, shouldRenderImageWithRoundedBars)
 
 //------------------------------------------------------------------------------
 
+// The IHDR chunk follows the 8 byte PNG signature, 4 byte length, 4 byte chunk
+// type, and 4 byte width and height.
+
+static void checkPngFormat(
+    const boost::filesystem::path& filename,
+    const int expected_bit_depth,
+    const int expected_color_type)
+{
+    const std::vector<uint8_t> data = FileUtil::readFile(filename);
+    ASSERT_THAT(data.size(), Gt(26U));
+
+    ASSERT_THAT(data[24], Eq(expected_bit_depth));
+    ASSERT_THAT(data[25], Eq(expected_color_type));
+}
+
+//------------------------------------------------------------------------------
+
+static void renderImage(
+    const boost::filesystem::path& filename,
+    const bool axis_labels,
+    const WaveformColors& colors,
+    const PngOptions& options)
+{
+    WaveformBuffer buffer;
+    bool result = buffer.load("../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    ASSERT_TRUE(result);
+
+    GdImageRenderer renderer;
+    renderer.enableAxisLabels(axis_labels);
+
+    result = renderer.create(buffer, 1000, 300, colors);
+    ASSERT_TRUE(result);
+
+    result = renderer.saveAsPng(filename.c_str(), options);
+    ASSERT_TRUE(result);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(GdImageRendererTest, shouldSaveIndexedColorImageWithFewestBitsPerPixel)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".png");
+
+    // Ensure temporary file is deleted at end of test.
+    FileDeleter deleter(filename);
+
+    // Background and waveform colors only
+    renderImage(filename, false, audacity_waveform_colors, PngOptions());
+    checkPngFormat(filename, 1, PNG_COLOR_TYPE_PALETTE);
+
+    // Also border and axis label colors
+    renderImage(filename, true, audacity_waveform_colors, PngOptions());
+    checkPngFormat(filename, 2, PNG_COLOR_TYPE_PALETTE);
+
+    renderImage(filename, true, audition_waveform_colors, PngOptions());
+    checkPngFormat(filename, 2, PNG_COLOR_TYPE_PALETTE);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(GdImageRendererTest, shouldSaveTruecolorImageIfPaletteDisabled)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".png");
+
+    // Ensure temporary file is deleted at end of test.
+    FileDeleter deleter(filename);
+
+    PngOptions options;
+    options.palette = false;
+
+    renderImage(filename, true, audacity_waveform_colors, options);
+    checkPngFormat(filename, 8, PNG_COLOR_TYPE_RGB);
+
+    WaveformColors colors = audacity_waveform_colors;
+    colors.background_color = RGBA(0, 0, 0, 0);
+
+    renderImage(filename, true, colors, options);
+    checkPngFormat(filename, 8, PNG_COLOR_TYPE_RGB_ALPHA);
+}
+
+//------------------------------------------------------------------------------
+
+// Renders an image with create() and saveAsPng(), and with renderAsPng() in
+// strips of several heights, and checks that every pixel is the same.
+
+static void testRenderAsPng(
+    const std::function<void(GdImageRenderer&)>& configure,
+    const WaveformColors& colors)
+{
+    const boost::filesystem::path ref_filename = FileUtil::getTempFilename(".png");
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".png");
+
+    // Ensure temporary files are deleted at end of test.
+    FileDeleter ref_deleter(ref_filename);
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+    bool result = buffer.load("../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    ASSERT_TRUE(result);
+
+    {
+        GdImageRenderer renderer;
+        configure(renderer);
+
+        result = renderer.create(buffer, 1000, 300, colors);
+        ASSERT_TRUE(result);
+
+        result = renderer.saveAsPng(ref_filename.c_str());
+        ASSERT_TRUE(result);
+    }
+
+    gdImagePtr ref_image = ImageUtil::loadPng(ref_filename);
+    ASSERT_THAT(ref_image, NotNull());
+
+    // 0 is the default, which draws the whole image in one strip
+    for (const int strip_height : { 1, 7, 64, 0 }) {
+        GdImageRenderer renderer;
+        configure(renderer);
+        renderer.setStripHeight(strip_height);
+
+        result = renderer.renderAsPng(buffer, 1000, 300, colors, filename.c_str());
+        ASSERT_TRUE(result);
+
+        gdImagePtr image = ImageUtil::loadPng(filename);
+        ASSERT_THAT(image, NotNull());
+
+        ASSERT_THAT(gdImageSX(image), Eq(1000));
+        ASSERT_THAT(gdImageSY(image), Eq(300));
+
+        for (int y = 0; y < 300; ++y) {
+            for (int x = 0; x < 1000; ++x) {
+                ASSERT_THAT(
+                    gdImageGetTrueColorPixel(image, x, y),
+                    Eq(gdImageGetTrueColorPixel(ref_image, x, y))
+                ) << "Strip height " << strip_height << ", pixel " << x << ", " << y;
+            }
+        }
+
+        gdImageDestroy(image);
+    }
+
+    gdImageDestroy(ref_image);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(GdImageRendererTest, shouldRenderSamePixelsInStrips)
+{
+    testRenderAsPng(
+        [](GdImageRenderer& renderer) {
+            renderer.setStartTime(5.0);
+        },
+        audacity_waveform_colors
+    );
+
+    ASSERT_THAT(error.str(), EndsWith(".png\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(GdImageRendererTest, shouldRenderSameBarsInStrips)
+{
+    testRenderAsPng(
+        [](GdImageRenderer& renderer) {
+            renderer.setBarStyle(8, 4, true);
+            renderer.setAmplitudeScale(true, 1.0);
+        },
+        audition_waveform_colors
+    );
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(GdImageRendererTest, shouldRenderSameTranslucentColorsInStrips)
+{
+    WaveformColors colors = audacity_waveform_colors;
+    colors.background_color = RGBA(255, 255, 255, 0);
+    colors.waveform_colors = { RGBA(0, 0, 255, 128), RGBA(255, 0, 0, 64) };
+
+    testRenderAsPng(
+        [](GdImageRenderer& renderer) {
+            renderer.enableAxisLabels(false);
+        },
+        colors
+    );
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(GdImageRendererTest, shouldReportErrorIfImageWidthIsLessThanMinimum)
 {
     WaveformBuffer buffer;
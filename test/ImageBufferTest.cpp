@@ -0,0 +1,344 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "ImageBuffer.h"
+
+#include "gmock/gmock.h"
+
+#include <gd.h>
+#include <gdfonts.h>
+
+#include <cstdlib>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+// Each test draws the same shapes with ImageBuffer and with the equivalent
+// libgd functions, and checks that every pixel is the same.
+
+class ImageBufferTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            image_ = gdImageCreateTrueColor(WIDTH, HEIGHT);
+            ASSERT_TRUE(image_ != nullptr);
+
+            buffer_.create(WIDTH, HEIGHT);
+        }
+
+        virtual void TearDown()
+        {
+            gdImageDestroy(image_);
+        }
+
+        void setAlphaBlending(bool alpha_blending)
+        {
+            gdImageAlphaBlending(image_, alpha_blending ? 1 : 0);
+            buffer_.setAlphaBlending(alpha_blending);
+        }
+
+        int countDifferentPixels() const;
+
+        static const int WIDTH = 64;
+        static const int HEIGHT = 48;
+
+        gdImagePtr image_;
+        ImageBuffer buffer_;
+};
+
+//------------------------------------------------------------------------------
+
+int ImageBufferTest::countDifferentPixels() const
+{
+    int count = 0;
+
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+            if (buffer_.getPixel(x, y) != gdImageGetTrueColorPixel(image_, x, y)) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+
+static const int OPAQUE_COLOR      = 0x0033aa55;
+static const int TRANSLUCENT_COLOR = 0x40ff8000;
+
+//------------------------------------------------------------------------------
+
+TEST_F(ImageBufferTest, shouldCreateBlackImage)
+{
+    ASSERT_THAT(buffer_.getWidth(), Eq(WIDTH));
+    ASSERT_THAT(buffer_.getHeight(), Eq(HEIGHT));
+    ASSERT_THAT(buffer_.getPixel(0, 0), Eq(0));
+    ASSERT_THAT(countDifferentPixels(), Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ImageBufferTest, shouldDrawIntoAttachedRows)
+{
+    buffer_.attach(image_->tpixels, WIDTH, HEIGHT);
+    buffer_.setPixel(3, 4, OPAQUE_COLOR);
+
+    ASSERT_THAT(gdImageGetTrueColorPixel(image_, 3, 4), Eq(OPAQUE_COLOR));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ImageBufferTest, shouldBlendColors)
+{
+    const int colors[] = { 0x00102030, 0x20405060, 0x7f7f7f7f, 0x7fffffff, 0x01ffffff };
+
+    for (int dst : colors) {
+        for (int src : colors) {
+            ASSERT_THAT(ImageBuffer::blend(dst, src), Eq(gdAlphaBlend(dst, src)));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ImageBufferTest, shouldDrawClippedLines)
+{
+    gdImageLine(image_, 5, -10, 5, 20, OPAQUE_COLOR);
+    buffer_.drawVerticalLine(5, -10, 20, OPAQUE_COLOR);
+
+    gdImageLine(image_, 70, 10, -3, 10, OPAQUE_COLOR);
+    buffer_.drawHorizontalLine(10, 70, -3, OPAQUE_COLOR);
+
+    gdImageLine(image_, 8, 40, 8, 30, TRANSLUCENT_COLOR);
+    buffer_.drawVerticalLine(8, 40, 30, TRANSLUCENT_COLOR);
+
+    gdImageLine(image_, -1, 5, -1, 15, OPAQUE_COLOR);
+    buffer_.drawVerticalLine(-1, 5, 15, OPAQUE_COLOR);
+
+    ASSERT_THAT(countDifferentPixels(), Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ImageBufferTest, shouldDrawRectangles)
+{
+    gdImageRectangle(image_, 0, 0, WIDTH - 1, HEIGHT - 1, TRANSLUCENT_COLOR);
+    buffer_.drawRectangle(0, 0, WIDTH - 1, HEIGHT - 1, TRANSLUCENT_COLOR);
+
+    gdImageRectangle(image_, 10, 10, 20, 11, TRANSLUCENT_COLOR);
+    buffer_.drawRectangle(10, 10, 20, 11, TRANSLUCENT_COLOR);
+
+    gdImageRectangle(image_, 30, 5, 30, 25, TRANSLUCENT_COLOR);
+    buffer_.drawRectangle(30, 5, 30, 25, TRANSLUCENT_COLOR);
+
+    gdImageFilledRectangle(image_, 40, 50, 35, 20, OPAQUE_COLOR);
+    buffer_.fillRectangle(40, 50, 35, 20, OPAQUE_COLOR);
+
+    gdImageFilledRectangle(image_, -5, 30, 12, 35, TRANSLUCENT_COLOR);
+    buffer_.fillRectangle(-5, 30, 12, 35, TRANSLUCENT_COLOR);
+
+    ASSERT_THAT(countDifferentPixels(), Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ImageBufferTest, shouldDrawRoundedCorners)
+{
+    for (int radius = 0; radius <= 8; ++radius) {
+        const int x = 4 + radius * 6;
+
+        gdImageFilledArc(image_, x, 10, radius * 2, radius * 2, 180, 270, OPAQUE_COLOR, gdStyledBrushed);
+        buffer_.fillPie(x, 10, radius * 2, radius * 2, 180, 270, OPAQUE_COLOR);
+
+        gdImageFilledArc(image_, x, 20, radius * 2, radius * 2, 270, 0, OPAQUE_COLOR, gdStyledBrushed);
+        buffer_.fillPie(x, 20, radius * 2, radius * 2, 270, 0, OPAQUE_COLOR);
+
+        gdImageFilledArc(image_, x, 30, radius * 2, radius * 2, 90, 180, OPAQUE_COLOR, gdStyledBrushed);
+        buffer_.fillPie(x, 30, radius * 2, radius * 2, 90, 180, OPAQUE_COLOR);
+
+        gdImageFilledArc(image_, x, 40, radius * 2, radius * 2, 0, 90, OPAQUE_COLOR, gdStyledBrushed);
+        buffer_.fillPie(x, 40, radius * 2, radius * 2, 0, 90, OPAQUE_COLOR);
+    }
+
+    ASSERT_THAT(countDifferentPixels(), Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ImageBufferTest, shouldDrawText)
+{
+    const gdFontPtr gd_font = gdFontGetSmall();
+
+    const ImageBuffer::Font font = {
+        gd_font->offset,
+        gd_font->nchars,
+        gd_font->w,
+        gd_font->h,
+        gd_font->data
+    };
+
+    char text[] = "00:01:30";
+
+    gdImageString(image_, gd_font, 2, 2, reinterpret_cast<unsigned char*>(text), OPAQUE_COLOR);
+    buffer_.drawText(2, 2, text, font, OPAQUE_COLOR);
+
+    // Partly outside the image
+    gdImageString(image_, gd_font, 30, 40, reinterpret_cast<unsigned char*>(text), TRANSLUCENT_COLOR);
+    buffer_.drawText(30, 40, text, font, TRANSLUCENT_COLOR);
+
+    ASSERT_THAT(countDifferentPixels(), Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ImageBufferTest, shouldDrawSameAsGdWithRandomShapes)
+{
+    srand(1);
+
+    for (int i = 0; i < 2000; ++i) {
+        setAlphaBlending(i % 2 == 0);
+
+        const int color = (rand() % 4 == 0 ? 0 : (rand() % 128) << 24) | (rand() & 0xffffff);
+
+        const int x1 = rand() % (WIDTH + 20) - 10;
+        const int y1 = rand() % (HEIGHT + 20) - 10;
+        const int x2 = rand() % (WIDTH + 20) - 10;
+        const int y2 = rand() % (HEIGHT + 20) - 10;
+
+        switch (rand() % 4) {
+            case 0:
+                gdImageLine(image_, x1, y1, x1, y2, color);
+                buffer_.drawVerticalLine(x1, y1, y2, color);
+                break;
+
+            case 1:
+                gdImageRectangle(image_, x1, y1, x2, y2, color);
+                buffer_.drawRectangle(x1, y1, x2, y2, color);
+                break;
+
+            case 2:
+                gdImageFilledRectangle(image_, x1, y1, x2, y2, color);
+                buffer_.fillRectangle(x1, y1, x2, y2, color);
+                break;
+
+            default: {
+                const int start = rand() % 720 - 360;
+                const int end   = rand() % 720 - 360;
+                const int width  = rand() % 30;
+                const int height = rand() % 30;
+
+                gdImageFilledArc(image_, x1, y1, width, height, start, end, color, gdStyledBrushed);
+                buffer_.fillPie(x1, y1, width, height, start, end, color);
+                break;
+            }
+        }
+
+        ASSERT_THAT(countDifferentPixels(), Eq(0)) << "Shape " << i;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Draws the same shapes each time it's called, with alpha blending.
+
+static void drawShapes(ImageBuffer& buffer)
+{
+    const gdFontPtr gd_font = gdFontGetSmall();
+
+    const ImageBuffer::Font font = {
+        gd_font->offset,
+        gd_font->nchars,
+        gd_font->w,
+        gd_font->h,
+        gd_font->data
+    };
+
+    srand(2);
+
+    for (int i = 0; i < 500; ++i) {
+        const int color = (rand() % 4 == 0 ? 0 : (rand() % 128) << 24) | (rand() & 0xffffff);
+
+        const int x1 = rand() % (buffer.getWidth() + 20) - 10;
+        const int y1 = rand() % (buffer.getHeight() + 20) - 10;
+        const int x2 = rand() % (buffer.getWidth() + 20) - 10;
+        const int y2 = rand() % (buffer.getHeight() + 20) - 10;
+
+        switch (rand() % 5) {
+            case 0:
+                buffer.drawVerticalLine(x1, y1, y2, color);
+                break;
+
+            case 1:
+                buffer.drawRectangle(x1, y1, x2, y2, color);
+                break;
+
+            case 2:
+                buffer.fillRectangle(x1, y1, x2, y2, color);
+                break;
+
+            case 3:
+                buffer.drawText(x1, y1, "00:01:30", font, color);
+                break;
+
+            default:
+                buffer.fillPie(x1, y1, rand() % 30, rand() % 30, rand() % 360, rand() % 360, color);
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ImageBufferTest, shouldDrawSamePixelsInStrips)
+{
+    drawShapes(buffer_);
+
+    for (const int strip_height : { 1, 5, 16, HEIGHT }) {
+        ImageBuffer strip;
+        strip.createStrip(WIDTH, HEIGHT, strip_height);
+
+        for (int top = 0; top < HEIGHT; top += strip_height) {
+            strip.setStripTop(top);
+            drawShapes(strip);
+
+            const int bottom = top + strip_height < HEIGHT ? top + strip_height : HEIGHT;
+
+            ASSERT_THAT(strip.getStripTop(), Eq(top));
+            ASSERT_THAT(strip.getStripBottom(), Eq(bottom));
+
+            for (int y = top; y < strip.getStripBottom(); ++y) {
+                for (int x = 0; x < WIDTH; ++x) {
+                    ASSERT_THAT(strip.getPixel(x, y), Eq(buffer_.getPixel(x, y)))
+                        << "Strip height " << strip_height << ", pixel " << x << ", " << y;
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
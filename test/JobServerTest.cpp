@@ -0,0 +1,480 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "JobServer.h"
+#include "Log.h"
+#include "Options.h"
+#include "util/FileDeleter.h"
+#include "util/FileUtil.h"
+#include "util/JobClient.h"
+#include "util/Streams.h"
+
+#include "gmock/gmock.h"
+
+#include <sys/stat.h>
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::HasSubstr;
+using testing::StartsWith;
+using testing::StrEq;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class JobServerTest : public Test
+{
+    public:
+        JobServerTest() :
+            socket_filename_(FileUtil::getTempFilename(".sock").string())
+        {
+        }
+
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+        }
+
+        virtual void TearDown()
+        {
+            stopServer();
+        }
+
+        void startServer(
+            int workers,
+            JobServer::JobHandler handler,
+            int max_connections = 64)
+        {
+            server_.reset(
+                new JobServer(socket_filename_, workers, handler, max_connections)
+            );
+
+            ASSERT_TRUE(server_->listen());
+
+            thread_ = std::thread([this] { server_->run(); });
+        }
+
+        void stopServer()
+        {
+            if (thread_.joinable()) {
+                server_->stop();
+                thread_.join();
+            }
+
+            server_.reset();
+        }
+
+        std::string socket_filename_;
+        std::unique_ptr<JobServer> server_;
+        std::thread thread_;
+};
+
+//------------------------------------------------------------------------------
+
+static bool writeOutputFile(const Options& options, const std::string& data)
+{
+    std::ofstream file(options.getOutputFilename().string());
+    file << data;
+
+    return file.good();
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldRespondToHealthRequest)
+{
+    startServer(1, [](const Options&) { return true; });
+
+    JobClient client;
+    ASSERT_TRUE(client.connect(socket_filename_));
+
+    std::string response;
+    ASSERT_TRUE(client.sendRequest("health", response));
+
+    ASSERT_THAT(response, StrEq("{\"status\":\"ok\"}"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldRunJobAndWriteOutputFile)
+{
+    const boost::filesystem::path output_filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(output_filename);
+
+    startServer(2, [](const Options& options) {
+        return writeOutputFile(options, "waveform data");
+    });
+
+    JobClient client;
+    ASSERT_TRUE(client.connect(socket_filename_));
+
+    std::string response;
+    ASSERT_TRUE(client.sendRequest(
+        "run -i test.wav -o " + output_filename.string() + " -b 8",
+        response
+    ));
+
+    ASSERT_THAT(response, StartsWith(
+        "{\"input\":\"test.wav\",\"output\":\"" + output_filename.string() +
+        "\",\"status\":\"ok\",\"seconds\":"
+    ));
+
+    ASSERT_THAT(FileUtil::readTextFile(output_filename), StrEq("waveform data"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldSendOutputInResponse)
+{
+    std::vector<boost::filesystem::path> output_filenames;
+
+    startServer(1, [&](const Options& options) {
+        output_filenames.push_back(options.getOutputFilename());
+        return writeOutputFile(options, "waveform data");
+    });
+
+    JobClient client;
+    ASSERT_TRUE(client.connect(socket_filename_));
+
+    std::string response;
+    std::string data;
+
+    ASSERT_TRUE(client.sendRequest(
+        "run -i test.wav --output-format dat -b 8", response, data
+    ));
+
+    ASSERT_THAT(response, HasSubstr("\"output\":\"-\",\"status\":\"ok\""));
+    ASSERT_THAT(response, HasSubstr(",\"size\":13}"));
+    ASSERT_THAT(data, StrEq("waveform data"));
+
+    ASSERT_TRUE(client.sendRequest(
+        "run -i test.wav -o - --output-format json", response, data
+    ));
+
+    ASSERT_THAT(response, HasSubstr(",\"size\":13}"));
+    ASSERT_THAT(data, StrEq("waveform data"));
+
+    // The temporary output files should have been removed
+    ASSERT_THAT(output_filenames.size(), Eq(2U));
+    ASSERT_FALSE(boost::filesystem::exists(output_filenames[0]));
+    ASSERT_FALSE(boost::filesystem::exists(output_filenames[1]));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldNotSendMultipleZoomLevelsInResponse)
+{
+    int count = 0;
+
+    startServer(1, [&](const Options&) {
+        ++count;
+        return true;
+    });
+
+    JobClient client;
+    ASSERT_TRUE(client.connect(socket_filename_));
+
+    std::string response;
+    std::string data;
+
+    ASSERT_TRUE(client.sendRequest(
+        "run -i test.wav --output-format dat -z 64,128", response, data
+    ));
+
+    ASSERT_THAT(response, HasSubstr("\"status\":\"error\""));
+    ASSERT_THAT(response, HasSubstr(
+        "\"error\":\"Cannot write multiple zoom levels to standard output\""
+    ));
+    ASSERT_THAT(data, StrEq(""));
+    ASSERT_THAT(count, Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldReportFailingJobAndContinue)
+{
+    startServer(1, [](const Options& options) {
+        if (options.getInputFilename() == "unknown.wav") {
+            log(Error) << "Failed to read file: unknown.wav\n";
+            return false;
+        }
+
+        return true;
+    });
+
+    JobClient client;
+    ASSERT_TRUE(client.connect(socket_filename_));
+
+    std::string response;
+
+    ASSERT_TRUE(client.sendRequest("run -i unknown.wav -o test.dat", response));
+    ASSERT_THAT(response, HasSubstr("\"status\":\"error\""));
+    ASSERT_THAT(response, HasSubstr("\"error\":\"Failed to read file: unknown.wav\"}"));
+
+    ASSERT_TRUE(client.sendRequest("run -i test.wav -o test.dat", response));
+    ASSERT_THAT(response, HasSubstr("\"status\":\"ok\""));
+
+    // Errors are sent to the client, not logged
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldReportInvalidRequests)
+{
+    int count = 0;
+
+    startServer(1, [&](const Options&) {
+        ++count;
+        return true;
+    });
+
+    JobClient client;
+    ASSERT_TRUE(client.connect(socket_filename_));
+
+    std::string response;
+
+    ASSERT_TRUE(client.sendRequest("run -i test.wav -o test.dat --bits 10", response));
+    ASSERT_THAT(response, StartsWith("{\"status\":\"error\""));
+    ASSERT_THAT(response, HasSubstr("\"error\":\"Error: Invalid bits"));
+
+    ASSERT_TRUE(client.sendRequest("run -i - --input-format wav -o test.dat", response));
+    ASSERT_THAT(response, HasSubstr("\"error\":\"Invalid job: input and output must be files\""));
+
+    ASSERT_TRUE(client.sendRequest("run --serve test.sock", response));
+    ASSERT_THAT(response, HasSubstr("\"error\":\"Invalid job: --help, --version, --batch, and --serve are not allowed\""));
+
+    ASSERT_TRUE(client.sendRequest("unknown", response));
+    ASSERT_THAT(response, StrEq("{\"status\":\"error\",\"error\":\"Unknown request: unknown\"}"));
+
+    ASSERT_THAT(count, Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldReturnStats)
+{
+    startServer(2, [](const Options& options) {
+        return options.getInputFilename() != "unknown.wav";
+    });
+
+    JobClient client;
+    ASSERT_TRUE(client.connect(socket_filename_));
+
+    std::string response;
+
+    ASSERT_TRUE(client.sendRequest("stats", response));
+    ASSERT_THAT(response, StartsWith(
+        "{\"status\":\"ok\",\"workers\":2,\"connections\":1,\"active\":0,"
+        "\"queued\":0,\"jobs\":0,\"failed\":0,\"uptime\":"
+    ));
+
+    ASSERT_TRUE(client.sendRequest("run -i test.wav -o test.dat", response));
+    ASSERT_TRUE(client.sendRequest("run -i unknown.wav -o test.dat", response));
+
+    ASSERT_TRUE(client.sendRequest("stats", response));
+    ASSERT_THAT(response, HasSubstr("\"jobs\":2,\"failed\":1,"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldRunJobsFromMultipleConnections)
+{
+    const int clients = 3;
+
+    std::mutex mutex;
+    std::condition_variable started;
+    int started_count = 0;
+
+    // Each job waits until the others have started, so this only succeeds if
+    // the jobs run at the same time
+    startServer(clients, [&](const Options&) {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        ++started_count;
+        started.notify_all();
+
+        return started.wait_for(lock, std::chrono::seconds(5), [&] {
+            return started_count == clients;
+        });
+    });
+
+    std::vector<std::string> responses(clients);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < clients; ++i) {
+        threads.emplace_back([this, i, &responses] {
+            JobClient client;
+
+            if (client.connect(socket_filename_)) {
+                client.sendRequest("run -i test.wav -o test.dat", responses[i]);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& response : responses) {
+        ASSERT_THAT(response, HasSubstr("\"status\":\"ok\""));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldLimitNumberOfConnections)
+{
+    startServer(1, [](const Options&) { return true; }, 2);
+
+    JobClient client1;
+    ASSERT_TRUE(client1.connect(socket_filename_));
+
+    JobClient client2;
+    ASSERT_TRUE(client2.connect(socket_filename_));
+
+    std::string response;
+    ASSERT_TRUE(client1.sendRequest("health", response));
+    ASSERT_TRUE(client2.sendRequest("health", response));
+
+    // The third connection isn't served until another connection closes
+    JobClient client3;
+    ASSERT_TRUE(client3.connect(socket_filename_));
+
+    std::string response3;
+
+    std::future<bool> result = std::async(std::launch::async, [&] {
+        return client3.sendRequest("health", response3);
+    });
+
+    ASSERT_THAT(
+        result.wait_for(std::chrono::milliseconds(500)),
+        Eq(std::future_status::timeout)
+    );
+
+    client1.close();
+
+    ASSERT_TRUE(result.get());
+    ASSERT_THAT(response3, StrEq("{\"status\":\"ok\"}"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldCreateSocketOnlyAccessibleByOwner)
+{
+    const mode_t mask = umask(0);
+
+    startServer(1, [](const Options&) { return true; });
+
+    umask(mask);
+
+    const boost::filesystem::file_status status =
+        boost::filesystem::status(socket_filename_);
+
+    ASSERT_THAT(
+        status.permissions(),
+        Eq(boost::filesystem::owner_read | boost::filesystem::owner_write)
+    );
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldStopOnShutdownRequest)
+{
+    startServer(1, [](const Options&) { return true; });
+
+    JobClient client;
+    ASSERT_TRUE(client.connect(socket_filename_));
+
+    JobClient other_client;
+    ASSERT_TRUE(other_client.connect(socket_filename_));
+
+    std::string response;
+    ASSERT_TRUE(client.sendRequest("shutdown", response));
+    ASSERT_THAT(response, StrEq("{\"status\":\"ok\"}"));
+
+    thread_.join();
+
+    ASSERT_FALSE(boost::filesystem::exists(socket_filename_));
+
+    // Other connections are closed
+    ASSERT_FALSE(other_client.sendRequest("health", response));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldNotReplaceFileThatIsNotSocket)
+{
+    FileDeleter deleter(socket_filename_);
+
+    {
+        std::ofstream file(socket_filename_);
+        file << "test";
+    }
+
+    JobServer server(socket_filename_, 1, [](const Options&) { return true; });
+
+    ASSERT_FALSE(server.listen());
+
+    ASSERT_THAT(error.str(), StrEq(
+        "File exists and is not a socket: " + socket_filename_ + "\n"
+    ));
+
+    ASSERT_THAT(FileUtil::readTextFile(socket_filename_), StrEq("test"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobServerTest, shouldNotListenIfSocketInUse)
+{
+    startServer(1, [](const Options&) { return true; });
+
+    JobServer server(socket_filename_, 1, [](const Options&) { return true; });
+
+    ASSERT_FALSE(server.listen());
+
+    ASSERT_THAT(error.str(), StrEq(
+        "Socket is already in use: " + socket_filename_ + "\n"
+    ));
+
+    JobClient client;
+    ASSERT_TRUE(client.connect(socket_filename_));
+
+    std::string response;
+    ASSERT_TRUE(client.sendRequest("health", response));
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "JobStats.h"
+#include "Config.h"
+
+#include "gmock/gmock.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::EndsWith;
+using testing::Eq;
+using testing::HasSubstr;
+using testing::IsNull;
+using testing::Not;
+using testing::StartsWith;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class JobStatsTest : public Test
+{
+    protected:
+        virtual void TearDown()
+        {
+            JobStats::setThreadStats(nullptr);
+        }
+};
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobStatsTest, shouldWriteStatsAsSingleLineOfJson)
+{
+    JobStats stats;
+    stats.addFrames(44100);
+
+    std::ostringstream stream;
+    stats.write(stream, "test.wav", "test.dat", 1000, 200, true);
+
+    const std::string output = stream.str();
+
+    ASSERT_THAT(output, StartsWith("{\"input\":\"test.wav\",\"output\":\"test.dat\",\"status\":\"ok\","));
+    ASSERT_THAT(output, EndsWith("}\n"));
+    ASSERT_THAT(output.find('\n'), Eq(output.size() - 1));
+
+    ASSERT_THAT(output, HasSubstr("\"wall_time\":"));
+    ASSERT_THAT(output, HasSubstr("\"cpu_time\":"));
+    ASSERT_THAT(output, HasSubstr("\"stages\":{\"open\":{"));
+    ASSERT_THAT(output, HasSubstr("\"decode\":{"));
+    ASSERT_THAT(output, HasSubstr("\"process\":{"));
+    ASSERT_THAT(output, HasSubstr("\"rescale\":{"));
+    ASSERT_THAT(output, HasSubstr("\"render\":{"));
+    ASSERT_THAT(output, HasSubstr("\"encode\":{"));
+    ASSERT_THAT(output, HasSubstr("\"write\":{"));
+    ASSERT_THAT(output, HasSubstr("\"frames\":44100,"));
+    ASSERT_THAT(output, HasSubstr("\"frames_per_second\":"));
+    ASSERT_THAT(output, HasSubstr("\"input_bytes\":1000,"));
+    ASSERT_THAT(output, HasSubstr("\"output_bytes\":200,"));
+    ASSERT_THAT(output, HasSubstr("\"peak_memory\":"));
+
+#if ENABLE_ALLOCATION_STATS
+    ASSERT_THAT(output, HasSubstr("\"allocations\":"));
+    ASSERT_THAT(output, HasSubstr("\"allocated_bytes\":"));
+#else
+    ASSERT_THAT(output, Not(HasSubstr("\"allocations\":")));
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobStatsTest, shouldReportErrorStatus)
+{
+    JobStats stats;
+
+    std::ostringstream stream;
+    stats.write(stream, "test.wav", "test.png", 0, 0, false);
+
+    ASSERT_THAT(stream.str(), HasSubstr("\"status\":\"error\""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobStatsTest, shouldEscapeFilenames)
+{
+    JobStats stats;
+
+    std::ostringstream stream;
+    stats.write(stream, "a\"b.wav", "c\\d.dat", 0, 0, true);
+
+    ASSERT_THAT(stream.str(), HasSubstr("\"input\":\"a\\\"b.wav\""));
+    ASSERT_THAT(stream.str(), HasSubstr("\"output\":\"c\\\\d.dat\""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobStatsTest, shouldRecordStageTimeForCurrentThread)
+{
+    JobStats stats;
+    JobStats::setThreadStats(&stats);
+
+    {
+        StageTimer timer(JobStats::Rescale);
+
+        // Do some work, so the stage takes a measurable amount of time
+        volatile double sum = 0.0;
+
+        for (int i = 0; i < 1000000; ++i) {
+            sum = sum + static_cast<double>(i);
+        }
+    }
+
+    JobStats::setThreadStats(nullptr);
+
+    std::ostringstream stream;
+    stats.write(stream, "", "", 0, 0, true);
+
+    ASSERT_THAT(stream.str(), HasSubstr("\"open\":{\"wall_time\":0.000000,\"cpu_time\":0.000000}"));
+    ASSERT_THAT(stream.str(), Not(HasSubstr("\"rescale\":{\"wall_time\":0.000000,")));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(JobStatsTest, shouldNotRecordIfNoStatsSet)
+{
+    ASSERT_THAT(JobStats::getThreadStats(), IsNull());
+
+    // Shouldn't crash
+    StageTimer timer(JobStats::Render);
+    timer.exclude(JobStats::now());
+}
+
+//------------------------------------------------------------------------------
+
+#if ENABLE_ALLOCATION_STATS
+
+TEST_F(JobStatsTest, shouldCountAllocations)
+{
+    JobStats stats;
+
+    std::vector<std::unique_ptr<int>> values;
+
+    for (int i = 0; i < 10; ++i) {
+        values.emplace_back(new int(i));
+    }
+
+    std::ostringstream stream;
+    stats.write(stream, "", "", 0, 0, true);
+
+    ASSERT_THAT(stream.str(), Not(HasSubstr("\"allocations\":0,")));
+    ASSERT_THAT(stream.str(), Not(HasSubstr("\"allocated_bytes\":0}")));
+}
+
+#endif
+
+//------------------------------------------------------------------------------
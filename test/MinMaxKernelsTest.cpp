@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "MinMaxKernels.h"
+#include "WaveformBuffer.h"
+
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::Ge;
+
+//------------------------------------------------------------------------------
+
+static std::vector<short> createSamples(int frames, int channels, unsigned int seed)
+{
+    std::mt19937 random(seed);
+
+    std::uniform_int_distribution<int> distribution(
+        std::numeric_limits<short>::min(),
+        std::numeric_limits<short>::max()
+    );
+
+    std::vector<short> samples(static_cast<size_t>(frames * channels));
+
+    for (auto& sample : samples) {
+        sample = static_cast<short>(distribution(random));
+    }
+
+    // Include the extreme values, which exercise rounding when mixing
+    if (samples.size() >= 4) {
+        samples[0] = std::numeric_limits<short>::min();
+        samples[1] = std::numeric_limits<short>::min() + 1;
+        samples[samples.size() - 2] = std::numeric_limits<short>::max();
+        samples[samples.size() - 1] = std::numeric_limits<short>::max();
+    }
+
+    return samples;
+}
+
+//------------------------------------------------------------------------------
+
+static void checkKernelSet(
+    const MinMaxKernels::KernelSet& kernel_set,
+    int channels,
+    bool split_channels)
+{
+    const MinMaxKernels::Kernel expected_kernel = MinMaxKernels::selectKernel(
+        MinMaxKernels::getScalarKernelSet(), channels, split_channels
+    );
+
+    const MinMaxKernels::Kernel actual_kernel = MinMaxKernels::selectKernel(
+        kernel_set, channels, split_channels
+    );
+
+    const int output_channels = split_channels ? channels : 1;
+
+    const int frame_counts[] = { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 64, 100, 257, 1000 };
+
+    unsigned int seed = 1;
+
+    for (int frames : frame_counts) {
+        const std::vector<short> samples = createSamples(frames, channels, seed++);
+
+        // Start from both the initial reset values and from values already
+        // within the sample range, as when continuing an output point
+        const int initial_values[][2] = {
+            { std::numeric_limits<short>::max(), std::numeric_limits<short>::min() },
+            { -100, 100 }
+        };
+
+        for (const auto& initial : initial_values) {
+            std::vector<int> expected_min(static_cast<size_t>(output_channels), initial[0]);
+            std::vector<int> expected_max(static_cast<size_t>(output_channels), initial[1]);
+
+            std::vector<int> actual_min(expected_min);
+            std::vector<int> actual_max(expected_max);
+
+            const short* input = samples.empty() ? nullptr : &samples[0];
+
+            expected_kernel(input, frames, channels, &expected_min[0], &expected_max[0]);
+            actual_kernel(input, frames, channels, &actual_min[0], &actual_max[0]);
+
+            ASSERT_THAT(actual_min, Eq(expected_min))
+                << kernel_set.name << ": channels " << channels
+                << ", split " << split_channels << ", frames " << frames;
+
+            ASSERT_THAT(actual_max, Eq(expected_max))
+                << kernel_set.name << ": channels " << channels
+                << ", split " << split_channels << ", frames " << frames;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST(MinMaxKernelsTest, shouldAlwaysSupportScalarKernels)
+{
+    const std::vector<const MinMaxKernels::KernelSet*> kernel_sets =
+        MinMaxKernels::getSupportedKernelSets();
+
+    ASSERT_THAT(kernel_sets.size(), Ge(1U));
+    ASSERT_THAT(kernel_sets[0], Eq(&MinMaxKernels::getScalarKernelSet()));
+}
+
+//------------------------------------------------------------------------------
+
+TEST(MinMaxKernelsTest, shouldSelectSupportedKernelSet)
+{
+    const std::vector<const MinMaxKernels::KernelSet*> kernel_sets =
+        MinMaxKernels::getSupportedKernelSets();
+
+    const MinMaxKernels::KernelSet* kernel_set = &MinMaxKernels::getKernelSet();
+
+    ASSERT_TRUE(
+        std::find(kernel_sets.begin(), kernel_sets.end(), kernel_set) != kernel_sets.end()
+    );
+}
+
+//------------------------------------------------------------------------------
+
+TEST(MinMaxKernelsTest, shouldMatchScalarKernelsWhenMixingChannels)
+{
+    for (const auto* kernel_set : MinMaxKernels::getSupportedKernelSets()) {
+        for (int channels = 1; channels <= WaveformBuffer::MAX_CHANNELS; ++channels) {
+            checkKernelSet(*kernel_set, channels, false);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST(MinMaxKernelsTest, shouldMatchScalarKernelsWhenSplittingChannels)
+{
+    for (const auto* kernel_set : MinMaxKernels::getSupportedKernelSets()) {
+        for (int channels = 1; channels <= WaveformBuffer::MAX_CHANNELS; ++channels) {
+            checkKernelSet(*kernel_set, channels, true);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST(MinMaxKernelsTest, shouldRoundMixedValuesTowardsZero)
+{
+    for (const auto* kernel_set : MinMaxKernels::getSupportedKernelSets()) {
+        // 16 frames, each with left = -3, right = 0, average -1.5
+        std::vector<short> samples;
+
+        for (int i = 0; i < 16; ++i) {
+            samples.push_back(-3);
+            samples.push_back(0);
+        }
+
+        int min = std::numeric_limits<short>::max();
+        int max = std::numeric_limits<short>::min();
+
+        kernel_set->stereo_mix(&samples[0], 16, 2, &min, &max);
+
+        ASSERT_THAT(min, Eq(-1)) << kernel_set->name;
+        ASSERT_THAT(max, Eq(-1)) << kernel_set->name;
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -23,16 +23,24 @@
 
 #include "Mp3AudioFileReader.h"
 #include "mocks/MockAudioProcessor.h"
+#include "util/FileDeleter.h"
+#include "util/FileUtil.h"
 #include "util/Streams.h"
 
 #include "gmock/gmock.h"
 
+#include <boost/filesystem.hpp>
+
+#include <vector>
+
 //------------------------------------------------------------------------------
 
 using testing::_;
 using testing::EndsWith;
 using testing::Eq;
+using testing::HasSubstr;
 using testing::InSequence;
+using testing::Not;
 using testing::Return;
 using testing::StartsWith;
 using testing::StrEq;
@@ -334,6 +342,130 @@ TEST_F(Mp3AudioFileReaderTest, shouldNotProcessFileMoreThanOnce)
     ASSERT_TRUE(error.str().empty());
 }
 
+class SampleCollector : public AudioProcessor
+{
+    public:
+        SampleCollector()
+        {
+        }
+
+    public:
+        virtual bool init(
+            int /* sample_rate */,
+            int /* channels */,
+            long /* frame_count */,
+            int /* buffer_size */)
+        {
+            return true;
+        }
+
+        virtual bool shouldContinue() const
+        {
+            return true;
+        }
+
+        virtual bool process(
+            const short* input_buffer,
+            int input_frame_count)
+        {
+            samples_.insert(
+                samples_.end(),
+                input_buffer,
+                input_buffer + input_frame_count * 2
+            );
+
+            return true;
+        }
+
+        virtual void done()
+        {
+        }
+
+    public:
+        const std::vector<short>& getSamples() const
+        {
+            return samples_;
+        }
+
+    private:
+        std::vector<short> samples_;
+};
+
+//------------------------------------------------------------------------------
+
+// Checks that reading a frame range gives the same samples as reading the
+// whole file.
+
+static void testFrameRange(
+    const char* filename,
+    const std::string& index_filename,
+    long long start_frame,
+    long long end_frame)
+{
+    SampleCollector expected;
+
+    Mp3AudioFileReader full_reader;
+    ASSERT_TRUE(full_reader.open(filename));
+    ASSERT_TRUE(full_reader.run(expected));
+
+    SampleCollector processor;
+
+    Mp3AudioFileReader reader;
+    ASSERT_TRUE(reader.open(filename));
+
+    if (!index_filename.empty()) {
+        reader.setFrameIndexFilename(index_filename);
+    }
+
+    ASSERT_TRUE(reader.setFrameRange(start_frame, end_frame));
+    ASSERT_TRUE(reader.run(processor));
+
+    const std::vector<short>& expected_samples = expected.getSamples();
+
+    ASSERT_THAT(
+        std::vector<short>(
+            expected_samples.begin() + start_frame * 2,
+            expected_samples.begin() + end_frame * 2
+        ),
+        Eq(processor.getSamples())
+    );
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3AudioFileReaderTest, shouldReadFrameRange)
+{
+    testFrameRange("../test/data/test_file_stereo.mp3", "", 40000, 60000);
+
+    ASSERT_THAT(error.str(), Not(HasSubstr("Unrecoverable")));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3AudioFileReaderTest, shouldReadFrameRangeUsingFrameIndex)
+{
+    const boost::filesystem::path mp3_filename = FileUtil::getTempFilename(".mp3");
+    const boost::filesystem::path index_filename = mp3_filename.string() + ".idx";
+
+    FileDeleter mp3_file_deleter(mp3_filename);
+    FileDeleter index_file_deleter(index_filename);
+
+    boost::filesystem::copy_file("../test/data/test_file_stereo.mp3", mp3_filename);
+
+    testFrameRange(mp3_filename.c_str(), index_filename.string(), 40000, 60000);
+
+    ASSERT_THAT(error.str(), HasSubstr("Creating MP3 frame index: "));
+    ASSERT_TRUE(boost::filesystem::exists(index_filename));
+
+    // The second time, the index is read from the file
+    error.str(std::string());
+
+    testFrameRange(mp3_filename.c_str(), index_filename.string(), 3, 100000);
+
+    ASSERT_THAT(error.str(), Not(HasSubstr("Creating MP3 frame index: ")));
+    ASSERT_THAT(error.str(), Not(HasSubstr("doesn't match")));
+}
+
 //------------------------------------------------------------------------------
 /*
 TEST_F(Mp3AudioFileReaderTest, shouldReportErrorIfNotAnMp3File)
@@ -0,0 +1,498 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Mp3FrameIndex.h"
+#include "util/FileDeleter.h"
+#include "util/FileUtil.h"
+#include "util/Streams.h"
+
+#include "gmock/gmock.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::Ge;
+using testing::Not;
+using testing::StartsWith;
+using testing::StrEq;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class Mp3FrameIndexTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+        }
+
+        virtual void TearDown()
+        {
+        }
+};
+
+//------------------------------------------------------------------------------
+
+// Appends an MPEG-1 layer III frame, 128 kbit/s, 44.1 kHz, stereo, with no
+// audio data. Returns the frame length.
+
+static size_t appendFrame(
+    std::vector<unsigned char>& data,
+    bool padding,
+    int main_data_begin)
+{
+    const size_t length = padding ? 418 : 417;
+
+    const size_t offset = data.size();
+    data.resize(offset + length, 0);
+
+    data[offset]     = 0xff;
+    data[offset + 1] = 0xfb;
+    data[offset + 2] = padding ? 0x92 : 0x90;
+    data[offset + 3] = 0x00;
+    data[offset + 4] = static_cast<unsigned char>(main_data_begin >> 1);
+    data[offset + 5] = static_cast<unsigned char>((main_data_begin & 1) << 7);
+
+    return length;
+}
+
+//------------------------------------------------------------------------------
+
+static void appendId3Tag(std::vector<unsigned char>& data)
+{
+    const unsigned char header[] = { 'I', 'D', '3', 3, 0, 0, 0, 0, 0, 20 };
+
+    data.insert(data.end(), header, header + sizeof(header));
+    data.resize(data.size() + 20, 0);
+}
+
+//------------------------------------------------------------------------------
+
+static void writeFile(
+    const boost::filesystem::path& filename,
+    const std::vector<unsigned char>& data)
+{
+    std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary);
+
+    stream.write(
+        reinterpret_cast<const char*>(data.data()),
+        static_cast<std::streamsize>(data.size())
+    );
+}
+
+//------------------------------------------------------------------------------
+
+// Creates a file with an ID3 tag, then 5 frames, some data that isn't a
+// frame, another 5 frames, and finally an incomplete frame.
+
+static std::vector<long long> createTestFile(const boost::filesystem::path& filename)
+{
+    const int main_data_begin[] = { 0, 0, 0, 500, 0, 0, 0, 0, 0, 0 };
+
+    std::vector<unsigned char> data;
+    std::vector<long long> offsets;
+
+    appendId3Tag(data);
+
+    for (int i = 0; i < 10; ++i) {
+        if (i == 5) {
+            data.resize(data.size() + 100, 0x55);
+        }
+
+        offsets.push_back(static_cast<long long>(data.size()));
+        appendFrame(data, i % 2 == 1, main_data_begin[i]);
+    }
+
+    std::vector<unsigned char> frame;
+    appendFrame(frame, false, 0);
+
+    data.insert(data.end(), frame.begin(), frame.begin() + 200);
+
+    writeFile(filename, data);
+
+    return offsets;
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldFindFramePositions)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    FileDeleter deleter(filename);
+
+    const std::vector<long long> offsets = createTestFile(filename);
+
+    Mp3FrameIndex index;
+
+    bool result = index.build(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(index.getSampleRate(), Eq(44100));
+    ASSERT_THAT(index.getSamplesPerFrame(), Eq(1152));
+    ASSERT_THAT(index.getFrameCount(), Eq(offsets.size()));
+
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        ASSERT_THAT(index.getFrameOffset(i), Eq(offsets[i]));
+    }
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldFindLowSamplingFrequencyFrames)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    FileDeleter deleter(filename);
+
+    // MPEG-2 layer III, 128 kbit/s, 16 kHz: 576 bytes per frame
+    std::vector<unsigned char> data(3 * 576, 0);
+
+    for (size_t offset = 0; offset < data.size(); offset += 576) {
+        data[offset]     = 0xff;
+        data[offset + 1] = 0xf3;
+        data[offset + 2] = 0xc8;
+        data[offset + 3] = 0x00;
+    }
+
+    writeFile(filename, data);
+
+    Mp3FrameIndex index;
+
+    bool result = index.build(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(index.getSampleRate(), Eq(16000));
+    ASSERT_THAT(index.getSamplesPerFrame(), Eq(576));
+    ASSERT_THAT(index.getFrameCount(), Eq(3U));
+    ASSERT_THAT(index.getFrameOffset(2), Eq(2 * 576));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldReturnPrerollFrame)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    FileDeleter deleter(filename);
+
+    createTestFile(filename);
+
+    Mp3FrameIndex index;
+
+    bool result = index.build(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(index.getPrerollFrame(0), Eq(0U));
+    ASSERT_THAT(index.getPrerollFrame(1), Eq(0U));
+
+    // Frame 3 uses 500 bytes from frames 1 and 2
+    ASSERT_THAT(index.getPrerollFrame(5), Eq(0U));
+    ASSERT_THAT(index.getPrerollFrame(6), Eq(3U));
+
+    ASSERT_THAT(index.getPrerollFrame(9), Eq(6U));
+    ASSERT_THAT(index.getPrerollFrame(100), Eq(6U));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldFailIfFreeFormat)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    FileDeleter deleter(filename);
+
+    std::vector<unsigned char> data(1000, 0);
+
+    data[0] = 0xff;
+    data[1] = 0xfb;
+    data[2] = 0x00;
+
+    writeFile(filename, data);
+
+    Mp3FrameIndex index;
+
+    bool result = index.build(filename.c_str());
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq("Free format MP3 files are not supported\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldReportErrorIfFileNotFound)
+{
+    Mp3FrameIndex index;
+
+    bool result = index.build("../test/data/unknown.mp3");
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith(
+        "Failed to read file: ../test/data/unknown.mp3\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldSaveAndLoadIndex)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    const boost::filesystem::path index_filename = FileUtil::getTempFilename(".idx");
+
+    FileDeleter deleter(filename);
+    FileDeleter index_deleter(index_filename);
+
+    const std::vector<long long> offsets = createTestFile(filename);
+
+    Mp3FrameIndex index;
+
+    bool result = index.build(filename.c_str());
+    ASSERT_TRUE(result);
+
+    result = index.save(index_filename.c_str(), filename.c_str());
+    ASSERT_TRUE(result);
+
+    Mp3FrameIndex loaded_index;
+
+    result = loaded_index.load(index_filename.c_str(), filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(loaded_index.getSampleRate(), Eq(44100));
+    ASSERT_THAT(loaded_index.getSamplesPerFrame(), Eq(1152));
+    ASSERT_THAT(loaded_index.getFrameCount(), Eq(offsets.size()));
+
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        ASSERT_THAT(loaded_index.getFrameOffset(i), Eq(offsets[i]));
+        ASSERT_THAT(loaded_index.getPrerollFrame(i), Eq(index.getPrerollFrame(i)));
+    }
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldReplaceExistingIndex)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    const boost::filesystem::path index_filename = FileUtil::getTempFilename(".idx");
+
+    FileDeleter deleter(filename);
+    FileDeleter index_deleter(index_filename);
+
+    const std::vector<long long> offsets = createTestFile(filename);
+
+    writeFile(index_filename, std::vector<unsigned char>(100, 'x'));
+
+    Mp3FrameIndex index;
+
+    bool result = index.build(filename.c_str());
+    ASSERT_TRUE(result);
+
+    result = index.save(index_filename.c_str(), filename.c_str());
+    ASSERT_TRUE(result);
+
+    Mp3FrameIndex loaded_index;
+
+    result = loaded_index.load(index_filename.c_str(), filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(loaded_index.getFrameCount(), Eq(offsets.size()));
+
+    // Check the temporary file has been renamed
+
+    const std::string temp_prefix = index_filename.filename().string() + ".";
+
+    for (const auto& entry : boost::filesystem::directory_iterator(index_filename.parent_path())) {
+        ASSERT_THAT(entry.path().filename().string(), Not(StartsWith(temp_prefix)));
+    }
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldReportErrorIfIndexCannotBeWritten)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    const boost::filesystem::path index_filename =
+        FileUtil::getTempFilename() / "test.idx";
+
+    FileDeleter deleter(filename);
+
+    createTestFile(filename);
+
+    Mp3FrameIndex index;
+
+    bool result = index.build(filename.c_str());
+    ASSERT_TRUE(result);
+
+    result = index.save(index_filename.c_str(), filename.c_str());
+    ASSERT_FALSE(result);
+
+    ASSERT_FALSE(boost::filesystem::exists(index_filename));
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith(
+        "Failed to write file: " + index_filename.string() + "\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldNotLoadIndexIfFileHasChanged)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    const boost::filesystem::path index_filename = FileUtil::getTempFilename(".idx");
+
+    FileDeleter deleter(filename);
+    FileDeleter index_deleter(index_filename);
+
+    createTestFile(filename);
+
+    Mp3FrameIndex index;
+
+    bool result = index.build(filename.c_str());
+    ASSERT_TRUE(result);
+
+    result = index.save(index_filename.c_str(), filename.c_str());
+    ASSERT_TRUE(result);
+
+    std::vector<unsigned char> data;
+    appendFrame(data, false, 0);
+    writeFile(filename, data);
+
+    Mp3FrameIndex loaded_index;
+
+    result = loaded_index.load(index_filename.c_str(), filename.c_str());
+    ASSERT_FALSE(result);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldNotLoadInvalidIndex)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    const boost::filesystem::path index_filename = FileUtil::getTempFilename(".idx");
+
+    FileDeleter deleter(filename);
+    FileDeleter index_deleter(index_filename);
+
+    createTestFile(filename);
+
+    Mp3FrameIndex index;
+
+    // Index file doesn't exist
+    bool result = index.load(index_filename.c_str(), filename.c_str());
+    ASSERT_FALSE(result);
+
+    writeFile(index_filename, std::vector<unsigned char>(100, 'x'));
+
+    result = index.load(index_filename.c_str(), filename.c_str());
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(index.getFrameCount(), Eq(0U));
+}
+
+//------------------------------------------------------------------------------
+
+// Checks that an index with an invalid sample rate, frame size, or frame
+// count isn't loaded. The frame count is checked before allocating memory
+// for the frames.
+
+TEST_F(Mp3FrameIndexTest, shouldNotLoadIndexWithInvalidValues)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".mp3");
+    const boost::filesystem::path index_filename = FileUtil::getTempFilename(".idx");
+
+    FileDeleter deleter(filename);
+    FileDeleter index_deleter(index_filename);
+
+    createTestFile(filename);
+
+    Mp3FrameIndex index;
+
+    bool result = index.build(filename.c_str());
+    ASSERT_TRUE(result);
+
+    result = index.save(index_filename.c_str(), filename.c_str());
+    ASSERT_TRUE(result);
+
+    const std::vector<uint8_t> index_data = FileUtil::readFile(index_filename);
+
+    // Offsets of the sample rate, samples per frame, and frame count, after
+    // the magic number, version, file size, and file time
+    const size_t sample_rate_offset       = 24;
+    const size_t samples_per_frame_offset = 28;
+    const size_t frame_count_offset       = 32;
+
+    ASSERT_THAT(index_data.size(), Ge(frame_count_offset + 4));
+
+    const struct {
+        size_t offset;
+        uint32_t value;
+    } invalid_values[] = {
+        { sample_rate_offset, 0 },
+        { sample_rate_offset, 0xffffffff }, // -1
+        { samples_per_frame_offset, 0 },
+        { samples_per_frame_offset, 0xffffffff }, // -1
+        { frame_count_offset, 11 },
+        { frame_count_offset, 0xffffffff }
+    };
+
+    for (const auto& invalid_value : invalid_values) {
+        std::vector<unsigned char> data(index_data.begin(), index_data.end());
+
+        memcpy(&data[invalid_value.offset], &invalid_value.value, sizeof(invalid_value.value));
+
+        writeFile(index_filename, data);
+
+        Mp3FrameIndex loaded_index;
+
+        result = loaded_index.load(index_filename.c_str(), filename.c_str());
+        ASSERT_FALSE(result);
+
+        ASSERT_THAT(loaded_index.getFrameCount(), Eq(0U));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(Mp3FrameIndexTest, shouldReturnIndexFilename)
+{
+    ASSERT_THAT(
+        Mp3FrameIndex::getIndexFilename("test.mp3"),
+        StrEq("test.mp3.idx")
+    );
+}
+
+//------------------------------------------------------------------------------
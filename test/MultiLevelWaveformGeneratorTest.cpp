@@ -0,0 +1,221 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "MultiLevelWaveformGenerator.h"
+#include "VectorAudioFileReader.h"
+#include "WaveformBuffer.h"
+#include "WaveformGenerator.h"
+#include "util/Streams.h"
+#include "util/WaveformUtil.h"
+
+#include "gmock/gmock.h"
+
+#include <memory>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::HasSubstr;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class MultiLevelWaveformGeneratorTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+        }
+
+        virtual void TearDown()
+        {
+        }
+};
+
+//------------------------------------------------------------------------------
+
+// Checks that each zoom level matches the output of a WaveformGenerator for
+// that zoom level alone.
+
+static void testMultipleLevels(int channels, bool split_channels)
+{
+    const int sample_rate = 44100;
+
+    // 100,000 frames, which isn't a multiple of any of the zoom levels
+    const std::vector<short> samples = WaveformUtil::createSamples(100000, channels);
+
+    // 128, 256, and 512 are folded from 64, 300 is folded from 100, and 100
+    // and 70 are computed from the audio
+    const int zoom_levels[] = { 256, 64, 100, 128, 512, 300, 70 };
+
+    std::vector<std::unique_ptr<SamplesPerPixelScaleFactor>> scale_factors;
+    std::vector<std::unique_ptr<WaveformBuffer>> buffers;
+
+    MultiLevelWaveformGenerator generator(split_channels);
+
+    for (int zoom : zoom_levels) {
+        scale_factors.emplace_back(new SamplesPerPixelScaleFactor(zoom));
+        buffers.emplace_back(new WaveformBuffer);
+
+        generator.addLevel(*buffers.back(), *scale_factors.back());
+    }
+
+    VectorAudioFileReader reader(samples, sample_rate, channels);
+
+    ASSERT_TRUE(reader.run(generator));
+
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        WaveformBuffer expected_buffer;
+        WaveformGenerator expected_generator(expected_buffer, split_channels, *scale_factors[i]);
+
+        VectorAudioFileReader expected_reader(samples, sample_rate, channels);
+
+        ASSERT_TRUE(expected_reader.run(expected_generator));
+
+        WaveformUtil::compareBuffers(*buffers[i], expected_buffer);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(MultiLevelWaveformGeneratorTest, shouldGenerateMonoLevels)
+{
+    testMultipleLevels(1, false);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(MultiLevelWaveformGeneratorTest, shouldGenerateStereoLevels)
+{
+    testMultipleLevels(2, false);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(MultiLevelWaveformGeneratorTest, shouldGenerateSplitChannelLevels)
+{
+    testMultipleLevels(3, true);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(MultiLevelWaveformGeneratorTest, shouldFoldFromFinerLevels)
+{
+    const std::vector<short> samples = WaveformUtil::createSamples(1000, 1);
+
+    SamplesPerPixelScaleFactor scale_factor_64(64);
+    SamplesPerPixelScaleFactor scale_factor_256(256);
+
+    WaveformBuffer buffer_64;
+    WaveformBuffer buffer_256;
+
+    MultiLevelWaveformGenerator generator(false);
+
+    generator.addLevel(buffer_256, scale_factor_256);
+    generator.addLevel(buffer_64, scale_factor_64);
+
+    VectorAudioFileReader reader(samples, 44100, 1);
+
+    ASSERT_TRUE(reader.run(generator));
+
+    ASSERT_THAT(buffer_64.getSize(), Eq(16)); // 1000 / 64 = 15 remainder 40
+    ASSERT_THAT(buffer_256.getSize(), Eq(4)); // 1000 / 256 = 3 remainder 232
+
+    ASSERT_THAT(error.str(), HasSubstr("Samples per pixel: 256 (from 64)\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(MultiLevelWaveformGeneratorTest, shouldFailIfZoomLevelIsTooSmall)
+{
+    const std::vector<short> samples = WaveformUtil::createSamples(1000, 1);
+
+    SamplesPerPixelScaleFactor scale_factor_1(1);
+    SamplesPerPixelScaleFactor scale_factor_64(64);
+
+    WaveformBuffer buffer_1;
+    WaveformBuffer buffer_64;
+
+    MultiLevelWaveformGenerator generator(false);
+
+    generator.addLevel(buffer_64, scale_factor_64);
+    generator.addLevel(buffer_1, scale_factor_1);
+
+    VectorAudioFileReader reader(samples, 44100, 1);
+
+    ASSERT_FALSE(reader.run(generator));
+
+    ASSERT_THAT(error.str(), HasSubstr("Invalid zoom: minimum 2\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(MultiLevelWaveformGeneratorTest, shouldGenerateLevelsFromFloatingPointInput)
+{
+    const int sample_rate = 44100;
+    const int channels    = 2;
+    const int frames      = 10000;
+
+    const std::vector<short> short_samples = WaveformUtil::createSamples(frames, channels);
+
+    std::vector<float> samples(short_samples.size());
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<float>(short_samples[i]) / 32768.0f;
+    }
+
+    SamplesPerPixelScaleFactor scale_factor_64(64);
+    SamplesPerPixelScaleFactor scale_factor_100(100);
+    SamplesPerPixelScaleFactor scale_factor_256(256);
+
+    const SamplesPerPixelScaleFactor* scale_factors[] = {
+        &scale_factor_64, &scale_factor_100, &scale_factor_256
+    };
+
+    WaveformBuffer buffers[3];
+
+    MultiLevelWaveformGenerator generator(true);
+
+    for (int i = 0; i < 3; ++i) {
+        generator.addLevel(buffers[i], *scale_factors[i]);
+    }
+
+    ASSERT_TRUE(generator.supportsFloat());
+    ASSERT_TRUE(generator.init(sample_rate, channels, frames, frames * channels));
+    ASSERT_TRUE(generator.processFloat(&samples[0], frames));
+    generator.done();
+
+    for (int i = 0; i < 3; ++i) {
+        WaveformBuffer expected_buffer;
+        WaveformGenerator expected_generator(expected_buffer, true, *scale_factors[i]);
+
+        ASSERT_TRUE(expected_generator.init(sample_rate, channels, frames, frames * channels));
+        ASSERT_TRUE(expected_generator.processFloat(&samples[0], frames));
+        expected_generator.done();
+
+        WaveformUtil::compareBuffers(buffers[i], expected_buffer);
+    }
+}
+
+//------------------------------------------------------------------------------
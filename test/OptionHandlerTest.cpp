@@ -31,7 +31,12 @@
 #include "gmock/gmock.h"
 
 #include <gd.h>
+#include <fcntl.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
 
 //------------------------------------------------------------------------------
 
@@ -130,8 +135,9 @@ static void compareImages(
 
     for (int y = 0; y < ref_height; ++y) {
         for (int x = 0; x < ref_width; ++x) {
-            const int test_pixel = gdImageGetPixel(test_image, x, y);
-            const int ref_pixel  = gdImageGetPixel(ref_image,  x, y);
+            // Compare colors, as either image may be an indexed color image
+            const int test_pixel = gdImageGetTrueColorPixel(test_image, x, y);
+            const int ref_pixel  = gdImageGetTrueColorPixel(ref_image,  x, y);
 
             ASSERT_THAT(test_pixel, Eq(ref_pixel));
         }
@@ -493,6 +499,15 @@ TEST_F(OptionHandlerTest, shouldGenerate2ChannelBinaryWaveformDataFromWavAudio)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionHandlerTest, shouldGenerateVersion3BinaryWaveformDataFromWavAudio)
+{
+    std::vector<const char*> args{ "-b", "8", "-z", "64", "--format-version", "3" };
+
+    runTests("test_file_stereo.wav", FileFormat::Wav, FileFormat::Dat, &args, true, "test_file_stereo_8bit_64spp_wav_v3.dat");
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionHandlerTest, shouldGenerateBinaryWaveformDataFromFloatingPointWavAudio)
 {
     std::vector<const char*> args{ "-b", "8", "-z", "64" };
@@ -625,6 +640,326 @@ TEST_F(OptionHandlerTest, shouldGenerateJsonWaveformDataWithAutoAmplitudeScale)
     runTests("test_file_stereo.wav", FileFormat::Wav, FileFormat::Json, &args, true, "test_file_stereo_8bit_64spp_wav_auto_scale.json");
 }
 
+//------------------------------------------------------------------------------
+
+static int runCommand(const std::string& args, std::string& error)
+{
+    const boost::filesystem::path stderr_pathname =
+        FileUtil::getTempFilename(".txt");
+
+    FileDeleter stderr_file_deleter(stderr_pathname);
+
+    const std::string command_line =
+        "./audiowaveform " + args + " 2>" + stderr_pathname.string();
+
+    const int result = system(command_line.c_str());
+
+    error = FileUtil::readTextFile(stderr_pathname);
+
+    return result == -1 ? -1 : WEXITSTATUS(result);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldGenerateMultipleZoomLevelsFromWavAudio)
+{
+    const boost::filesystem::path output_pathname = FileUtil::getTempFilename(".dat");
+
+    const boost::filesystem::path directory = output_pathname.parent_path();
+    const std::string stem = output_pathname.stem().string();
+
+    // 128 is folded from 64, 100 is computed from the audio
+    const boost::filesystem::path level_64_pathname  = directory / (stem + "-64.dat");
+    const boost::filesystem::path level_128_pathname = directory / (stem + "-128.dat");
+    const boost::filesystem::path level_100_pathname = directory / (stem + "-100.dat");
+
+    const boost::filesystem::path ref_128_pathname = FileUtil::getTempFilename(".dat");
+    const boost::filesystem::path ref_100_pathname = FileUtil::getTempFilename(".dat");
+
+    FileDeleter level_64_file_deleter(level_64_pathname);
+    FileDeleter level_128_file_deleter(level_128_pathname);
+    FileDeleter level_100_file_deleter(level_100_pathname);
+    FileDeleter ref_128_file_deleter(ref_128_pathname);
+    FileDeleter ref_100_file_deleter(ref_100_pathname);
+
+    const std::string input_args = "-i ../test/data/test_file_stereo.wav -b 8";
+
+    std::string error;
+
+    ASSERT_THAT(runCommand(input_args + " -o " + output_pathname.string() + " -z 128,64,100", error), Eq(0));
+    ASSERT_THAT(error, EndsWith("Done\n"));
+
+    ASSERT_FALSE(boost::filesystem::exists(output_pathname));
+
+    ASSERT_THAT(runCommand(input_args + " -o " + ref_128_pathname.string() + " -z 128", error), Eq(0));
+    ASSERT_THAT(runCommand(input_args + " -o " + ref_100_pathname.string() + " -z 100", error), Eq(0));
+
+    compareFiles(level_64_pathname, "../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    compareFiles(level_128_pathname, ref_128_pathname);
+    compareFiles(level_100_pathname, ref_100_pathname);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldFailIfMultipleZoomLevelsWrittenToStandardOutput)
+{
+    std::string error;
+
+    const int exit_status = runCommand(
+        "-i ../test/data/test_file_stereo.wav --output-format dat -z 64,128 >/dev/null",
+        error
+    );
+
+    ASSERT_THAT(exit_status, Eq(1));
+    ASSERT_THAT(error, EndsWith("Cannot write multiple zoom levels to standard output\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldGenerateMultipleOutputFilesFromWavAudio)
+{
+    const boost::filesystem::path dat_pathname   = FileUtil::getTempFilename(".dat");
+    const boost::filesystem::path json_pathname  = FileUtil::getTempFilename(".json");
+    const boost::filesystem::path image_pathname = FileUtil::getTempFilename(".png");
+    const boost::filesystem::path auto_pathname  = FileUtil::getTempFilename(".png");
+
+    FileDeleter dat_file_deleter(dat_pathname);
+    FileDeleter json_file_deleter(json_pathname);
+    FileDeleter image_file_deleter(image_pathname);
+    FileDeleter auto_file_deleter(auto_pathname);
+
+    std::string error;
+
+    const int exit_status = runCommand(
+        "-i ../test/data/test_file_stereo.wav -b 8"
+        " -o " + dat_pathname.string() + ":zoom=64"
+        " -o " + json_pathname.string() + ":zoom=64"
+        " -o " + image_pathname.string() + ":zoom=128"
+        " -o " + auto_pathname.string() + ":zoom=auto,width=500,height=150",
+        error
+    );
+
+    ASSERT_THAT(exit_status, Eq(0));
+    ASSERT_THAT(error, EndsWith("Done\n"));
+
+    compareFiles(dat_pathname, "../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    compareFiles(json_pathname, "../test/data/test_file_stereo_8bit_64spp_wav.json");
+    compareImageFiles(image_pathname, "../test/data/test_file_stereo_wav_128spp.png");
+    compareImageFiles(auto_pathname, "../test/data/test_file_stereo_wav_500.png");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldGenerateMultipleOutputFilesFromBinaryWaveformData)
+{
+    const boost::filesystem::path json_pathname  = FileUtil::getTempFilename(".json");
+    const boost::filesystem::path image_pathname = FileUtil::getTempFilename(".png");
+
+    FileDeleter json_file_deleter(json_pathname);
+    FileDeleter image_file_deleter(image_pathname);
+
+    std::string error;
+
+    const int exit_status = runCommand(
+        "-i ../test/data/test_file_stereo_8bit_64spp_wav.dat"
+        " -o " + json_pathname.string() +
+        " -o " + image_pathname.string() + ":zoom=128",
+        error
+    );
+
+    ASSERT_THAT(exit_status, Eq(0));
+    ASSERT_THAT(error, EndsWith("Done\n"));
+
+    compareFiles(json_pathname, "../test/data/test_file_stereo_8bit_64spp_wav.json");
+    compareImageFiles(image_pathname, "../test/data/test_file_stereo_dat_128spp.png");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldFailIfMultipleOutputFilesIncludeAudio)
+{
+    std::string error;
+
+    const int exit_status = runCommand(
+        "-i ../test/data/test_file_stereo.mp3 -o test.wav -o test.dat",
+        error
+    );
+
+    ASSERT_THAT(exit_status, Eq(1));
+    ASSERT_THAT(error, EndsWith("Can't generate wav format output with more than one output file\n"));
+
+    ASSERT_FALSE(boost::filesystem::exists("test.wav"));
+    ASSERT_FALSE(boost::filesystem::exists("test.dat"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderTilesFromWavAudio)
+{
+    const boost::filesystem::path directory = FileUtil::getTempFilename();
+    const boost::filesystem::path image_pathname = FileUtil::getTempFilename(".png");
+
+    FileDeleter image_file_deleter(image_pathname);
+
+    std::string error;
+
+    const int exit_status = runCommand(
+        "-i ../test/data/test_file_stereo.wav -o " + directory.string() +
+        " --tiles --tile-width 256 -h 100 -z 64 --threads 2",
+        error
+    );
+
+    ASSERT_THAT(exit_status, Eq(0));
+    ASSERT_THAT(error, EndsWith("Done\n"));
+
+    ASSERT_TRUE(boost::filesystem::is_regular_file(directory / "manifest.json"));
+    ASSERT_TRUE(boost::filesystem::is_regular_file(directory / "1" / "0.png"));
+
+    // The first tile is the same as an image of the start of the audio
+    ASSERT_THAT(runCommand("-i ../test/data/test_file_stereo.wav -o " + image_pathname.string() + " -w 256 -h 100 -z 64 --no-axis-labels", error), Eq(0));
+
+    compareImageFiles(directory / "0" / "0.png", image_pathname);
+
+    boost::system::error_code error_code;
+    boost::filesystem::remove_all(directory, error_code);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldFailIfTilesWithAutoZoom)
+{
+    std::string error;
+
+    const int exit_status = runCommand(
+        "-i ../test/data/test_file_stereo.wav -o tiles --tiles -z auto",
+        error
+    );
+
+    ASSERT_THAT(exit_status, Eq(1));
+    ASSERT_THAT(error, EndsWith("Can't use --zoom auto or --end with --tiles\n"));
+
+    ASSERT_FALSE(boost::filesystem::exists("tiles"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRunBatchOfJobs)
+{
+    const boost::filesystem::path manifest_pathname = FileUtil::getTempFilename(".txt");
+    const boost::filesystem::path status_pathname = FileUtil::getTempFilename(".txt");
+    const boost::filesystem::path dat_pathname = FileUtil::getTempFilename(".dat");
+    const boost::filesystem::path json_pathname = FileUtil::getTempFilename(".json");
+
+    FileDeleter manifest_file_deleter(manifest_pathname);
+    FileDeleter status_file_deleter(status_pathname);
+    FileDeleter dat_file_deleter(dat_pathname);
+    FileDeleter json_file_deleter(json_pathname);
+
+    {
+        std::ofstream manifest(manifest_pathname.string());
+
+        manifest << "-i ../test/data/test_file_stereo.wav -o " << dat_pathname.string() << " -b 8 -z 64\n"
+                 << "-i ../test/data/unknown.wav -o unknown.dat\n"
+                 << "-i ../test/data/test_file_stereo.wav -o " << json_pathname.string() << " -b 8 -z 64\n";
+    }
+
+    std::string error;
+
+    const int exit_status = runCommand(
+        "--batch " + manifest_pathname.string() + " --jobs 2 >" + status_pathname.string(),
+        error
+    );
+
+    // One job failed, but the others still ran
+    ASSERT_THAT(exit_status, Eq(1));
+    ASSERT_THAT(error, EndsWith("Finished 3 jobs, 1 failed\n"));
+
+    compareFiles(dat_pathname, "../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    compareFiles(json_pathname, "../test/data/test_file_stereo_8bit_64spp_wav.json");
+
+    const std::string status = FileUtil::readTextFile(status_pathname);
+
+    ASSERT_THAT(status, HasSubstr("{\"line\":1,"));
+    ASSERT_THAT(status, HasSubstr("{\"line\":2,\"input\":\"../test/data/unknown.wav\",\"output\":\"unknown.dat\",\"status\":\"error\""));
+    ASSERT_THAT(status, HasSubstr("{\"line\":3,"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldFailIfMultipleZoomLevelsUsedToRenderImage)
+{
+    std::vector<const char*> args{ "-z", "64,128" };
+
+    runTests("test_file_stereo.wav", FileFormat::Wav, FileFormat::Png, &args, false, nullptr, "Multiple zoom levels can only be used when generating waveform data from audio\n");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldGenerateBinaryWaveformDataFromWavAudioUsingMultipleThreads)
+{
+    std::vector<const char*> args{ "-b", "8", "-z", "64", "--threads", "4" };
+
+    runTests("test_file_stereo.wav", FileFormat::Wav, FileFormat::Dat, &args, true, "test_file_stereo_8bit_64spp_wav.dat");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldGenerateBinaryWaveformDataFromFlacAudioUsingMultipleThreads)
+{
+    std::vector<const char*> args{ "-b", "8", "-z", "64", "--threads", "4" };
+
+    runTests("test_file_stereo.flac", FileFormat::Flac, FileFormat::Dat, &args, true, "test_file_stereo_8bit_64spp_flac.dat");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldGenerateBinaryWaveformDataFromMp3AudioUsingPipeline)
+{
+    std::vector<const char*> args{ "-b", "8", "-z", "64", "--threads", "4" };
+
+    runTests("test_file_stereo.mp3", FileFormat::Mp3, FileFormat::Dat, &args, true, "test_file_stereo_8bit_64spp_mp3.dat");
+}
+
+//------------------------------------------------------------------------------
+
+// The pipeline used with --threads for images and for input that can't be
+// split into ranges should pass floating point audio through unchanged, so
+// mixing the channels gives the same result as without the pipeline.
+
+TEST_F(OptionHandlerTest, shouldGiveSameOutputFromFloatingPointAudioUsingMultipleThreads)
+{
+    const std::string input_filename = "../test/data/test_file_stereo_float32.wav";
+
+    const boost::filesystem::path dat_pathname = FileUtil::getTempFilename(".dat");
+    const boost::filesystem::path pipelined_dat_pathname = FileUtil::getTempFilename(".dat");
+    const boost::filesystem::path parallel_dat_pathname = FileUtil::getTempFilename(".dat");
+    const boost::filesystem::path image_pathname = FileUtil::getTempFilename(".png");
+    const boost::filesystem::path pipelined_image_pathname = FileUtil::getTempFilename(".png");
+
+    FileDeleter dat_file_deleter(dat_pathname);
+    FileDeleter pipelined_dat_file_deleter(pipelined_dat_pathname);
+    FileDeleter parallel_dat_file_deleter(parallel_dat_pathname);
+    FileDeleter image_file_deleter(image_pathname);
+    FileDeleter pipelined_image_file_deleter(pipelined_image_pathname);
+
+    std::string error;
+
+    ASSERT_THAT(runCommand("-i " + input_filename + " -o " + dat_pathname.string() + " -b 16 -z 64 --threads 1", error), Eq(0)) << error;
+
+    // Standard input can't be split into ranges, so is read using the pipeline
+    ASSERT_THAT(runCommand("--input-format wav -o " + pipelined_dat_pathname.string() + " -b 16 -z 64 --threads 2 <" + input_filename, error), Eq(0)) << error;
+
+    ASSERT_THAT(runCommand("-i " + input_filename + " -o " + parallel_dat_pathname.string() + " -b 16 -z 64 --threads 2", error), Eq(0)) << error;
+
+    compareFiles(pipelined_dat_pathname, dat_pathname);
+    compareFiles(parallel_dat_pathname, dat_pathname);
+
+    ASSERT_THAT(runCommand("-i " + input_filename + " -o " + image_pathname.string() + " -z 64 --threads 1", error), Eq(0)) << error;
+    ASSERT_THAT(runCommand("-i " + input_filename + " -o " + pipelined_image_pathname.string() + " -z 64 --threads 2", error), Eq(0)) << error;
+
+    compareImageFiles(pipelined_image_pathname, image_pathname);
+}
+
 //------------------------------------------------------------------------------
 //
 // Waveform data format conversion tests
@@ -645,6 +980,20 @@ TEST_F(OptionHandlerTest, shouldConvert2ChannelBinaryWaveformDataToJson)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionHandlerTest, shouldConvertVersion3BinaryWaveformDataToJson)
+{
+    runTests("test_file_stereo_8bit_64spp_wav_v3.dat", FileFormat::Dat, FileFormat::Json, nullptr, true, "test_file_stereo_8bit_64spp_wav.json");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldConvert2ChannelVersion3BinaryWaveformDataToJson)
+{
+    runTests("07023003_8bit_64spp_2channel_v3.dat", FileFormat::Dat, FileFormat::Json, nullptr, true, "07023003_8bit_64spp_2channel.json");
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionHandlerTest, shouldConvertBinaryWaveformDataToText)
 {
     runTests("test_file_stereo_8bit_64spp_wav.dat", FileFormat::Dat, FileFormat::Txt, nullptr, true, "test_file_stereo_8bit_64spp_wav.txt");
@@ -673,6 +1022,15 @@ TEST_F(OptionHandlerTest, shouldConvertJsonWaveformDataToText)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionHandlerTest, shouldConvertJsonWaveformDataToVersion3Binary)
+{
+    std::vector<const char*> args{ "--format-version", "3" };
+
+    runTests("test_file_stereo_8bit_64spp_wav.json", FileFormat::Json, FileFormat::Dat, &args, true, "test_file_stereo_8bit_64spp_wav_v3.dat");
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionHandlerTest, shouldNotConvertTextWaveformDataToBinary)
 {
     runTests("test_file_stereo_8bit_64spp_wav.txt", FileFormat::Txt, FileFormat::Dat, nullptr, false);
@@ -915,6 +1273,15 @@ TEST_F(OptionHandlerTest, shouldRenderWaveformWithRoundedBars)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionHandlerTest, shouldRenderWaveformWithPngEncodingOptions)
+{
+    std::vector<const char*> args{ "-z", "128", "--png-filter", "up", "--png-strategy", "rle", "--no-png-palette" };
+
+    runTests("test_file_stereo_8bit_64spp_wav.dat", FileFormat::Dat, FileFormat::Png, &args, true, "test_file_stereo_dat_128spp.png");
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionHandlerTest, shouldRenderWaveformBarsWithStartTimeOffset)
 {
     std::vector<const char*> args{ "-z", "128", "--waveform-style", "bars", "--start", "0.5" };
@@ -933,6 +1300,188 @@ TEST_F(OptionHandlerTest, shouldRenderWaveformBarsWithSplitChannels)
 
 //------------------------------------------------------------------------------
 
+// Checks that rendering an image from audio, where only the part of the audio
+// shown in the image is decoded, gives the same image as rendering from
+// waveform data generated from the whole audio file.
+
+static void testRenderPartOfAudio(
+    const char* input_filename,
+    const std::string& zoom_args,
+    const std::string& image_args)
+{
+    const boost::filesystem::path data_pathname       = FileUtil::getTempFilename(".dat");
+    const boost::filesystem::path data_image_pathname = FileUtil::getTempFilename(".png");
+    const boost::filesystem::path image_pathname      = FileUtil::getTempFilename(".png");
+
+    FileDeleter data_file_deleter(data_pathname);
+    FileDeleter data_image_file_deleter(data_image_pathname);
+    FileDeleter image_file_deleter(image_pathname);
+
+    const std::string input_args = std::string("-i ../test/data/") + input_filename;
+
+    std::string error;
+
+    ASSERT_THAT(runCommand(input_args + " -o " + data_pathname.string() + " -b 16 " + zoom_args, error), Eq(0));
+
+    ASSERT_THAT(runCommand("-i " + data_pathname.string() + " -o " + data_image_pathname.string() + " " + zoom_args + " " + image_args, error), Eq(0));
+
+    ASSERT_THAT(runCommand(input_args + " -o " + image_pathname.string() + " " + zoom_args + " " + image_args, error), Eq(0));
+    ASSERT_THAT(error, EndsWith("Done\n"));
+
+    compareImageFiles(image_pathname, data_image_pathname);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformWithStartTimeOffsetFromWav)
+{
+    testRenderPartOfAudio("test_file_stereo.wav", "-z 32", "-s 2.0 -w 300 -h 100");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformWithStartTimeOffsetFromFlac)
+{
+    testRenderPartOfAudio("test_file_stereo.flac", "-z 32", "-s 2.0 -w 300 -h 100");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformWithStartTimeOffsetFromMp3)
+{
+    testRenderPartOfAudio("test_file_stereo.mp3", "-z 32", "-s 2.0 -w 300 -h 100");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformBarsWithStartTimeOffsetFromMp3)
+{
+    testRenderPartOfAudio("test_file_stereo.mp3", "-z 32", "-s 2.05 -w 300 -h 100 --waveform-style bars --bar-width 5 --bar-gap 2");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformWithStartTimeAfterEndOfAudio)
+{
+    testRenderPartOfAudio("test_file_stereo.wav", "-z 32", "-s 100 -w 300 -h 100");
+}
+
+//------------------------------------------------------------------------------
+
+// libsndfile doesn't guarantee sample exact seeking in Ogg Vorbis or Opus
+// files, so these are decoded from the start.
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformWithStartTimeOffsetFromOggVorbis)
+{
+    testRenderPartOfAudio("test_file_stereo.oga", "-z 32", "-s 2.0 -w 300 -h 100");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformWithStartTimeOffsetFromOpus)
+{
+    testRenderPartOfAudio("test_file_stereo.opus", "-z 32", "-s 2.0 -w 300 -h 100");
+}
+
+//------------------------------------------------------------------------------
+
+// Checks that an image can be rendered from a named pipe, which can't be
+// seeked, by decoding the whole input.
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformWithStartTimeOffsetFromNamedPipe)
+{
+    const boost::filesystem::path fifo_pathname  = FileUtil::getTempFilename(".wav");
+    const boost::filesystem::path image_pathname = FileUtil::getTempFilename(".png");
+    const boost::filesystem::path ref_pathname   = FileUtil::getTempFilename(".png");
+
+    FileDeleter fifo_deleter(fifo_pathname);
+    FileDeleter image_file_deleter(image_pathname);
+    FileDeleter ref_file_deleter(ref_pathname);
+
+    ASSERT_THAT(mkfifo(fifo_pathname.c_str(), 0600), Eq(0));
+
+    const std::string image_args = " -z 32 -s 2.0 -w 300 -h 100";
+
+    std::string error;
+
+    ASSERT_THAT(runCommand("-i ../test/data/test_file_stereo.wav -o " + ref_pathname.string() + image_args, error), Eq(0));
+
+    const std::string write_command =
+        "cat ../test/data/test_file_stereo.wav >" + fifo_pathname.string() + " &";
+
+    ASSERT_THAT(system(write_command.c_str()), Eq(0));
+
+    const int result = runCommand("-i " + fifo_pathname.string() + " -o " + image_pathname.string() + image_args, error);
+
+    // Let the writer finish if the input wasn't opened
+    const int fd = open(fifo_pathname.c_str(), O_RDONLY | O_NONBLOCK);
+
+    if (fd != -1) {
+        close(fd);
+    }
+
+    ASSERT_THAT(result, Eq(0));
+    ASSERT_THAT(error, EndsWith("Done\n"));
+
+    compareImageFiles(image_pathname, ref_pathname);
+}
+
+//------------------------------------------------------------------------------
+
+// Checks that rendering an image from an indexed data file, where only the
+// blocks shown in the image are read, gives the same image as rendering from
+// a data file that isn't indexed.
+
+static void testRenderPartOfIndexedData(
+    const std::string& data_args,
+    const std::string& image_args)
+{
+    const boost::filesystem::path data_pathname          = FileUtil::getTempFilename(".dat");
+    const boost::filesystem::path indexed_data_pathname  = FileUtil::getTempFilename(".dat");
+    const boost::filesystem::path image_pathname         = FileUtil::getTempFilename(".png");
+    const boost::filesystem::path indexed_image_pathname = FileUtil::getTempFilename(".png");
+
+    FileDeleter data_file_deleter(data_pathname);
+    FileDeleter indexed_data_file_deleter(indexed_data_pathname);
+    FileDeleter image_file_deleter(image_pathname);
+    FileDeleter indexed_image_file_deleter(indexed_image_pathname);
+
+    const std::string input_args = "-i ../test/data/test_file_stereo.wav -z 32";
+
+    std::string error;
+
+    ASSERT_THAT(runCommand(input_args + " -o " + data_pathname.string(), error), Eq(0));
+    ASSERT_THAT(runCommand(input_args + " -o " + indexed_data_pathname.string() + " " + data_args, error), Eq(0));
+
+    ASSERT_THAT(runCommand("-i " + data_pathname.string() + " -o " + image_pathname.string() + " " + image_args, error), Eq(0));
+    ASSERT_THAT(runCommand("-i " + indexed_data_pathname.string() + " -o " + indexed_image_pathname.string() + " " + image_args, error), Eq(0));
+    ASSERT_THAT(error, EndsWith("Done\n"));
+
+    compareImageFiles(indexed_image_pathname, image_pathname);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformWithStartTimeOffsetFromIndexedData)
+{
+    testRenderPartOfIndexedData("--block-size 50", "-z 32 -s 2.0 -w 300 -h 100");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderRescaledWaveformWithStartTimeOffsetFromIndexedData)
+{
+    testRenderPartOfIndexedData("--block-size 50 --format-version 3", "-z 75 -s 2.03 -w 200 -h 100");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldRenderWaveformBarsWithEndTimeFromIndexedData)
+{
+    testRenderPartOfIndexedData("--block-size 64", "-s 1.5 -e 4.5 -w 300 -h 100 --waveform-style bars --bar-width 5 --bar-gap 2");
+}
+//------------------------------------------------------------------------------
+
 TEST_F(OptionHandlerTest, shouldNotRenderWaveformImageFromTextWaveformData)
 {
     runTests("test_file_stereo_8bit_64spp_wav.txt", FileFormat::Txt, FileFormat::Png, nullptr, false);
@@ -996,6 +1545,22 @@ TEST_F(OptionHandlerTest, shouldFailIfUnknownWaveformBarStyle)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionHandlerTest, shouldFailIfUnknownPngFilter)
+{
+    std::vector<const char*> args{ "--png-filter", "test" };
+    runTests("test_file_stereo.wav", FileFormat::Wav, FileFormat::Png, &args, false, nullptr, "Unknown PNG filter: test\n");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionHandlerTest, shouldFailIfUnknownPngStrategy)
+{
+    std::vector<const char*> args{ "--png-strategy", "test" };
+    runTests("test_file_stereo.wav", FileFormat::Wav, FileFormat::Png, &args, false, nullptr, "Unknown PNG strategy: test\n");
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionHandlerTest, shouldFailIfBarGapIsNegative)
 {
     std::vector<const char*> args{ "--waveform-style", "bars", "--bar-gap", "-1" };
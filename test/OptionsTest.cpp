@@ -29,6 +29,7 @@
 
 //------------------------------------------------------------------------------
 
+using testing::ElementsAre;
 using testing::EndsWith;
 using testing::Eq;
 using testing::HasSubstr;
@@ -600,6 +601,72 @@ TEST_F(OptionsTest, shouldReturnAutoZoomOption)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionsTest, shouldReturnMultipleZoomLevels)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "-z", "64,128,256"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_TRUE(options_.hasSamplesPerPixel());
+    ASSERT_THAT(options_.getSamplesPerPixel(), Eq(64));
+    ASSERT_THAT(options_.getSamplesPerPixelValues(), ElementsAre(64, 128, 256));
+
+    ASSERT_FALSE(options_.isAutoSamplesPerPixel());
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfInvalidZoomInList)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "-z", "64,invalid"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Invalid zoom"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfZoomListHasTrailingComma)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "-z", "64,"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Invalid zoom: must be a number"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfDuplicateZoomInList)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "-z", "256,64,256"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Invalid zoom: 256 is given more than once"));
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionsTest, shouldDisplayErrorIfInvalidZoom)
 {
     const char* const argv[] = {
@@ -663,6 +730,25 @@ TEST_F(OptionsTest, shouldReturnPixelsPerSecond)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionsTest, shouldReturnMultiplePixelsPerSecondValues)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "--pixels-per-second", "200,100,50"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_TRUE(options_.hasPixelsPerSecond());
+    ASSERT_THAT(options_.getPixelsPerSecond(), Eq(200));
+    ASSERT_THAT(options_.getPixelsPerSecondValues(), ElementsAre(200, 100, 50));
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionsTest, shouldReturnDefaultPixelsPerSecondOption)
 {
     const char* const argv[] = {
@@ -696,6 +782,36 @@ TEST_F(OptionsTest, shouldDisplayErrorIfInvalidPixelsPerSecond)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionsTest, shouldDisplayErrorIfPixelsPerSecondListHasTrailingComma)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "--pixels-per-second", "200,"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Invalid pixels per second: must be a number"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfDuplicatePixelsPerSecondInList)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "--pixels-per-second", "200,200"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Invalid pixels per second: 200 is given more than once"));
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionsTest, shouldDisplayErrorIfMissingPixelsPerSecond)
 {
     const char* const argv[] = {
@@ -826,6 +942,104 @@ TEST_F(OptionsTest, shouldReturnDefaultBitsOption)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionsTest, shouldReturnFormatVersion)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "--format-version", "3"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(options_.getFormatVersion(), Eq(3));
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnDefaultFormatVersion)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(options_.getFormatVersion(), Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfFormatVersionInvalid)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "--format-version", "1"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(
+        "Error: Invalid format version: must be either 2 or 3\n"
+        "See 'appname --help' for available options\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnBlockSize)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "--block-size", "4096"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(options_.getBlockSize(), Eq(4096));
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnDefaultBlockSize)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(options_.getBlockSize(), Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfBlockSizeInvalid)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "--block-size", "0"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(
+        "Error: Invalid block size: must be greater than zero\n"
+        "See 'appname --help' for available options\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionsTest, shouldDisableAxisLabelRendering)
 {
     const char* const argv[] = {
@@ -926,6 +1140,350 @@ TEST_F(OptionsTest, shouldDisplayErrorIfInvalidPngCompressionLevel)
 
 //------------------------------------------------------------------------------
 
+TEST_F(OptionsTest, shouldReturnDefaultPngEncodingOptions)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.png"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_THAT(options_.getPngFilter(), StrEq("default"));
+    ASSERT_THAT(options_.getPngStrategy(), StrEq("default"));
+    ASSERT_TRUE(options_.getPngPalette());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnPngEncodingOptions)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.png",
+        "--png-filter", "paeth", "--png-strategy", "rle", "--no-png-palette"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_THAT(options_.getPngFilter(), StrEq("paeth"));
+    ASSERT_THAT(options_.getPngStrategy(), StrEq("rle"));
+    ASSERT_FALSE(options_.getPngPalette());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnDefaultThreads)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.wav", "-o", "test.dat"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(options_.getThreads(), Eq(1));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnThreads)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.wav", "-o", "test.dat", "--threads", "8"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_THAT(options_.getThreads(), Eq(8));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfInvalidThreads)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.wav", "-o", "test.dat", "--threads", "0"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Invalid threads"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldNotUseMp3IndexByDefault)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.png"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_FALSE(options_.getMp3Index());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldUseMp3Index)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.png", "--mp3-index"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_TRUE(options_.getMp3Index());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldNotRenderTilesByDefault)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.png"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_FALSE(options_.getTiles());
+    ASSERT_THAT(options_.getTileWidth(), Eq(512));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldRenderTiles)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "tiles", "--tiles", "--tile-width", "256"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_TRUE(options_.getTiles());
+    ASSERT_THAT(options_.getTileWidth(), Eq(256));
+    ASSERT_THAT(options_.getOutputFilename().string(), StrEq("tiles"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReportErrorIfTileWidthIsInvalid)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "tiles", "--tiles", "--tile-width", "0"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Invalid tile width: must be greater than zero\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReportErrorIfTilesWithMultipleOutputFiles)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "tiles", "-o", "test.dat", "--tiles"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Can't use --tiles with more than one output file\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldNotWriteStatsByDefault)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.png"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_FALSE(options_.hasStats());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldWriteStatsToStandardError)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.png", "--stats"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_TRUE(options_.hasStats());
+    ASSERT_THAT(options_.getStatsFilename(), StrEq("-"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldWriteStatsToFile)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.png", "--stats=stats.json"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_TRUE(options_.hasStats());
+    ASSERT_THAT(options_.getStatsFilename(), StrEq("stats.json"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnTraceFilename)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.png", "--trace", "trace.json"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_THAT(options_.getTraceFilename(), StrEq("trace.json"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnTraceFilenameWithBatch)
+{
+    const char* const argv[] = {
+        "appname", "--batch", "jobs.txt", "--trace", "trace.json"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(options_.getBatchFilename(), StrEq("jobs.txt"));
+    ASSERT_THAT(options_.getTraceFilename(), StrEq("trace.json"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnBatchFilename)
+{
+    const char* const argv[] = {
+        "appname", "--batch", "jobs.txt", "--jobs", "4"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_THAT(options_.getBatchFilename(), StrEq("jobs.txt"));
+    ASSERT_THAT(options_.getJobs(), Eq(4));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldNotReturnBatchFilenameByDefault)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.wav", "-o", "test.dat"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(options_.getBatchFilename(), StrEq(""));
+    ASSERT_THAT(options_.getJobs(), Eq(1));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnServeFilename)
+{
+    const char* const argv[] = {
+        "appname", "--serve", "/tmp/audiowaveform.sock", "--jobs", "4"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_THAT(options_.getServeFilename(), StrEq("/tmp/audiowaveform.sock"));
+    ASSERT_THAT(options_.getBatchFilename(), StrEq(""));
+    ASSERT_THAT(options_.getJobs(), Eq(4));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfBatchAndServe)
+{
+    const char* const argv[] = {
+        "appname", "--batch", "jobs.txt", "--serve", "/tmp/audiowaveform.sock"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Can't use --batch and --serve together"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfInvalidJobs)
+{
+    const char* const argv[] = {
+        "appname", "--batch", "jobs.txt", "--jobs", "0"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Invalid jobs"));
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(OptionsTest, shouldReturnInputFormat)
 {
     const char* const argv[] = {
@@ -1305,3 +1863,115 @@ TEST_F(OptionsTest, shouldReturnDefaultQuietOption)
 }
 
 //------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnMultipleOutputFiles)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat:zoom=64",
+        "-o", "test.png:zoom=auto,width=1800,height=140",
+        "-o", "test.json:pixels-per-second=20", "-w", "1000", "-h", "200"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+
+    ASSERT_TRUE(result);
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    ASSERT_THAT(options_.getOutputFilename().string(), StrEq("test.dat"));
+    ASSERT_THAT(options_.getOutputFormat(), Eq(FileFormat::Dat));
+
+    const std::vector<OutputFile>& output_files = options_.getOutputFiles();
+    ASSERT_THAT(output_files.size(), Eq(3U));
+
+    ASSERT_THAT(output_files[0].filename.string(), StrEq("test.dat"));
+    ASSERT_THAT(output_files[0].format, Eq(FileFormat::Dat));
+    ASSERT_TRUE(output_files[0].has_samples_per_pixel);
+    ASSERT_FALSE(output_files[0].auto_samples_per_pixel);
+    ASSERT_THAT(output_files[0].samples_per_pixel, Eq(64));
+    ASSERT_FALSE(output_files[0].has_pixels_per_second);
+
+    ASSERT_THAT(output_files[1].filename.string(), StrEq("test.png"));
+    ASSERT_THAT(output_files[1].format, Eq(FileFormat::Png));
+    ASSERT_TRUE(output_files[1].has_samples_per_pixel);
+    ASSERT_TRUE(output_files[1].auto_samples_per_pixel);
+    ASSERT_THAT(output_files[1].image_width, Eq(1800));
+    ASSERT_THAT(output_files[1].image_height, Eq(140));
+
+    ASSERT_THAT(output_files[2].filename.string(), StrEq("test.json"));
+    ASSERT_THAT(output_files[2].format, Eq(FileFormat::Json));
+    ASSERT_FALSE(output_files[2].has_samples_per_pixel);
+    ASSERT_TRUE(output_files[2].has_pixels_per_second);
+    ASSERT_THAT(output_files[2].pixels_per_second, Eq(20));
+    ASSERT_THAT(output_files[2].image_width, Eq(1000));
+    ASSERT_THAT(output_files[2].image_height, Eq(200));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldReturnSingleOutputFileWithColonInFilename)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "c:test.dat", "-z", "128"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+
+    ASSERT_TRUE(result);
+    ASSERT_THAT(error.str(), StrEq(""));
+
+    const std::vector<OutputFile>& output_files = options_.getOutputFiles();
+    ASSERT_THAT(output_files.size(), Eq(1U));
+
+    ASSERT_THAT(output_files[0].filename.string(), StrEq("c:test.dat"));
+    ASSERT_THAT(output_files[0].format, Eq(FileFormat::Dat));
+    ASSERT_FALSE(output_files[0].has_samples_per_pixel);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfUnknownOutputFileSetting)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "-o", "test.png:colour=red"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Unknown setting for output file test.png: colour"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfInvalidOutputFileZoom)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "-o", "test.png:zoom=big"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Invalid zoom for output file test.png: big"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(OptionsTest, shouldDisplayErrorIfOutputFormatUsedWithMultipleOutputFiles)
+{
+    const char* const argv[] = {
+        "appname", "-i", "test.mp3", "-o", "test.dat", "-o", "test.png",
+        "--output-format", "json"
+    };
+
+    bool result = options_.parseCommandLine(static_cast<int>(ARRAY_LENGTH(argv)), argv);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith("Error: Can't use --output-format with more than one output file"));
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,310 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "ParallelWaveformGenerator.h"
+#include "JobStats.h"
+#include "VectorAudioFileReader.h"
+#include "WaveformBuffer.h"
+#include "WaveformGenerator.h"
+#include "util/Streams.h"
+#include "util/WaveformUtil.h"
+
+#include "gmock/gmock.h"
+
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::ContainsRegex;
+using testing::Eq;
+using testing::HasSubstr;
+using testing::Not;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class ParallelWaveformGeneratorTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+        }
+
+        virtual void TearDown()
+        {
+            JobStats::setThreadStats(nullptr);
+        }
+};
+
+//------------------------------------------------------------------------------
+
+static ParallelWaveformGenerator::ReaderFactory createReaderFactory(
+    const std::vector<short>& samples,
+    int sample_rate,
+    int channels,
+    std::atomic<int>* reader_count = nullptr)
+{
+    return [&samples, sample_rate, channels, reader_count](
+        long long start_frame,
+        long long end_frame) -> std::unique_ptr<AudioFileReader>
+    {
+        std::unique_ptr<VectorAudioFileReader> reader(
+            new VectorAudioFileReader(samples, sample_rate, channels)
+        );
+
+        if (!reader->setFrameRange(start_frame, end_frame)) {
+            return nullptr;
+        }
+
+        if (reader_count != nullptr) {
+            ++*reader_count;
+        }
+
+        return std::unique_ptr<AudioFileReader>(reader.release());
+    };
+}
+
+//------------------------------------------------------------------------------
+
+// Checks the output from several threads matches the output from a single
+// WaveformGenerator.
+
+static void testThreads(
+    int frames,
+    int channels,
+    bool split_channels,
+    int samples_per_pixel,
+    int threads)
+{
+    const int sample_rate = 44100;
+
+    const std::vector<short> samples = WaveformUtil::createSamples(frames, channels);
+
+    SamplesPerPixelScaleFactor scale_factor(samples_per_pixel);
+
+    WaveformBuffer expected_buffer;
+    WaveformGenerator expected_generator(expected_buffer, split_channels, scale_factor);
+
+    VectorAudioFileReader reader(samples, sample_rate, channels);
+    ASSERT_TRUE(reader.run(expected_generator));
+
+    WaveformBuffer buffer;
+    ParallelWaveformGenerator generator(threads, split_channels);
+    generator.addLevel(buffer, scale_factor);
+
+    ASSERT_TRUE(generator.run(
+        createReaderFactory(samples, sample_rate, channels),
+        sample_rate,
+        frames
+    ));
+
+    WaveformUtil::compareBuffers(buffer, expected_buffer);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ParallelWaveformGeneratorTest, shouldMatchSingleThreadedOutput)
+{
+    const int frame_counts[] = { 1, 255, 256, 257, 10000, 100000, 100001 };
+    const int thread_counts[] = { 2, 3, 4, 7, 16 };
+
+    for (int frames : frame_counts) {
+        for (int threads : thread_counts) {
+            testThreads(frames, 1, false, 256, threads);
+            testThreads(frames, 2, false, 100, threads);
+            testThreads(frames, 2, true, 64, threads);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ParallelWaveformGeneratorTest, shouldSplitInputIntoRanges)
+{
+    const int sample_rate = 44100;
+    const int channels    = 1;
+    const int frames      = 100000;
+
+    const std::vector<short> samples = WaveformUtil::createSamples(frames, channels);
+
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    WaveformBuffer buffer;
+    ParallelWaveformGenerator generator(4, false);
+    generator.addLevel(buffer, scale_factor);
+
+    std::atomic<int> reader_count(0);
+
+    ASSERT_TRUE(generator.run(
+        createReaderFactory(samples, sample_rate, channels, &reader_count),
+        sample_rate,
+        frames
+    ));
+
+    ASSERT_THAT(reader_count.load(), Eq(4));
+    ASSERT_THAT(buffer.getSize(), Eq(391)); // 100000 / 256 = 390 remainder 160
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ParallelWaveformGeneratorTest, shouldAlignRangesToAllZoomLevels)
+{
+    const int sample_rate = 44100;
+    const int channels    = 2;
+    const int frames      = 123457;
+
+    const std::vector<short> samples = WaveformUtil::createSamples(frames, channels);
+
+    const int zoom_levels[] = { 64, 100, 384 };
+
+    std::vector<std::unique_ptr<SamplesPerPixelScaleFactor>> scale_factors;
+    std::vector<std::unique_ptr<WaveformBuffer>> buffers;
+
+    ParallelWaveformGenerator generator(5, true);
+
+    for (int zoom : zoom_levels) {
+        scale_factors.emplace_back(new SamplesPerPixelScaleFactor(zoom));
+        buffers.emplace_back(new WaveformBuffer);
+
+        generator.addLevel(*buffers.back(), *scale_factors.back());
+    }
+
+    ASSERT_TRUE(generator.run(
+        createReaderFactory(samples, sample_rate, channels),
+        sample_rate,
+        frames
+    ));
+
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        WaveformBuffer expected_buffer;
+        WaveformGenerator expected_generator(expected_buffer, true, *scale_factors[i]);
+
+        VectorAudioFileReader reader(samples, sample_rate, channels);
+        ASSERT_TRUE(reader.run(expected_generator));
+
+        WaveformUtil::compareBuffers(*buffers[i], expected_buffer);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ParallelWaveformGeneratorTest, shouldFailIfRangeIsShorterThanExpected)
+{
+    const int sample_rate = 44100;
+    const int channels    = 1;
+    const int frames      = 10000;
+
+    const std::vector<short> samples = WaveformUtil::createSamples(frames, channels);
+
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    WaveformBuffer buffer;
+    ParallelWaveformGenerator generator(2, false);
+    generator.addLevel(buffer, scale_factor);
+
+    // Simulate a decoder that stops early in the first range
+    ASSERT_FALSE(generator.run(
+        [&](long long start_frame, long long end_frame) -> std::unique_ptr<AudioFileReader> {
+            if (end_frame >= 0) {
+                end_frame -= 1000;
+            }
+
+            return createReaderFactory(samples, sample_rate, channels)(start_frame, end_frame);
+        },
+        sample_rate,
+        frames
+    ));
+
+    ASSERT_THAT(error.str(), HasSubstr("Failed to read audio frames 0 to 5120\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ParallelWaveformGeneratorTest, shouldReportErrorsFromWorkerThreads)
+{
+    const int sample_rate = 44100;
+    const int channels    = 1;
+    const int frames      = 10000;
+
+    const std::vector<short> samples = WaveformUtil::createSamples(frames, channels);
+
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    WaveformBuffer buffer;
+    ParallelWaveformGenerator generator(4, false);
+    generator.addLevel(buffer, scale_factor);
+
+    // Fail to open the third range
+    ASSERT_FALSE(generator.run(
+        [&](long long start_frame, long long end_frame) -> std::unique_ptr<AudioFileReader> {
+            if (start_frame > 5000) {
+                return createReaderFactory(samples, sample_rate, channels)(20000, end_frame);
+            }
+
+            return createReaderFactory(samples, sample_rate, channels)(start_frame, end_frame);
+        },
+        sample_rate,
+        frames
+    ));
+
+    ASSERT_THAT(error.str(), HasSubstr("Invalid start frame: 20000\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(ParallelWaveformGeneratorTest, shouldRecordStatsFromWorkerThreads)
+{
+    const int sample_rate = 44100;
+    const int channels    = 2;
+    const int frames      = 1000000;
+
+    const std::vector<short> samples = WaveformUtil::createSamples(frames, channels);
+
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    WaveformBuffer buffer;
+    ParallelWaveformGenerator generator(4, false);
+    generator.addLevel(buffer, scale_factor);
+
+    JobStats stats;
+    JobStats::setThreadStats(&stats);
+
+    ASSERT_TRUE(generator.run(
+        createReaderFactory(samples, sample_rate, channels),
+        sample_rate,
+        frames
+    ));
+
+    JobStats::setThreadStats(nullptr);
+
+    std::ostringstream stream;
+    stats.write(stream, "", "", 0, 0, true);
+
+    ASSERT_THAT(stream.str(), HasSubstr("\"frames\":1000000,"));
+    ASSERT_THAT(stream.str(), Not(ContainsRegex("\"process\":\\{[^}]*\"cpu_time\":0\\.000000\\}")));
+}
+
+//------------------------------------------------------------------------------
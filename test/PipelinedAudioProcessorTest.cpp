@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "PipelinedAudioProcessor.h"
+#include "VectorAudioFileReader.h"
+#include "WaveformBuffer.h"
+#include "WaveformGenerator.h"
+#include "mocks/MockAudioProcessor.h"
+#include "util/Streams.h"
+#include "util/WaveformUtil.h"
+
+#include "gmock/gmock.h"
+
+#include <stdexcept>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::_;
+using testing::Eq;
+using testing::HasSubstr;
+using testing::InSequence;
+using testing::Return;
+using testing::StrictMock;
+using testing::Test;
+using testing::Throw;
+
+//------------------------------------------------------------------------------
+
+class PipelinedAudioProcessorTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+        }
+
+        virtual void TearDown()
+        {
+        }
+};
+
+//------------------------------------------------------------------------------
+
+TEST_F(PipelinedAudioProcessorTest, shouldGiveSameOutputAsProcessor)
+{
+    const int sample_rate = 44100;
+    const int channels    = 2;
+    const int frames      = 1000000;
+
+    const std::vector<short> samples = WaveformUtil::createSamples(frames, channels);
+
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    WaveformBuffer expected_buffer;
+    WaveformGenerator expected_generator(expected_buffer, true, scale_factor);
+
+    VectorAudioFileReader expected_reader(samples, sample_rate, channels);
+    ASSERT_TRUE(expected_reader.run(expected_generator));
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, true, scale_factor);
+    PipelinedAudioProcessor pipeline(generator, 2);
+
+    VectorAudioFileReader reader(samples, sample_rate, channels);
+    ASSERT_TRUE(reader.run(pipeline));
+    ASSERT_FALSE(pipeline.hasError());
+
+    WaveformUtil::compareBuffers(buffer, expected_buffer);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PipelinedAudioProcessorTest, shouldPassFloatingPointInputToProcessor)
+{
+    const int sample_rate = 44100;
+    const int channels    = 2;
+    const int frames      = 100000;
+    const int block_size  = 1024;
+
+    const std::vector<short> short_samples = WaveformUtil::createSamples(frames, channels);
+
+    std::vector<float> samples(short_samples.size());
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<float>(short_samples[i]) / 32768.0f;
+    }
+
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    // Mix the channels, as the result then depends on the samples being
+    // floating point
+    WaveformBuffer expected_buffer;
+    WaveformGenerator expected_generator(expected_buffer, false, scale_factor);
+
+    ASSERT_TRUE(expected_generator.init(sample_rate, channels, frames, frames * channels));
+    ASSERT_TRUE(expected_generator.processFloat(&samples[0], frames));
+    expected_generator.done();
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, false, scale_factor);
+    PipelinedAudioProcessor pipeline(generator, 2);
+
+    ASSERT_TRUE(pipeline.supportsFloat());
+    ASSERT_TRUE(pipeline.init(sample_rate, channels, frames, block_size * channels));
+
+    for (int frame = 0; frame < frames; frame += block_size) {
+        const int frame_count = frames - frame < block_size ? frames - frame : block_size;
+
+        ASSERT_TRUE(pipeline.processFloat(&samples[static_cast<size_t>(frame * channels)], frame_count));
+    }
+
+    pipeline.done();
+    ASSERT_FALSE(pipeline.hasError());
+
+    ASSERT_THAT(buffer.getSize(), Eq(expected_buffer.getSize()));
+    ASSERT_THAT(buffer.getChannels(), Eq(1));
+
+    for (int i = 0; i < buffer.getSize(); ++i) {
+        ASSERT_THAT(buffer.getMinSample(0, i), Eq(expected_buffer.getMinSample(0, i)));
+        ASSERT_THAT(buffer.getMaxSample(0, i), Eq(expected_buffer.getMaxSample(0, i)));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PipelinedAudioProcessorTest, shouldNotProcessIfShouldNotContinue)
+{
+    const std::vector<short> samples = WaveformUtil::createSamples(100000, 1);
+
+    StrictMock<MockAudioProcessor> processor;
+
+    InSequence sequence;
+
+    EXPECT_CALL(processor, init(44100, 1, 100000, _)).WillOnce(Return(true));
+    EXPECT_CALL(processor, shouldContinue()).WillOnce(Return(false));
+    EXPECT_CALL(processor, process(_, _)).Times(0);
+    EXPECT_CALL(processor, done()).Times(0);
+
+    PipelinedAudioProcessor pipeline(processor);
+
+    VectorAudioFileReader reader(samples, 44100, 1);
+    ASSERT_TRUE(reader.run(pipeline));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PipelinedAudioProcessorTest, shouldStopIfProcessFails)
+{
+    // 100 blocks of 16384 samples
+    const std::vector<short> samples = WaveformUtil::createSamples(100 * 16384, 1);
+
+    StrictMock<MockAudioProcessor> processor;
+
+    InSequence sequence;
+
+    EXPECT_CALL(processor, init(44100, 1, 100 * 16384, _)).WillOnce(Return(true));
+    EXPECT_CALL(processor, shouldContinue()).WillOnce(Return(true));
+    EXPECT_CALL(processor, process(_, 16384)).Times(2).WillRepeatedly(Return(true));
+    EXPECT_CALL(processor, process(_, 16384)).WillOnce(Return(false)).RetiresOnSaturation();
+    EXPECT_CALL(processor, done());
+
+    PipelinedAudioProcessor pipeline(processor, 4);
+
+    VectorAudioFileReader reader(samples, 44100, 1);
+    ASSERT_FALSE(reader.run(pipeline));
+    ASSERT_TRUE(pipeline.hasError());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PipelinedAudioProcessorTest, shouldReportErrorIfLastBlockFails)
+{
+    const std::vector<short> samples = WaveformUtil::createSamples(1000, 1);
+
+    StrictMock<MockAudioProcessor> processor;
+
+    InSequence sequence;
+
+    EXPECT_CALL(processor, init(44100, 1, 1000, _)).WillOnce(Return(true));
+    EXPECT_CALL(processor, shouldContinue()).WillOnce(Return(true));
+    EXPECT_CALL(processor, process(_, 1000)).WillOnce(Throw(std::runtime_error("Test error")));
+    EXPECT_CALL(processor, done());
+
+    PipelinedAudioProcessor pipeline(processor);
+
+    VectorAudioFileReader reader(samples, 44100, 1);
+    reader.run(pipeline);
+
+    ASSERT_TRUE(pipeline.hasError());
+    ASSERT_THAT(error.str(), HasSubstr("Test error\n"));
+}
+
+//------------------------------------------------------------------------------
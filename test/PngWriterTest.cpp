@@ -0,0 +1,378 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "PngWriter.h"
+#include "ImageBuffer.h"
+
+#include "util/FileDeleter.h"
+#include "util/FileUtil.h"
+#include "util/ImageUtil.h"
+#include "util/Streams.h"
+
+#include "gmock/gmock.h"
+
+#include <gd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::StrEq;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class PngWriterTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+
+            filename_ = FileUtil::getTempFilename(".png");
+        }
+
+        virtual void TearDown()
+        {
+            boost::system::error_code error_code;
+            boost::filesystem::remove(filename_, error_code);
+        }
+
+        bool writeImage(
+            const ImageBuffer& image,
+            bool save_alpha,
+            const PngOptions& options = PngOptions()
+        );
+
+        void checkImage(const ImageBuffer& image, bool save_alpha);
+
+        // The IHDR chunk follows the 8 byte signature, 4 byte length, and
+        // 4 byte chunk type, then width and height
+        int getBitDepth() const { return data_[24]; }
+        int getColorType() const { return data_[25]; }
+
+        bool hasChunk(const char* type) const;
+
+        boost::filesystem::path filename_;
+        std::vector<uint8_t> data_;
+};
+
+//------------------------------------------------------------------------------
+
+bool PngWriterTest::writeImage(
+    const ImageBuffer& image,
+    const bool save_alpha,
+    const PngOptions& options)
+{
+    FILE* file = fopen(filename_.c_str(), "wb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    PngWriter writer(options);
+    const bool result = writer.write(file, image, save_alpha);
+
+    fclose(file);
+
+    data_ = FileUtil::readFile(filename_);
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+// Checks the PNG file has the same pixels as the image, when read by libgd.
+
+void PngWriterTest::checkImage(const ImageBuffer& image, const bool save_alpha)
+{
+    gdImagePtr png_image = ImageUtil::loadPng(filename_);
+    ASSERT_THAT(png_image, testing::NotNull());
+    ASSERT_THAT(gdImageSX(png_image), Eq(image.getWidth()));
+    ASSERT_THAT(gdImageSY(png_image), Eq(image.getHeight()));
+
+    const int mask = save_alpha ? 0x7fffffff : 0x00ffffff;
+
+    for (int y = 0; y < image.getHeight(); ++y) {
+        for (int x = 0; x < image.getWidth(); ++x) {
+            const int pixel = gdImageGetTrueColorPixel(png_image, x, y);
+
+            ASSERT_THAT(pixel, Eq(image.getPixel(x, y) & mask));
+        }
+    }
+
+    gdImageDestroy(png_image);
+}
+
+//------------------------------------------------------------------------------
+
+bool PngWriterTest::hasChunk(const char* type) const
+{
+    const std::string data(data_.begin(), data_.end());
+
+    return data.find(type) != std::string::npos;
+}
+
+//------------------------------------------------------------------------------
+
+// Draws vertical stripes, one of each color.
+
+static void drawStripes(ImageBuffer& image, const std::vector<int>& colors)
+{
+    const int count = static_cast<int>(colors.size());
+
+    image.create(count * 2, 10);
+    image.setAlphaBlending(false);
+
+    for (int i = 0; i < count; ++i) {
+        const int color = colors[static_cast<size_t>(i)];
+
+        image.fillRectangle(i * 2, 0, i * 2 + 1, 9, color);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static std::vector<int> createColors(const int count)
+{
+    std::vector<int> colors;
+
+    for (int i = 0; i < count; ++i) {
+        colors.push_back((i * 0x010203) & 0xffffff);
+    }
+
+    return colors;
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PngWriterTest, shouldWriteTwoColorImageWithOneBitPerPixel)
+{
+    ImageBuffer image;
+    drawStripes(image, { 0xffffff, 0x3a3a3a });
+
+    bool result = writeImage(image, false);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(getColorType(), Eq(PNG_COLOR_TYPE_PALETTE));
+    ASSERT_THAT(getBitDepth(), Eq(1));
+    ASSERT_FALSE(hasChunk("tRNS"));
+
+    checkImage(image, false);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PngWriterTest, shouldChooseBitDepthFromNumberOfColors)
+{
+    const int counts[]      = { 3, 4, 5, 16, 17, 256 };
+    const int bit_depths[]  = { 2, 2, 4,  4,  8,   8 };
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        ImageBuffer image;
+        drawStripes(image, createColors(counts[i]));
+
+        bool result = writeImage(image, false);
+        ASSERT_TRUE(result);
+
+        ASSERT_THAT(getColorType(), Eq(PNG_COLOR_TYPE_PALETTE));
+        ASSERT_THAT(getBitDepth(), Eq(bit_depths[i]));
+
+        checkImage(image, false);
+    }
+
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PngWriterTest, shouldWriteTruecolorImageIfMoreThan256Colors)
+{
+    ImageBuffer image;
+    drawStripes(image, createColors(257));
+
+    bool result = writeImage(image, false);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(getColorType(), Eq(PNG_COLOR_TYPE_RGB));
+    ASSERT_THAT(getBitDepth(), Eq(8));
+
+    checkImage(image, false);
+
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PngWriterTest, shouldWriteTransparencyOfTranslucentColors)
+{
+    ImageBuffer image;
+    drawStripes(image, { 0x7f000000, 0x00ff0000, 0x400000ff });
+
+    bool result = writeImage(image, true);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(getColorType(), Eq(PNG_COLOR_TYPE_PALETTE));
+    ASSERT_THAT(getBitDepth(), Eq(2));
+    ASSERT_TRUE(hasChunk("tRNS"));
+
+    checkImage(image, true);
+
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PngWriterTest, shouldIgnoreAlphaIfNotSaved)
+{
+    ImageBuffer image;
+    drawStripes(image, { 0x7f000000, 0x00000000, 0x400000ff });
+
+    bool result = writeImage(image, false);
+    ASSERT_TRUE(result);
+
+    // The first two colors are the same, without alpha
+    ASSERT_THAT(getColorType(), Eq(PNG_COLOR_TYPE_PALETTE));
+    ASSERT_THAT(getBitDepth(), Eq(1));
+    ASSERT_FALSE(hasChunk("tRNS"));
+
+    checkImage(image, false);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PngWriterTest, shouldWriteTruecolorImageIfPaletteDisabled)
+{
+    ImageBuffer image;
+    drawStripes(image, { 0x7f000000, 0x00ff0000 });
+
+    PngOptions options;
+    options.palette = false;
+
+    bool result = writeImage(image, true, options);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(getColorType(), Eq(PNG_COLOR_TYPE_RGB_ALPHA));
+    ASSERT_THAT(getBitDepth(), Eq(8));
+
+    checkImage(image, true);
+
+    result = writeImage(image, false, options);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(getColorType(), Eq(PNG_COLOR_TYPE_RGB));
+
+    checkImage(image, false);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PngWriterTest, shouldWriteImageWithEachFilterAndStrategy)
+{
+    const PngFilter filters[] = {
+        PngFilter::Default,
+        PngFilter::None,
+        PngFilter::Sub,
+        PngFilter::Up,
+        PngFilter::Average,
+        PngFilter::Paeth,
+        PngFilter::All
+    };
+
+    const PngStrategy strategies[] = {
+        PngStrategy::Default,
+        PngStrategy::Filtered,
+        PngStrategy::HuffmanOnly,
+        PngStrategy::Rle,
+        PngStrategy::Fixed
+    };
+
+    ImageBuffer image;
+    drawStripes(image, createColors(300));
+
+    for (const bool palette : { true, false }) {
+        for (const PngFilter filter : filters) {
+            for (const PngStrategy strategy : strategies) {
+                PngOptions options;
+                options.compression_level = 9;
+                options.filter = filter;
+                options.strategy = strategy;
+                options.palette = palette;
+
+                bool result = writeImage(image, false, options);
+                ASSERT_TRUE(result);
+
+                checkImage(image, false);
+            }
+        }
+    }
+
+    ASSERT_THAT(error.str(), StrEq(""));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PngWriterTest, shouldReportErrorIfColorNotInPalette)
+{
+    FILE* file = fopen(filename_.c_str(), "wb");
+    ASSERT_THAT(file, testing::NotNull());
+
+    PngWriter writer;
+
+    bool result = writer.start(file, 2, 1, { 0xffffff }, false);
+    ASSERT_TRUE(result);
+    ASSERT_THAT(writer.getBitDepth(), Eq(1));
+
+    const int row[] = { 0xffffff, 0x000000 };
+
+    result = writer.writeRow(row);
+    ASSERT_FALSE(result);
+
+    fclose(file);
+
+    ASSERT_THAT(error.str(), StrEq("Failed to write PNG file: color not in palette\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(PngWriterTest, shouldReportErrorIfPaletteHasTooManyColors)
+{
+    FILE* file = fopen(filename_.c_str(), "wb");
+    ASSERT_THAT(file, testing::NotNull());
+
+    PngWriter writer;
+
+    bool result = writer.start(file, 2, 1, createColors(257), false);
+    ASSERT_FALSE(result);
+
+    fclose(file);
+
+    ASSERT_THAT(error.str(), StrEq("Invalid PNG palette: maximum 256 colors\n"));
+}
+
+//------------------------------------------------------------------------------
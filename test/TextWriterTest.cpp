@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "TextWriter.h"
+
+#include "gmock/gmock.h"
+
+#include <climits>
+#include <sstream>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::StrEq;
+
+//------------------------------------------------------------------------------
+
+static std::string formatInt(int value)
+{
+    char output[TextWriter::MAX_INT_LENGTH];
+
+    const size_t length = TextWriter::formatInt(value, output);
+
+    return std::string(output, length);
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TextWriterTest, shouldFormatIntegers)
+{
+    const int values[] = {
+        0, 1, -1, 9, -9, 10, -10, 99, -99, 100, -100, 101, 999, 1000, 12345,
+        -32768, 32767, -128, 127, INT_MAX, INT_MIN, INT_MAX - 1, INT_MIN + 1
+    };
+
+    for (const int value : values) {
+        ASSERT_THAT(formatInt(value), StrEq(std::to_string(value)));
+    }
+
+    for (int value = -100000; value <= 100000; ++value) {
+        ASSERT_THAT(formatInt(value), StrEq(std::to_string(value)));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TextWriterTest, shouldNotWriteToStreamUntilFlushed)
+{
+    std::ostringstream stream;
+
+    TextWriter writer(stream);
+
+    writer.write("[");
+    writer.writeInt(-42);
+    writer.write(']');
+
+    ASSERT_THAT(stream.str(), StrEq(""));
+
+    writer.flush();
+
+    ASSERT_THAT(stream.str(), StrEq("[-42]"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TextWriterTest, shouldWriteMoreTextThanBufferSize)
+{
+    std::ostringstream stream;
+    std::ostringstream expected;
+
+    TextWriter writer(stream);
+
+    for (int i = -200000; i < 200000; ++i) {
+        writer.writeInt(i);
+        writer.write(',');
+
+        expected << i << ',';
+    }
+
+    const std::string long_string(100000, 'x');
+
+    writer.write(long_string.c_str());
+    writer.flush();
+
+    expected << long_string;
+
+    ASSERT_THAT(stream.str().size(), Eq(expected.str().size()));
+    ASSERT_TRUE(stream.str() == expected.str());
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "TileRenderer.h"
+#include "GdImageRenderer.h"
+#include "WaveformBuffer.h"
+#include "WaveformColors.h"
+
+#include "util/FileDeleter.h"
+#include "util/FileUtil.h"
+#include "util/ImageUtil.h"
+#include "util/Streams.h"
+
+#include "gmock/gmock.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::HasSubstr;
+using testing::StartsWith;
+using testing::StrEq;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class TileRendererTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+
+            directory_ = FileUtil::getTempFilename();
+        }
+
+        virtual void TearDown()
+        {
+            boost::system::error_code error_code;
+            boost::filesystem::remove_all(directory_, error_code);
+        }
+
+        static bool configureRenderer(GdImageRenderer&)
+        {
+            return true;
+        }
+
+        boost::filesystem::path directory_;
+};
+
+//------------------------------------------------------------------------------
+
+TEST_F(TileRendererTest, shouldRenderTilesAtEachLevel)
+{
+    WaveformBuffer buffer;
+    bool result = buffer.load("../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    ASSERT_TRUE(result);
+    ASSERT_THAT(buffer.getSize(), Eq(1774));
+
+    TileRenderer tile_renderer(4, configureRenderer);
+
+    result = tile_renderer.setTileSize(512, 100);
+    ASSERT_TRUE(result);
+
+    result = tile_renderer.render(buffer, audacity_waveform_colors, directory_);
+    ASSERT_TRUE(result);
+
+    // Level 0: 1774 points, level 1: 887 points, level 2: 444 points
+    ASSERT_TRUE(boost::filesystem::is_regular_file(directory_ / "0" / "0.png"));
+    ASSERT_TRUE(boost::filesystem::is_regular_file(directory_ / "0" / "3.png"));
+    ASSERT_FALSE(boost::filesystem::exists(directory_ / "0" / "4.png"));
+    ASSERT_TRUE(boost::filesystem::is_regular_file(directory_ / "1" / "1.png"));
+    ASSERT_FALSE(boost::filesystem::exists(directory_ / "1" / "2.png"));
+    ASSERT_TRUE(boost::filesystem::is_regular_file(directory_ / "2" / "0.png"));
+    ASSERT_FALSE(boost::filesystem::exists(directory_ / "2" / "1.png"));
+    ASSERT_FALSE(boost::filesystem::exists(directory_ / "3"));
+
+    const std::string manifest = FileUtil::readTextFile(directory_ / "manifest.json");
+
+    ASSERT_THAT(manifest, StrEq(
+        "{\n"
+        "  \"version\": 1,\n"
+        "  \"sample_rate\": 16000,\n"
+        "  \"channels\": 1,\n"
+        "  \"tile_width\": 512,\n"
+        "  \"tile_height\": 100,\n"
+        "  \"levels\": [\n"
+        "    {\"samples_per_pixel\": 64, \"width\": 1774, \"tiles\": 4},\n"
+        "    {\"samples_per_pixel\": 128, \"width\": 887, \"tiles\": 2},\n"
+        "    {\"samples_per_pixel\": 256, \"width\": 444, \"tiles\": 1}\n"
+        "  ]\n"
+        "}\n"
+    ));
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), HasSubstr("Level 0: 64 samples per pixel, 4 tiles\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(TileRendererTest, shouldRenderTilesThatMatchWholeImage)
+{
+    WaveformBuffer buffer;
+    bool result = buffer.load("../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    ASSERT_TRUE(result);
+
+    const int tile_width = 300;
+    const int height = 100;
+
+    TileRenderer tile_renderer(2, [](GdImageRenderer& renderer) {
+        return renderer.setBarStyle(8, 4, false);
+    });
+
+    result = tile_renderer.setTileSize(tile_width, height);
+    ASSERT_TRUE(result);
+
+    result = tile_renderer.render(buffer, audacity_waveform_colors, directory_);
+    ASSERT_TRUE(result);
+
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".png");
+    FileDeleter deleter(filename);
+
+    GdImageRenderer renderer;
+    renderer.setBarStyle(8, 4, false);
+    renderer.enableAxisLabels(false);
+
+    result = renderer.create(buffer, buffer.getSize(), height, audacity_waveform_colors);
+    ASSERT_TRUE(result);
+
+    result = renderer.saveAsPng(filename.c_str());
+    ASSERT_TRUE(result);
+
+    gdImagePtr image = ImageUtil::loadPng(filename);
+    ASSERT_TRUE(image != nullptr);
+
+    int x = 0;
+
+    for (int i = 0; x < buffer.getSize(); ++i) {
+        gdImagePtr tile = ImageUtil::loadPng(directory_ / "0" / (std::to_string(i) + ".png"));
+        ASSERT_TRUE(tile != nullptr);
+
+        const int expected_width = std::min(tile_width, buffer.getSize() - x);
+        ASSERT_THAT(gdImageSX(tile), Eq(expected_width));
+        ASSERT_THAT(gdImageSY(tile), Eq(height));
+
+        for (int tile_x = 0; tile_x < gdImageSX(tile); ++tile_x) {
+            for (int y = 0; y < height; ++y) {
+                ASSERT_THAT(
+                    gdImageGetTrueColorPixel(tile, tile_x, y),
+                    Eq(gdImageGetTrueColorPixel(image, x + tile_x, y))
+                );
+            }
+        }
+
+        x += gdImageSX(tile);
+
+        gdImageDestroy(tile);
+    }
+
+    gdImageDestroy(image);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(TileRendererTest, shouldReportErrorIfTileWidthIsInvalid)
+{
+    TileRenderer tile_renderer(1, configureRenderer);
+
+    bool result = tile_renderer.setTileSize(0, 100);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq("Invalid tile width: minimum 1\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(TileRendererTest, shouldReportErrorIfBufferIsEmpty)
+{
+    WaveformBuffer buffer;
+
+    TileRenderer tile_renderer(1, configureRenderer);
+
+    bool result = tile_renderer.render(buffer, audacity_waveform_colors, directory_);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq("Empty waveform buffer\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(TileRendererTest, shouldReportErrorFromWorkerThreads)
+{
+    WaveformBuffer buffer;
+    bool result = buffer.load("../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    ASSERT_TRUE(result);
+
+    TileRenderer tile_renderer(2, [](GdImageRenderer& renderer) {
+        return renderer.setBarStyle(0, 4, false);
+    });
+
+    result = tile_renderer.render(buffer, audacity_waveform_colors, directory_);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), HasSubstr("Invalid bar width: minimum 1\n"));
+    ASSERT_FALSE(boost::filesystem::exists(directory_ / "manifest.json"));
+}
+
+//------------------------------------------------------------------------------
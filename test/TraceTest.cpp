@@ -0,0 +1,174 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "Trace.h"
+
+#include "util/FileDeleter.h"
+#include "util/FileUtil.h"
+#include "util/Streams.h"
+
+#include "gmock/gmock.h"
+
+#include <string>
+#include <thread>
+
+//------------------------------------------------------------------------------
+
+using testing::EndsWith;
+using testing::HasSubstr;
+using testing::Not;
+using testing::StartsWith;
+using testing::StrEq;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class TraceTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+        }
+
+        virtual void TearDown()
+        {
+        }
+};
+
+//------------------------------------------------------------------------------
+
+TEST_F(TraceTest, shouldNotBeEnabledByDefault)
+{
+    ASSERT_FALSE(Trace::isEnabled());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(TraceTest, shouldWriteTraceEvents)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    Trace::start();
+    ASSERT_TRUE(Trace::isEnabled());
+
+    {
+        TraceScope scope("decode", "read");
+    }
+
+    Trace::addInstantEvent("decode", "error");
+
+    bool result = Trace::stop(filename.c_str());
+    ASSERT_TRUE(result);
+    ASSERT_FALSE(Trace::isEnabled());
+
+    const std::string trace = FileUtil::readTextFile(filename);
+
+    ASSERT_THAT(trace, StartsWith("{\"traceEvents\":["));
+    ASSERT_THAT(trace, EndsWith("],\"displayTimeUnit\":\"ms\"}\n"));
+    ASSERT_THAT(trace, HasSubstr("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"audiowaveform\"}}"));
+    ASSERT_THAT(trace, HasSubstr("{\"name\":\"read\",\"cat\":\"decode\",\"ph\":\"X\",\"ts\":"));
+    ASSERT_THAT(trace, HasSubstr("{\"name\":\"error\",\"cat\":\"decode\",\"ph\":\"i\",\"ts\":"));
+    ASSERT_THAT(trace, HasSubstr(",\"s\":\"t\",\"pid\":1,\"tid\":"));
+
+    ASSERT_THAT(error.str(), StrEq("Trace events: 2\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(TraceTest, shouldNotRecordEventsWhenNotStarted)
+{
+    {
+        TraceScope scope("render", "draw");
+    }
+
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    Trace::start();
+
+    bool result = Trace::stop(filename.c_str());
+    ASSERT_TRUE(result);
+
+    const std::string trace = FileUtil::readTextFile(filename);
+
+    ASSERT_THAT(trace, Not(HasSubstr("\"draw\"")));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(TraceTest, shouldRecordEventsFromEachThread)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    Trace::start();
+
+    {
+        TraceScope scope("process", "main");
+    }
+
+    std::thread thread([] {
+        TraceScope scope("process", "worker");
+    });
+
+    thread.join();
+
+    bool result = Trace::stop(filename.c_str());
+    ASSERT_TRUE(result);
+
+    const std::string trace = FileUtil::readTextFile(filename);
+
+    const size_t main_pos = trace.find("\"name\":\"main\"");
+    const size_t worker_pos = trace.find("\"name\":\"worker\"");
+
+    ASSERT_NE(main_pos, std::string::npos);
+    ASSERT_NE(worker_pos, std::string::npos);
+
+    // Each event's thread id is the last member
+    const std::string main_tid = trace.substr(
+        trace.find("\"tid\":", main_pos),
+        trace.find('}', main_pos) - trace.find("\"tid\":", main_pos)
+    );
+
+    const std::string worker_tid = trace.substr(
+        trace.find("\"tid\":", worker_pos),
+        trace.find('}', worker_pos) - trace.find("\"tid\":", worker_pos)
+    );
+
+    ASSERT_THAT(main_tid, Not(StrEq(worker_tid)));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(TraceTest, shouldReportErrorIfFileCannotBeWritten)
+{
+    Trace::start();
+
+    bool result = Trace::stop("/nonexistent/trace.json");
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), StartsWith("Failed to write trace file: /nonexistent/trace.json\n"));
+}
+
+//------------------------------------------------------------------------------
@@ -28,7 +28,12 @@
 
 #include "gmock/gmock.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
 
 //------------------------------------------------------------------------------
 
@@ -36,7 +41,10 @@ using testing::EndsWith;
 using testing::Eq;
 using testing::Gt;
 using testing::HasSubstr;
+using testing::Lt;
 using testing::Ne;
+using testing::Not;
+using testing::StartsWith;
 using testing::StrEq;
 using testing::Test;
 
@@ -175,7 +183,7 @@ TEST_F(WaveformBufferTest, shouldLoad8BitVersion2DataFile)
 
 TEST_F(WaveformBufferTest, shouldNotLoadUnknownVersionDataFile)
 {
-    const char* filename = "../test/data/version3.dat";
+    const char* filename = "../test/data/version4.dat";
 
     bool result = buffer_.load(filename);
     ASSERT_FALSE(result);
@@ -184,7 +192,7 @@ TEST_F(WaveformBufferTest, shouldNotLoadUnknownVersionDataFile)
 
     std::string str = error.str();
     ASSERT_THAT(str, HasSubstr(filename));
-    ASSERT_THAT(str, HasSubstr("Cannot load data file version: 3"));
+    ASSERT_THAT(str, HasSubstr("Cannot load data file version: 4"));
     ASSERT_THAT(str, EndsWith("\n"));
 }
 
@@ -296,6 +304,402 @@ TEST_F(WaveformBufferTest, shouldLoadDataFileIfSizeIsZero)
 
 //------------------------------------------------------------------------------
 
+// Loads the file from standard input, which reads each value from a stream,
+// and checks the result is the same as loading the file by name.
+
+static void testLoadFromStandardInput(const char* filename)
+{
+    WaveformBuffer buffer;
+
+    bool result = buffer.load(filename);
+    ASSERT_TRUE(result);
+
+    WaveformBuffer stdin_buffer;
+
+    {
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        std::streambuf* streambuf = std::cin.rdbuf(file.rdbuf());
+
+        result = stdin_buffer.load("-");
+
+        std::cin.rdbuf(streambuf);
+        std::cin.clear();
+    }
+
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(stdin_buffer.getSampleRate(), Eq(buffer.getSampleRate()));
+    ASSERT_THAT(stdin_buffer.getSamplesPerPixel(), Eq(buffer.getSamplesPerPixel()));
+    ASSERT_THAT(stdin_buffer.getBits(), Eq(buffer.getBits()));
+    ASSERT_THAT(stdin_buffer.getChannels(), Eq(buffer.getChannels()));
+    ASSERT_THAT(stdin_buffer.getSize(), Eq(buffer.getSize()));
+
+    for (int i = 0; i < buffer.getSize(); ++i) {
+        for (int channel = 0; channel < buffer.getChannels(); ++channel) {
+            ASSERT_THAT(stdin_buffer.getMinSample(channel, i), Eq(buffer.getMinSample(channel, i)));
+            ASSERT_THAT(stdin_buffer.getMaxSample(channel, i), Eq(buffer.getMaxSample(channel, i)));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadSame16BitDataFromStandardInput)
+{
+    testLoadFromStandardInput("../test/data/test_file_stereo_16bit_64spp_wav_v2.dat");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadSame8BitDataFromStandardInput)
+{
+    testLoadFromStandardInput("../test/data/test_file_stereo_8bit_64spp_wav_v2.dat");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadSameDataFromStandardInputIfSizeMismatch)
+{
+    testLoadFromStandardInput("../test/data/size_mismatch.dat");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadMultiChannel8BitDataFile)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    // Version 2, 8-bit, 2 channels, 3 points, the last incomplete
+    const int32_t header[] = { 2, 1, 44100, 256, 3, 2 };
+    const int8_t data[] = { -1, 1, -2, 2, -128, 127, -4, 4, 0 };
+
+    {
+        std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data), sizeof(data));
+    }
+
+    bool result = buffer_.load(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(buffer_.getChannels(), Eq(2));
+    ASSERT_THAT(buffer_.getBits(), Eq(8));
+    ASSERT_THAT(buffer_.getSize(), Eq(2));
+
+    ASSERT_THAT(buffer_.getMinSample(0, 0), Eq(-256));
+    ASSERT_THAT(buffer_.getMaxSample(0, 0), Eq(256));
+    ASSERT_THAT(buffer_.getMinSample(1, 0), Eq(-512));
+    ASSERT_THAT(buffer_.getMaxSample(1, 0), Eq(512));
+    ASSERT_THAT(buffer_.getMinSample(0, 1), Eq(-32768));
+    ASSERT_THAT(buffer_.getMaxSample(0, 1), Eq(32512));
+    ASSERT_THAT(buffer_.getMinSample(1, 1), Eq(-1024));
+    ASSERT_THAT(buffer_.getMaxSample(1, 1), Eq(1024));
+
+    ASSERT_THAT(error.str(), EndsWith(
+        "Expected 3 points, read 2 min and max points\n"
+    ));
+
+    testLoadFromStandardInput(filename.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadDataFileWithUnknownLength)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    // Version 2, 16-bit, 2 channels, unknown length, 2 points followed by
+    // an incomplete point
+    const uint32_t header[] = { 2, 0, 44100, 256, WaveformBuffer::UNKNOWN_LENGTH, 2 };
+    const int16_t data[] = { -1, 1, -2, 2, -3, 3, -4, 4, -5, 5, -6 };
+
+    {
+        std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data), sizeof(data));
+    }
+
+    bool result = buffer_.load(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(buffer_.getChannels(), Eq(2));
+    ASSERT_THAT(buffer_.getBits(), Eq(16));
+    ASSERT_THAT(buffer_.getSize(), Eq(2));
+
+    ASSERT_THAT(buffer_.getMinSample(0, 0), Eq(-1));
+    ASSERT_THAT(buffer_.getMaxSample(0, 0), Eq(1));
+    ASSERT_THAT(buffer_.getMinSample(1, 1), Eq(-4));
+    ASSERT_THAT(buffer_.getMaxSample(1, 1), Eq(4));
+
+    ASSERT_THAT(error.str(), Not(HasSubstr("Expected")));
+
+    testLoadFromStandardInput(filename.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+static void writeTextFile(
+    const boost::filesystem::path& filename,
+    const std::string& text)
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+    file << text;
+}
+
+//------------------------------------------------------------------------------
+
+static void assertSameData(
+    const WaveformBuffer& buffer,
+    const WaveformBuffer& expected_buffer)
+{
+    ASSERT_THAT(buffer.getSampleRate(), Eq(expected_buffer.getSampleRate()));
+    ASSERT_THAT(buffer.getSamplesPerPixel(), Eq(expected_buffer.getSamplesPerPixel()));
+    ASSERT_THAT(buffer.getBits(), Eq(expected_buffer.getBits()));
+    ASSERT_THAT(buffer.getChannels(), Eq(expected_buffer.getChannels()));
+    ASSERT_THAT(buffer.getSize(), Eq(expected_buffer.getSize()));
+
+    for (int i = 0; i < buffer.getSize(); ++i) {
+        for (int channel = 0; channel < buffer.getChannels(); ++channel) {
+            ASSERT_THAT(buffer.getMinSample(channel, i), Eq(expected_buffer.getMinSample(channel, i)));
+            ASSERT_THAT(buffer.getMaxSample(channel, i), Eq(expected_buffer.getMaxSample(channel, i)));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadJsonFile)
+{
+    bool result = buffer_.loadJson("../test/data/test_file_stereo_8bit_64spp_wav.json");
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StrEq(
+        "Input file: ../test/data/test_file_stereo_8bit_64spp_wav.json\n"
+        "Channels: 1\n"
+        "Sample rate: 16000 Hz\n"
+        "Bits: 8\n"
+        "Samples per pixel: 64\n"
+        "Length: 1774 points\n"
+    ));
+
+    WaveformBuffer expected_buffer;
+
+    result = expected_buffer.load("../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    ASSERT_TRUE(result);
+
+    assertSameData(buffer_, expected_buffer);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadMultiChannelJsonFile)
+{
+    bool result = buffer_.loadJson("../test/data/07023003_8bit_64spp_2channel.json");
+    ASSERT_TRUE(result);
+
+    WaveformBuffer expected_buffer;
+
+    result = expected_buffer.load("../test/data/07023003_8bit_64spp_2channel.dat");
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(buffer_.getChannels(), Eq(2));
+    assertSameData(buffer_, expected_buffer);
+}
+
+//------------------------------------------------------------------------------
+
+// The data array is read without pdjson if it only contains integers, so
+// check that other values are read in the same way as before.
+
+TEST_F(WaveformBufferTest, shouldLoadJsonDataWithNonIntegerValues)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    writeTextFile(
+        filename,
+        "{\"version\":2,\"channels\":1,\"sample_rate\":44100,"
+        "\"samples_per_pixel\":256,\"bits\":16,\"length\":3,"
+        "\"data\":[-1,1.0,-2.5,2e1,-0,1E2]}"
+    );
+
+    bool result = buffer_.loadJson(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(buffer_.getSize(), Eq(3));
+
+    ASSERT_THAT(buffer_.getMinSample(0, 0), Eq(-1));
+    ASSERT_THAT(buffer_.getMaxSample(0, 0), Eq(1));
+    ASSERT_THAT(buffer_.getMinSample(0, 1), Eq(-2));
+    ASSERT_THAT(buffer_.getMaxSample(0, 1), Eq(20));
+    ASSERT_THAT(buffer_.getMinSample(0, 2), Eq(0));
+    ASSERT_THAT(buffer_.getMaxSample(0, 2), Eq(100));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadJsonDataWithWhitespace)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    writeTextFile(
+        filename,
+        "{\n"
+        "  \"version\": 2,\n"
+        "  \"channels\": 2,\n"
+        "  \"sample_rate\": 44100,\n"
+        "  \"samples_per_pixel\": 256,\n"
+        "  \"bits\": 8,\n"
+        "  \"length\": 2,\n"
+        "  \"data\": [\n"
+        "    -128, 127,\t-2 ,2,\r\n"
+        "    0,0, -4,\n"
+        "    4\n"
+        "  ]\n"
+        "}\n"
+    );
+
+    bool result = buffer_.loadJson(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(buffer_.getChannels(), Eq(2));
+    ASSERT_THAT(buffer_.getSize(), Eq(2));
+
+    ASSERT_THAT(buffer_.getMinSample(0, 0), Eq(-32768));
+    ASSERT_THAT(buffer_.getMaxSample(0, 0), Eq(32512));
+    ASSERT_THAT(buffer_.getMinSample(1, 0), Eq(-512));
+    ASSERT_THAT(buffer_.getMaxSample(1, 0), Eq(512));
+    ASSERT_THAT(buffer_.getMinSample(0, 1), Eq(0));
+    ASSERT_THAT(buffer_.getMaxSample(0, 1), Eq(0));
+    ASSERT_THAT(buffer_.getMinSample(1, 1), Eq(-1024));
+    ASSERT_THAT(buffer_.getMaxSample(1, 1), Eq(1024));
+
+    ASSERT_THAT(error.str(), Not(HasSubstr("Expected")));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadJsonWithEmptyDataArray)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    writeTextFile(
+        filename,
+        "{\"version\":2,\"channels\":1,\"sample_rate\":44100,"
+        "\"samples_per_pixel\":256,\"bits\":16,\"length\":0,\"data\":[ ]}"
+    );
+
+    bool result = buffer_.loadJson(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(buffer_.getSize(), Eq(0));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldReportErrorIf8BitJsonDataValueOutOfRange)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    writeTextFile(
+        filename,
+        "{\"version\":2,\"channels\":1,\"sample_rate\":44100,"
+        "\"samples_per_pixel\":256,\"bits\":8,\"length\":1,\"data\":[-1,128]}"
+    );
+
+    bool result = buffer_.loadJson(filename.c_str());
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), EndsWith("Data value out of range: 128\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldReportErrorIf16BitJsonDataValueOutOfRange)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    writeTextFile(
+        filename,
+        "{\"version\":2,\"channels\":1,\"sample_rate\":44100,"
+        "\"samples_per_pixel\":256,\"bits\":16,\"length\":1,\"data\":[-32769,0]}"
+    );
+
+    bool result = buffer_.loadJson(filename.c_str());
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), EndsWith("Data value out of range: -32769\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldReportErrorIfJsonDataArrayIsInvalid)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    writeTextFile(
+        filename,
+        "{\"version\":2,\"channels\":1,\"sample_rate\":44100,"
+        "\"samples_per_pixel\":256,\"bits\":16,\"length\":1,\"data\":[1,\"2\"]}"
+    );
+
+    bool result = buffer_.loadJson(filename.c_str());
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), EndsWith(
+        "Invalid JSON structure: the data array must only contain numbers\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldReportJsonErrorPositionAfterDataArray)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    const std::string json =
+        "{\"version\":2,\"channels\":1,\"sample_rate\":44100,"
+        "\"samples_per_pixel\":256,\"bits\":16,\"length\":1,\"data\":[\n"
+        "1,\n"
+        "2\n"
+        "],\n"
+        "3}";
+
+    writeTextFile(filename, json);
+
+    bool result = buffer_.loadJson(filename.c_str());
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), EndsWith(
+        "Invalid JSON format at line 5, column " +
+        std::to_string(json.size() - 1) + "\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldReportErrorIfJsonFileNotFound)
+{
+    bool result = buffer_.loadJson("../test/data/unknown.json");
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith(
+        "Failed to read file: ../test/data/unknown.json\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
 TEST_F(WaveformBufferSaveTest, shouldSaveEmptyDataFile)
 {
     const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
@@ -366,6 +770,391 @@ TEST_F(WaveformBufferSaveTest, shouldSave8BitDataFile)
 
 //------------------------------------------------------------------------------
 
+static void testSaveVersion3DataFile(const char* input_filename, const int bits)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.load(input_filename);
+    ASSERT_TRUE(result);
+
+    result = buffer.save(filename.c_str(), bits, 3);
+    ASSERT_TRUE(result);
+
+    const std::vector<uint8_t> data = FileUtil::readFile(filename);
+    ASSERT_THAT(data.size(), Gt(24U));
+
+    int32_t version;
+    memcpy(&version, &data[0], sizeof(version));
+    ASSERT_THAT(version, Eq(3));
+
+    // Smaller than the uncompressed data
+    const size_t uncompressed_size = static_cast<size_t>(
+        buffer.getSize() * buffer.getChannels() * 2 * (bits / 8)
+    );
+
+    ASSERT_THAT(data.size() - 24, Lt(uncompressed_size));
+
+    WaveformBuffer loaded_buffer;
+
+    result = loaded_buffer.load(filename.c_str());
+    ASSERT_TRUE(result);
+
+    assertSameData(loaded_buffer, buffer);
+
+    testLoadFromStandardInput(filename.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSave8BitVersion3DataFile)
+{
+    testSaveVersion3DataFile("../test/data/test_file_stereo_8bit_64spp_wav.dat", 8);
+    testSaveVersion3DataFile("../test/data/07023003_8bit_64spp_2channel.dat", 8);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSave16BitVersion3DataFile)
+{
+    testSaveVersion3DataFile("../test/data/test_file_stereo_16bit_64spp_wav.dat", 16);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldReportErrorIfInvalidFormatVersion)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.save(filename.c_str(), 16, 1);
+    ASSERT_FALSE(result);
+
+    ASSERT_FALSE(boost::filesystem::exists(filename));
+
+    ASSERT_THAT(error.str(), EndsWith(
+        "Invalid format version: must be either 2 or 3\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadTruncatedVersion3DataFile)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.load("../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    ASSERT_TRUE(result);
+
+    result = buffer.save(filename.c_str(), 8, 3);
+    ASSERT_TRUE(result);
+
+    boost::filesystem::resize_file(filename, 1000);
+
+    error.str(std::string());
+
+    result = buffer_.load(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(buffer_.getSize(), Gt(0));
+    ASSERT_THAT(buffer_.getSize(), Lt(buffer.getSize()));
+
+    for (int i = 0; i < buffer_.getSize(); ++i) {
+        ASSERT_THAT(buffer_.getMinSample(0, i), Eq(buffer.getMinSample(0, i)));
+        ASSERT_THAT(buffer_.getMaxSample(0, i), Eq(buffer.getMaxSample(0, i)));
+    }
+
+    ASSERT_THAT(error.str(), HasSubstr("Expected 1774 points, read "));
+
+    testLoadFromStandardInput(filename.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+static void testSaveIndexedDataFile(
+    const char* input_filename,
+    const int bits,
+    const int version)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.load(input_filename);
+    ASSERT_TRUE(result);
+
+    result = buffer.save(filename.c_str(), bits, version, 100);
+    ASSERT_TRUE(result);
+
+    const std::vector<uint8_t> data = FileUtil::readFile(filename);
+    ASSERT_THAT(data.size(), Gt(32U));
+
+    int32_t file_version;
+    memcpy(&file_version, &data[0], sizeof(file_version));
+    ASSERT_THAT(file_version, Eq(version == 0 ? 2 : version));
+
+    uint32_t flags;
+    memcpy(&flags, &data[4], sizeof(flags));
+    ASSERT_THAT(flags, Eq(bits == 8 ? 3U : 2U));
+
+    uint32_t block_size;
+    memcpy(&block_size, &data[24], sizeof(block_size));
+    ASSERT_THAT(block_size, Eq(100U));
+
+    uint32_t block_count;
+    memcpy(&block_count, &data[28], sizeof(block_count));
+    ASSERT_THAT(block_count, Eq(static_cast<uint32_t>((buffer.getSize() + 99) / 100)));
+
+    // The last offset is the end of the file
+    uint64_t end_offset;
+    memcpy(&end_offset, &data[32 + block_count * 8], sizeof(end_offset));
+    ASSERT_THAT(end_offset, Eq(data.size()));
+
+    WaveformBuffer loaded_buffer;
+
+    result = loaded_buffer.load(filename.c_str());
+    ASSERT_TRUE(result);
+
+    assertSameData(loaded_buffer, buffer);
+
+    testLoadFromStandardInput(filename.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSave8BitIndexedDataFile)
+{
+    testSaveIndexedDataFile("../test/data/test_file_stereo_8bit_64spp_wav.dat", 8, 0);
+    testSaveIndexedDataFile("../test/data/07023003_8bit_64spp_2channel.dat", 8, 2);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSave16BitIndexedDataFile)
+{
+    testSaveIndexedDataFile("../test/data/test_file_stereo_16bit_64spp_wav.dat", 16, 2);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSaveIndexedVersion3DataFile)
+{
+    testSaveIndexedDataFile("../test/data/test_file_stereo_8bit_64spp_wav.dat", 8, 3);
+    testSaveIndexedDataFile("../test/data/07023003_8bit_64spp_2channel.dat", 8, 3);
+    testSaveIndexedDataFile("../test/data/test_file_stereo_16bit_64spp_wav.dat", 16, 3);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldReportErrorIfInvalidBlockSize)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.save(filename.c_str(), 16, 2, -1);
+    ASSERT_FALSE(result);
+
+    ASSERT_FALSE(boost::filesystem::exists(filename));
+
+    ASSERT_THAT(error.str(), EndsWith(
+        "Invalid block size: must be greater than zero\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
+// Loads ranges of points from the file, and checks they are the same as the
+// same points from the whole file.
+
+static void testLoadPartOfDataFile(const char* filename)
+{
+    WaveformBuffer buffer;
+
+    bool result = buffer.load(filename);
+    ASSERT_TRUE(result);
+
+    const int size = buffer.getSize();
+
+    const int ranges[][2] = {
+        { 0, 100 },
+        { 150, 420 },
+        { size - 50, size + 50 },
+        { size + 100, size + 200 },
+        { 0, 0 }
+    };
+
+    for (const auto& range : ranges) {
+        WaveformBuffer part_buffer;
+
+        result = part_buffer.load(filename, range[0], range[1]);
+        ASSERT_TRUE(result);
+
+        ASSERT_THAT(part_buffer.getSampleRate(), Eq(buffer.getSampleRate()));
+        ASSERT_THAT(part_buffer.getSamplesPerPixel(), Eq(buffer.getSamplesPerPixel()));
+        ASSERT_THAT(part_buffer.getBits(), Eq(buffer.getBits()));
+        ASSERT_THAT(part_buffer.getChannels(), Eq(buffer.getChannels()));
+        ASSERT_THAT(part_buffer.getStartIndex(), Eq(range[0]));
+
+        const int expected_size = std::max(std::min(range[1], size) - range[0], 0);
+        ASSERT_THAT(part_buffer.getSize(), Eq(expected_size));
+
+        for (int i = 0; i < part_buffer.getSize(); ++i) {
+            for (int channel = 0; channel < buffer.getChannels(); ++channel) {
+                ASSERT_THAT(part_buffer.getMinSample(channel, i), Eq(buffer.getMinSample(channel, range[0] + i)));
+                ASSERT_THAT(part_buffer.getMaxSample(channel, i), Eq(buffer.getMaxSample(channel, range[0] + i)));
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadPartOfDataFile)
+{
+    testLoadPartOfDataFile("../test/data/test_file_stereo_8bit_64spp_wav.dat");
+    testLoadPartOfDataFile("../test/data/07023003_8bit_64spp_2channel.dat");
+    testLoadPartOfDataFile("../test/data/test_file_stereo_16bit_64spp_wav.dat");
+    testLoadPartOfDataFile("../test/data/test_file_stereo_8bit_64spp_wav_v3.dat");
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadPartOfIndexedDataFile)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.load("../test/data/07023003_8bit_64spp_2channel.dat");
+    ASSERT_TRUE(result);
+
+    for (int version = 2; version <= 3; ++version) {
+        result = buffer.save(filename.c_str(), 8, version, 64);
+        ASSERT_TRUE(result);
+
+        testLoadPartOfDataFile(filename.c_str());
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldOnlyReadBlocksInRangeFromIndexedDataFile)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.load("../test/data/07023003_8bit_64spp_2channel.dat");
+    ASSERT_TRUE(result);
+
+    result = buffer.save(filename.c_str(), 8, 3, 100);
+    ASSERT_TRUE(result);
+
+    // Make the first block invalid, by setting its Rice parameter to more
+    // than the number of bits in a value plus one
+    std::vector<uint8_t> data = FileUtil::readFile(filename);
+
+    uint64_t block_offset;
+    memcpy(&block_offset, &data[32], sizeof(block_offset));
+
+    data[block_offset] = 0xff;
+
+    writeTextFile(filename, std::string(data.begin(), data.end()));
+
+    result = buffer_.load(filename.c_str(), 200, 300);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(buffer_.getSize(), Eq(100));
+    ASSERT_THAT(buffer_.getMinSample(0, 0), Eq(buffer.getMinSample(0, 200)));
+    ASSERT_THAT(buffer_.getMaxSample(1, 99), Eq(buffer.getMaxSample(1, 299)));
+
+    WaveformBuffer whole_buffer;
+
+    result = whole_buffer.load(filename.c_str());
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), EndsWith("Invalid compressed data\n"));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldLoadTruncatedIndexedDataFile)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.load("../test/data/07023003_8bit_64spp_2channel.dat");
+    ASSERT_TRUE(result);
+
+    result = buffer.save(filename.c_str(), 8, 2, 100);
+    ASSERT_TRUE(result);
+
+    // 2 channels, 8-bit: 4 bytes per point
+    const std::vector<uint8_t> data = FileUtil::readFile(filename);
+    boost::filesystem::resize_file(filename, data.size() - 1000);
+
+    error.str(std::string());
+
+    result = buffer_.load(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(buffer_.getSize(), Eq(buffer.getSize() - 250));
+
+    for (int i = 0; i < buffer_.getSize(); ++i) {
+        ASSERT_THAT(buffer_.getMinSample(0, i), Eq(buffer.getMinSample(0, i)));
+        ASSERT_THAT(buffer_.getMaxSample(1, i), Eq(buffer.getMaxSample(1, i)));
+    }
+
+    ASSERT_THAT(error.str(), HasSubstr("Expected 10438 points, read 10188 min and max points\n"));
+
+    testLoadFromStandardInput(filename.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferTest, shouldReportErrorIfInvalidBlockIndex)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.load("../test/data/07023003_8bit_64spp_2channel.dat");
+    ASSERT_TRUE(result);
+
+    result = buffer.save(filename.c_str(), 8, 2, 100);
+    ASSERT_TRUE(result);
+
+    // Block count doesn't match the length
+    std::vector<uint8_t> data = FileUtil::readFile(filename);
+    data[28] = 1;
+
+    writeTextFile(filename, std::string(data.begin(), data.end()));
+
+    error.str(std::string());
+
+    result = buffer_.load(filename.c_str());
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), EndsWith(
+        "Failed to read data file: " + filename.string() + "\n"
+        "Invalid block index\n"
+    ));
+}
+//------------------------------------------------------------------------------
+
 TEST_F(WaveformBufferSaveTest, shouldReportErrorIfNot8Or16Bits)
 {
     const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
@@ -562,3 +1351,209 @@ TEST_F(WaveformBufferSaveTest, shouldSave8BitJsonFile)
 }
 
 //------------------------------------------------------------------------------
+
+// Fills the buffer with every 16-bit value, so that the text and JSON output
+// covers every value that can be written.
+
+static void fillWithAllValues(WaveformBuffer& buffer, int channels)
+{
+    buffer.setChannels(channels);
+    buffer.setSampleRate(44100);
+    buffer.setSamplesPerPixel(256);
+
+    for (int value = -32768; value <= 32767; value += 2) {
+        buffer.appendSamples(static_cast<short>(value), static_cast<short>(value + 1));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the text that saveAsText() wrote when each value was formatted
+// using std::ostream.
+
+static std::string getExpectedText(const WaveformBuffer& buffer, int bits)
+{
+    const int divisor = bits == 8 ? 256 : 1;
+
+    std::ostringstream stream;
+
+    for (int i = 0; i < buffer.getSize(); ++i) {
+        for (int channel = 0; channel < buffer.getChannels(); ++channel) {
+            if (channel > 0) {
+                stream << ',';
+            }
+
+            stream << buffer.getMinSample(channel, i) / divisor << ','
+                   << buffer.getMaxSample(channel, i) / divisor;
+        }
+
+        stream << '\n';
+    }
+
+    return stream.str();
+}
+
+//------------------------------------------------------------------------------
+
+// Returns the JSON that saveAsJson() wrote when each value was formatted
+// using std::ostream.
+
+static std::string getExpectedJson(const WaveformBuffer& buffer, int bits)
+{
+    const int divisor = bits == 8 ? 256 : 1;
+
+    std::ostringstream stream;
+
+    stream << "{\"version\":2"
+           << ",\"channels\":" << buffer.getChannels()
+           << ",\"sample_rate\":" << buffer.getSampleRate()
+           << ",\"samples_per_pixel\":" << buffer.getSamplesPerPixel()
+           << ",\"bits\":" << bits
+           << ",\"length\":" << buffer.getSize()
+           << ",\"data\":[";
+
+    for (int i = 0; i < buffer.getSize(); ++i) {
+        for (int channel = 0; channel < buffer.getChannels(); ++channel) {
+            if (i > 0 || channel > 0) {
+                stream << ',';
+            }
+
+            stream << buffer.getMinSample(channel, i) / divisor << ','
+                   << buffer.getMaxSample(channel, i) / divisor;
+        }
+    }
+
+    stream << "]}\n";
+
+    return stream.str();
+}
+
+//------------------------------------------------------------------------------
+
+static void testSaveSameText(int bits, int channels)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".txt");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+    fillWithAllValues(buffer, channels);
+
+    bool result = buffer.saveAsText(filename.c_str(), bits);
+    ASSERT_TRUE(result);
+
+    const std::string data = FileUtil::readTextFile(filename.c_str());
+
+    ASSERT_TRUE(data == getExpectedText(buffer, bits));
+}
+
+//------------------------------------------------------------------------------
+
+static void testSaveSameJson(int bits, int channels)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".json");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+    fillWithAllValues(buffer, channels);
+
+    bool result = buffer.saveAsJson(filename.c_str(), bits);
+    ASSERT_TRUE(result);
+
+    const std::string data = FileUtil::readTextFile(filename.c_str());
+
+    ASSERT_TRUE(data == getExpectedJson(buffer, bits));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSaveSame16BitTextAsStreamFormatting)
+{
+    testSaveSameText(16, 1);
+    testSaveSameText(16, 2);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSaveSame8BitTextAsStreamFormatting)
+{
+    testSaveSameText(8, 1);
+    testSaveSameText(8, 2);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSaveSame16BitJsonAsStreamFormatting)
+{
+    testSaveSameJson(16, 1);
+    testSaveSameJson(16, 2);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSaveSame8BitJsonAsStreamFormatting)
+{
+    testSaveSameJson(8, 1);
+    testSaveSameJson(8, 2);
+}
+
+//------------------------------------------------------------------------------
+
+static void testSaveSameAsReferenceFile(
+    const char* input_filename,
+    const char* reference_filename,
+    bool json)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(json ? ".json" : ".txt");
+    FileDeleter deleter(filename);
+
+    WaveformBuffer buffer;
+
+    bool result = buffer.load(input_filename);
+    ASSERT_TRUE(result);
+
+    result = json ?
+        buffer.saveAsJson(filename.c_str(), 8) :
+        buffer.saveAsText(filename.c_str(), 8);
+
+    ASSERT_TRUE(result);
+
+    ASSERT_TRUE(
+        FileUtil::readFile(filename) == FileUtil::readFile(reference_filename)
+    );
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSaveSameJsonAsReferenceFiles)
+{
+    testSaveSameAsReferenceFile(
+        "../test/data/test_file_stereo_8bit_64spp_wav.dat",
+        "../test/data/test_file_stereo_8bit_64spp_wav.json",
+        true
+    );
+
+    testSaveSameAsReferenceFile(
+        "../test/data/07023003_8bit_64spp_2channel.dat",
+        "../test/data/07023003_8bit_64spp_2channel.json",
+        true
+    );
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformBufferSaveTest, shouldSaveSameTextAsReferenceFiles)
+{
+    testSaveSameAsReferenceFile(
+        "../test/data/test_file_stereo_8bit_64spp_wav.dat",
+        "../test/data/test_file_stereo_8bit_64spp_wav.txt",
+        false
+    );
+
+    testSaveSameAsReferenceFile(
+        "../test/data/07023003_8bit_64spp_2channel.dat",
+        "../test/data/07023003_8bit_64spp_2channel.txt",
+        false
+    );
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,337 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "WaveformCodec.h"
+#include "WaveformBuffer.h"
+
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::Lt;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class WaveformCodecTest : public Test
+{
+};
+
+//------------------------------------------------------------------------------
+
+// Fills the buffer with a random walk, with steps of the given maximum size.
+// Values are multiples of 256 for 8-bit data.
+
+static void createTestData(
+    WaveformBuffer& buffer,
+    const int channels,
+    const int bits,
+    const int size,
+    const int max_step)
+{
+    buffer.setChannels(channels);
+    buffer.setSize(size);
+
+    const int min_value = bits == 8 ? INT8_MIN : INT16_MIN;
+    const int max_value = bits == 8 ? INT8_MAX : INT16_MAX;
+    const int scale     = bits == 8 ? 256 : 1;
+
+    uint32_t seed = 12345;
+    int value = 0;
+
+    auto next = [&]() {
+        seed = seed * 1664525U + 1013904223U;
+
+        const int step = static_cast<int>(seed >> 8) % (2 * max_step + 1) - max_step;
+
+        value = std::max(min_value, std::min(max_value, value + step));
+
+        return static_cast<short>(value * scale);
+    };
+
+    for (int i = 0; i < size; ++i) {
+        for (int channel = 0; channel < channels; ++channel) {
+            const short min = next();
+            const short max = next();
+
+            buffer.setSamples(channel, i, min, max);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static std::vector<char> encode(const WaveformBuffer& buffer, const int bits)
+{
+    WaveformCodec::Encoder encoder(buffer.getChannels(), bits);
+
+    std::vector<char> data;
+    encoder.encode(buffer, data);
+    encoder.finish(data);
+
+    return data;
+}
+
+//------------------------------------------------------------------------------
+
+static bool decode(
+    const std::vector<char>& data,
+    const int channels,
+    const int bits,
+    const size_t max_values,
+    std::vector<short>& values)
+{
+    return WaveformCodec::decode(
+        reinterpret_cast<const unsigned char*>(data.data()),
+        data.size(),
+        channels,
+        bits,
+        max_values,
+        values
+    );
+}
+
+//------------------------------------------------------------------------------
+
+static void testRoundTrip(
+    const int channels,
+    const int bits,
+    const int size,
+    const int max_step)
+{
+    WaveformBuffer buffer;
+    createTestData(buffer, channels, bits, size, max_step);
+
+    const std::vector<char> data = encode(buffer, bits);
+
+    const size_t value_count = static_cast<size_t>(size * channels * 2);
+
+    std::vector<short> values;
+
+    bool result = decode(data, channels, bits, value_count, values);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(values.size(), Eq(value_count));
+
+    size_t index = 0;
+
+    for (int i = 0; i < size; ++i) {
+        for (int channel = 0; channel < channels; ++channel) {
+            ASSERT_THAT(values[index++], Eq(buffer.getMinSample(channel, i)));
+            ASSERT_THAT(values[index++], Eq(buffer.getMaxSample(channel, i)));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldEncodeAndDecode16BitData)
+{
+    testRoundTrip(1, 16, 1000, 100);
+    testRoundTrip(2, 16, 1000, 3000);
+    testRoundTrip(5, 16, 333, 20);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldEncodeAndDecode8BitData)
+{
+    testRoundTrip(1, 8, 1000, 10);
+    testRoundTrip(2, 8, 1000, 100);
+    testRoundTrip(3, 8, 77, 1);
+}
+
+//------------------------------------------------------------------------------
+
+// Steps larger than the range of values give residuals that need the escape
+// code, and values at both ends of the range.
+
+TEST_F(WaveformCodecTest, shouldEncodeAndDecodeFullRangeData)
+{
+    testRoundTrip(1, 16, 1000, 70000);
+    testRoundTrip(2, 8, 1000, 300);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldEncodeAndDecodeConstantData)
+{
+    testRoundTrip(2, 16, 1000, 0);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldEncodeEmptyBuffer)
+{
+    WaveformBuffer buffer;
+
+    const std::vector<char> data = encode(buffer, 16);
+    ASSERT_TRUE(data.empty());
+
+    std::vector<short> values;
+
+    bool result = decode(data, 1, 16, 100, values);
+    ASSERT_TRUE(result);
+    ASSERT_TRUE(values.empty());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldEncodeBufferInParts)
+{
+    WaveformBuffer buffer;
+    createTestData(buffer, 2, 16, 1000, 500);
+
+    WaveformBuffer part;
+    part.setChannels(2);
+
+    WaveformCodec::Encoder encoder(2, 16);
+    std::vector<char> data;
+
+    // Encode 7 points at a time, as WaveformWriter does while the points are
+    // being generated
+    for (int i = 0; i < buffer.getSize(); ++i) {
+        for (int channel = 0; channel < 2; ++channel) {
+            part.appendSamples(buffer.getMinSample(channel, i), buffer.getMaxSample(channel, i));
+        }
+
+        if (part.getSize() == 7) {
+            encoder.encode(part, data);
+            part.setSize(0);
+        }
+    }
+
+    encoder.encode(part, data);
+    encoder.finish(data);
+
+    ASSERT_TRUE(data == encode(buffer, 16));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldCompressData)
+{
+    WaveformBuffer buffer;
+    createTestData(buffer, 1, 16, 10000, 200);
+
+    const std::vector<char> data = encode(buffer, 16);
+
+    // About 10 bits per value, instead of 16
+    ASSERT_THAT(data.size(), Lt(10000U * 2 * 2 * 3 / 4));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldDecodeUpToMaxValues)
+{
+    WaveformBuffer buffer;
+    createTestData(buffer, 1, 16, 1000, 100);
+
+    const std::vector<char> data = encode(buffer, 16);
+
+    std::vector<short> values;
+
+    bool result = decode(data, 1, 16, 301, values);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(values.size(), Eq(301U));
+    ASSERT_THAT(values[300], Eq(buffer.getMinSample(0, 150)));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldDecodeTruncatedData)
+{
+    WaveformBuffer buffer;
+    createTestData(buffer, 1, 16, 1000, 100);
+
+    std::vector<char> data = encode(buffer, 16);
+    data.resize(data.size() / 2);
+
+    std::vector<short> values;
+
+    bool result = decode(data, 1, 16, 2000, values);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(values.size(), Lt(2000U));
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        const int index = static_cast<int>(i / 2);
+
+        ASSERT_THAT(
+            values[i],
+            Eq(i % 2 == 0 ? buffer.getMinSample(0, index) : buffer.getMaxSample(0, index))
+        );
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldNotDecodeInvalidRiceParameter)
+{
+    // The parameter must be at most 9 for 8-bit data
+    const std::vector<char> data{ 10, 0x01, 0x01 };
+
+    std::vector<short> values;
+
+    bool result = decode(data, 1, 8, 2, values);
+    ASSERT_FALSE(result);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformCodecTest, shouldNotDecodeOutOfRangeValues)
+{
+    // Rice parameter 8, then codes for the 8-bit residuals -128 (minimum),
+    // 127 (maximum), then -1, which gives a minimum value of -129. Each code
+    // is a one bit, for a quotient of zero, then the zigzag encoded residual
+    // in 8 bits.
+    const uint64_t codes[] = { 1 | (255 << 1), 1 | (254 << 1), 1 | (1 << 1) };
+
+    const uint64_t bits = codes[0] | (codes[1] << 9) | (codes[2] << 18);
+
+    std::vector<char> data{ 8 };
+
+    for (int i = 0; i < 4; ++i) {
+        data.push_back(static_cast<char>((bits >> (i * 8)) & 0xff));
+    }
+
+    std::vector<short> values;
+
+    bool result = decode(data, 1, 8, 2, values);
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(values.size(), Eq(2U));
+    ASSERT_THAT(values[0], Eq(-128 * 256));
+    ASSERT_THAT(values[1], Eq(127 * 256));
+
+    values.clear();
+
+    result = decode(data, 1, 8, 3, values);
+    ASSERT_FALSE(result);
+}
+
+//------------------------------------------------------------------------------
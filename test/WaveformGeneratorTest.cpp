@@ -23,18 +23,22 @@
 
 #include "WaveformBuffer.h"
 #include "WaveformGenerator.h"
+#include "WaveformRescaler.h"
 #include "util/Streams.h"
 
 #include "gmock/gmock.h"
 
+#include <algorithm>
 #include <climits>
 #include <stdexcept>
+#include <vector>
 
 //------------------------------------------------------------------------------
 
 using testing::EndsWith;
 using testing::Eq;
 using testing::HasSubstr;
+using testing::Lt;
 using testing::StartsWith;
 using testing::StrEq;
 using testing::Test;
@@ -416,3 +420,280 @@ TEST_F(WaveformGeneratorTest, shouldComputeMaxAndMinValuesFromMonoInput)
 }
 
 //------------------------------------------------------------------------------
+
+TEST_F(WaveformGeneratorTest, shouldGiveSameResultWhenInputIsProcessedInChunks)
+{
+    const int sample_rate       = 44100;
+    const int samples_per_pixel = 37;
+    const int frames            = 1000;
+
+    for (int channels = 1; channels <= 5; ++channels) {
+        for (int split = 0; split < 2; ++split) {
+            const bool split_channels = split != 0;
+
+            std::vector<short> samples(static_cast<size_t>(frames * channels));
+
+            for (size_t i = 0; i < samples.size(); ++i) {
+                samples[i] = static_cast<short>((i * 7919) % 65536 - 32768);
+            }
+
+            SamplesPerPixelScaleFactor scale_factor(samples_per_pixel);
+
+            WaveformBuffer expected_buffer;
+            WaveformGenerator expected_generator(expected_buffer, split_channels, scale_factor);
+
+            ASSERT_TRUE(expected_generator.init(sample_rate, channels, 0, frames * channels));
+            ASSERT_TRUE(expected_generator.process(&samples[0], frames));
+            expected_generator.done();
+
+            WaveformBuffer buffer;
+            WaveformGenerator generator(buffer, split_channels, scale_factor);
+
+            ASSERT_TRUE(generator.init(sample_rate, channels, 0, frames * channels));
+
+            // Irregular chunk sizes, so that output points span calls to
+            // process()
+            const int chunk_sizes[] = { 1, 5, 36, 38, 100, 3 };
+
+            int frame = 0;
+
+            for (int i = 0; frame < frames; ++i) {
+                const int chunk_size = std::min(chunk_sizes[i % 6], frames - frame);
+
+                ASSERT_TRUE(generator.process(&samples[static_cast<size_t>(frame * channels)], chunk_size));
+
+                frame += chunk_size;
+            }
+
+            generator.done();
+
+            const int output_channels = split_channels ? channels : 1;
+
+            ASSERT_THAT(buffer.getChannels(), Eq(output_channels));
+            ASSERT_THAT(buffer.getSize(), Eq(expected_buffer.getSize()));
+            ASSERT_THAT(buffer.getSize(), Eq(28)); // 1000 / 37 = 27 remainder 1
+
+            for (int channel = 0; channel < output_channels; ++channel) {
+                for (int i = 0; i < buffer.getSize(); ++i) {
+                    ASSERT_THAT(buffer.getMinSample(channel, i), Eq(expected_buffer.getMinSample(channel, i)));
+                    ASSERT_THAT(buffer.getMaxSample(channel, i), Eq(expected_buffer.getMaxSample(channel, i)));
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Floating point input gives the same result as converting each sample to
+// 16-bit first, as SndFileAudioFileReader does for processors that don't
+// support floating point input.
+
+TEST_F(WaveformGeneratorTest, shouldGiveSameResultFromFloatingPointInput)
+{
+    const int sample_rate       = 44100;
+    const int samples_per_pixel = 37;
+    const int frames            = 1000;
+
+    for (int channels = 1; channels <= 3; ++channels) {
+        std::vector<float> float_samples(static_cast<size_t>(frames * channels));
+        std::vector<short> samples(float_samples.size());
+
+        for (size_t i = 0; i < samples.size(); ++i) {
+            float_samples[i] = static_cast<float>((i * 7919) % 20001) / 10000.0f - 1.0f;
+
+            samples[i] = static_cast<short>(float_samples[i] * SHRT_MAX);
+        }
+
+        SamplesPerPixelScaleFactor scale_factor(samples_per_pixel);
+
+        WaveformBuffer expected_buffer;
+        WaveformGenerator expected_generator(expected_buffer, true, scale_factor);
+
+        ASSERT_TRUE(expected_generator.init(sample_rate, channels, 0, frames * channels));
+        ASSERT_TRUE(expected_generator.process(&samples[0], frames));
+        expected_generator.done();
+
+        WaveformBuffer buffer;
+        WaveformGenerator generator(buffer, true, scale_factor);
+
+        ASSERT_TRUE(generator.supportsFloat());
+        ASSERT_TRUE(generator.init(sample_rate, channels, 0, frames * channels));
+        ASSERT_TRUE(generator.processFloat(&float_samples[0], 500));
+        ASSERT_TRUE(generator.processFloat(&float_samples[static_cast<size_t>(500 * channels)], 500));
+        generator.done();
+
+        ASSERT_THAT(buffer.getChannels(), Eq(channels));
+        ASSERT_THAT(buffer.getSize(), Eq(expected_buffer.getSize()));
+
+        for (int channel = 0; channel < channels; ++channel) {
+            for (int i = 0; i < buffer.getSize(); ++i) {
+                ASSERT_THAT(buffer.getMinSample(channel, i), Eq(expected_buffer.getMinSample(channel, i)));
+                ASSERT_THAT(buffer.getMaxSample(channel, i), Eq(expected_buffer.getMaxSample(channel, i)));
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformGeneratorTest, shouldMixFloatingPointInputBeforeConverting)
+{
+    WaveformBuffer buffer;
+
+    SamplesPerPixelScaleFactor scale_factor(4);
+    WaveformGenerator generator(buffer, false, scale_factor);
+
+    // Values outside -1.0 to 1.0 are clipped
+    const float samples[] = {
+        0.5f, 0.25f,
+        -0.5f, -0.25f,
+        2.0f, 2.0f,
+        -3.0f, 1.0f
+    };
+
+    ASSERT_TRUE(generator.init(44100, 2, 0, 8));
+    ASSERT_TRUE(generator.processFloat(samples, 4));
+    generator.done();
+
+    ASSERT_THAT(buffer.getSize(), Eq(1));
+    ASSERT_THAT(buffer.getMinSample(0, 0), Eq(-32767));
+    ASSERT_THAT(buffer.getMaxSample(0, 0), Eq(32767));
+
+    WaveformBuffer buffer2;
+    WaveformGenerator generator2(buffer2, false, scale_factor);
+
+    ASSERT_TRUE(generator2.init(44100, 2, 0, 8));
+    ASSERT_TRUE(generator2.processFloat(samples, 2));
+    generator2.done();
+
+    // (0.5 + 0.25) / 2 * 32767, rounded towards zero
+    ASSERT_THAT(buffer2.getMinSample(0, 0), Eq(-12287));
+    ASSERT_THAT(buffer2.getMaxSample(0, 0), Eq(12287));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformGeneratorTest, shouldCombinePointsWhenMaxSizeIsReached)
+{
+    const int sample_rate = 44100;
+    const int channels    = 2;
+    const int frames      = 10000;
+
+    std::vector<short> samples(static_cast<size_t>(frames * channels));
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<short>((i * 7919) % 65536 - 32768);
+    }
+
+    SamplesPerPixelScaleFactor scale_factor(1);
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, true, scale_factor);
+
+    generator.setMaxSize(1000);
+
+    ASSERT_TRUE(generator.init(sample_rate, channels, 0, 512));
+
+    for (int frame = 0; frame < frames; frame += 500) {
+        ASSERT_TRUE(generator.process(&samples[static_cast<size_t>(frame * channels)], 500));
+        ASSERT_THAT(buffer.getSize(), Lt(1000));
+    }
+
+    generator.done();
+
+    ASSERT_THAT(generator.getFrameCount(), Eq(frames));
+
+    // 10000 frames need 625 points at 16 samples per pixel
+    ASSERT_THAT(buffer.getSamplesPerPixel(), Eq(16));
+    ASSERT_THAT(buffer.getSize(), Eq(625));
+
+    SamplesPerPixelScaleFactor expected_scale_factor(16);
+
+    WaveformBuffer expected_buffer;
+    WaveformGenerator expected_generator(expected_buffer, true, expected_scale_factor);
+
+    ASSERT_TRUE(expected_generator.init(sample_rate, channels, 0, frames * channels));
+    ASSERT_TRUE(expected_generator.process(&samples[0], frames));
+    expected_generator.done();
+
+    ASSERT_THAT(buffer.getSize(), Eq(expected_buffer.getSize()));
+
+    for (int channel = 0; channel < channels; ++channel) {
+        for (int i = 0; i < buffer.getSize(); ++i) {
+            ASSERT_THAT(buffer.getMinSample(channel, i), Eq(expected_buffer.getMinSample(channel, i)));
+            ASSERT_THAT(buffer.getMaxSample(channel, i), Eq(expected_buffer.getMaxSample(channel, i)));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Waveform data generated at one sample per pixel then rescaled is the same as
+// generating it at the final scale, which renderWaveformImage() relies on when
+// fitting audio of unknown duration to the image width.
+
+TEST_F(WaveformGeneratorTest, shouldGiveSameResultWhenRescaledFromOneSamplePerPixel)
+{
+    const int sample_rate       = 44100;
+    const int channels          = 2;
+    const int frames            = 10000;
+    const int samples_per_pixel = 227;
+
+    std::vector<short> samples(static_cast<size_t>(frames * channels));
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<short>((i * 7919) % 65536 - 32768);
+    }
+
+    SamplesPerPixelScaleFactor scale_factor(1);
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, false, scale_factor);
+
+    generator.setMaxSize(1 << 20);
+
+    ASSERT_TRUE(generator.init(sample_rate, channels, 0, frames * channels));
+    ASSERT_TRUE(generator.process(&samples[0], frames));
+    generator.done();
+
+    ASSERT_THAT(buffer.getSamplesPerPixel(), Eq(1));
+
+    WaveformBuffer rescaled_buffer;
+    WaveformRescaler rescaler;
+
+    rescaler.rescale(buffer, rescaled_buffer, samples_per_pixel);
+
+    SamplesPerPixelScaleFactor expected_scale_factor(samples_per_pixel);
+
+    WaveformBuffer expected_buffer;
+    WaveformGenerator expected_generator(expected_buffer, false, expected_scale_factor);
+
+    ASSERT_TRUE(expected_generator.init(sample_rate, channels, 0, frames * channels));
+    ASSERT_TRUE(expected_generator.process(&samples[0], frames));
+    expected_generator.done();
+
+    ASSERT_THAT(rescaled_buffer.getSize(), Eq(expected_buffer.getSize()));
+
+    for (int i = 0; i < expected_buffer.getSize(); ++i) {
+        ASSERT_THAT(rescaled_buffer.getMinSample(0, i), Eq(expected_buffer.getMinSample(0, i)));
+        ASSERT_THAT(rescaled_buffer.getMaxSample(0, i), Eq(expected_buffer.getMaxSample(0, i)));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformGeneratorTest, shouldFailIfSamplesPerPixelIsOneAndSizeIsNotLimited)
+{
+    WaveformBuffer buffer;
+
+    SamplesPerPixelScaleFactor scale_factor(1);
+    WaveformGenerator generator(buffer, false, scale_factor);
+
+    bool result = generator.init(44100, 1, 0, 1024);
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), StrEq("Invalid zoom: minimum 2\n"));
+}
+
+//------------------------------------------------------------------------------
@@ -26,6 +26,8 @@
 
 #include "gmock/gmock.h"
 
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 
 using testing::Eq;
@@ -120,3 +122,137 @@ TEST_F(WaveformRescalerTest, shouldRescale16BitWaveformData)
 }
 
 //------------------------------------------------------------------------------
+
+TEST_F(WaveformRescalerTest, shouldRescalePartOfWaveformData)
+{
+    WaveformBuffer input_buffer;
+    bool result = input_buffer.load("../test/data/07023003_8bit_64spp_2channel.dat");
+
+    ASSERT_TRUE(result);
+
+    WaveformBuffer output_buffer;
+
+    rescaler_.rescale(input_buffer, output_buffer, 150);
+
+    // Output points 100 to 399 use input points 234 to 936
+    WaveformBuffer part_buffer;
+    result = part_buffer.load("../test/data/07023003_8bit_64spp_2channel.dat", 234, 937);
+
+    ASSERT_TRUE(result);
+
+    WaveformBuffer part_output_buffer;
+
+    rescaler_.rescale(part_buffer, part_output_buffer, 150);
+
+    ASSERT_THAT(part_output_buffer.getStartIndex(), Eq(100));
+    ASSERT_THAT(part_output_buffer.getSize(), Eq(300));
+
+    for (int i = 0; i < part_output_buffer.getSize(); ++i) {
+        for (int channel = 0; channel < 2; ++channel) {
+            ASSERT_THAT(part_output_buffer.getMinSample(channel, i), Eq(output_buffer.getMinSample(channel, 100 + i)));
+            ASSERT_THAT(part_output_buffer.getMaxSample(channel, i), Eq(output_buffer.getMaxSample(channel, 100 + i)));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Checks each output point against the minimum and maximum of the input points
+// from (index * output samples per pixel) / input samples per pixel.
+
+static void testRescaleWaveformData(int samples_per_pixel)
+{
+    WaveformBuffer input_buffer;
+    bool result = input_buffer.load("../test/data/07023003_8bit_64spp_2channel.dat");
+
+    ASSERT_TRUE(result);
+    ASSERT_THAT(input_buffer.getSize(), Eq(10438));
+
+    WaveformBuffer output_buffer;
+
+    WaveformRescaler rescaler;
+    rescaler.rescale(input_buffer, output_buffer, samples_per_pixel);
+
+    const int expected_size = static_cast<int>(
+        (10438LL * 64 + samples_per_pixel - 1) / samples_per_pixel
+    );
+
+    ASSERT_THAT(output_buffer.getSize(), Eq(expected_size));
+    ASSERT_THAT(output_buffer.getChannels(), Eq(2));
+
+    for (int i = 0; i < output_buffer.getSize(); ++i) {
+        const int first = static_cast<int>(
+            static_cast<long long>(i) * samples_per_pixel / 64
+        );
+
+        const int last = std::min(
+            static_cast<int>(static_cast<long long>(i + 1) * samples_per_pixel / 64),
+            input_buffer.getSize()
+        );
+
+        for (int channel = 0; channel < 2; ++channel) {
+            short min = input_buffer.getMinSample(channel, first);
+            short max = input_buffer.getMaxSample(channel, first);
+
+            for (int j = first + 1; j < last; ++j) {
+                min = std::min(min, input_buffer.getMinSample(channel, j));
+                max = std::max(max, input_buffer.getMaxSample(channel, j));
+            }
+
+            ASSERT_THAT(output_buffer.getMinSample(channel, i), Eq(min));
+            ASSERT_THAT(output_buffer.getMaxSample(channel, i), Eq(max));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformRescalerTest, shouldRescaleMultiChannelWaveformData)
+{
+    testRescaleWaveformData(150);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformRescalerTest, shouldRescaleMultiChannelWaveformDataToLargeScale)
+{
+    testRescaleWaveformData(4410);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformRescalerTest, shouldRescaleWithMultipleThreads)
+{
+    WaveformBuffer input_buffer;
+
+    input_buffer.setSampleRate(44100);
+    input_buffer.setChannels(2);
+    input_buffer.setSamplesPerPixel(64);
+
+    for (int i = 0; i < 500000; ++i) {
+        const short value = static_cast<short>((i % 3001) * 9);
+
+        input_buffer.appendSamples(static_cast<short>(-value), value);
+        input_buffer.appendSamples(static_cast<short>(value / 2 - 20000), static_cast<short>(value / 3));
+    }
+
+    WaveformBuffer output_buffer;
+    rescaler_.rescale(input_buffer, output_buffer, 100);
+
+    WaveformBuffer threaded_output_buffer;
+
+    WaveformRescaler threaded_rescaler(4);
+    threaded_rescaler.rescale(input_buffer, threaded_output_buffer, 100);
+
+    ASSERT_THAT(output_buffer.getSize(), Eq(320000));
+    ASSERT_THAT(threaded_output_buffer.getSize(), Eq(output_buffer.getSize()));
+
+    for (int i = 0; i < output_buffer.getSize(); ++i) {
+        for (int channel = 0; channel < 2; ++channel) {
+            ASSERT_THAT(threaded_output_buffer.getMinSample(channel, i), Eq(output_buffer.getMinSample(channel, i)));
+            ASSERT_THAT(threaded_output_buffer.getMaxSample(channel, i), Eq(output_buffer.getMaxSample(channel, i)));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
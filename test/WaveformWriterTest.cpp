@@ -0,0 +1,357 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "WaveformWriter.h"
+#include "WaveformBuffer.h"
+#include "WaveformGenerator.h"
+#include "util/FileDeleter.h"
+#include "util/FileUtil.h"
+#include "util/Streams.h"
+#include "util/WaveformUtil.h"
+
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+using testing::StartsWith;
+using testing::StrEq;
+using testing::Test;
+
+//------------------------------------------------------------------------------
+
+class WaveformWriterTest : public Test
+{
+    protected:
+        virtual void SetUp()
+        {
+            output.str(std::string());
+            error.str(std::string());
+        }
+
+        virtual void TearDown()
+        {
+        }
+};
+
+//------------------------------------------------------------------------------
+
+static void processSamples(
+    AudioProcessor& processor,
+    const std::vector<short>& samples,
+    const int channels,
+    const int block_frames)
+{
+    const int frames = static_cast<int>(samples.size()) / channels;
+
+    bool result = processor.init(44100, channels, frames, block_frames);
+    ASSERT_TRUE(result);
+
+    for (int frame = 0; frame < frames; frame += block_frames) {
+        const int count = std::min(block_frames, frames - frame);
+
+        result = processor.process(&samples[static_cast<size_t>(frame * channels)], count);
+        ASSERT_TRUE(result);
+    }
+
+    processor.done();
+}
+
+//------------------------------------------------------------------------------
+
+// Checks that the output is the same as when the waveform data is generated
+// into a WaveformBuffer and then saved.
+
+static void testWriteSameOutput(
+    const FileFormat::FileFormat format,
+    const int bits,
+    const int channels,
+    const bool split_channels,
+    const int version = 0)
+{
+    const char* ext = format == FileFormat::Dat ? ".dat" : ".json";
+
+    const boost::filesystem::path filename = FileUtil::getTempFilename(ext);
+    const boost::filesystem::path expected_filename = FileUtil::getTempFilename(ext);
+
+    FileDeleter deleter(filename);
+    FileDeleter expected_deleter(expected_filename);
+
+    const std::vector<short> samples = WaveformUtil::createSamples(100000, channels);
+
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    {
+        WaveformBuffer buffer;
+        WaveformGenerator generator(buffer, split_channels, scale_factor);
+        WaveformWriter writer(generator, buffer, format, bits, version);
+
+        bool result = writer.open(filename.c_str());
+        ASSERT_TRUE(result);
+
+        processSamples(writer, samples, channels, 4096);
+
+        ASSERT_FALSE(writer.hasError());
+        ASSERT_THAT(writer.getSize(), Eq(391));
+
+        // Points are removed from the buffer once written
+        ASSERT_THAT(buffer.getSize(), Eq(0));
+    }
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, split_channels, scale_factor);
+
+    processSamples(generator, samples, channels, 4096);
+
+    bool result = format == FileFormat::Dat ?
+        buffer.save(expected_filename.c_str(), bits, version) :
+        buffer.saveAsJson(expected_filename.c_str(), bits);
+
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(
+        FileUtil::readFile(filename),
+        Eq(FileUtil::readFile(expected_filename))
+    );
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldWriteSame16BitDataFile)
+{
+    testWriteSameOutput(FileFormat::Dat, 16, 1, false);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldWriteSame8BitDataFileWithMultipleChannels)
+{
+    testWriteSameOutput(FileFormat::Dat, 8, 2, true);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldWriteSame16BitVersion3DataFile)
+{
+    testWriteSameOutput(FileFormat::Dat, 16, 1, false, 3);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldWriteSame8BitVersion3DataFileWithMultipleChannels)
+{
+    testWriteSameOutput(FileFormat::Dat, 8, 2, true, 3);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldWriteSame16BitJsonFile)
+{
+    testWriteSameOutput(FileFormat::Json, 16, 2, false);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldWriteSame8BitJsonFileWithMultipleChannels)
+{
+    testWriteSameOutput(FileFormat::Json, 8, 2, true);
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldNotKeepPointsInBuffer)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    const std::vector<short> samples = WaveformUtil::createSamples(100000, 1);
+
+    SamplesPerPixelScaleFactor scale_factor(64);
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, false, scale_factor);
+    WaveformWriter writer(generator, buffer, FileFormat::Dat, 16);
+
+    bool result = writer.open(filename.c_str());
+    ASSERT_TRUE(result);
+
+    result = writer.init(44100, 1, 100000, 1024);
+    ASSERT_TRUE(result);
+
+    for (int frame = 0; frame < 100000; frame += 1000) {
+        result = writer.process(&samples[static_cast<size_t>(frame)], 1000);
+        ASSERT_TRUE(result);
+
+        ASSERT_THAT(buffer.getSize(), Eq(0));
+    }
+
+    writer.done();
+
+    ASSERT_FALSE(writer.hasError());
+    ASSERT_THAT(writer.getSize(), Eq(1563));
+}
+
+//------------------------------------------------------------------------------
+
+// A stream buffer that can't be seeked, like a pipe.
+
+class NonSeekableStreamBuffer : public std::stringbuf
+{
+    protected:
+        virtual pos_type seekoff(off_type, std::ios::seekdir, std::ios::openmode)
+        {
+            return pos_type(off_type(-1));
+        }
+
+        virtual pos_type seekpos(pos_type, std::ios::openmode)
+        {
+            return pos_type(off_type(-1));
+        }
+};
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldWriteUnknownLengthIfOutputNotSeekable)
+{
+    const std::vector<short> samples = WaveformUtil::createSamples(1000, 1);
+
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, false, scale_factor);
+    WaveformWriter writer(generator, buffer, FileFormat::Dat, 8);
+
+    NonSeekableStreamBuffer stream_buffer;
+
+    std::streambuf* streambuf = std::cout.rdbuf(&stream_buffer);
+
+    bool result = writer.open("-");
+
+    if (result) {
+        processSamples(writer, samples, 1, 100);
+    }
+
+    std::cout.rdbuf(streambuf);
+
+    ASSERT_TRUE(result);
+    ASSERT_FALSE(writer.hasError());
+
+    const std::string data = stream_buffer.str();
+
+    // 20 byte header + 4 points
+    ASSERT_THAT(data.size(), Eq(28U));
+
+    uint32_t length;
+    memcpy(&length, &data[16], sizeof(length));
+
+    ASSERT_THAT(length, Eq(WaveformBuffer::UNKNOWN_LENGTH));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldWriteVersion3DataFileToNonSeekableOutput)
+{
+    const boost::filesystem::path filename = FileUtil::getTempFilename(".dat");
+    FileDeleter deleter(filename);
+
+    const std::vector<short> samples = WaveformUtil::createSamples(1000, 2);
+
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, true, scale_factor);
+    WaveformWriter writer(generator, buffer, FileFormat::Dat, 16, 3);
+
+    NonSeekableStreamBuffer stream_buffer;
+
+    std::streambuf* streambuf = std::cout.rdbuf(&stream_buffer);
+
+    bool result = writer.open("-");
+
+    if (result) {
+        processSamples(writer, samples, 2, 100);
+    }
+
+    std::cout.rdbuf(streambuf);
+
+    ASSERT_TRUE(result);
+    ASSERT_FALSE(writer.hasError());
+
+    const std::string data = stream_buffer.str();
+
+    {
+        std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+        file << data;
+    }
+
+    WaveformBuffer loaded_buffer;
+
+    result = loaded_buffer.load(filename.c_str());
+    ASSERT_TRUE(result);
+
+    ASSERT_THAT(loaded_buffer.getChannels(), Eq(2));
+    ASSERT_THAT(loaded_buffer.getSize(), Eq(4));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldReportErrorIfFileCannotBeCreated)
+{
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, false, scale_factor);
+    WaveformWriter writer(generator, buffer, FileFormat::Dat, 16);
+
+    bool result = writer.open("/nonexistent/test.dat");
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(output.str(), StrEq(""));
+    ASSERT_THAT(error.str(), StartsWith(
+        "Failed to write data file: /nonexistent/test.dat\n"
+    ));
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(WaveformWriterTest, shouldReportErrorIfInvalidBits)
+{
+    SamplesPerPixelScaleFactor scale_factor(256);
+
+    WaveformBuffer buffer;
+    WaveformGenerator generator(buffer, false, scale_factor);
+    WaveformWriter writer(generator, buffer, FileFormat::Dat, 12);
+
+    bool result = writer.open("-");
+    ASSERT_FALSE(result);
+
+    ASSERT_THAT(error.str(), StrEq("Invalid bits: must be either 8 or 16\n"));
+}
+
+//------------------------------------------------------------------------------
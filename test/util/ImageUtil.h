@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_IMAGE_UTIL_H)
+#define INC_IMAGE_UTIL_H
+
+//------------------------------------------------------------------------------
+
+#include <boost/filesystem.hpp>
+
+#include <gd.h>
+
+//------------------------------------------------------------------------------
+
+namespace ImageUtil {
+    // Returns nullptr if the file can't be read. The caller must destroy the
+    // image with gdImageDestroy().
+
+    gdImagePtr loadPng(const boost::filesystem::path& filename);
+}
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_IMAGE_UTIL_H)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "JobClient.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+
+#if defined(MSG_NOSIGNAL)
+const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+const int SEND_FLAGS = 0;
+#endif
+
+//------------------------------------------------------------------------------
+
+JobClient::JobClient() :
+    fd_(-1)
+{
+}
+
+//------------------------------------------------------------------------------
+
+JobClient::~JobClient()
+{
+    close();
+}
+
+//------------------------------------------------------------------------------
+
+bool JobClient::connect(const std::string& socket_filename)
+{
+    close();
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (socket_filename.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+
+    memcpy(address.sun_path, socket_filename.c_str(), socket_filename.size());
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd_ == -1) {
+        return false;
+    }
+
+    if (::connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void JobClient::close()
+{
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    buffer_.clear();
+}
+
+//------------------------------------------------------------------------------
+
+bool JobClient::sendRequest(
+    const std::string& request,
+    std::string& response,
+    std::string& data)
+{
+    const std::string line = request + '\n';
+
+    size_t offset = 0;
+
+    while (offset < line.size()) {
+        const ssize_t result = send(
+            fd_,
+            line.data() + offset,
+            line.size() - offset,
+            SEND_FLAGS
+        );
+
+        if (result <= 0) {
+            return false;
+        }
+
+        offset += static_cast<size_t>(result);
+    }
+
+    if (!readLine(response)) {
+        return false;
+    }
+
+    data.clear();
+
+    const char size_key[] = "\"size\":";
+
+    const size_t pos = response.find(size_key);
+
+    if (pos != std::string::npos) {
+        const size_t size = strtoul(
+            response.c_str() + pos + strlen(size_key), nullptr, 10
+        );
+
+        return read(size, data);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool JobClient::sendRequest(const std::string& request, std::string& response)
+{
+    std::string data;
+    return sendRequest(request, response, data);
+}
+
+//------------------------------------------------------------------------------
+
+bool JobClient::readLine(std::string& line)
+{
+    size_t pos;
+
+    while ((pos = buffer_.find('\n')) == std::string::npos) {
+        if (!receive()) {
+            return false;
+        }
+    }
+
+    line.assign(buffer_, 0, pos);
+    buffer_.erase(0, pos + 1);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool JobClient::read(const size_t size, std::string& data)
+{
+    while (buffer_.size() < size) {
+        if (!receive()) {
+            return false;
+        }
+    }
+
+    data.assign(buffer_, 0, size);
+    buffer_.erase(0, size);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool JobClient::receive()
+{
+    char data[4096];
+
+    for (;;) {
+        const ssize_t result = recv(fd_, data, sizeof(data), 0);
+
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (result <= 0) {
+            return false;
+        }
+
+        buffer_.append(data, static_cast<size_t>(result));
+
+        return true;
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#if !defined(INC_JOB_CLIENT_H)
+#define INC_JOB_CLIENT_H
+
+//------------------------------------------------------------------------------
+
+#include <string>
+
+//------------------------------------------------------------------------------
+
+// A minimal client for JobServer, which sends requests over a Unix domain
+// socket and reads the responses.
+
+class JobClient
+{
+    public:
+        JobClient();
+        ~JobClient();
+
+        JobClient(const JobClient&) = delete;
+        JobClient& operator=(const JobClient&) = delete;
+
+    public:
+        bool connect(const std::string& socket_filename);
+        void close();
+
+        // Sends a request and reads the response line. If the response gives
+        // a size, also reads the data that follows it.
+        bool sendRequest(
+            const std::string& request,
+            std::string& response,
+            std::string& data
+        );
+
+        bool sendRequest(const std::string& request, std::string& response);
+
+    private:
+        bool readLine(std::string& line);
+        bool read(size_t size, std::string& data);
+        bool receive();
+
+    private:
+        int fd_;
+        std::string buffer_;
+};
+
+//------------------------------------------------------------------------------
+
+#endif // #if !defined(INC_JOB_CLIENT_H)
+
+//------------------------------------------------------------------------------
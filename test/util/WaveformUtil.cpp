@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+//
+// Copyright 2026 BBC Research and Development
+//
+// This file is part of Audio Waveform Image Generator.
+//
+// Audio Waveform Image Generator is free software: you can redistribute it
+// and/or modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+//
+// Audio Waveform Image Generator is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// Audio Waveform Image Generator.  If not, see <http://www.gnu.org/licenses/>.
+//
+//------------------------------------------------------------------------------
+
+#include "WaveformUtil.h"
+#include "WaveformBuffer.h"
+
+#include "gmock/gmock.h"
+
+//------------------------------------------------------------------------------
+
+using testing::Eq;
+
+//------------------------------------------------------------------------------
+
+namespace WaveformUtil {
+
+//------------------------------------------------------------------------------
+
+std::vector<short> createSamples(int frames, int channels)
+{
+    std::vector<short> samples(static_cast<size_t>(frames * channels));
+
+    unsigned int value = 1;
+
+    for (auto& sample : samples) {
+        value = value * 1103515245 + 12345;
+        sample = static_cast<short>((value >> 16) & 0xffff);
+    }
+
+    return samples;
+}
+
+//------------------------------------------------------------------------------
+
+void compareBuffers(
+    const WaveformBuffer& buffer,
+    const WaveformBuffer& expected_buffer)
+{
+    ASSERT_THAT(buffer.getSampleRate(), Eq(expected_buffer.getSampleRate()));
+    ASSERT_THAT(buffer.getSamplesPerPixel(), Eq(expected_buffer.getSamplesPerPixel()));
+    ASSERT_THAT(buffer.getChannels(), Eq(expected_buffer.getChannels()));
+    ASSERT_THAT(buffer.getSize(), Eq(expected_buffer.getSize()));
+
+    for (int channel = 0; channel < buffer.getChannels(); ++channel) {
+        for (int i = 0; i < buffer.getSize(); ++i) {
+            ASSERT_THAT(buffer.getMinSample(channel, i), Eq(expected_buffer.getMinSample(channel, i)));
+            ASSERT_THAT(buffer.getMaxSample(channel, i), Eq(expected_buffer.getMaxSample(channel, i)));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace WaveformUtil
+
+//------------------------------------------------------------------------------
@@ -1,8 +1,6 @@
 //------------------------------------------------------------------------------
 //
-// Copyright 2022 BBC Research and Development
-//
-// Author: Chris Needham
+// Copyright 2026 BBC Research and Development
 //
 // This file is part of Audio Waveform Image Generator.
 //
@@ -21,61 +19,35 @@
 //
 //------------------------------------------------------------------------------
 
-#include "AudioLoader.h"
-
-#include "Log.h"
-
-#include <ostream>
-
-//------------------------------------------------------------------------------
-
-AudioLoader::AudioLoader() :
-    sample_rate_(0),
-    channels_(0)
-{
-}
+#if !defined(INC_WAVEFORM_UTIL_H)
+#define INC_WAVEFORM_UTIL_H
 
 //------------------------------------------------------------------------------
 
-bool AudioLoader::init(int sample_rate, int channels, long /* frame_count */, int /* buffer_size */)
-{
-    sample_rate_ = sample_rate;
-    channels_ = channels;
-
-    return true;
-}
+#include <vector>
 
 //------------------------------------------------------------------------------
 
-bool AudioLoader::shouldContinue() const
-{
-    return true;
-}
+class WaveformBuffer;
 
 //------------------------------------------------------------------------------
 
-bool AudioLoader::process(const short* input_buffer, int input_frame_count)
-{
-    for (int i = 0; i < input_frame_count * channels_; i++) {
-        audio_samples_.push_back(input_buffer[i]);
-    }
+namespace WaveformUtil {
+    // Returns frames * channels pseudo-random samples. The same arguments
+    // always give the same samples.
 
-    return true;
-}
+    std::vector<short> createSamples(int frames, int channels);
 
-//------------------------------------------------------------------------------
+    // Asserts that both buffers have the same attributes and data.
 
-void AudioLoader::done()
-{
+    void compareBuffers(
+        const WaveformBuffer& buffer,
+        const WaveformBuffer& expected_buffer
+    );
 }
 
 //------------------------------------------------------------------------------
 
-double AudioLoader::getDuration() const
-{
-    const size_t frame_count = audio_samples_.size() / channels_;
-
-    return static_cast<double>(frame_count) / static_cast<double>(sample_rate_);
-}
+#endif // #if !defined(INC_WAVEFORM_UTIL_H)
 
 //------------------------------------------------------------------------------